@@ -0,0 +1,214 @@
+/* Annex-B start-code scan over SHM-sized access units: the byte-at-a-time
+ * loop hevc_parse_annex_b_stats() used before (copied here) against every
+ * scanner src/annexb_scan.c offers on this CPU.
+ *
+ * Two synthetic 4K access units are built up front, shaped like what a
+ * hardware encoder writes to the SHM ring: an IDR (AUD, VPS, SPS, PPS,
+ * SEI, then IDR_W_RADL slices, ~480 KiB by default) and a P frame (AUD,
+ * then TRAIL_R slices, ~48 KiB). Slice payload is random with emulation
+ * prevention applied, so 00 00 0x only ever appears as a real start code.
+ * Each scanner walks each AU the way the relay does, and its NAL type
+ * list is checked against the reference loop.
+ *
+ * Built by `make bench` against src/annexb_scan.c (no GLib/GStreamer). */
+#define _GNU_SOURCE
+#include "annexb_scan.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_NALS 64u
+
+typedef struct {
+    const char *name;
+    uint8_t *data;
+    size_t len;
+    size_t cap;
+} Au;
+
+typedef struct {
+    unsigned count;
+    uint8_t types[MAX_NALS];
+} NalList;
+
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000ll + ts.tv_nsec;
+}
+
+static uint32_t next_rand(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static void au_byte(Au *au, uint8_t b) {
+    if (au->len == au->cap) {
+        au->cap = au->cap ? au->cap * 2u : 4096u;
+        au->data = realloc(au->data, au->cap);
+        if (!au->data) {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+    }
+    au->data[au->len++] = b;
+}
+
+/* Start code, 2-byte NAL header, then size bytes of random payload with an
+ * emulation-prevention 03 after any 00 00 that would be followed by <= 3. */
+static void au_nal(Au *au, uint8_t type, size_t size, int long_start, uint32_t *rng) {
+    if (long_start) au_byte(au, 0);
+    au_byte(au, 0);
+    au_byte(au, 0);
+    au_byte(au, 1);
+    au_byte(au, (uint8_t)(type << 1));
+    au_byte(au, 1);
+    unsigned zeros = 0;
+    for (size_t i = 0; i < size; i++) {
+        /* Roughly 1 in 32 bytes zero, as in CABAC output around
+         * byte-aligned slice data. */
+        uint32_t r = next_rand(rng);
+        uint8_t b = (r & 31u) == 0 ? 0 : (uint8_t)(r >> 8);
+        if (zeros >= 2 && b <= 3) {
+            au_byte(au, 3);
+            zeros = 0;
+        }
+        au_byte(au, b);
+        zeros = b == 0 ? zeros + 1 : 0;
+    }
+    /* rbsp_trailing_bits, so the NAL never ends on a zero byte. */
+    au_byte(au, 0x80);
+}
+
+static void build_idr(Au *au, size_t bytes, unsigned slices, uint32_t *rng) {
+    au->name = "idr";
+    au_nal(au, 35, 1, 1, rng);   /* AUD */
+    au_nal(au, 32, 24, 1, rng);  /* VPS */
+    au_nal(au, 33, 64, 1, rng);  /* SPS */
+    au_nal(au, 34, 12, 1, rng);  /* PPS */
+    au_nal(au, 39, 40, 1, rng);  /* prefix SEI */
+    for (unsigned s = 0; s < slices; s++) au_nal(au, 19, bytes / slices, s == 0, rng);
+}
+
+static void build_p(Au *au, size_t bytes, unsigned slices, uint32_t *rng) {
+    au->name = "p";
+    au_nal(au, 35, 1, 1, rng);
+    for (unsigned s = 0; s < slices; s++) au_nal(au, 1, bytes / slices, s == 0, rng);
+}
+
+/* hevc_parse_annex_b_stats() before the scanner. */
+static void scan_bytewise(const uint8_t *au, size_t len, NalList *out) {
+    out->count = 0;
+    size_t i = 0;
+    while (i + 4 <= len) {
+        size_t start = SIZE_MAX;
+        for (; i + 3 <= len; i++) {
+            if (au[i] == 0 && au[i + 1] == 0 && au[i + 2] == 1) {
+                start = i + 3;
+                break;
+            }
+            if (i + 4 <= len && au[i] == 0 && au[i + 1] == 0 &&
+                au[i + 2] == 0 && au[i + 3] == 1) {
+                start = i + 4;
+                break;
+            }
+        }
+        if (start == SIZE_MAX || start >= len) break;
+        if (out->count < MAX_NALS) out->types[out->count] = (uint8_t)((au[start] >> 1) & 0x3f);
+        out->count++;
+        i = start + 1;
+    }
+}
+
+/* hevc_parse_annex_b_stats() now. */
+static void scan_with(const AnnexbScanner *sc, const uint8_t *au, size_t len, NalList *out) {
+    out->count = 0;
+    size_t pos = 0;
+    while ((pos = sc->find(au, len, pos)) + 3 < len) {
+        if (out->count < MAX_NALS) out->types[out->count] = (uint8_t)((au[pos + 3] >> 1) & 0x3f);
+        out->count++;
+        pos += 4;
+    }
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--idr-kb N] [--p-kb N] [--slices N] [--iters N] [--rounds N]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    size_t idr_kb = 480, p_kb = 48;
+    unsigned slices = 8, iters = 200, rounds = 5;
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--idr-kb") == 0) {
+            idr_kb = strtoull(argv[++i], NULL, 10);
+        } else if (i + 1 < argc && strcmp(argv[i], "--p-kb") == 0) {
+            p_kb = strtoull(argv[++i], NULL, 10);
+        } else if (i + 1 < argc && strcmp(argv[i], "--slices") == 0) {
+            slices = (unsigned)strtoul(argv[++i], NULL, 10);
+        } else if (i + 1 < argc && strcmp(argv[i], "--iters") == 0) {
+            iters = (unsigned)strtoul(argv[++i], NULL, 10);
+        } else if (i + 1 < argc && strcmp(argv[i], "--rounds") == 0) {
+            rounds = (unsigned)strtoul(argv[++i], NULL, 10);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (idr_kb == 0 || p_kb == 0 || slices == 0 || slices > MAX_NALS - 8u || iters == 0 || rounds == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    uint32_t rng = 0x2545f491u;
+    Au aus[2];
+    memset(aus, 0, sizeof(aus));
+    build_idr(&aus[0], idr_kb * 1024u, slices, &rng);
+    build_p(&aus[1], p_kb * 1024u, slices, &rng);
+
+    const AnnexbScanner *scanners;
+    size_t n_scanners = annexb_scanners(&scanners);
+    printf("selected=%s iters=%u rounds=%u\n", annexb_scanner()->name, iters, rounds);
+    printf("%-4s %8s %-9s %5s %11s %8s %8s\n", "au", "bytes", "scanner", "nals", "us/au", "GB/s", "speedup");
+
+    int mismatches = 0;
+    volatile unsigned sink = 0;
+    for (size_t a = 0; a < 2; a++) {
+        const Au *au = &aus[a];
+        NalList ref, got;
+        scan_bytewise(au->data, au->len, &ref);
+
+        double base_ns = 0.0;
+        for (size_t s = 0; s <= n_scanners; s++) {
+            const AnnexbScanner *sc = s == 0 ? NULL : &scanners[s - 1];
+            double best = 0.0;
+            for (unsigned r = 0; r < rounds; r++) {
+                int64_t t0 = now_ns();
+                for (unsigned it = 0; it < iters; it++) {
+                    if (sc) scan_with(sc, au->data, au->len, &got);
+                    else scan_bytewise(au->data, au->len, &got);
+                    sink += got.count;
+                }
+                double ns = (double)(now_ns() - t0) / (double)iters;
+                if (r == 0 || ns < best) best = ns;
+            }
+            if (s == 0) base_ns = best;
+            int ok = got.count == ref.count &&
+                     memcmp(got.types, ref.types, got.count < MAX_NALS ? got.count : MAX_NALS) == 0;
+            if (!ok) mismatches++;
+            printf("%-4s %8zu %-9s %5u %11.2f %8.2f %7.1fx%s\n",
+                   au->name, au->len, sc ? sc->name : "bytewise", got.count,
+                   best / 1000.0, (double)au->len / best, base_ns / best,
+                   ok ? "" : "  MISMATCH");
+        }
+    }
+
+    for (size_t a = 0; a < 2; a++) free(aus[a].data);
+    return mismatches == 0 ? 0 : 1;
+}
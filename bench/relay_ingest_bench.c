@@ -0,0 +1,461 @@
+/* Receive-path ceiling of the relay's ingest backends over loopback:
+ * recvmmsg() on a UDP socket (relay_backend = socket), a multishot
+ * io_uring recvmsg into a provided buffer ring (io-uring, src/uring_io.c
+ * and relay_uring_thread_run()), and an in-place walk of a TPACKET_V3
+ * PACKET_RX_RING behind a BPF port filter (packet-ring,
+ * src/packet_ring.c). The ring setups, filter and completion/block walks
+ * are trimmed copies of the relay's.
+ *
+ * Sender threads blast fixed-size datagrams at 127.0.0.1 as fast as
+ * sendmmsg() allows for a fixed time while one receiver drains the chosen
+ * backend and touches every payload. Reported per backend: datagrams sent
+ * and received per second, the share lost before the receiver (socket
+ * buffer or ring full), receiver syscalls per datagram, and receiver CPU
+ * time per datagram. On lo the kernel's copy into either the socket or
+ * the ring runs in the sender's softirq, so cpu_ns/pkt is the receiver's
+ * own cost: syscalls and copy-out for recvmmsg, the block walk for the
+ * ring. The packet ring needs CAP_NET_RAW; without it that row prints
+ * n/a.
+ *
+ * Built standalone (no GLib/GStreamer) by `make bench`. */
+#define _GNU_SOURCE
+#include <arpa/inet.h>
+#include <errno.h>
+#include <linux/filter.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <linux/io_uring.h>
+#include <linux/sock_diag.h>
+#include <net/if.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef PACKET_IGNORE_OUTGOING
+#define PACKET_IGNORE_OUTGOING 23
+#endif
+
+#define BENCH_BATCH 32
+#define RING_BLOCK_SIZE (1u << 20)
+#define RING_BLOCK_NR 16u
+#define RING_FRAME_SIZE 2048u
+
+typedef struct {
+    int port;
+    size_t payload;
+    atomic_int *stop;
+    uint64_t sent;
+} Sender;
+
+typedef struct {
+    uint64_t received;
+    uint64_t syscalls;
+    uint64_t kernel_drops;
+    uint64_t checksum;
+    int64_t cpu_ns;
+} RecvResult;
+
+static int64_t clock_ns(clockid_t id) {
+    struct timespec ts;
+    clock_gettime(id, &ts);
+    return (int64_t)ts.tv_sec * 1000000000ll + ts.tv_nsec;
+}
+
+static void *sender_run(void *arg) {
+    Sender *s = arg;
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in dst = { .sin_family = AF_INET, .sin_port = htons((uint16_t)s->port) };
+    dst.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&dst, sizeof(dst)) < 0) return NULL;
+    unsigned char *buf = calloc(1, s->payload);
+    struct iovec iov = { .iov_base = buf, .iov_len = s->payload };
+    struct mmsghdr msgs[BENCH_BATCH];
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < BENCH_BATCH; i++) {
+        msgs[i].msg_hdr.msg_iov = &iov;
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    while (!atomic_load_explicit(s->stop, memory_order_relaxed)) {
+        buf[0]++;
+        int n = sendmmsg(fd, msgs, BENCH_BATCH, 0);
+        if (n > 0) s->sent += (uint64_t)n;
+    }
+    free(buf);
+    close(fd);
+    return NULL;
+}
+
+static int socket_open(int port) {
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    if (fd < 0) return -1;
+    int one = 1, rcvbuf = 4 * 1024 * 1024;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    setsockopt(fd, SOL_SOCKET, SO_RXQ_OVFL, &one, sizeof(one));
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons((uint16_t)port) };
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void socket_drain(int fd, atomic_int *stop, RecvResult *r) {
+    static unsigned char bufs[BENCH_BATCH][65536];
+    static unsigned char ctrl[BENCH_BATCH][CMSG_SPACE(sizeof(uint32_t))];
+    struct mmsghdr msgs[BENCH_BATCH];
+    struct iovec iov[BENCH_BATCH];
+    struct sockaddr_in from[BENCH_BATCH];
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+    int backlog = 0;
+    while (!atomic_load_explicit(stop, memory_order_relaxed)) {
+        if (!backlog) {
+            r->syscalls++;
+            if (poll(&pfd, 1, 20) <= 0) continue;
+        }
+        for (int i = 0; i < BENCH_BATCH; i++) {
+            iov[i].iov_base = bufs[i];
+            iov[i].iov_len = sizeof(bufs[i]);
+            memset(&msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr));
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = &from[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(from[i]);
+            msgs[i].msg_hdr.msg_control = ctrl[i];
+            msgs[i].msg_hdr.msg_controllen = sizeof(ctrl[i]);
+        }
+        r->syscalls++;
+        int n = recvmmsg(fd, msgs, BENCH_BATCH, MSG_DONTWAIT, NULL);
+        backlog = n == BENCH_BATCH;
+        if (n <= 0) continue;
+        for (int i = 0; i < n; i++) {
+            r->checksum += bufs[i][0] + msgs[i].msg_len + from[i].sin_port;
+            struct cmsghdr *c = CMSG_FIRSTHDR(&msgs[i].msg_hdr);
+            if (c && c->cmsg_level == SOL_SOCKET && c->cmsg_type == SO_RXQ_OVFL) {
+                uint32_t d;
+                memcpy(&d, CMSG_DATA(c), sizeof(d));
+                r->kernel_drops = d;
+            }
+        }
+        r->received += (uint64_t)n;
+    }
+}
+
+typedef struct {
+    int fd;
+    int port_fd;
+    unsigned char *map;
+    size_t map_len;
+} Ring;
+
+static int ring_open(Ring *ring, int port) {
+    memset(ring, 0, sizeof(*ring));
+    ring->port_fd = -1;
+    ring->fd = socket(AF_PACKET, SOCK_DGRAM, htons(ETH_P_IP));
+    if (ring->fd < 0) return -1;
+    struct sock_filter code[] = {
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 0),
+        BPF_STMT(BPF_ALU | BPF_AND | BPF_K, 0xf0),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0x40, 0, 8),
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 9),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_UDP, 0, 6),
+        BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 6),
+        BPF_JUMP(BPF_JMP | BPF_JSET | BPF_K, 0x3fff, 4, 0),
+        BPF_STMT(BPF_LDX | BPF_B | BPF_MSH, 0),
+        BPF_STMT(BPF_LD | BPF_H | BPF_IND, 2),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, (uint32_t)port, 0, 1),
+        BPF_STMT(BPF_RET | BPF_K, 0xffffffffu),
+        BPF_STMT(BPF_RET | BPF_K, 0),
+    };
+    struct sock_fprog prog = { .len = sizeof(code) / sizeof(code[0]), .filter = code };
+    int one = 1, version = TPACKET_V3;
+    struct tpacket_req3 req = {
+        .tp_block_size = RING_BLOCK_SIZE,
+        .tp_block_nr = RING_BLOCK_NR,
+        .tp_frame_size = RING_FRAME_SIZE,
+        .tp_frame_nr = (RING_BLOCK_SIZE / RING_FRAME_SIZE) * RING_BLOCK_NR,
+        .tp_retire_blk_tov = 1,
+    };
+    if (setsockopt(ring->fd, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)) < 0) return -1;
+    setsockopt(ring->fd, SOL_PACKET, PACKET_IGNORE_OUTGOING, &one, sizeof(one));
+    if (setsockopt(ring->fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0 ||
+        setsockopt(ring->fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0) {
+        return -1;
+    }
+    ring->map_len = (size_t)RING_BLOCK_SIZE * RING_BLOCK_NR;
+    ring->map = mmap(NULL, ring->map_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, 0);
+    if (ring->map == MAP_FAILED) return -1;
+    struct sockaddr_ll ll = {
+        .sll_family = AF_PACKET,
+        .sll_protocol = htons(ETH_P_IP),
+        .sll_ifindex = (int)if_nametoindex("lo"),
+    };
+    if (bind(ring->fd, (struct sockaddr *)&ll, sizeof(ll)) < 0) return -1;
+
+    /* Hold the port so the sender gets no ICMP unreachable, as the relay does. */
+    struct sock_filter drop = BPF_STMT(BPF_RET | BPF_K, 0);
+    struct sock_fprog drop_prog = { .len = 1, .filter = &drop };
+    ring->port_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons((uint16_t)port) };
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    setsockopt(ring->port_fd, SOL_SOCKET, SO_ATTACH_FILTER, &drop_prog, sizeof(drop_prog));
+    bind(ring->port_fd, (struct sockaddr *)&addr, sizeof(addr));
+    return 0;
+}
+
+static void ring_close(Ring *ring) {
+    if (ring->map && ring->map != MAP_FAILED) munmap(ring->map, ring->map_len);
+    if (ring->fd >= 0) close(ring->fd);
+    if (ring->port_fd >= 0) close(ring->port_fd);
+}
+
+static void ring_drain(Ring *ring, atomic_int *stop, RecvResult *r) {
+    struct pollfd pfd = { .fd = ring->fd, .events = POLLIN };
+    unsigned block = 0;
+    while (!atomic_load_explicit(stop, memory_order_relaxed)) {
+        struct tpacket_block_desc *bd =
+            (struct tpacket_block_desc *)(ring->map + (size_t)block * RING_BLOCK_SIZE);
+        if (!(__atomic_load_n(&bd->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER)) {
+            r->syscalls++;
+            poll(&pfd, 1, 20);
+            continue;
+        }
+        const unsigned char *p = (const unsigned char *)bd + bd->hdr.bh1.offset_to_first_pkt;
+        for (uint32_t i = 0; i < bd->hdr.bh1.num_pkts; i++) {
+            const struct tpacket3_hdr *h = (const struct tpacket3_hdr *)p;
+            const unsigned char *ip = p + h->tp_net;
+            const unsigned char *udp = ip + (ip[0] & 0x0f) * 4;
+            size_t len = (((size_t)udp[4] << 8) | udp[5]) - 8u;
+            r->checksum += udp[8] + len + (uint16_t)((udp[0] << 8) | udp[1]);
+            r->received++;
+            p += h->tp_next_offset;
+        }
+        __atomic_store_n(&bd->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+        block = (block + 1) % RING_BLOCK_NR;
+    }
+    struct tpacket_stats_v3 st;
+    socklen_t len = sizeof(st);
+    if (getsockopt(ring->fd, SOL_PACKET, PACKET_STATISTICS, &st, &len) == 0) r->kernel_drops = st.tp_drops;
+}
+
+/* io-uring receive, as the relay does it: 128 buffers sized for any
+ * datagram, one multishot recvmsg re-armed whenever it stops. */
+#define URING_BUFS 128u
+#define URING_BUF_SIZE (sizeof(struct io_uring_recvmsg_out) + sizeof(struct sockaddr_in) + 65536u)
+
+static void uring_drain(int fd, atomic_int *stop, RecvResult *r) {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    p.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_COOP_TASKRUN | IORING_SETUP_CQSIZE;
+    p.cq_entries = 4 * URING_BUFS;
+    int ufd = (int)syscall(__NR_io_uring_setup, 2 * URING_BUFS, &p);
+    if (ufd < 0) {
+        fprintf(stderr, "io_uring_setup: %s\n", strerror(errno));
+        return;
+    }
+    size_t ring_len = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (ring_len < p.sq_off.array + p.sq_entries * sizeof(unsigned)) {
+        ring_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    }
+    unsigned char *ring = mmap(NULL, ring_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                               ufd, IORING_OFF_SQ_RING);
+    struct io_uring_sqe *sqes = mmap(NULL, p.sq_entries * sizeof(struct io_uring_sqe),
+                                     PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ufd, IORING_OFF_SQES);
+    unsigned *sq_tail = (unsigned *)(ring + p.sq_off.tail);
+    unsigned sq_mask = *(unsigned *)(ring + p.sq_off.ring_mask);
+    unsigned *sq_array = (unsigned *)(ring + p.sq_off.array);
+    unsigned *cq_head = (unsigned *)(ring + p.cq_off.head);
+    unsigned *cq_tail = (unsigned *)(ring + p.cq_off.tail);
+    unsigned cq_mask = *(unsigned *)(ring + p.cq_off.ring_mask);
+    struct io_uring_cqe *cqes = (struct io_uring_cqe *)(ring + p.cq_off.cqes);
+    for (unsigned i = 0; i < p.sq_entries; i++) sq_array[i] = i;
+
+    struct io_uring_buf_ring *br = mmap(NULL, URING_BUFS * sizeof(struct io_uring_buf),
+                                        PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    unsigned char *bufs = malloc((size_t)URING_BUFS * URING_BUF_SIZE);
+    struct io_uring_buf_reg reg = { .ring_addr = (uint64_t)(uintptr_t)br, .ring_entries = URING_BUFS };
+    if (syscall(__NR_io_uring_register, ufd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        fprintf(stderr, "IORING_REGISTER_PBUF_RING: %s\n", strerror(errno));
+        close(ufd);
+        return;
+    }
+    uint16_t buf_tail = 0;
+    for (unsigned i = 0; i < URING_BUFS; i++, buf_tail++) {
+        br->bufs[buf_tail & (URING_BUFS - 1)] =
+            (struct io_uring_buf){ .addr = (uint64_t)(uintptr_t)(bufs + (size_t)i * URING_BUF_SIZE),
+                                   .len = URING_BUF_SIZE, .bid = (uint16_t)i };
+    }
+    __atomic_store_n(&br->tail, buf_tail, __ATOMIC_RELEASE);
+
+    struct msghdr mh = { .msg_namelen = sizeof(struct sockaddr_in), .msg_controllen = 0 };
+    struct __kernel_timespec ts = { .tv_sec = 0, .tv_nsec = 20 * 1000000 };
+    struct io_uring_getevents_arg arg = { .ts = (uint64_t)(uintptr_t)&ts };
+    int armed = 0;
+    unsigned local_tail = *sq_tail;
+    while (!atomic_load_explicit(stop, memory_order_relaxed)) {
+        unsigned to_submit = 0;
+        if (!armed) {
+            struct io_uring_sqe *sqe = &sqes[local_tail++ & sq_mask];
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = IORING_OP_RECVMSG;
+            sqe->fd = fd;
+            sqe->addr = (uint64_t)(uintptr_t)&mh;
+            sqe->len = 1;
+            sqe->ioprio = IORING_RECV_MULTISHOT;
+            sqe->flags = IOSQE_BUFFER_SELECT;
+            __atomic_store_n(sq_tail, local_tail, __ATOMIC_RELEASE);
+            to_submit = 1;
+            armed = 1;
+        }
+        r->syscalls++;
+        syscall(__NR_io_uring_enter, ufd, to_submit, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                &arg, sizeof(arg));
+        unsigned head = *cq_head;
+        unsigned ready = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE) - head;
+        for (unsigned k = 0; k < ready; k++) {
+            const struct io_uring_cqe *cqe = &cqes[(head + k) & cq_mask];
+            if (!(cqe->flags & IORING_CQE_F_MORE)) armed = 0;
+            if (cqe->res < 0) continue; /* -ENOBUFS: re-armed above */
+            unsigned bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+            unsigned char *b = bufs + (size_t)bid * URING_BUF_SIZE;
+            const struct io_uring_recvmsg_out *out = (const struct io_uring_recvmsg_out *)b;
+            const unsigned char *name = b + sizeof(*out);
+            const unsigned char *payload = name + mh.msg_namelen;
+            r->checksum += payload[0] + out->payloadlen + ((const struct sockaddr_in *)name)->sin_port;
+            r->received++;
+            br->bufs[buf_tail & (URING_BUFS - 1)] =
+                (struct io_uring_buf){ .addr = (uint64_t)(uintptr_t)b, .len = URING_BUF_SIZE,
+                                       .bid = (uint16_t)bid };
+            buf_tail++;
+        }
+        __atomic_store_n(cq_head, head + ready, __ATOMIC_RELEASE);
+        __atomic_store_n(&br->tail, buf_tail, __ATOMIC_RELEASE);
+    }
+    /* Socket receive-queue drops, the same counter SO_RXQ_OVFL reports. */
+    uint32_t meminfo[SK_MEMINFO_VARS];
+    socklen_t len = sizeof(meminfo);
+    if (getsockopt(fd, SOL_SOCKET, SO_MEMINFO, meminfo, &len) == 0) r->kernel_drops = meminfo[SK_MEMINFO_DROPS];
+    close(ufd);
+    munmap(ring, ring_len);
+    munmap(sqes, p.sq_entries * sizeof(struct io_uring_sqe));
+    munmap(br, URING_BUFS * sizeof(struct io_uring_buf));
+    free(bufs);
+}
+
+enum { BACKEND_SOCKET, BACKEND_URING, BACKEND_RING };
+
+typedef struct {
+    int backend;
+    int fd;
+    Ring r;
+    atomic_int *stop;
+    RecvResult result;
+} Receiver;
+
+static void *receiver_run(void *arg) {
+    Receiver *rx = arg;
+    int64_t t0 = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+    if (rx->backend == BACKEND_RING) {
+        ring_drain(&rx->r, rx->stop, &rx->result);
+    } else if (rx->backend == BACKEND_URING) {
+        uring_drain(rx->fd, rx->stop, &rx->result);
+    } else {
+        socket_drain(rx->fd, rx->stop, &rx->result);
+    }
+    rx->result.cpu_ns = clock_ns(CLOCK_THREAD_CPUTIME_ID) - t0;
+    return NULL;
+}
+
+static void run(const char *name, int backend, int port, int senders, size_t payload, double seconds) {
+    Receiver rx = {0};
+    atomic_int stop_rx = 0, stop_tx = 0;
+    int ring = backend == BACKEND_RING;
+    rx.backend = backend;
+    rx.stop = &stop_rx;
+    rx.fd = -1;
+    if (ring ? ring_open(&rx.r, port) < 0 : (rx.fd = socket_open(port)) < 0) {
+        printf("%-12s n/a (%s%s)\n", name, strerror(errno),
+               ring && (errno == EPERM || errno == EACCES) ? ", needs CAP_NET_RAW" : "");
+        if (ring) ring_close(&rx.r);
+        return;
+    }
+    pthread_t rx_thread, tx_threads[16];
+    Sender tx[16];
+    pthread_create(&rx_thread, NULL, receiver_run, &rx);
+    for (int i = 0; i < senders; i++) {
+        tx[i] = (Sender){ .port = port, .payload = payload, .stop = &stop_tx };
+        pthread_create(&tx_threads[i], NULL, sender_run, &tx[i]);
+    }
+    struct timespec d = { .tv_sec = (time_t)seconds,
+                          .tv_nsec = (long)((seconds - (double)(time_t)seconds) * 1e9) };
+    nanosleep(&d, NULL);
+    atomic_store(&stop_tx, 1);
+    uint64_t sent = 0;
+    for (int i = 0; i < senders; i++) {
+        pthread_join(tx_threads[i], NULL);
+        sent += tx[i].sent;
+    }
+    /* Let the receiver finish what is already queued. */
+    struct timespec settle = { .tv_sec = 0, .tv_nsec = 100 * 1000000 };
+    nanosleep(&settle, NULL);
+    atomic_store(&stop_rx, 1);
+    pthread_join(rx_thread, NULL);
+    if (ring) ring_close(&rx.r);
+    else close(rx.fd);
+
+    const RecvResult *r = &rx.result;
+    double lost = sent > 0 ? 100.0 * (double)(sent - (r->received < sent ? r->received : sent)) / (double)sent : 0.0;
+    printf("%-12s %12.0f %12.0f %7.2f%% %12.4f %10.1f %10llu\n", name,
+           (double)sent / seconds, (double)r->received / seconds, lost,
+           r->received ? (double)r->syscalls / (double)r->received : 0.0,
+           r->received ? (double)r->cpu_ns / (double)r->received : 0.0,
+           (unsigned long long)r->kernel_drops);
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--seconds S] [--senders N] [--payload BYTES] [--port PORT]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    double seconds = 2.0;
+    int senders = 2;
+    size_t payload = 1200;
+    int port = 15600;
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--seconds") == 0) {
+            seconds = atof(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--senders") == 0) {
+            senders = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--payload") == 0) {
+            payload = strtoull(argv[++i], NULL, 10);
+        } else if (i + 1 < argc && strcmp(argv[i], "--port") == 0) {
+            port = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (seconds <= 0 || senders < 1 || senders > 16 || payload == 0 || payload > 65507 ||
+        port < 1 || port > 65535) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    printf("seconds=%.1f senders=%d payload=%zu port=%d\n", seconds, senders, payload, port);
+    printf("%-12s %12s %12s %8s %12s %10s %10s\n", "backend", "sent_pps", "recv_pps", "lost",
+           "syscalls/pkt", "cpu_ns/pkt", "drops");
+    run("recvmmsg", BACKEND_SOCKET, port, senders, payload, seconds);
+    run("io-uring", BACKEND_URING, port, senders, payload, seconds);
+    run("packet-ring", BACKEND_RING, port, senders, payload, seconds);
+    return 0;
+}
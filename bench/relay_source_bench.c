@@ -0,0 +1,140 @@
+/* Cache lines the relay writes in a source slot per packet: the flat
+ * UvRelaySource layout the relay used up to the hot/cold split versus the
+ * layout that ships.
+ *
+ * The shipped layout is UvRelaySource itself, from src/uv_internal.h, so
+ * the figure follows the struct as it changes. The flat layout no longer
+ * exists anywhere else and is kept below as a frozen copy; its size is
+ * asserted so an accidental edit shows. The field lists are the writes a
+ * continuation FU packet of the selected source makes (no NAL start, no
+ * marker): the registry pass, the worker's counters and rtp_update_stats().
+ * The packet's sequence-window entry is one more line in either layout and
+ * is left out of both counts.
+ *
+ * This reports the layout only. Timing the two on one host showed no
+ * per-packet difference outside noise, and cache-miss counters are not
+ * available in every environment, so neither is claimed here.
+ *
+ * Built against the viewer headers (GStreamer needed, nothing linked) by
+ * `make bench` when pkg-config finds GStreamer. */
+#define _GNU_SOURCE
+#include "uv_internal.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define CACHE_LINE 64
+#define FLAT_WIN_SIZE 4096
+#define FLAT_FPS_WINDOW 512
+
+/* UvRelaySource before the split: identity, counters, the 16 KiB sequence
+ * window and the 4 KiB marker window inline, NAL counters at the far end. */
+typedef struct {
+    uint64_t lock;
+    int kind;
+    char label[64];
+    struct sockaddr_in addr;
+    socklen_t addrlen;
+    uint32_t ssrc;
+    bool ssrc_bound;
+    bool in_use;
+    int lru_prev;
+    int lru_next;
+    int64_t lru_touch_us;
+    uint64_t rx_packets;
+    uint64_t rx_bytes;
+    uint64_t forwarded_packets;
+    uint64_t forwarded_bytes;
+    int64_t last_seen_us;
+    uint64_t prev_bytes;
+    int64_t prev_timestamp_us;
+    unsigned pub_seq;
+    unsigned char pub[256];
+    int pub_dirty;
+    bool rtp_initialized;
+    uint32_t rtp_cycles;
+    uint32_t rtp_first_ext_seq;
+    uint32_t rtp_max_ext_seq;
+    uint32_t rtp_bad_seq;
+    uint64_t rtp_unique_packets;
+    uint64_t rtp_duplicate_packets;
+    uint64_t rtp_reordered_packets;
+    uint32_t rtp_seq_slot[FLAT_WIN_SIZE];
+    uint64_t rtp_marker_frames;
+    int64_t frame_times_us[FLAT_FPS_WINDOW];
+    unsigned frame_times_head;
+    unsigned frame_times_count;
+    bool jitter_initialized;
+    uint32_t jitter_prev_transit;
+    double jitter_value;
+    unsigned char analytics[264];
+    uint64_t hevc_counts[9];
+    uint64_t rtp_ap_packets;
+    uint64_t rtp_fu_packets;
+    int64_t last_keyframe_us;
+    int64_t prev_keyframe_us;
+} FlatSource;
+
+_Static_assert(sizeof(FlatSource) == 21368, "the pre-split copy is frozen");
+
+/* The shipped layout keeps its promises: every field written per packet
+ * sits in the hot block (ahead of the sequence window) or the identity
+ * block, and each block starts a line. */
+_Static_assert(offsetof(UvRelaySource, rtp_seq_bits) % CACHE_LINE == 0, "window starts a line");
+_Static_assert(offsetof(UvRelaySource, kind) % CACHE_LINE == 0, "identity starts a line");
+_Static_assert(offsetof(UvRelaySource, prev_bytes) % CACHE_LINE == 0, "reader side starts a line");
+_Static_assert(offsetof(UvRelaySource, rtp_fu_packets) < offsetof(UvRelaySource, rtp_seq_bits),
+               "per-packet counters are in the hot block");
+_Static_assert(offsetof(UvRelaySource, jitter_q4) < offsetof(UvRelaySource, rtp_seq_bits),
+               "jitter is in the hot block");
+_Static_assert(offsetof(UvRelaySource, lru_touch_us) < offsetof(UvRelaySource, prev_bytes) &&
+               offsetof(UvRelaySource, ssrc_seen_us) < offsetof(UvRelaySource, prev_bytes),
+               "registry writes are in the identity block");
+
+#define FLAT_FIELDS                                                                \
+    offsetof(FlatSource, lock), offsetof(FlatSource, lru_touch_us),                \
+    offsetof(FlatSource, rx_packets), offsetof(FlatSource, rx_bytes),              \
+    offsetof(FlatSource, last_seen_us), offsetof(FlatSource, rtp_cycles),          \
+    offsetof(FlatSource, rtp_max_ext_seq), offsetof(FlatSource, rtp_bad_seq),      \
+    offsetof(FlatSource, rtp_unique_packets), offsetof(FlatSource, hevc_counts) + 2 * 8, \
+    offsetof(FlatSource, rtp_fu_packets), offsetof(FlatSource, jitter_prev_transit), \
+    offsetof(FlatSource, jitter_value), offsetof(FlatSource, forwarded_packets),   \
+    offsetof(FlatSource, forwarded_bytes), offsetof(FlatSource, pub_dirty)
+
+#define SHIPPED_FIELDS                                                             \
+    offsetof(UvRelaySource, lock), offsetof(UvRelaySource, lru_touch_us),          \
+    offsetof(UvRelaySource, ssrc_seen_us), offsetof(UvRelaySource, rx_packets),    \
+    offsetof(UvRelaySource, rx_bytes), offsetof(UvRelaySource, last_seen_us),      \
+    offsetof(UvRelaySource, forwarded_packets), offsetof(UvRelaySource, forwarded_bytes), \
+    offsetof(UvRelaySource, pub_dirty), offsetof(UvRelaySource, rtp_max_ext_seq),  \
+    offsetof(UvRelaySource, rtp_bad_seq), offsetof(UvRelaySource, rtp_window_lost), \
+    offsetof(UvRelaySource, rtp_unique_packets), offsetof(UvRelaySource, rtp_fu_packets), \
+    offsetof(UvRelaySource, jitter_prev_transit), offsetof(UvRelaySource, jitter_q4)
+
+/* Distinct cache lines among the given field offsets. */
+static unsigned lines_touched(const size_t *offsets, size_t n) {
+    unsigned count = 0;
+    for (size_t i = 0; i < n; i++) {
+        bool seen = false;
+        for (size_t j = 0; j < i; j++) {
+            if (offsets[j] / CACHE_LINE == offsets[i] / CACHE_LINE) seen = true;
+        }
+        if (!seen) count++;
+    }
+    return count;
+}
+
+int main(void) {
+    const size_t flat[] = { FLAT_FIELDS };
+    const size_t shipped[] = { SHIPPED_FIELDS };
+    unsigned flat_lines = lines_touched(flat, sizeof(flat) / sizeof(flat[0]));
+    unsigned shipped_lines = lines_touched(shipped, sizeof(shipped) / sizeof(shipped[0]));
+
+    printf("%-8s %10s %10s %9s\n", "layout", "slot_bytes", "cold_bytes", "lines/pkt");
+    printf("%-8s %10zu %10zu %9u\n", "flat", sizeof(FlatSource), (size_t)0, flat_lines);
+    printf("%-8s %10zu %10zu %9u\n", "shipped", sizeof(UvRelaySource), sizeof(UvRelaySourceCold),
+           shipped_lines);
+    return 0;
+}
@@ -0,0 +1,693 @@
+/* Relay throughput under synthetic RTP/H.265 load: a headless viewer
+ * (fakesink video sink, no GUI) listening on a loopback port, fed by an
+ * in-process generator whose offered rate is stepped up until the relay
+ * stops keeping up.
+ *
+ * The generator packetises a synthetic GOP per RFC 7798: every access
+ * unit opens with an aggregation packet (AUD and SEI, plus VPS/SPS/PPS on
+ * the IDR), slices that fit the payload budget go out as single NAL unit
+ * packets and larger ones as fragmentation units, with the marker on each
+ * access unit's last packet. Frame and slice sizes set the AP/FU/single
+ * mix. Packets leave in bursts of --burst from one source at a time
+ * (round robin over --sources senders, each its own socket and SSRC), and
+ * sender-side loss and reordering can be injected. Slice payload is
+ * random bytes, not a coded picture; whatever h265parse and the decoder
+ * spend on it is part of the CPU figure, which is not split by stage.
+ *
+ * Each step runs for --step-seconds at one offered rate and is compared
+ * against the viewer's own counters: where packets went missing (socket
+ * receive buffer, source table, analytics ring, appsrc push, restream
+ * queue) and the process CPU time per received packet, less the
+ * generator's and the restream drain's threads. A step is sustained when
+ * no more than --loss-threshold percent of what was sent failed to reach
+ * the relay; the ramp stops at the first step that is not, or when the
+ * generator itself cannot reach the rate.
+ *
+ * Built against the viewer core, so unlike the libc benches it needs
+ * GStreamer: `make bench` runs it when pkg-config finds GStreamer, and
+ * `make bench-throughput` runs it alone. The report is one JSON document on stdout
+ * (or --json FILE); viewer logging goes to stderr. */
+#define _GNU_SOURCE
+#include "uv_viewer.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define PKT_MAX 1500u
+#define RTP_HDR 12u
+#define SOURCES_MAX 64u
+#define BURST_MAX 256u
+#define STEPS_MAX 64u
+#define SETTLE_NS 300000000ll
+
+typedef struct {
+    uint16_t len;
+    uint16_t frame;      /* index in the GOP, for the RTP timestamp */
+    uint8_t  data[PKT_MAX];
+} TemplatePacket;
+
+typedef struct {
+    TemplatePacket *pkts;
+    size_t count;
+    size_t cap;
+    unsigned frames;
+    uint64_t ap, fu, single;
+} Template;
+
+typedef struct {
+    int fd;
+    uint32_t ssrc;
+    uint16_t seq;
+    size_t pos;          /* next template packet */
+    uint32_t ts_base;
+    uint32_t gops;
+} Sender;
+
+typedef struct {
+    unsigned sources;
+    double start_pps;
+    double max_pps;
+    double step_factor;
+    double step_seconds;
+    double loss_threshold_pct;
+    unsigned burst;
+    unsigned fps;
+    unsigned gop;
+    size_t frame_bytes;
+    size_t idr_bytes;
+    unsigned slices;
+    size_t payload_max;
+    double loss_pct;
+    double reorder_pct;
+    gboolean frame_block;
+    gboolean release;
+    gboolean restream;
+    unsigned workers;
+    UvRelayBackend backend;
+    const char *backend_name;
+    const char *json_path;
+} Options;
+
+/* One step's generator result. */
+typedef struct {
+    double target_pps;
+    uint64_t sent;
+    uint64_t lost_injected;
+    uint64_t reordered;
+    int64_t elapsed_ns;
+    int64_t cpu_ns;
+} GenResult;
+
+/* Counters the report diffs across a step. */
+typedef struct {
+    uint64_t recv;
+    uint64_t kernel_drops;
+    uint64_t syscalls;
+    uint64_t source_rejects;
+    uint64_t analytics_overruns;
+    uint64_t analytics_records;
+    uint64_t rx;
+    uint64_t forwarded;
+    uint64_t selected_rx;
+    uint64_t selected_forwarded;
+    uint64_t rtp_lost;
+    uint64_t restream_tx;
+    uint64_t restream_dropped;
+    uint64_t restream_errors;
+} Counters;
+
+typedef struct {
+    GenResult gen;
+    Counters delta;
+    uint64_t restream_received;
+    int64_t relay_cpu_ns;
+    double received_pps;
+    double loss_pct;
+    gboolean sustained;
+    gboolean generator_limited;
+} Step;
+
+typedef struct {
+    int fd;
+    volatile int running;
+    uint64_t received;
+    clockid_t cpu_clock;
+} RestreamSink;
+
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000ll + ts.tv_nsec;
+}
+
+static int64_t clock_ns(clockid_t id) {
+    struct timespec ts;
+    if (clock_gettime(id, &ts) != 0) return 0;
+    return (int64_t)ts.tv_sec * 1000000000ll + ts.tv_nsec;
+}
+
+static uint32_t next_rand(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static TemplatePacket *template_add(Template *t, unsigned frame) {
+    if (t->count == t->cap) {
+        t->cap = t->cap ? t->cap * 2u : 1024u;
+        t->pkts = realloc(t->pkts, t->cap * sizeof(*t->pkts));
+        if (!t->pkts) {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+    }
+    TemplatePacket *p = &t->pkts[t->count++];
+    memset(p->data, 0, RTP_HDR);
+    p->data[0] = 0x80;
+    p->frame = (uint16_t)frame;
+    p->len = RTP_HDR;
+    return p;
+}
+
+static void fill_random(uint8_t *dst, size_t n, uint32_t *rng) {
+    for (size_t i = 0; i < n; i++) dst[i] = (uint8_t)(next_rand(rng) >> 8) | 0x04u;
+}
+
+/* Access unit prologue: one AP with AUD, SEI and (IDR) parameter sets. */
+static void template_ap(Template *t, unsigned frame, gboolean idr, uint32_t *rng) {
+    static const struct { uint8_t type; uint16_t size; } units[] = {
+        { 35, 3 }, { 32, 24 }, { 33, 48 }, { 34, 8 }, { 39, 32 },
+    };
+    TemplatePacket *p = template_add(t, frame);
+    uint8_t *w = p->data + RTP_HDR;
+    *w++ = 48u << 1;
+    *w++ = 1;
+    for (size_t i = 0; i < sizeof(units) / sizeof(units[0]); i++) {
+        if (!idr && units[i].type >= 32 && units[i].type <= 34) continue;
+        *w++ = (uint8_t)(units[i].size >> 8);
+        *w++ = (uint8_t)units[i].size;
+        w[0] = (uint8_t)(units[i].type << 1);
+        w[1] = 1;
+        fill_random(w + 2, units[i].size - 2u, rng);
+        w += units[i].size;
+    }
+    p->len = (uint16_t)(w - p->data);
+    t->ap++;
+}
+
+/* One slice NAL unit: a single NAL unit packet when it fits, else FUs. */
+static void template_slice(Template *t, unsigned frame, uint8_t type, size_t bytes,
+                           size_t payload_max, uint32_t *rng) {
+    if (bytes + 2u <= payload_max) {
+        TemplatePacket *p = template_add(t, frame);
+        p->data[RTP_HDR] = (uint8_t)(type << 1);
+        p->data[RTP_HDR + 1] = 1;
+        fill_random(p->data + RTP_HDR + 2, bytes, rng);
+        p->len = (uint16_t)(RTP_HDR + 2u + bytes);
+        t->single++;
+        return;
+    }
+    size_t chunk = payload_max - 3u;
+    for (size_t off = 0; off < bytes; off += chunk) {
+        size_t n = bytes - off < chunk ? bytes - off : chunk;
+        TemplatePacket *p = template_add(t, frame);
+        p->data[RTP_HDR] = 49u << 1;
+        p->data[RTP_HDR + 1] = 1;
+        p->data[RTP_HDR + 2] = (uint8_t)((off == 0 ? 0x80u : 0u) |
+                                         (off + n == bytes ? 0x40u : 0u) | type);
+        fill_random(p->data + RTP_HDR + 3, n, rng);
+        p->len = (uint16_t)(RTP_HDR + 3u + n);
+        t->fu++;
+    }
+}
+
+static void template_build(Template *t, const Options *o) {
+    uint32_t rng = 0x2545f491u;
+    memset(t, 0, sizeof(*t));
+    t->frames = o->gop;
+    for (unsigned f = 0; f < o->gop; f++) {
+        gboolean idr = f == 0;
+        size_t bytes = idr ? o->idr_bytes : o->frame_bytes;
+        template_ap(t, f, idr, &rng);
+        for (unsigned s = 0; s < o->slices; s++) {
+            template_slice(t, f, idr ? 19 : 1, bytes / o->slices, o->payload_max, &rng);
+        }
+        t->pkts[t->count - 1].data[1] = 0x80;   /* marker on the last packet */
+    }
+}
+
+/* Copy the next template packet for s into buf with its own seq, ts and
+ * SSRC, returning the length. */
+static size_t sender_next(Sender *s, const Template *t, const Options *o, int pt, uint8_t *buf) {
+    const TemplatePacket *tp = &t->pkts[s->pos];
+    memcpy(buf, tp->data, tp->len);
+    uint32_t ts = s->ts_base + (s->gops * t->frames + tp->frame) * (90000u / o->fps);
+    buf[1] = (uint8_t)((buf[1] & 0x80) | (pt & 0x7f));
+    buf[2] = (uint8_t)(s->seq >> 8);
+    buf[3] = (uint8_t)s->seq;
+    buf[4] = (uint8_t)(ts >> 24);
+    buf[5] = (uint8_t)(ts >> 16);
+    buf[6] = (uint8_t)(ts >> 8);
+    buf[7] = (uint8_t)ts;
+    buf[8] = (uint8_t)(s->ssrc >> 24);
+    buf[9] = (uint8_t)(s->ssrc >> 16);
+    buf[10] = (uint8_t)(s->ssrc >> 8);
+    buf[11] = (uint8_t)s->ssrc;
+    s->seq++;
+    if (++s->pos == t->count) {
+        s->pos = 0;
+        s->gops++;
+    }
+    return tp->len;
+}
+
+/* Offer target_pps for seconds, in bursts of o->burst from one sender at
+ * a time, on the calling thread. */
+static void generate(Sender *senders, const Template *t, const Options *o, int pt,
+                     double target_pps, double seconds, uint32_t *rng, GenResult *out) {
+    static uint8_t bufs[BURST_MAX][PKT_MAX];
+    struct mmsghdr msgs[BURST_MAX];
+    struct iovec iov[BURST_MAX];
+    memset(out, 0, sizeof(*out));
+    out->target_pps = target_pps;
+
+    int64_t interval_ns = (int64_t)((double)o->burst * 1e9 / target_pps);
+    int64_t cpu0 = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+    int64_t t0 = now_ns();
+    int64_t end = t0 + (int64_t)(seconds * 1e9);
+    int64_t next = t0;
+    unsigned turn = 0;
+    for (;;) {
+        int64_t now = now_ns();
+        if (now >= end) break;
+        if (next > now) {
+            struct timespec ts = { .tv_sec = next / 1000000000ll, .tv_nsec = next % 1000000000ll };
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+        } else if (now - next > 50000000ll) {
+            next = now;   /* fell behind; the achieved rate shows it */
+        }
+        next += interval_ns;
+
+        Sender *s = &senders[turn++ % o->sources];
+        unsigned n = 0;
+        for (unsigned i = 0; i < o->burst; i++) {
+            size_t len = sender_next(s, t, o, pt, bufs[n]);
+            if (o->loss_pct > 0.0 && (double)(next_rand(rng) % 1000000u) < o->loss_pct * 1e4) {
+                out->lost_injected++;
+                continue;
+            }
+            iov[n].iov_base = bufs[n];
+            iov[n].iov_len = len;
+            n++;
+        }
+        for (unsigned i = 0; i + 1 < n; i++) {
+            if (o->reorder_pct > 0.0 && (double)(next_rand(rng) % 1000000u) < o->reorder_pct * 1e4) {
+                struct iovec tmp = iov[i];
+                iov[i] = iov[i + 1];
+                iov[i + 1] = tmp;
+                out->reordered++;
+                i++;
+            }
+        }
+        memset(msgs, 0, n * sizeof(msgs[0]));
+        for (unsigned i = 0; i < n; i++) {
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        unsigned done = 0;
+        while (done < n) {
+            int r = sendmmsg(s->fd, msgs + done, n - done, 0);
+            if (r < 0) {
+                if (errno == EINTR) continue;
+                /* ENOBUFS / ECONNREFUSED: the datagram is lost before the
+                 * relay could count it; drop the rest of the burst. */
+                break;
+            }
+            done += (unsigned)r;
+        }
+        out->sent += done;
+    }
+    out->elapsed_ns = now_ns() - t0;
+    out->cpu_ns = clock_ns(CLOCK_THREAD_CPUTIME_ID) - cpu0;
+}
+
+static void *restream_sink_run(void *data) {
+    RestreamSink *rs = (RestreamSink *)data;
+    pthread_getcpuclockid(pthread_self(), &rs->cpu_clock);
+    static uint8_t bufs[64][PKT_MAX];
+    struct mmsghdr msgs[64];
+    struct iovec iov[64];
+    for (unsigned i = 0; i < 64; i++) {
+        iov[i].iov_base = bufs[i];
+        iov[i].iov_len = PKT_MAX;
+        memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    struct timespec timeout = { .tv_sec = 0, .tv_nsec = 100000000l };
+    while (rs->running) {
+        int r = recvmmsg(rs->fd, msgs, 64, MSG_WAITFORONE, &timeout);
+        if (r > 0) __atomic_add_fetch(&rs->received, (uint64_t)r, __ATOMIC_RELAXED);
+    }
+    return NULL;
+}
+
+static int udp_socket_bound(uint16_t port, uint16_t *bound_port) {
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    struct sockaddr_in sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    sa.sin_port = htons(port);
+    socklen_t len = sizeof(sa);
+    if (bind(fd, (struct sockaddr *)&sa, sizeof(sa)) != 0 ||
+        getsockname(fd, (struct sockaddr *)&sa, &len) != 0) {
+        close(fd);
+        return -1;
+    }
+    if (bound_port) *bound_port = ntohs(sa.sin_port);
+    return fd;
+}
+
+static gboolean counters_read(UvViewer *viewer, Counters *c) {
+    UvViewerStats stats;
+    uv_viewer_stats_init(&stats);
+    if (!uv_viewer_get_stats(viewer, &stats)) {
+        uv_viewer_stats_clear(&stats);
+        return FALSE;
+    }
+    memset(c, 0, sizeof(*c));
+    c->recv = stats.ingest.recv_datagrams;
+    for (guint i = 0; i < stats.ingest.workers; i++) {
+        c->kernel_drops += stats.ingest.worker[i].kernel_drops;
+        c->syscalls += stats.ingest.worker[i].syscalls;
+    }
+    c->source_rejects = stats.ingest.source_rejects;
+    c->analytics_overruns = stats.ingest.analytics_overruns;
+    c->analytics_records = stats.ingest.analytics_records;
+    for (guint i = 0; i < stats.sources->len; i++) {
+        const UvSourceStats *s = &g_array_index(stats.sources, UvSourceStats, i);
+        c->rx += s->rx_packets;
+        c->forwarded += s->forwarded_packets;
+        c->rtp_lost += s->rtp_lost_packets;
+        if (s->selected) {
+            c->selected_rx = s->rx_packets;
+            c->selected_forwarded = s->forwarded_packets;
+        }
+    }
+    c->restream_tx = stats.restream.tx_packets;
+    c->restream_dropped = stats.restream.dropped;
+    c->restream_errors = stats.restream.tx_errors;
+    uv_viewer_stats_clear(&stats);
+    return TRUE;
+}
+
+static void counters_delta(const Counters *a, const Counters *b, Counters *d) {
+    d->recv = b->recv - a->recv;
+    d->kernel_drops = b->kernel_drops - a->kernel_drops;
+    d->syscalls = b->syscalls - a->syscalls;
+    d->source_rejects = b->source_rejects - a->source_rejects;
+    d->analytics_overruns = b->analytics_overruns - a->analytics_overruns;
+    d->analytics_records = b->analytics_records - a->analytics_records;
+    d->rx = b->rx - a->rx;
+    d->forwarded = b->forwarded - a->forwarded;
+    d->selected_rx = b->selected_rx - a->selected_rx;
+    d->selected_forwarded = b->selected_forwarded - a->selected_forwarded;
+    d->rtp_lost = b->rtp_lost - a->rtp_lost;
+    d->restream_tx = b->restream_tx - a->restream_tx;
+    d->restream_dropped = b->restream_dropped - a->restream_dropped;
+    d->restream_errors = b->restream_errors - a->restream_errors;
+}
+
+static void report(FILE *out, const Options *o, const Template *t, const Step *steps,
+                   unsigned n_steps, const char *stop_reason) {
+    double best_pps = 0.0;
+    double best_ns = 0.0;
+    for (unsigned i = 0; i < n_steps; i++) {
+        if (steps[i].sustained && steps[i].received_pps > best_pps) {
+            best_pps = steps[i].received_pps;
+            best_ns = steps[i].delta.recv ? (double)steps[i].relay_cpu_ns / (double)steps[i].delta.recv : 0.0;
+        }
+    }
+    double total = (double)t->count;
+    fprintf(out, "{\n");
+    fprintf(out, "  \"config\": {\"backend\": \"%s\", \"workers\": %u, \"sources\": %u, \"burst\": %u,"
+                 " \"fps\": %u, \"gop\": %u, \"frame_bytes\": %zu, \"idr_bytes\": %zu, \"slices\": %u,"
+                 " \"payload_max\": %zu, \"loss_pct\": %.3f, \"reorder_pct\": %.3f,"
+                 " \"frame_block\": %s, \"release\": %s, \"restream\": %s,"
+                 " \"step_seconds\": %.2f, \"loss_threshold_pct\": %.3f},\n",
+            o->backend_name, o->workers, o->sources, o->burst, o->fps, o->gop, o->frame_bytes,
+            o->idr_bytes, o->slices, o->payload_max, o->loss_pct, o->reorder_pct,
+            o->frame_block ? "true" : "false", o->release ? "true" : "false",
+            o->restream ? "true" : "false", o->step_seconds, o->loss_threshold_pct);
+    fprintf(out, "  \"mix\": {\"packets_per_gop\": %zu, \"ap\": %.4f, \"fu\": %.4f, \"single\": %.4f},\n",
+            t->count, (double)t->ap / total, (double)t->fu / total, (double)t->single / total);
+    fprintf(out, "  \"max_sustained_pps\": %.0f,\n", best_pps);
+    fprintf(out, "  \"cpu_ns_per_packet_at_max\": %.1f,\n", best_ns);
+    fprintf(out, "  \"stop_reason\": \"%s\",\n", stop_reason);
+    fprintf(out, "  \"steps\": [\n");
+    for (unsigned i = 0; i < n_steps; i++) {
+        const Step *s = &steps[i];
+        const Counters *d = &s->delta;
+        double secs = (double)s->gen.elapsed_ns / 1e9;
+        uint64_t unaccounted = s->gen.sent > d->recv + d->kernel_drops
+            ? s->gen.sent - d->recv - d->kernel_drops : 0;
+        fprintf(out, "    {\"target_pps\": %.0f, \"offered_pps\": %.0f, \"received_pps\": %.0f,"
+                     " \"sent\": %" G_GUINT64_FORMAT ", \"received\": %" G_GUINT64_FORMAT ","
+                     " \"loss_pct\": %.4f, \"sustained\": %s, \"generator_limited\": %s,"
+                     " \"cpu_ns_per_packet\": %.1f, \"syscalls_per_packet\": %.3f,"
+                     " \"generator_cpu_pct\": %.1f, \"injected_loss\": %" G_GUINT64_FORMAT ","
+                     " \"injected_reorder\": %" G_GUINT64_FORMAT ", \"rtp_lost\": %" G_GUINT64_FORMAT ",\n",
+                s->gen.target_pps, (double)s->gen.sent / secs, s->received_pps,
+                s->gen.sent, d->recv, s->loss_pct,
+                s->sustained ? "true" : "false", s->generator_limited ? "true" : "false",
+                d->recv ? (double)s->relay_cpu_ns / (double)d->recv : 0.0,
+                d->recv ? (double)d->syscalls / (double)d->recv : 0.0,
+                100.0 * (double)s->gen.cpu_ns / (double)s->gen.elapsed_ns,
+                s->gen.lost_injected, s->gen.reordered, d->rtp_lost);
+        fprintf(out, "     \"drops\": {\"socket\": %" G_GUINT64_FORMAT ", \"unaccounted\": %" G_GUINT64_FORMAT ","
+                     " \"source_table\": %" G_GUINT64_FORMAT ", \"analytics_ring\": %" G_GUINT64_FORMAT ","
+                     " \"appsrc\": %" G_GUINT64_FORMAT ", \"restream_queue\": %" G_GUINT64_FORMAT ","
+                     " \"restream_tx_errors\": %" G_GUINT64_FORMAT ", \"restream_delivery\": %" G_GUINT64_FORMAT "}}%s\n",
+                d->kernel_drops, unaccounted, d->source_rejects, d->analytics_overruns,
+                d->selected_rx > d->selected_forwarded ? d->selected_rx - d->selected_forwarded : 0,
+                d->restream_dropped, d->restream_errors,
+                d->restream_tx > s->restream_received ? d->restream_tx - s->restream_received : 0,
+                i + 1 < n_steps ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [--sources N] [--start-pps N] [--max-pps N] [--step-factor X]\n"
+            "          [--step-seconds S] [--loss-threshold PCT] [--burst N] [--fps N] [--gop N]\n"
+            "          [--frame-bytes N] [--idr-bytes N] [--slices N] [--payload N]\n"
+            "          [--loss PCT] [--reorder PCT] [--frame-block] [--release] [--restream]\n"
+            "          [--workers N] [--backend socket|io-uring|packet-ring] [--json FILE]\n",
+            argv0);
+}
+
+int main(int argc, char **argv) {
+    Options o = {
+        .sources = 1, .start_pps = 20000.0, .max_pps = 4000000.0, .step_factor = 1.5,
+        .step_seconds = 1.0, .loss_threshold_pct = 0.1, .burst = 32, .fps = 60, .gop = 60,
+        .frame_bytes = 24000, .idr_bytes = 160000, .slices = 4, .payload_max = 1400,
+        .workers = 1, .backend = UV_RELAY_BACKEND_SOCKET, .backend_name = "socket",
+    };
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (v && strcmp(a, "--sources") == 0) { o.sources = (unsigned)strtoul(v, NULL, 10); i++; }
+        else if (v && strcmp(a, "--start-pps") == 0) { o.start_pps = strtod(v, NULL); i++; }
+        else if (v && strcmp(a, "--max-pps") == 0) { o.max_pps = strtod(v, NULL); i++; }
+        else if (v && strcmp(a, "--step-factor") == 0) { o.step_factor = strtod(v, NULL); i++; }
+        else if (v && strcmp(a, "--step-seconds") == 0) { o.step_seconds = strtod(v, NULL); i++; }
+        else if (v && strcmp(a, "--loss-threshold") == 0) { o.loss_threshold_pct = strtod(v, NULL); i++; }
+        else if (v && strcmp(a, "--burst") == 0) { o.burst = (unsigned)strtoul(v, NULL, 10); i++; }
+        else if (v && strcmp(a, "--fps") == 0) { o.fps = (unsigned)strtoul(v, NULL, 10); i++; }
+        else if (v && strcmp(a, "--gop") == 0) { o.gop = (unsigned)strtoul(v, NULL, 10); i++; }
+        else if (v && strcmp(a, "--frame-bytes") == 0) { o.frame_bytes = strtoull(v, NULL, 10); i++; }
+        else if (v && strcmp(a, "--idr-bytes") == 0) { o.idr_bytes = strtoull(v, NULL, 10); i++; }
+        else if (v && strcmp(a, "--slices") == 0) { o.slices = (unsigned)strtoul(v, NULL, 10); i++; }
+        else if (v && strcmp(a, "--payload") == 0) { o.payload_max = strtoull(v, NULL, 10); i++; }
+        else if (v && strcmp(a, "--loss") == 0) { o.loss_pct = strtod(v, NULL); i++; }
+        else if (v && strcmp(a, "--reorder") == 0) { o.reorder_pct = strtod(v, NULL); i++; }
+        else if (strcmp(a, "--frame-block") == 0) o.frame_block = TRUE;
+        else if (strcmp(a, "--release") == 0) o.release = TRUE;
+        else if (strcmp(a, "--restream") == 0) o.restream = TRUE;
+        else if (v && strcmp(a, "--workers") == 0) { o.workers = (unsigned)strtoul(v, NULL, 10); i++; }
+        else if (v && strcmp(a, "--json") == 0) { o.json_path = v; i++; }
+        else if (v && strcmp(a, "--backend") == 0) {
+            o.backend_name = v;
+            if (strcmp(v, "socket") == 0) o.backend = UV_RELAY_BACKEND_SOCKET;
+            else if (strcmp(v, "io-uring") == 0) o.backend = UV_RELAY_BACKEND_IO_URING;
+            else if (strcmp(v, "packet-ring") == 0) o.backend = UV_RELAY_BACKEND_PACKET_RING;
+            else { usage(argv[0]); return 2; }
+            i++;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (o.sources == 0 || o.sources > SOURCES_MAX || o.burst == 0 || o.burst > BURST_MAX ||
+        o.fps == 0 || o.gop == 0 || o.slices == 0 || o.payload_max < 64 ||
+        o.payload_max > PKT_MAX - RTP_HDR || o.start_pps <= 0.0 || o.step_factor <= 1.0 ||
+        o.step_seconds <= 0.0 || o.workers == 0 || o.workers > UV_RELAY_WORKERS_MAX) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    Template tmpl;
+    template_build(&tmpl, &o);
+
+    /* An ephemeral loopback port for the viewer: bind one, note it, let
+     * it go. */
+    uint16_t listen_port = 0;
+    int probe = udp_socket_bound(0, &listen_port);
+    if (probe < 0) {
+        perror("bind");
+        return 1;
+    }
+    close(probe);
+
+    UvViewerConfig cfg;
+    uv_viewer_config_init(&cfg);
+    cfg.listen_port = listen_port;
+    cfg.video_sink_preference = UV_VIDEO_SINK_FAKESINK;
+    cfg.decoder_preference = UV_DECODER_SOFTWARE;
+    cfg.audio_enabled = FALSE;
+    cfg.sidecar_enabled = FALSE;
+    cfg.shm_enabled = FALSE;
+    cfg.relay_workers = o.workers;
+    cfg.relay_backend = o.backend;
+    if (o.backend == UV_RELAY_BACKEND_PACKET_RING) g_strlcpy(cfg.relay_ring_ifname, "lo", sizeof(cfg.relay_ring_ifname));
+
+    UvViewer *viewer = uv_viewer_new(&cfg);
+    GError *err = NULL;
+    if (!viewer || !uv_viewer_start(viewer, &err)) {
+        fprintf(stderr, "viewer start failed: %s\n", err ? err->message : "unknown");
+        if (err) g_error_free(err);
+        if (viewer) uv_viewer_free(viewer);
+        return 1;
+    }
+    if (o.frame_block) uv_viewer_frame_block_configure(viewer, TRUE, FALSE);
+    if (o.release) uv_viewer_frame_release_configure(viewer, TRUE);
+
+    RestreamSink sink = { .fd = -1 };
+    pthread_t sink_thread;
+    if (o.restream) {
+        uint16_t sink_port = 0;
+        sink.fd = udp_socket_bound(0, &sink_port);
+        if (sink.fd < 0) {
+            perror("restream sink");
+            return 1;
+        }
+        int rcvbuf = 8 << 20;
+        setsockopt(sink.fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+        sink.running = 1;
+        pthread_create(&sink_thread, NULL, restream_sink_run, &sink);
+        uv_viewer_set_restream(viewer, true, "127.0.0.1", sink_port);
+    }
+
+    Sender senders[SOURCES_MAX];
+    uint32_t rng = 0x9e3779b9u;
+    struct sockaddr_in dst;
+    memset(&dst, 0, sizeof(dst));
+    dst.sin_family = AF_INET;
+    dst.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    dst.sin_port = htons(listen_port);
+    for (unsigned i = 0; i < o.sources; i++) {
+        Sender *s = &senders[i];
+        memset(s, 0, sizeof(*s));
+        s->fd = udp_socket_bound(0, NULL);
+        if (s->fd < 0 || connect(s->fd, (struct sockaddr *)&dst, sizeof(dst)) != 0) {
+            perror("sender socket");
+            return 1;
+        }
+        int sndbuf = 4 << 20;
+        setsockopt(s->fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+        s->ssrc = next_rand(&rng);
+        s->seq = (uint16_t)next_rand(&rng);
+        s->ts_base = next_rand(&rng);
+    }
+
+    /* Warm up at the start rate so every source is discovered (and the
+     * first selected) before anything is measured. */
+    GenResult warm;
+    generate(senders, &tmpl, &o, cfg.payload_type, o.start_pps, 0.5, &rng, &warm);
+    usleep(SETTLE_NS / 1000);
+
+    Step steps[STEPS_MAX];
+    unsigned n_steps = 0;
+    const char *stop_reason = "max_pps";
+    for (double pps = o.start_pps; pps <= o.max_pps && n_steps < STEPS_MAX; pps *= o.step_factor) {
+        Step *st = &steps[n_steps++];
+        memset(st, 0, sizeof(*st));
+        Counters before, after;
+        counters_read(viewer, &before);
+        uint64_t sink_before = __atomic_load_n(&sink.received, __ATOMIC_RELAXED);
+        int64_t sink_cpu0 = o.restream ? clock_ns(sink.cpu_clock) : 0;
+        int64_t cpu0 = clock_ns(CLOCK_PROCESS_CPUTIME_ID);
+
+        generate(senders, &tmpl, &o, cfg.payload_type, pps, o.step_seconds, &rng, &st->gen);
+        /* Let queued datagrams drain before reading the counters. */
+        usleep(SETTLE_NS / 1000);
+
+        int64_t cpu = clock_ns(CLOCK_PROCESS_CPUTIME_ID) - cpu0;
+        int64_t sink_cpu = o.restream ? clock_ns(sink.cpu_clock) - sink_cpu0 : 0;
+        counters_read(viewer, &after);
+        counters_delta(&before, &after, &st->delta);
+        st->restream_received = __atomic_load_n(&sink.received, __ATOMIC_RELAXED) - sink_before;
+        st->relay_cpu_ns = cpu - st->gen.cpu_ns - sink_cpu;
+        st->received_pps = (double)st->delta.recv / ((double)st->gen.elapsed_ns / 1e9);
+        uint64_t missing = st->gen.sent > st->delta.recv ? st->gen.sent - st->delta.recv : 0;
+        st->loss_pct = st->gen.sent ? 100.0 * (double)missing / (double)st->gen.sent : 0.0;
+        st->sustained = st->loss_pct <= o.loss_threshold_pct;
+        double offered = (double)(st->gen.sent + st->gen.lost_injected) / ((double)st->gen.elapsed_ns / 1e9);
+        st->generator_limited = offered < 0.95 * pps;
+        fprintf(stderr, "step %u: target %.0f pps, received %.0f pps, loss %.3f%%\n",
+                n_steps, pps, st->received_pps, st->loss_pct);
+        if (!st->sustained) {
+            stop_reason = "loss";
+            break;
+        }
+        if (st->generator_limited) {
+            stop_reason = "generator_limited";
+            break;
+        }
+    }
+
+    FILE *out = stdout;
+    if (o.json_path && !(out = fopen(o.json_path, "w"))) {
+        perror(o.json_path);
+        out = stdout;
+    }
+    report(out, &o, &tmpl, steps, n_steps, stop_reason);
+    if (out != stdout) fclose(out);
+
+    if (o.restream) {
+        uv_viewer_set_restream(viewer, false, NULL, 0);
+        sink.running = 0;
+        pthread_join(sink_thread, NULL);
+        close(sink.fd);
+    }
+    uv_viewer_stop(viewer);
+    uv_viewer_free(viewer);
+    for (unsigned i = 0; i < o.sources; i++) close(senders[i].fd);
+    free(tmpl.pkts);
+    return 0;
+}
@@ -0,0 +1,170 @@
+/* Per-packet cost of the relay's arrival-clock conversion and RFC 3550
+ * jitter update: the long double / double path the relay used before the
+ * integer rewrite versus the current integer path (rtp_now_ts_from_us()
+ * and the jitter_q4 estimator in src/relay_controller.c, copied here).
+ *
+ * A synthetic 90 kHz stream is generated up front: arrival times step by a
+ * frame interval with random network jitter and packet bursts, starting
+ * days into CLOCK_MONOTONIC so the products are realistically large. Both
+ * paths walk the same arrays; the integer conversion is also checked
+ * against the long double one for every sample, and the two jitter
+ * estimates are printed side by side.
+ *
+ * Built standalone (no GLib/GStreamer) by `make bench`. */
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    uint32_t prev_transit;
+    int initialized;
+    double value;
+} FloatJitter;
+
+typedef struct {
+    uint32_t prev_transit;
+    int initialized;
+    uint64_t q4;
+} IntJitter;
+
+static inline uint32_t float_ts_from_us(int clock_rate, int64_t us) {
+    long double ts = ((long double)us * (long double)clock_rate) / 1000000.0L;
+    if (ts < 0) ts = 0;
+    return (uint32_t)((uint64_t)ts);
+}
+
+static inline uint32_t int_ts_from_us(int clock_rate, int64_t us) {
+    if (us <= 0 || clock_rate <= 0) return 0;
+    uint64_t sec = (uint64_t)us / 1000000u;
+    uint64_t rem = (uint64_t)us % 1000000u;
+    uint64_t rate = (uint64_t)clock_rate;
+    return (uint32_t)(sec * rate + (rem * rate) / 1000000u);
+}
+
+static inline void float_update(FloatJitter *j, int clock_rate, int64_t arrival_us,
+                                uint32_t ts) {
+    uint32_t transit = float_ts_from_us(clock_rate, arrival_us) - ts;
+    if (!j->initialized) {
+        j->initialized = 1;
+        j->prev_transit = transit;
+        return;
+    }
+    int32_t d = (int32_t)(transit - j->prev_transit);
+    if (d < 0) d = -d;
+    j->value += ((double)d - j->value) / 16.0;
+    j->prev_transit = transit;
+}
+
+static inline void int_update(IntJitter *j, int clock_rate, int64_t arrival_us,
+                              uint32_t ts) {
+    uint32_t transit = int_ts_from_us(clock_rate, arrival_us) - ts;
+    if (!j->initialized) {
+        j->initialized = 1;
+        j->prev_transit = transit;
+        return;
+    }
+    int32_t d = (int32_t)(transit - j->prev_transit);
+    uint64_t ad = d < 0 ? (uint64_t)(-(int64_t)d) : (uint64_t)d;
+    j->q4 += ad - ((j->q4 + 8u) >> 4);
+    j->prev_transit = transit;
+}
+
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000ll + ts.tv_nsec;
+}
+
+static uint32_t next_rand(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [--packets N] [--clock-rate HZ] [--rounds N]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    size_t packets = 4u << 20;
+    int clock_rate = 90000;
+    unsigned rounds = 8;
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "--packets") == 0) {
+            packets = strtoull(argv[++i], NULL, 10);
+        } else if (i + 1 < argc && strcmp(argv[i], "--clock-rate") == 0) {
+            clock_rate = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--rounds") == 0) {
+            rounds = (unsigned)strtoul(argv[++i], NULL, 10);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (packets == 0 || clock_rate <= 0 || rounds == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    int64_t *arrival = malloc(packets * sizeof(*arrival));
+    uint32_t *rtp_ts = malloc(packets * sizeof(*rtp_ts));
+    if (!arrival || !rtp_ts) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    /* 60 fps, ~20 packets per frame sent back to back, up to 2 ms of
+     * network jitter per packet; monotonic clock ~3 days after boot. */
+    uint32_t rng = 0x2545f491u;
+    int64_t frame_us = 3ll * 86400 * 1000000;
+    uint32_t ts = 0x12345678u;
+    for (size_t i = 0; i < packets; i++) {
+        if (i % 20u == 0 && i > 0) {
+            frame_us += 16667;
+            ts += (uint32_t)clock_rate / 60u;
+        }
+        arrival[i] = frame_us + (int64_t)(i % 20u) * 40 + (int64_t)(next_rand(&rng) % 2000u);
+        rtp_ts[i] = ts;
+    }
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < packets; i++) {
+        if (float_ts_from_us(clock_rate, arrival[i]) != int_ts_from_us(clock_rate, arrival[i])) {
+            mismatches++;
+        }
+    }
+
+    double best_float = 0.0, best_int = 0.0;
+    FloatJitter fj;
+    IntJitter ij;
+    for (unsigned r = 0; r < rounds; r++) {
+        memset(&fj, 0, sizeof(fj));
+        int64_t t0 = now_ns();
+        for (size_t i = 0; i < packets; i++) float_update(&fj, clock_rate, arrival[i], rtp_ts[i]);
+        int64_t t1 = now_ns();
+        memset(&ij, 0, sizeof(ij));
+        for (size_t i = 0; i < packets; i++) int_update(&ij, clock_rate, arrival[i], rtp_ts[i]);
+        int64_t t2 = now_ns();
+        double f = (double)(t1 - t0) / (double)packets;
+        double n = (double)(t2 - t1) / (double)packets;
+        if (r == 0 || f < best_float) best_float = f;
+        if (r == 0 || n < best_int) best_int = n;
+    }
+
+    printf("packets=%zu clock_rate=%d rounds=%u ts_mismatches=%zu\n",
+           packets, clock_rate, rounds, mismatches);
+    printf("%-8s %9s %11s\n", "path", "ns/pkt", "jitter_ms");
+    printf("%-8s %9.2f %11.4f\n", "float", best_float,
+           fj.value * 1000.0 / (double)clock_rate);
+    printf("%-8s %9.2f %11.4f\n", "integer", best_int,
+           (double)ij.q4 * 1000.0 / 16.0 / (double)clock_rate);
+
+    free(arrival);
+    free(rtp_ts);
+    return mismatches == 0 ? 0 : 1;
+}
@@ -10,6 +10,33 @@ G_BEGIN_DECLS
 
 #define UV_VIEWER_ADDR_MAX 64
 #define UV_SHM_NAME_MAX 64
+/* recvmmsg() vector length bounds for the UDP relay. Each slot owns a full
+ * 64 KiB receive buffer so an oversized datagram is never truncated. */
+#define UV_RELAY_BATCH_DEFAULT 32u
+#define UV_RELAY_BATCH_MAX 64u
+/* Upper bound on SO_REUSEPORT relay receive threads (see relay_workers). */
+#define UV_RELAY_WORKERS_MAX 16u
+/* Datagrams per receive-delay window (see UvRelayWorkerStats). */
+#define UV_RELAY_DELAY_WINDOW 1024u
+/* Per-worker analytics ring length bounds (see relay_analytics_ring). */
+#define UV_RELAY_ANALYTICS_RING_DEFAULT 8192u
+#define UV_RELAY_ANALYTICS_RING_MAX (1u << 20)
+/* Interface name buffer for relay_ring_ifname (IFNAMSIZ). */
+#define UV_RELAY_IFNAME_MAX 16
+/* Relay source table size bounds (see relay_max_sources). */
+#define UV_RELAY_SOURCES_DEFAULT 256u
+#define UV_RELAY_SOURCES_MAX 65536u
+#define UV_GOP_CACHE_MAX_KB 65536u
+/* Restream fan-out: destinations fed at once, and per-destination queue
+ * length bounds (see restream_queue_depth). */
+#define UV_RESTREAM_TARGETS_MAX 8u
+#define UV_RESTREAM_QUEUE_DEFAULT 256u
+#define UV_RESTREAM_QUEUE_MAX 65536u
+/* Capture recorder: output path buffer and in-memory ring size bounds in
+ * MiB (see record_path). */
+#define UV_RECORD_PATH_MAX 512
+#define UV_RECORD_BUFFER_DEFAULT_MB 32u
+#define UV_RECORD_BUFFER_MAX_MB 1024u
 
 typedef enum {
     UV_SOURCE_UDP = 0,
@@ -18,6 +45,12 @@ typedef enum {
 
 typedef struct _UvViewer UvViewer;
 
+/* One restream destination. */
+typedef struct {
+    char    address[UV_VIEWER_ADDR_MAX]; /* IPv4 address */
+    guint16 port;
+} UvRestreamTarget;
+
 typedef enum {
     UV_DECODER_AUTO = 0,
     UV_DECODER_INTEL_VAAPI,
@@ -36,6 +69,28 @@ typedef enum {
     UV_VIDEO_SINK_FAKESINK
 } UvVideoSinkPreference;
 
+/* How the relay takes datagrams off the wire. */
+typedef enum {
+    UV_RELAY_BACKEND_SOCKET = 0,  /* recvmmsg() on UDP sockets (relay_workers of them) */
+    UV_RELAY_BACKEND_PACKET_RING, /* TPACKET_V3 mmap ring on an AF_PACKET socket; needs CAP_NET_RAW */
+    UV_RELAY_BACKEND_IO_URING,    /* io_uring multishot recvmsg into provided buffers, restream via linked sends */
+    UV_RELAY_BACKEND_REPLAY       /* datagrams read from a capture file (replay_path) on a virtual clock */
+} UvRelayBackend;
+
+/* Capture file written by the recorder. */
+typedef enum {
+    UV_RECORD_FORMAT_PCAP = 0,  /* libpcap, LINKTYPE_IPV4: each datagram behind synthesised IPv4/UDP headers */
+    UV_RECORD_FORMAT_RTPDUMP    /* rtptools rtpdump: datagrams with millisecond offsets, no sender address */
+} UvRecordFormat;
+
+/* Direct AU mode: what to do with an access unit the relay could not
+ * reassemble whole (a datagram of it missing, or arriving out of order). */
+typedef enum {
+    UV_DIRECT_AU_LOSS_PASS = 0,   /* push its complete NAL units, drop the broken ones (as rtph265depay does) */
+    UV_DIRECT_AU_LOSS_DROP_AU,    /* drop the access unit */
+    UV_DIRECT_AU_LOSS_WAIT_IRAP   /* drop it and everything after it up to the next IDR/CRA */
+} UvDirectAuLoss;
+
 typedef struct {
     int listen_port;   // UDP port to bind (default: 5600)
     int payload_type;  // RTP payload type (default: 97)
@@ -68,8 +123,69 @@ typedef struct {
     gboolean restream_enabled;                  // TRUE to forward the selected source
     char     restream_address[UV_VIEWER_ADDR_MAX]; // destination IPv4 address
     guint16  restream_port;                     // destination UDP port
+    /* Further destinations fed alongside restream_address:restream_port
+     * while restream is enabled. Each gets its own send socket and bounded
+     * queue, so a slow one only ever drops its own datagrams. */
+    UvRestreamTarget restream_extra[UV_RESTREAM_TARGETS_MAX - 1];
+    guint    restream_extra_count;
+    guint    restream_queue_depth; // datagrams queued per destination before dropping (default: 256)
+    /* Paced restream: spread each frame's datagrams over this fraction of
+     * the selected source's measured frame period instead of forwarding the
+     * encoder's burst back to back (0 = unpaced, default). */
+    double   restream_pace_spread;
     gboolean shm_enabled;
     char shm_name[UV_SHM_NAME_MAX];
+    gboolean shm_zero_copy; // push ring slots as wrapped GstMemory instead of copying (default: FALSE)
+    guint shm_max_inflight; // zero-copy: ring slots downstream may hold at once (default: 8)
+    guint relay_batch_size; // datagrams drained per recvmmsg() wakeup (default: 32, 1 = one per syscall)
+    guint relay_pool_buffers; // GstBufferPool buffers preallocated for zero-copy receive (default: 512, 0 = copy per packet)
+    guint relay_max_sources; // relay source table size; when full, stale sources are evicted LRU-first (default: 256)
+    guint relay_workers; // relay receive threads, each with an SO_REUSEPORT socket on listen_port (default: 1)
+    gboolean relay_pin_workers; // with relay_workers > 1, pin worker i to CPU i (mod online CPUs) (default: TRUE)
+    gboolean relay_kernel_timestamps; // stamp packet arrival with the kernel receive time (SO_TIMESTAMPING) (default: TRUE)
+    UvRelayBackend relay_backend; // receive path (default: UV_RELAY_BACKEND_SOCKET)
+    char relay_ring_ifname[UV_RELAY_IFNAME_MAX]; // packet-ring backend: interface to tap, "any" = all (default: "any")
+    guint relay_analytics_ring; // per-worker packet-metadata records queued for the analytics thread (default: 8192)
+    /* Capture: write the raw datagrams the relay receives to record_path
+     * for post-mortem analysis. Ingest copies them into an in-memory ring
+     * of record_buffer_mb and a writer thread streams that to disk, so a
+     * slow disk costs dropped records, never a stalled receive. */
+    char record_path[UV_RECORD_PATH_MAX]; // capture file, "" = off (default)
+    UvRecordFormat record_format;  // default: UV_RECORD_FORMAT_PCAP
+    gboolean record_all_sources;   // TRUE: every source; FALSE: the selected one only (default)
+    guint record_buffer_mb;        // capture ring size (default: 32)
+    gboolean record_direct;        // open with O_DIRECT, bypassing the page cache (default: FALSE)
+    /* Replay: feed the relay from a pcap or rtpdump capture (such as one
+     * written by the recorder) instead of the network. Time is the
+     * capture's: arrivals, and everything derived from them, are the
+     * recorded timestamps, so replaying a capture twice yields the same
+     * stream statistics. Setting replay_path selects
+     * UV_RELAY_BACKEND_REPLAY. */
+    char replay_path[UV_RECORD_PATH_MAX]; // capture to replay, "" = off (default)
+    gboolean replay_fast;          // TRUE: as fast as possible; FALSE: at the original timing (default)
+    gboolean replay_decode;        // TRUE: also push the replayed stream to the decoder (default: FALSE)
+    /* Latency tracing: stamp each video frame at ingest (keyed by its RTP
+     * timestamp or SHM pts) and again as it leaves each pipeline stage,
+     * and histogram the time spent between stages. */
+    gboolean latency_trace;        // default: FALSE
+    /* GOP cache: keep each source's video datagrams since its latest
+     * IDR/CRA, up to gop_cache_kb per source, and hand them to the decoder
+     * in one burst when the source is selected, so the picture comes back
+     * without waiting for the next keyframe. */
+    guint gop_cache_kb;            // per-source cap, 0 = off (default)
+    /* Direct AU mode: the relay depacketizes the selected source's
+     * RFC 7798 stream itself and pushes whole Annex-B access units to an
+     * appsrc feeding h265parse, as the SHM path does, instead of the
+     * datagrams to rtpjitterbuffer and rtph265depay. There is no
+     * jitterbuffer, so a reordered datagram counts as lost. */
+    gboolean direct_au;            // default: FALSE
+    UvDirectAuLoss direct_au_loss; // default: UV_DIRECT_AU_LOSS_PASS
+    /* Marker release: the relay holds the selected source's video
+     * datagrams in sequence order and releases a frame as soon as its
+     * marker datagram is in and nothing before it is missing. Only a frame
+     * with a hole waits, up to jitter_latency_ms; the jitterbuffer itself
+     * runs with no latency. */
+    gboolean marker_release;       // default: FALSE
 } UvViewerConfig;
 
 typedef struct {
@@ -86,6 +202,7 @@ typedef struct {
     uint64_t rtp_lost_packets;
     uint64_t rtp_duplicate_packets;
     uint64_t rtp_reordered_packets;
+    uint64_t rtp_window_lost_packets; /* left the 4096-packet reorder window unseen */
     uint64_t rtp_marker_frames;
     double rtp_marker_fps;
     double rfc3550_jitter_ms;
@@ -114,6 +231,15 @@ typedef struct {
     uint64_t shm_oversize_drops;
     uint64_t shm_bad_slots;
     uint64_t shm_reattaches;
+    /* Zero-copy SHM ingress: slots currently held downstream (READ_IDX only
+     * advances once they are released), the high-water mark and the cap. */
+    gboolean shm_zero_copy;
+    guint shm_inflight;
+    guint shm_inflight_peak;
+    guint shm_inflight_max;
+    uint64_t shm_zero_copy_frames;
+    uint64_t shm_copy_fallbacks;   /* copied after downstream stopped releasing */
+    uint64_t gop_cache_bytes;      /* held in the source's GOP cache */
 } UvSourceStats;
 
 typedef struct {
@@ -303,7 +429,29 @@ typedef struct {
     uint32_t encoder_packets_sent;    /* lifetime */
 } UvSidecarStats;
 
-/* Restream (verbatim UDP forward of the selected source) status. */
+/* One restream destination's queue and sender. Ingest copies each
+ * datagram into the destination's queue; the fan-out sender thread drains
+ * it with sendmmsg(). Counters restart whenever the destination list is
+ * changed. */
+typedef struct {
+    char     address[UV_VIEWER_ADDR_MAX];
+    guint16  port;
+    gboolean active;                      /* send socket open */
+    guint    queued;                      /* datagrams waiting to be sent */
+    guint    queue_peak;                  /* most ever waiting at once */
+    guint    queue_depth;                 /* queue capacity */
+    uint64_t dropped;                     /* queue full (or datagram over 2 KiB) */
+    uint64_t tx_packets;
+    uint64_t tx_bytes;
+    uint64_t tx_errors;                   /* datagrams the kernel refused */
+    uint64_t send_calls;                  /* sendmmsg() calls */
+    double   delay_us_avg;                /* queued to sent: latency the queue (and pacer) adds */
+    double   delay_us_max;
+} UvRestreamTargetStats;
+
+/* Restream (verbatim UDP forward of the selected source) status. address,
+ * port and active describe the first destination; the tx and drop totals
+ * are summed over all of them. */
 typedef struct {
     gboolean enabled;                     /* config: restream is on */
     gboolean active;                      /* send socket open + destination resolved */
@@ -311,9 +459,267 @@ typedef struct {
     guint16  port;                        /* destination UDP port */
     uint64_t tx_packets;                  /* datagrams forwarded since last (re)start */
     uint64_t tx_bytes;                    /* bytes forwarded since last (re)start */
-    uint64_t tx_errors;                   /* sendto() failures */
+    uint64_t tx_errors;                   /* send failures */
+    uint64_t dropped;                     /* datagrams dropped by a full queue */
+    double   pace_spread;                 /* config: fraction of the frame period, 0 = unpaced */
+    double   frame_period_ms;             /* period the pacer works from, 0 = not measured yet */
+    guint    target_count;
+    UvRestreamTargetStats targets[UV_RESTREAM_TARGETS_MAX];
 } UvRestreamStats;
 
+/* Mutex contention as seen by one acquiring thread. Only acquisitions that
+ * found the lock already held are timed; wait_ns_avg spreads that wait over
+ * every acquisition, i.e. the mean stall the lock adds per take. */
+typedef struct {
+    uint64_t acquisitions;      /* times the lock was taken */
+    uint64_t contended;         /* acquisitions that had to block */
+    uint64_t wait_ns_total;     /* summed blocking time, ns */
+    uint64_t wait_ns_max;       /* longest single wait, ns */
+    double   wait_ns_avg;       /* wait_ns_total / acquisitions */
+} UvLockStats;
+
+/* One relay receive thread. The kernel hashes each sender's address and
+ * port to one SO_REUSEPORT socket, so a source stays on one worker. */
+typedef struct {
+    int      cpu;               /* pinned CPU, -1 = not pinned */
+    uint64_t batches;           /* recvmmsg() calls that returned >= 1 datagram */
+    uint64_t datagrams;
+    uint64_t kernel_drops;      /* datagrams the socket dropped on a full receive buffer (SO_RXQ_OVFL) */
+    double   pps;               /* datagrams per second since the previous snapshot */
+    /* Arrival times come from the kernel's receive timestamp when
+     * kernel_timestamps is set. The delay is how long a datagram waited
+     * between that timestamp and recvmmsg() returning it (wakeup,
+     * scheduling, the rest of the batch), over the last
+     * UV_RELAY_DELAY_WINDOW datagrams; -1 until a window has filled. */
+    bool     kernel_timestamps;
+    double   rx_delay_median_us;
+    double   rx_delay_max_us;
+    /* Receive-loop cost, comparable across backends. syscalls counts every
+     * call the loop makes on the data path: poll() and recvmmsg() for
+     * socket, io_uring_enter() for io-uring, poll() and ring statistics for
+     * packet-ring, plus any wakeup of the restream sender. A batch is timed
+     * from the wakeup returning to the batch being fully handled: received,
+     * routed, pushed and queued for restream. */
+    UvRelayBackend backend;     /* receive path this worker runs (io-uring falls back to socket) */
+    uint64_t syscalls;
+    double   syscalls_per_datagram;
+    double   batch_us_avg;
+    double   batch_us_max;
+    uint64_t buffer_stalls;     /* io-uring: receive re-armed after running out of provided buffers */
+    uint64_t analytics_overruns; /* metadata records dropped on a full analytics ring */
+} UvRelayWorkerStats;
+
+/* UDP relay receive-loop telemetry. The relay drains the socket with
+ * recvmmsg(); a batch is the set of datagrams one call returned, all of which
+ * are routed under a single relay lock acquisition. With the packet-ring
+ * backend a batch is up to recv_batch_size datagrams read in place from one
+ * ring block, and a worker's kernel_drops counts frames lost to a full ring. */
+typedef struct {
+    UvRelayBackend backend;
+    guint    recv_batch_size;   /* configured recvmmsg() vector length */
+    uint64_t recv_batches;      /* recvmmsg() calls that returned >= 1 datagram */
+    uint64_t recv_datagrams;    /* datagrams drained across those calls */
+    guint    recv_batch_last;   /* datagrams returned by the most recent call */
+    guint    recv_batch_peak;   /* largest batch seen since the relay started */
+    double   recv_batch_avg;    /* recv_datagrams / recv_batches */
+
+    /* Zero-copy receive pool. allocated counts buffers the pool had to
+     * create (preallocation plus growth under pressure); recycled counts
+     * acquisitions served by a buffer downstream already released. */
+    guint    pool_buffers;      /* preallocated pool buffers, 0 = pool off */
+    guint    pool_buffer_size;  /* bytes per pool buffer */
+    uint64_t pool_allocated;    /* distinct pool buffers handed to the relay */
+    uint64_t pool_recycled;     /* acquisitions that reused a returned buffer */
+    uint64_t pool_copies;       /* oversized datagrams pushed via a copy */
+
+    /* Relay-thread lock contention. registry_lock is the controller lock
+     * (source table, routing, restream) taken once per batch; source_lock
+     * is the per-source lock held around receive counters by the workers
+     * and around RTP stats and analytics by the analytics thread, taken
+     * once per run of same-source datagrams. */
+    UvLockStats registry_lock;
+    UvLockStats source_lock;
+
+    /* Source table. Lookups go through a hash index on (address, port,
+     * SSRC); probes counts buckets examined, so probe_avg near 1 means
+     * lookup cost is flat in the number of sources. */
+    guint    sources_max;       /* configured table size */
+    guint    sources_used;      /* slots ever filled (<= sources_max) */
+    uint64_t source_lookups;
+    double   source_probe_avg;  /* buckets examined per lookup */
+    uint64_t source_evictions;  /* stale sources recycled for new ones */
+    uint64_t source_rejects;    /* datagrams from new sources dropped: table full, none stale */
+
+    guint    workers;           /* relay receive threads running */
+    UvRelayWorkerStats worker[UV_RELAY_WORKERS_MAX];
+    double   rx_delay_median_us; /* worst worker's rx_delay_median_us, -1 = none */
+
+    /* RTP, HEVC, frame-block and release analytics run on their own
+     * thread, fed by a fixed-size metadata record per datagram from each
+     * worker's lock-free ring. An overrun is a record dropped on a full
+     * ring: the datagram was still forwarded, but the analytics count it
+     * as lost. Without the thread (it failed to start) each worker folds
+     * its own records after every batch. */
+    bool     analytics_thread;
+    guint    analytics_ring_size;   /* records per worker ring */
+    uint64_t analytics_records;     /* records folded so far */
+    uint64_t analytics_overruns;    /* records dropped, all workers */
+    guint    analytics_backlog;     /* records waiting at the last publish */
+
+    /* Capture replay (backend UV_RELAY_BACKEND_REPLAY). Capture records
+     * that are not UDP to listen_port (pcap) or not RTP (rtpdump) are
+     * skipped. replay_capture_s over replay_wall_s is the speed-up. */
+    bool     replay_finished;       /* end of the capture reached */
+    bool     replay_fast;
+    uint64_t replay_datagrams;
+    uint64_t replay_skipped;
+    double   replay_capture_s;      /* capture time replayed */
+    double   replay_wall_s;         /* wall time taken */
+
+    /* GOP cache (gop_cache_kb > 0). A source holds a GOP once an IRAP
+     * access unit has arrived; one that outgrows the cap is dropped until
+     * the next. The last flush is what the most recent select sent. */
+    guint    gop_cache_kb;
+    guint    gop_cache_sources;     /* holding a GOP */
+    uint64_t gop_cache_bytes;       /* held, all sources */
+    uint64_t gop_cache_overflows;
+    uint64_t gop_flushes;
+    guint    gop_flush_frames;
+    guint    gop_flush_packets;
+    uint64_t gop_flush_bytes;
+
+    /* Direct AU mode (direct_au). Partial access units went out with a
+     * broken NAL unit left out (loss policy pass); dropped ones not at
+     * all. */
+    gboolean direct_au;
+    UvDirectAuLoss direct_au_loss;
+    uint64_t direct_aus;            /* pushed */
+    uint64_t direct_au_bytes;
+    uint64_t direct_au_partial;
+    uint64_t direct_au_dropped;
+    uint64_t direct_nals_dropped;   /* incomplete fragmented NAL units */
+    uint64_t direct_lost_packets;   /* sequence gaps */
+    uint64_t direct_late_packets;   /* behind the sequence, discarded */
+
+    /* Marker release (marker_release). Frames went out complete on their
+     * marker; timeouts had a hole when the latency ran out. hold is how
+     * long a frame's first datagram waited in the relay, saved how much
+     * sooner than the fixed latency window it went out, both averaged
+     * over every release. */
+    gboolean hold_enabled;
+    guint    hold_latency_ms;
+    uint64_t hold_frames;
+    uint64_t hold_timeouts;
+    uint64_t hold_lost_packets;     /* never arrived before their frame went */
+    uint64_t hold_late_packets;     /* arrived after, discarded */
+    uint64_t hold_overflows;        /* sequence jumped past the hold window */
+    double   hold_avg_ms;
+    double   hold_max_ms;
+    double   hold_saved_avg_ms;
+} UvIngestStats;
+
+/* Capture recorder. records and bytes count datagrams taken into the
+ * ring; dropped ones found it full (the writer fell behind). The write
+ * figures time each write() the writer thread makes, so write_mib_s is the
+ * rate the disk sustains while written to, not the capture rate. */
+typedef struct {
+    bool     enabled;               /* config: record_path set */
+    bool     active;                /* file open and writer running */
+    bool     failed;                /* open or write failed; capture stopped */
+    char     path[UV_RECORD_PATH_MAX];
+    UvRecordFormat format;
+    bool     all_sources;
+    bool     direct;                /* O_DIRECT in effect */
+    uint64_t ring_bytes;
+    uint64_t backlog_bytes;         /* waiting for the writer now */
+    uint64_t backlog_peak;
+    uint64_t records;
+    uint64_t bytes;                 /* record bytes, file headers included */
+    uint64_t dropped;
+    uint64_t dropped_bytes;
+    uint64_t bytes_written;
+    uint64_t write_calls;
+    uint64_t write_errors;
+    double   write_us_avg;
+    double   write_us_max;
+    double   write_mib_s;
+} UvRecordStats;
+
+/* Per-frame latency through the pipeline. Each stage is the time from the
+ * frame leaving the previous stage (ingest for the first) to it leaving
+ * this one:
+ *   APPSRC         ingest -> the frame's last datagram (UDP) or its access
+ *                  unit (SHM) leaving appsrc; relay hand-off and appsrc queue
+ *   DEPAY          -> out of rtph265depay; queue0, jitterbuffer, depayload
+ *                  (UDP only)
+ *   PARSER         -> out of h265parse
+ *   DECODER        -> out of the decoder
+ *   QUEUE_POSTDEC  -> out of the post-decode queue
+ *   SINK           -> into the video sink (not traced with videorate, which
+ *                  retimes frames)
+ *   TOTAL          ingest -> the last traced stage
+ * Ingest is the arrival of the frame's first datagram, or the read of its
+ * SHM slot. Histogram bucket i counts frames under 2^i ms; the last bucket
+ * takes the rest. */
+#define UV_LATENCY_BUCKETS 10u
+
+typedef enum {
+    UV_LATENCY_STAGE_APPSRC,
+    UV_LATENCY_STAGE_DEPAY,
+    UV_LATENCY_STAGE_PARSER,
+    UV_LATENCY_STAGE_DECODER,
+    UV_LATENCY_STAGE_QUEUE_POSTDEC,
+    UV_LATENCY_STAGE_SINK,
+    UV_LATENCY_STAGE_TOTAL,
+    UV_LATENCY_STAGE_COUNT
+} UvLatencyStage;
+
+typedef struct {
+    uint64_t frames;
+    double   avg_ms;
+    double   p50_ms;              /* interpolated within the histogram */
+    double   p95_ms;
+    double   max_ms;
+    uint64_t hist[UV_LATENCY_BUCKETS];
+} UvLatencyStageStats;
+
+typedef struct {
+    gboolean enabled;
+    uint64_t frames_traced;       /* reached the last traced stage */
+    uint64_t frames_lost;         /* tagged at ingest, never got that far */
+    UvLatencyStageStats stage[UV_LATENCY_STAGE_COUNT];
+} UvLatencyStats;
+
+/* Live pipeline updates (uv_viewer_update_pipeline). An update takes from
+ * the call until it is in effect: at once for element properties, after
+ * the relink for videorate on/off. Frames lost are decoded frames that did
+ * not reach the video converter between the call and the first frame
+ * converted after it took effect. A failed relink is not counted as an
+ * update; the pipeline needs a restart after one. */
+typedef struct {
+    guint    updates;
+    guint    failures;            /* relinks that failed */
+    gboolean pending;             /* relink waiting for the pad to go idle */
+    gboolean failed;              /* the last relink failed */
+    char     last_change[64];     /* e.g. "latency queue sync" */
+    double   last_ms;
+    double   max_ms;
+    uint64_t last_frames_lost;
+    uint64_t frames_lost_total;
+} UvReconfigStats;
+
+/* Cost of uv_viewer_get_stats() itself. The relay, SHM and sidecar threads
+ * publish their counters through sequence-locked snapshots, so a reader
+ * never blocks them; a reader copy that races a publish is retried instead. */
+typedef struct {
+    uint64_t snapshots;         /* uv_viewer_get_stats() calls so far */
+    double   last_us;           /* duration of the most recent call */
+    double   avg_us;
+    double   max_us;
+    uint64_t reader_retries;    /* copies redone after racing a publish */
+    guint    last_retries;      /* of which in the most recent call */
+} UvSnapshotStats;
+
 typedef struct {
     GArray *sources;      // UvSourceStats elements
     GArray *qos_entries;  // UvNamedQoSStats elements
@@ -328,11 +734,30 @@ typedef struct {
     UvReleaseStats frame_release;
     UvSidecarStats sidecar;
     UvRestreamStats restream;
+    UvRecordStats record;
+    UvLatencyStats latency;
+    UvReconfigStats reconfig;
+    UvIngestStats ingest;
+    UvSnapshotStats snapshot;
 } UvViewerStats;
 
 typedef struct {
     const char *descriptive_name; // optional, e.g. "vah265dec"
     GstElement *custom_decoder;   // optional externally created element
+
+    /* Applied to the running pipeline in place, each only when its set_
+     * flag is TRUE, and kept in the viewer config for later rebuilds. The
+     * decoder fields above still need uv_viewer_restart_pipeline(). */
+    gboolean set_jitter_latency;
+    guint jitter_latency_ms;
+    gboolean set_queue_max_buffers;
+    guint queue_max_buffers;
+    gboolean set_videorate;       // enable/disable relinks behind an idle probe
+    gboolean videorate_enabled;
+    guint videorate_fps_numerator;
+    guint videorate_fps_denominator;
+    gboolean set_sync;
+    gboolean sync_to_clock;
 } UvPipelineOverrides;
 
 typedef enum {
@@ -376,9 +801,10 @@ void uv_viewer_set_sidecar_enabled(UvViewer *viewer, bool enabled, guint port);
 
 /* Toggle / retarget the restream verbatim UDP forward at runtime. When enabled,
  * every raw datagram from the currently selected source is re-sent to
- * address:port unchanged. Pass enabled=false (or a NULL/empty address) to stop
- * forwarding. Takes effect immediately; the setting is also stored in the
- * viewer config so it survives a pipeline/config restart. */
+ * address:port unchanged, and to the config's restream_extra destinations.
+ * Pass enabled=false (or a NULL/empty address) to stop forwarding. Takes
+ * effect immediately; the setting is also stored in the viewer config so it
+ * survives a pipeline/config restart. */
 void uv_viewer_set_restream(UvViewer *viewer, bool enabled, const char *address, guint16 port);
 
 void uv_viewer_frame_block_configure(UvViewer *viewer, gboolean enabled, gboolean snapshot_mode);
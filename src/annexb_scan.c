@@ -0,0 +1,145 @@
+#include "annexb_scan.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ANNEXB_X86 1
+#elif defined(__aarch64__) || (defined(__ARM_NEON) && defined(__arm__))
+#include <arm_neon.h>
+#define ANNEXB_NEON 1
+#endif
+
+/* Scalar search keyed on the start code's last byte. A byte above 1 at
+ * i rules out a start code at i - 2, i - 1 and i, so the next candidate
+ * ends three bytes on; in real streams that is nearly every byte. */
+static size_t annexb_find_scalar(const uint8_t *buf, size_t len, size_t from) {
+    size_t i = from + 2;
+    while (i < len) {
+        uint8_t b = buf[i];
+        if (b > 1) {
+            i += 3;
+        } else if (b == 1) {
+            if (buf[i - 1] == 0 && buf[i - 2] == 0) return i - 2;
+            i += 3;
+        } else {
+            i++;
+        }
+    }
+    return len;
+}
+
+/* The vector scanners test 00 00 01 at every offset of a block at once:
+ * bytes p and p + 1 zero and byte p + 2 one, from three overlapping loads.
+ * Most blocks hold no zero byte at all, so the block loop only asks
+ * whether any lane matched; the lane is worked out once one has. What is
+ * left after the last whole block goes to the scalar search. */
+
+#if ANNEXB_X86
+__attribute__((target("sse2")))
+static size_t annexb_find_sse2(const uint8_t *buf, size_t len, size_t from) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    size_t i = from;
+    for (; i + 2 + 16 <= len; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(buf + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(buf + i + 1));
+        __m128i c = _mm_loadu_si128((const __m128i *)(buf + i + 2));
+        __m128i hit = _mm_and_si128(_mm_cmpeq_epi8(_mm_or_si128(a, b), zero),
+                                    _mm_cmpeq_epi8(c, one));
+        unsigned mask = (unsigned)_mm_movemask_epi8(hit);
+        if (mask) return i + (size_t)__builtin_ctz(mask);
+    }
+    return annexb_find_scalar(buf, len, i);
+}
+
+/* Two 32-byte blocks per iteration, tested together. */
+__attribute__((target("avx2")))
+static size_t annexb_find_avx2(const uint8_t *buf, size_t len, size_t from) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi8(1);
+    size_t i = from;
+    for (; i + 2 + 64 <= len; i += 64) {
+        __m256i a0 = _mm256_loadu_si256((const __m256i *)(buf + i));
+        __m256i b0 = _mm256_loadu_si256((const __m256i *)(buf + i + 1));
+        __m256i c0 = _mm256_loadu_si256((const __m256i *)(buf + i + 2));
+        __m256i a1 = _mm256_loadu_si256((const __m256i *)(buf + i + 32));
+        __m256i b1 = _mm256_loadu_si256((const __m256i *)(buf + i + 33));
+        __m256i c1 = _mm256_loadu_si256((const __m256i *)(buf + i + 34));
+        __m256i hit0 = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_or_si256(a0, b0), zero),
+                                        _mm256_cmpeq_epi8(c0, one));
+        __m256i hit1 = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_or_si256(a1, b1), zero),
+                                        _mm256_cmpeq_epi8(c1, one));
+        if (_mm256_testz_si256(_mm256_or_si256(hit0, hit1), _mm256_or_si256(hit0, hit1))) continue;
+        uint64_t mask = (uint32_t)_mm256_movemask_epi8(hit0) |
+                        ((uint64_t)(uint32_t)_mm256_movemask_epi8(hit1) << 32);
+        return i + (size_t)__builtin_ctzll(mask);
+    }
+    return annexb_find_sse2(buf, len, i);
+}
+#endif
+
+#if ANNEXB_NEON
+static size_t annexb_find_neon(const uint8_t *buf, size_t len, size_t from) {
+    const uint8x16_t zero = vdupq_n_u8(0);
+    const uint8x16_t one = vdupq_n_u8(1);
+    size_t i = from;
+    for (; i + 2 + 16 <= len; i += 16) {
+        uint8x16_t a = vld1q_u8(buf + i);
+        uint8x16_t b = vld1q_u8(buf + i + 1);
+        uint8x16_t c = vld1q_u8(buf + i + 2);
+        uint8x16_t hit = vandq_u8(vceqq_u8(vorrq_u8(a, b), zero), vceqq_u8(c, one));
+        /* Narrow to 4 bits per lane for a scalar mask. */
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(
+            vshrn_n_u16(vreinterpretq_u16_u8(hit), 4)), 0);
+        if (mask) return i + (size_t)(__builtin_ctzll(mask) >> 2);
+    }
+    return annexb_find_scalar(buf, len, i);
+}
+#endif
+
+static const AnnexbScanner annexb_all[] = {
+    { "scalar", annexb_find_scalar },
+#if ANNEXB_X86
+    { "sse2", annexb_find_sse2 },
+    { "avx2", annexb_find_avx2 },
+#endif
+#if ANNEXB_NEON
+    { "neon", annexb_find_neon },
+#endif
+};
+
+static size_t annexb_count;
+static const AnnexbScanner *annexb_best;
+
+/* SSE2 is part of x86-64 but not of 32-bit x86; NEON is taken as given
+ * wherever it was compiled in. Racing first callers resolve the same
+ * answer, so plain atomic stores are enough. */
+static const AnnexbScanner *annexb_resolve(void) {
+    size_t count = 1;
+#if ANNEXB_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        count = 2;
+        if (__builtin_cpu_supports("avx2")) count = 3;
+    }
+#elif ANNEXB_NEON
+    count = 2;
+#endif
+    __atomic_store_n(&annexb_count, count, __ATOMIC_RELAXED);
+    __atomic_store_n(&annexb_best, &annexb_all[count - 1], __ATOMIC_RELEASE);
+    return &annexb_all[count - 1];
+}
+
+const AnnexbScanner *annexb_scanner(void) {
+    const AnnexbScanner *s = __atomic_load_n(&annexb_best, __ATOMIC_ACQUIRE);
+    return s ? s : annexb_resolve();
+}
+
+size_t annexb_scanners(const AnnexbScanner **out) {
+    annexb_scanner();
+    *out = annexb_all;
+    return __atomic_load_n(&annexb_count, __ATOMIC_RELAXED);
+}
+
+size_t annexb_find_start_code(const uint8_t *buf, size_t len, size_t from) {
+    return annexb_scanner()->find(buf, len, from);
+}
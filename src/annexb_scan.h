@@ -0,0 +1,26 @@
+#ifndef ANNEXB_SCAN_H
+#define ANNEXB_SCAN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Annex-B start-code search (ITU-T H.265 B.2). Plain libc so anything
+ * walking a byte stream can use it, benches included. A 4-byte start code
+ * 00 00 00 01 is found as the 00 00 01 one byte in, so the NAL unit header
+ * is always at the returned offset + 3. */
+
+typedef struct {
+    const char *name;
+    /* Offset of the first 00 00 01 at or after from, or len when none. */
+    size_t (*find)(const uint8_t *buf, size_t len, size_t from);
+} AnnexbScanner;
+
+/* Scanners this CPU can run, scalar first. */
+size_t annexb_scanners(const AnnexbScanner **out);
+
+/* The fastest of them, picked on first use. */
+const AnnexbScanner *annexb_scanner(void);
+
+size_t annexb_find_start_code(const uint8_t *buf, size_t len, size_t from);
+
+#endif // ANNEXB_SCAN_H
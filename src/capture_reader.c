@@ -0,0 +1,211 @@
+#define _GNU_SOURCE
+#include "uv_internal.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Capture reader for replay: the UDP datagrams of a pcap or rtpdump file,
+ * in file order, with their capture timestamps. Reads what the recorder
+ * writes and what tcpdump/rtpdump write for this stream: classic pcap
+ * (either byte order, micro- or nanosecond stamps) over Ethernet (VLAN
+ * tagged or not), Linux cooked (SLL, SLL2), BSD loopback or raw IPv4; and
+ * rtpdump "#!rtpplay1.0". pcapng is not supported. In pcap, only
+ * unfragmented IPv4 UDP to the port given at open is returned; anything
+ * else is skipped and counted. rtpdump has no addresses, so every
+ * datagram comes from the one source its file header names. */
+
+#define PCAP_LINKTYPE_NULL     0u
+#define PCAP_LINKTYPE_ETHERNET 1u
+#define PCAP_LINKTYPE_RAW      101u
+#define PCAP_LINKTYPE_SLL      113u
+#define PCAP_LINKTYPE_IPV4     228u
+#define PCAP_LINKTYPE_SLL2     276u
+/* Largest pcap record accepted; anything bigger means a corrupt file. */
+#define CAPTURE_RECORD_MAX     (256u * 1024u)
+
+static inline uint16_t get_be16(const unsigned char *p) {
+    return (uint16_t)(p[0] << 8 | p[1]);
+}
+
+static inline uint32_t get_be32(const unsigned char *p) {
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+static inline uint32_t capture_u32(const CaptureReader *cr, const unsigned char *p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return cr->swapped ? GUINT32_SWAP_LE_BE(v) : v;
+}
+
+gboolean capture_reader_open(CaptureReader *cr, const char *path, guint16 port) {
+    memset(cr, 0, sizeof(*cr));
+    cr->port = port;
+    cr->fp = fopen(path, "rb");
+    if (!cr->fp) {
+        uv_log_warn("Replay: cannot open %s: %s", path, g_strerror(errno));
+        return FALSE;
+    }
+    unsigned char hdr[24];
+    if (fread(hdr, 1, sizeof(hdr), cr->fp) != sizeof(hdr)) {
+        uv_log_warn("Replay: %s is too short to be a capture", path);
+        capture_reader_close(cr);
+        return FALSE;
+    }
+
+    uint32_t magic;
+    memcpy(&magic, hdr, 4);
+    if (magic == 0xa1b2c3d4u || magic == 0xa1b23c4du ||
+        magic == 0xd4c3b2a1u || magic == 0x4d3cb2a1u) {
+        cr->format = UV_RECORD_FORMAT_PCAP;
+        cr->swapped = magic == 0xd4c3b2a1u || magic == 0x4d3cb2a1u;
+        cr->nanos = magic == 0xa1b23c4du || magic == 0x4d3cb2a1u;
+        cr->linktype = capture_u32(cr, hdr + 20) & 0x0fffffffu;
+        switch (cr->linktype) {
+        case PCAP_LINKTYPE_NULL:
+        case PCAP_LINKTYPE_ETHERNET:
+        case PCAP_LINKTYPE_RAW:
+        case PCAP_LINKTYPE_SLL:
+        case PCAP_LINKTYPE_IPV4:
+        case PCAP_LINKTYPE_SLL2:
+            break;
+        default:
+            uv_log_warn("Replay: %s: unsupported pcap link type %u", path, cr->linktype);
+            capture_reader_close(cr);
+            return FALSE;
+        }
+    } else if (memcmp(hdr, "#!rtpplay1.0 ", 13) == 0) {
+        cr->format = UV_RECORD_FORMAT_RTPDUMP;
+        /* Header line: "#!rtpplay1.0 address/port\n", then the binary
+         * start time, source address and port. */
+        rewind(cr->fp);
+        char line[128];
+        if (!fgets(line, sizeof(line), cr->fp) || !strchr(line, '\n')) {
+            uv_log_warn("Replay: %s: malformed rtpdump header", path);
+            capture_reader_close(cr);
+            return FALSE;
+        }
+        unsigned char bin[16];
+        if (fread(bin, 1, sizeof(bin), cr->fp) != sizeof(bin)) {
+            uv_log_warn("Replay: %s: truncated rtpdump header", path);
+            capture_reader_close(cr);
+            return FALSE;
+        }
+        cr->start_us = (gint64)get_be32(bin) * G_USEC_PER_SEC + get_be32(bin + 4);
+        cr->from.sin_family = AF_INET;
+        memcpy(&cr->from.sin_addr.s_addr, bin + 8, 4);
+        memcpy(&cr->from.sin_port, bin + 12, 2);
+    } else if (magic == 0x0a0d0d0au) {
+        uv_log_warn("Replay: %s is pcapng; convert it with editcap -F pcap first", path);
+        capture_reader_close(cr);
+        return FALSE;
+    } else {
+        uv_log_warn("Replay: %s is neither pcap nor rtpdump", path);
+        capture_reader_close(cr);
+        return FALSE;
+    }
+    cr->buf = g_malloc(CAPTURE_RECORD_MAX);
+    return TRUE;
+}
+
+void capture_reader_close(CaptureReader *cr) {
+    if (cr->fp) fclose(cr->fp);
+    cr->fp = NULL;
+    g_free(cr->buf);
+    cr->buf = NULL;
+}
+
+/* Offset of the IPv4 header in a link-layer frame, or -1 when it carries
+ * something else. */
+static long capture_ip_offset(const CaptureReader *cr, const unsigned char *f, size_t len) {
+    switch (cr->linktype) {
+    case PCAP_LINKTYPE_RAW:
+    case PCAP_LINKTYPE_IPV4:
+        return 0;
+    case PCAP_LINKTYPE_NULL: {
+        if (len < 4) return -1;
+        uint32_t family;
+        memcpy(&family, f, 4);
+        return family == 2 || GUINT32_SWAP_LE_BE(family) == 2 ? 4 : -1;
+    }
+    case PCAP_LINKTYPE_ETHERNET: {
+        size_t off = 12;
+        if (len >= off + 2 && (get_be16(f + off) == 0x8100 || get_be16(f + off) == 0x88a8)) off += 4;
+        if (len >= off + 2 && get_be16(f + off) == 0x8100) off += 4;
+        return len >= off + 2 && get_be16(f + off) == 0x0800 ? (long)(off + 2) : -1;
+    }
+    case PCAP_LINKTYPE_SLL:
+        return len >= 16 && get_be16(f + 14) == 0x0800 ? 16 : -1;
+    case PCAP_LINKTYPE_SLL2:
+        return len >= 20 && get_be16(f) == 0x0800 ? 20 : -1;
+    default:
+        return -1;
+    }
+}
+
+/* The UDP payload of one pcap frame, if it is one we replay. */
+static gboolean capture_pcap_datagram(CaptureReader *cr, const unsigned char *f, size_t len,
+                                      CaptureDatagram *out) {
+    long off = capture_ip_offset(cr, f, len);
+    if (off < 0 || len < (size_t)off + 20) return FALSE;
+    const unsigned char *ip = f + off;
+    size_t ip_len = len - (size_t)off;
+    size_t ihl = (size_t)(ip[0] & 0x0f) * 4;
+    if ((ip[0] >> 4) != 4 || ihl < 20 || ip[9] != 17 || ip_len < ihl + 8) return FALSE;
+    if (get_be16(ip + 6) & 0x3fff) return FALSE;   /* fragment */
+    const unsigned char *udp = ip + ihl;
+    size_t udp_len = get_be16(udp + 4);
+    if (udp_len < 8 || udp_len > ip_len - ihl) return FALSE;
+    if (cr->port && get_be16(udp + 2) != cr->port) return FALSE;
+    memset(&out->from, 0, sizeof(out->from));
+    out->from.sin_family = AF_INET;
+    memcpy(&out->from.sin_addr.s_addr, ip + 12, 4);
+    memcpy(&out->from.sin_port, udp, 2);
+    out->data = udp + 8;
+    out->len = udp_len - 8;
+    return TRUE;
+}
+
+/* Next datagram into out (data points into the reader, valid until the
+ * next call). Returns FALSE at the end of the file or on a truncated or
+ * corrupt record. */
+gboolean capture_reader_next(CaptureReader *cr, CaptureDatagram *out) {
+    if (!cr->fp) return FALSE;
+    for (;;) {
+        if (cr->format == UV_RECORD_FORMAT_RTPDUMP) {
+            unsigned char hdr[8];
+            if (fread(hdr, 1, sizeof(hdr), cr->fp) != sizeof(hdr)) return FALSE;
+            size_t len = get_be16(hdr);
+            if (len < sizeof(hdr)) return FALSE;
+            len -= sizeof(hdr);
+            if (fread(cr->buf, 1, len, cr->fp) != len) return FALSE;
+            /* plen 0 marks a non-RTP (RTCP) packet. */
+            if (get_be16(hdr + 2) == 0) {
+                cr->skipped++;
+                continue;
+            }
+            out->data = cr->buf;
+            out->len = len;
+            out->from = cr->from;
+            out->ts_us = cr->start_us + (gint64)get_be32(hdr + 4) * 1000;
+            return TRUE;
+        }
+
+        unsigned char hdr[16];
+        if (fread(hdr, 1, sizeof(hdr), cr->fp) != sizeof(hdr)) return FALSE;
+        uint32_t incl = capture_u32(cr, hdr + 8);
+        if (incl > CAPTURE_RECORD_MAX) {
+            uv_log_warn("Replay: corrupt pcap record (%u bytes); stopping", incl);
+            return FALSE;
+        }
+        if (fread(cr->buf, 1, incl, cr->fp) != incl) return FALSE;
+        if (!capture_pcap_datagram(cr, cr->buf, incl, out)) {
+            cr->skipped++;
+            continue;
+        }
+        uint32_t frac = capture_u32(cr, hdr + 4);
+        out->ts_us = (gint64)capture_u32(cr, hdr) * G_USEC_PER_SEC +
+                     (cr->nanos ? frac / 1000u : frac);
+        return TRUE;
+    }
+}
@@ -0,0 +1,361 @@
+#define _GNU_SOURCE
+#include "uv_internal.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Capture recorder: ingest formats each datagram as a file record straight
+ * into the ring (capture_recorder_push), so the writer thread only ever
+ * copies ring bytes to the file in order. The file header goes through the
+ * ring too, which keeps every O_DIRECT write at a page-aligned file offset.
+ *
+ * pcap: LINKTYPE_IPV4 with microsecond stamps on the realtime clock (moved
+ * over from the relay's monotonic arrival time); each datagram gets an
+ * IPv4 and UDP header carrying the sender's address and port, the listen
+ * port as destination, 0.0.0.0 as destination address (the socket is bound
+ * to the wildcard) and no UDP checksum.
+ *
+ * rtpdump (rtptools "#!rtpplay1.0"): per-packet millisecond offsets from
+ * the start of the capture; the format has no per-packet sender, so an
+ * all-sources capture interleaves them. */
+
+#define PCAP_LINKTYPE_IPV4 228u
+#define RECORD_IP_UDP_LEN  28u
+#define RECORD_HDR_MAX     (16u + RECORD_IP_UDP_LEN)
+#define RECORD_DATAGRAM_MAX (65535u - RECORD_IP_UDP_LEN)
+
+/* Single-writer counters, read concurrently by capture_recorder_snapshot(). */
+static inline void record_count(uint64_t *c, uint64_t v) {
+    __atomic_store_n(c, *c + v, __ATOMIC_RELAXED);
+}
+
+static inline uint64_t record_read(const uint64_t *c) {
+    return __atomic_load_n(c, __ATOMIC_RELAXED);
+}
+
+static inline uint64_t record_clock_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static inline void put_be16(unsigned char *p, uint16_t v) {
+    p[0] = (unsigned char)(v >> 8);
+    p[1] = (unsigned char)v;
+}
+
+static inline void put_be32(unsigned char *p, uint32_t v) {
+    p[0] = (unsigned char)(v >> 24);
+    p[1] = (unsigned char)(v >> 16);
+    p[2] = (unsigned char)(v >> 8);
+    p[3] = (unsigned char)v;
+}
+
+/* Copy n bytes into the ring at free-running offset pos, wrapping. */
+static void record_ring_put(CaptureRecorder *r, uint64_t pos, const void *src, size_t n) {
+    uint64_t off = pos & (r->size - 1);
+    size_t first = (size_t)MIN((uint64_t)n, r->size - off);
+    memcpy(r->ring + off, src, first);
+    if (first < n) memcpy(r->ring, (const unsigned char *)src + first, n - first);
+}
+
+void capture_recorder_init(CaptureRecorder *r, const UvViewerConfig *cfg) {
+    memset(r, 0, sizeof(*r));
+    r->fd = -1;
+    r->wake_fd = -1;
+    g_strlcpy(r->path, cfg->record_path, sizeof(r->path));
+    r->format = cfg->record_format;
+    r->all_sources = cfg->record_all_sources;
+    r->listen_port = (guint16)cfg->listen_port;
+    r->direct = cfg->record_direct;
+    guint mb = cfg->record_buffer_mb ? cfg->record_buffer_mb : UV_RECORD_BUFFER_DEFAULT_MB;
+    mb = MIN(mb, UV_RECORD_BUFFER_MAX_MB);
+    r->size = 1u << 20;
+    while (r->size < (uint64_t)mb << 20) r->size <<= 1;
+}
+
+/* File header, queued as the ring's first bytes. */
+static void record_put_file_header(CaptureRecorder *r) {
+    unsigned char hdr[64];
+    size_t n;
+    if (r->format == UV_RECORD_FORMAT_RTPDUMP) {
+        gint64 rt_us = r->start_us + r->rt_offset_us;
+        n = (size_t)g_snprintf((char *)hdr, sizeof(hdr), "#!rtpplay1.0 0.0.0.0/%u\n", r->listen_port);
+        put_be32(hdr + n, (uint32_t)(rt_us / G_USEC_PER_SEC));
+        put_be32(hdr + n + 4, (uint32_t)(rt_us % G_USEC_PER_SEC));
+        put_be32(hdr + n + 8, 0);
+        put_be16(hdr + n + 12, r->listen_port);
+        put_be16(hdr + n + 14, 0);
+        n += 16;
+    } else {
+        uint32_t magic = 0xa1b2c3d4u, snaplen = 65535u, linktype = PCAP_LINKTYPE_IPV4;
+        uint16_t major = 2, minor = 4;
+        int32_t zone = 0;
+        uint32_t sigfigs = 0;
+        memcpy(hdr, &magic, 4);
+        memcpy(hdr + 4, &major, 2);
+        memcpy(hdr + 6, &minor, 2);
+        memcpy(hdr + 8, &zone, 4);
+        memcpy(hdr + 12, &sigfigs, 4);
+        memcpy(hdr + 16, &snaplen, 4);
+        memcpy(hdr + 20, &linktype, 4);
+        n = 24;
+    }
+    record_ring_put(r, r->head, hdr, n);
+    record_count(&r->bytes, n);
+    __atomic_store_n(&r->head, r->head + n, __ATOMIC_RELEASE);
+}
+
+static int record_open(CaptureRecorder *r) {
+    int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    int fd = open(r->path, flags | (r->direct ? O_DIRECT : 0), 0644);
+    if (fd < 0 && r->direct && errno == EINVAL) {
+        uv_log_warn("Record: %s does not support O_DIRECT; writing through the page cache", r->path);
+        r->direct = FALSE;
+        fd = open(r->path, flags, 0644);
+    }
+    return fd;
+}
+
+/* Fall back to buffered writes: for a filesystem that refuses an O_DIRECT
+ * write, and for the final partial page at close. */
+static void record_drop_direct(CaptureRecorder *r) {
+    int flags = fcntl(r->fd, F_GETFL);
+    if (flags >= 0) fcntl(r->fd, F_SETFL, flags & ~O_DIRECT);
+    g_atomic_int_set(&r->direct, 0);
+}
+
+/* Write the next contiguous run of the ring, up to head: at most
+ * UV_RECORD_WRITE_MAX bytes and, under O_DIRECT, whole pages only. Returns
+ * the bytes written; 0 when nothing could go out yet or the write failed. */
+static uint64_t record_write(CaptureRecorder *r, uint64_t head) {
+    uint64_t off = r->tail & (r->size - 1);
+    uint64_t n = MIN(head - r->tail, r->size - off);
+    n = MIN(n, (uint64_t)UV_RECORD_WRITE_MAX);
+    if (g_atomic_int_get(&r->direct)) n &= ~(uint64_t)(UV_RECORD_ALIGN - 1);
+    if (n == 0) return 0;
+
+    uint64_t t0 = record_clock_ns();
+    ssize_t w = write(r->fd, r->ring + off, (size_t)n);
+    uint64_t ns = record_clock_ns() - t0;
+    record_count(&r->write_calls, 1);
+    record_count(&r->write_ns_total, ns);
+    if (ns > r->write_ns_max) __atomic_store_n(&r->write_ns_max, ns, __ATOMIC_RELAXED);
+    if (w < 0 && errno == EINTR) return 0;
+    if (w < 0 && errno == EINVAL && g_atomic_int_get(&r->direct)) {
+        /* Some filesystems accept O_DIRECT at open and refuse the write. */
+        uv_log_warn("Record: O_DIRECT write refused on %s; writing through the page cache", r->path);
+        record_drop_direct(r);
+        return 0;
+    }
+    if (w <= 0) {
+        record_count(&r->write_errors, 1);
+        uv_log_warn("Record: write to %s failed: %s; capture stopped",
+                    r->path, w < 0 ? g_strerror(errno) : "no space");
+        g_atomic_int_set(&r->failed, 1);
+        return 0;
+    }
+    record_count(&r->bytes_written, (uint64_t)w);
+    __atomic_store_n(&r->tail, r->tail + (uint64_t)w, __ATOMIC_RELEASE);
+    return (uint64_t)w;
+}
+
+static gpointer capture_recorder_run(gpointer data) {
+    CaptureRecorder *r = (CaptureRecorder *)data;
+    gint64 last_write_us = g_get_monotonic_time();
+
+    for (;;) {
+        gboolean running = g_atomic_int_get(&r->running);
+        uint64_t head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+        if (g_atomic_int_get(&r->failed)) {
+            /* Nothing more reaches the file; keep the ring empty. */
+            __atomic_store_n(&r->tail, head, __ATOMIC_RELEASE);
+            if (!running) break;
+        }
+        uint64_t pending = head - r->tail;
+        gint64 now_us = g_get_monotonic_time();
+        if (!running && pending > 0 && g_atomic_int_get(&r->direct)) {
+            /* Closing: the last partial page goes out buffered. */
+            record_drop_direct(r);
+        }
+        if (pending > 0 && (pending >= UV_RECORD_WRITE_CHUNK || !running ||
+                            now_us - last_write_us >= (gint64)UV_RECORD_FLUSH_MS * 1000)) {
+            if (record_write(r, head) > 0) {
+                last_write_us = now_us;
+                continue;
+            }
+            if (!running && !g_atomic_int_get(&r->failed) && !g_atomic_int_get(&r->direct)) continue;
+        }
+        if (!running) break;
+
+        /* Announce the sleep, then look once more: a chunk completed
+         * before the announcement was seen has to be caught here. */
+        g_atomic_int_set(&r->sleeping, 1);
+        if (__atomic_load_n(&r->head, __ATOMIC_ACQUIRE) - r->tail < UV_RECORD_WRITE_CHUNK) {
+            struct pollfd pfd = { .fd = r->wake_fd, .events = POLLIN };
+            if (poll(&pfd, 1, UV_RECORD_FLUSH_MS) > 0) {
+                uint64_t v;
+                ssize_t rd = read(r->wake_fd, &v, sizeof(v));
+                (void)rd;
+            }
+        }
+        g_atomic_int_set(&r->sleeping, 0);
+    }
+    return NULL;
+}
+
+/* Open the file and start the writer, once; later relay restarts keep
+ * writing to the same file. Returns FALSE when capture is configured but
+ * could not start (logged); capture then stays off. */
+gboolean capture_recorder_start(CaptureRecorder *r) {
+    if (!r->path[0] || r->thread) return TRUE;
+    if (g_atomic_int_get(&r->failed)) return FALSE;
+
+    void *ring = NULL;
+    if (posix_memalign(&ring, UV_RECORD_ALIGN, r->size) != 0) {
+        uv_log_warn("Record: cannot allocate a %" G_GUINT64_FORMAT " MiB ring", r->size >> 20);
+        g_atomic_int_set(&r->failed, 1);
+        return FALSE;
+    }
+    r->fd = record_open(r);
+    r->wake_fd = r->fd >= 0 ? eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC) : -1;
+    if (r->fd < 0 || r->wake_fd < 0) {
+        uv_log_warn("Record: cannot open %s: %s", r->path, g_strerror(errno));
+        if (r->fd >= 0) close(r->fd);
+        r->fd = -1;
+        free(ring);
+        g_atomic_int_set(&r->failed, 1);
+        return FALSE;
+    }
+    /* Touch every page now so ingest never takes a fault in the ring. */
+    memset(ring, 0, r->size);
+    r->ring = ring;
+    r->start_us = g_get_monotonic_time();
+    r->rt_offset_us = g_get_real_time() - r->start_us;
+    record_put_file_header(r);
+
+    g_atomic_int_set(&r->running, 1);
+    r->thread = g_thread_new("uv-record", capture_recorder_run, r);
+    uv_log_info("Record: capturing %s to %s (%s, %" G_GUINT64_FORMAT " MiB ring%s)",
+                r->all_sources ? "all sources" : "the selected source", r->path,
+                r->format == UV_RECORD_FORMAT_RTPDUMP ? "rtpdump" : "pcap",
+                r->size >> 20, g_atomic_int_get(&r->direct) ? ", O_DIRECT" : "");
+    return TRUE;
+}
+
+/* Stop the writer once everything queued is on disk, and close the file.
+ * The caller has stopped every producer. */
+void capture_recorder_deinit(CaptureRecorder *r) {
+    if (r->thread) {
+        g_atomic_int_set(&r->running, 0);
+        uint64_t one = 1;
+        ssize_t w = write(r->wake_fd, &one, sizeof(one));
+        (void)w;
+        g_thread_join(r->thread);
+        r->thread = NULL;
+    }
+    if (r->fd >= 0) close(r->fd);
+    r->fd = -1;
+    if (r->wake_fd >= 0) close(r->wake_fd);
+    r->wake_fd = -1;
+    free(r->ring);
+    r->ring = NULL;
+}
+
+/* Queue one datagram. Called by ingest under RelayController.lock; never
+ * blocks. arrival_us is the monotonic receive time. */
+void capture_recorder_push(CaptureRecorder *r, const unsigned char *pkt, size_t len,
+                           const struct sockaddr_in *from, gint64 arrival_us) {
+    if (!r->thread || g_atomic_int_get(&r->failed)) return;
+    unsigned char hdr[RECORD_HDR_MAX];
+    size_t hlen;
+    if (r->format == UV_RECORD_FORMAT_RTPDUMP) {
+        hlen = 8;
+        put_be16(hdr, (uint16_t)(hlen + len));
+        put_be16(hdr + 2, (uint16_t)len);
+        put_be32(hdr + 4, (uint32_t)((arrival_us - r->start_us) / 1000));
+    } else {
+        gint64 rt_us = arrival_us + r->rt_offset_us;
+        uint32_t rec[4] = {
+            (uint32_t)(rt_us / G_USEC_PER_SEC), (uint32_t)(rt_us % G_USEC_PER_SEC),
+            (uint32_t)(len + RECORD_IP_UDP_LEN), (uint32_t)(len + RECORD_IP_UDP_LEN),
+        };
+        memcpy(hdr, rec, sizeof(rec));
+        unsigned char *ip = hdr + 16;
+        memset(ip, 0, RECORD_IP_UDP_LEN);
+        ip[0] = 0x45;
+        put_be16(ip + 2, (uint16_t)(len + RECORD_IP_UDP_LEN));
+        put_be16(ip + 6, 0x4000);        /* DF */
+        ip[8] = 64;
+        ip[9] = IPPROTO_UDP;
+        memcpy(ip + 12, &from->sin_addr.s_addr, 4);
+        uint32_t sum = 0;
+        for (guint i = 0; i < 20; i += 2) sum += (uint32_t)(ip[i] << 8 | ip[i + 1]);
+        while (sum >> 16) sum = (sum & 0xffffu) + (sum >> 16);
+        put_be16(ip + 10, (uint16_t)~sum);
+        unsigned char *udp = ip + 20;
+        memcpy(udp, &from->sin_port, 2);
+        put_be16(udp + 2, r->listen_port);
+        put_be16(udp + 4, (uint16_t)(len + 8));
+        hlen = 16 + RECORD_IP_UDP_LEN;
+    }
+
+    uint64_t need = hlen + len;
+    uint64_t used = r->head - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+    if (len > RECORD_DATAGRAM_MAX || used + need > r->size) {
+        record_count(&r->dropped, 1);
+        record_count(&r->dropped_bytes, len);
+        return;
+    }
+    record_ring_put(r, r->head, hdr, hlen);
+    record_ring_put(r, r->head + hlen, pkt, len);
+    record_count(&r->records, 1);
+    record_count(&r->bytes, need);
+    if (used + need > r->backlog_peak) __atomic_store_n(&r->backlog_peak, used + need, __ATOMIC_RELAXED);
+    __atomic_store_n(&r->head, r->head + need, __ATOMIC_RELEASE);
+}
+
+/* Wake the writer after a batch was queued, once a write chunk is waiting.
+ * Returns TRUE when that took a syscall. */
+gboolean capture_recorder_kick(CaptureRecorder *r) {
+    if (r->wake_fd < 0) return FALSE;
+    if (r->head - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE) < UV_RECORD_WRITE_CHUNK) return FALSE;
+    if (!g_atomic_int_compare_and_exchange(&r->sleeping, 1, 0)) return FALSE;
+    uint64_t one = 1;
+    ssize_t w = write(r->wake_fd, &one, sizeof(one));
+    (void)w;
+    return TRUE;
+}
+
+void capture_recorder_snapshot(CaptureRecorder *r, UvRecordStats *out) {
+    memset(out, 0, sizeof(*out));
+    out->enabled = r->path[0] != '\0';
+    if (!out->enabled) return;
+    g_strlcpy(out->path, r->path, sizeof(out->path));
+    out->format = r->format;
+    out->all_sources = r->all_sources;
+    out->failed = g_atomic_int_get(&r->failed) != 0;
+    out->active = g_atomic_int_get(&r->running) && !out->failed;
+    out->direct = g_atomic_int_get(&r->direct) != 0;
+    out->ring_bytes = r->size;
+    uint64_t tail = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+    out->backlog_bytes = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE) - tail;
+    out->backlog_peak = record_read(&r->backlog_peak);
+    out->records = record_read(&r->records);
+    out->bytes = record_read(&r->bytes);
+    out->dropped = record_read(&r->dropped);
+    out->dropped_bytes = record_read(&r->dropped_bytes);
+    out->bytes_written = record_read(&r->bytes_written);
+    out->write_calls = record_read(&r->write_calls);
+    out->write_errors = record_read(&r->write_errors);
+    uint64_t write_ns = record_read(&r->write_ns_total);
+    out->write_us_avg = out->write_calls ? (double)write_ns / 1000.0 / (double)out->write_calls : 0.0;
+    out->write_us_max = (double)record_read(&r->write_ns_max) / 1000.0;
+    out->write_mib_s = write_ns ? (double)out->bytes_written / (1024.0 * 1024.0) / ((double)write_ns / 1e9) : 0.0;
+}
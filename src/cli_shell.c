@@ -28,6 +28,23 @@ static void format_bitrate(double bps, char *out, size_t outlen) {
     }
 }
 
+static const char *relay_backend_name(UvRelayBackend backend) {
+    switch (backend) {
+    case UV_RELAY_BACKEND_PACKET_RING: return "packet-ring";
+    case UV_RELAY_BACKEND_IO_URING: return "io-uring";
+    case UV_RELAY_BACKEND_REPLAY: return "replay";
+    default: return "socket";
+    }
+}
+
+static const char *direct_au_loss_name(UvDirectAuLoss loss) {
+    switch (loss) {
+    case UV_DIRECT_AU_LOSS_DROP_AU: return "drop-au";
+    case UV_DIRECT_AU_LOSS_WAIT_IRAP: return "wait-irap";
+    default: return "pass";
+    }
+}
+
 static void print_sources(UvViewer *viewer) {
     UvViewerStats stats = {0};
     uv_viewer_stats_init(&stats);
@@ -50,6 +67,26 @@ static void print_sources(UvViewer *viewer) {
     uv_viewer_stats_clear(&stats);
 }
 
+static void print_latency(const UvLatencyStats *lat) {
+    static const char *names[UV_LATENCY_STAGE_COUNT] = {
+        "appsrc", "depay", "parser", "decoder", "queue_postdec", "sink", "total"
+    };
+    if (!lat->enabled) return;
+    g_print("latency: traced=%" G_GUINT64_FORMAT " lost=%" G_GUINT64_FORMAT
+            " (hist bucket i counts frames under 2^i ms)\n",
+            lat->frames_traced, lat->frames_lost);
+    for (guint s = 0; s < UV_LATENCY_STAGE_COUNT; s++) {
+        const UvLatencyStageStats *st = &lat->stage[s];
+        if (st->frames == 0) continue;
+        g_print("latency %s: frames=%" G_GUINT64_FORMAT " avg=%.2fms p50=%.2fms p95=%.2fms max=%.2fms hist=",
+                names[s], st->frames, st->avg_ms, st->p50_ms, st->p95_ms, st->max_ms);
+        for (guint b = 0; b < UV_LATENCY_BUCKETS; b++) {
+            g_print("%s%" G_GUINT64_FORMAT, b ? "/" : "", st->hist[b]);
+        }
+        g_print("\n");
+    }
+}
+
 static void print_qos(const UvViewerStats *stats) {
     if (!stats->qos_entries || stats->qos_entries->len == 0) {
         g_print("QoS: (no messages yet)\n");
@@ -101,7 +138,8 @@ static void print_stats(UvViewer *viewer, int clock_rate) {
                     " rate=%s last_seen=%.1fs"
                     " | rtp_unique=%" G_GUINT64_FORMAT " expected=%" G_GUINT64_FORMAT
                     " lost=%" G_GUINT64_FORMAT " dup=%" G_GUINT64_FORMAT
-                    " reorder=%" G_GUINT64_FORMAT " marker_frames=%" G_GUINT64_FORMAT
+                    " reorder=%" G_GUINT64_FORMAT " window_lost=%" G_GUINT64_FORMAT
+                    " marker_frames=%" G_GUINT64_FORMAT
                     " input_fps=%.2f jitter=%.2fms\n",
                     i,
                     s->selected ? "*" : "",
@@ -117,12 +155,149 @@ static void print_stats(UvViewer *viewer, int clock_rate) {
                     s->rtp_lost_packets,
                     s->rtp_duplicate_packets,
                     s->rtp_reordered_packets,
+                    s->rtp_window_lost_packets,
                     s->rtp_marker_frames,
                     s->rtp_marker_fps,
                     jitter_ms);
         }
     }
 
+    g_print("relay: backend=%s recv_batch=%u batches=%" G_GUINT64_FORMAT " datagrams=%" G_GUINT64_FORMAT
+            " avg=%.1f last=%u peak=%u\n",
+            relay_backend_name(stats.ingest.backend),
+            stats.ingest.recv_batch_size,
+            stats.ingest.recv_batches,
+            stats.ingest.recv_datagrams,
+            stats.ingest.recv_batch_avg,
+            stats.ingest.recv_batch_last,
+            stats.ingest.recv_batch_peak);
+    g_print("relay pool: buffers=%u size=%u allocated=%" G_GUINT64_FORMAT
+            " recycled=%" G_GUINT64_FORMAT " copies=%" G_GUINT64_FORMAT "\n",
+            stats.ingest.pool_buffers,
+            stats.ingest.pool_buffer_size,
+            stats.ingest.pool_allocated,
+            stats.ingest.pool_recycled,
+            stats.ingest.pool_copies);
+    const UvLockStats *locks[2] = {&stats.ingest.registry_lock, &stats.ingest.source_lock};
+    const char *lock_names[2] = {"registry", "source"};
+    for (int i = 0; i < 2; i++) {
+        g_print("relay %s lock: takes=%" G_GUINT64_FORMAT " contended=%" G_GUINT64_FORMAT
+                " wait avg=%.0fns max=%" G_GUINT64_FORMAT "ns\n",
+                lock_names[i],
+                locks[i]->acquisitions,
+                locks[i]->contended,
+                locks[i]->wait_ns_avg,
+                locks[i]->wait_ns_max);
+    }
+    g_print("relay sources: used=%u/%u lookups=%" G_GUINT64_FORMAT " probes/lookup=%.2f"
+            " evicted=%" G_GUINT64_FORMAT " rejected=%" G_GUINT64_FORMAT "\n",
+            stats.ingest.sources_used,
+            stats.ingest.sources_max,
+            stats.ingest.source_lookups,
+            stats.ingest.source_probe_avg,
+            stats.ingest.source_evictions,
+            stats.ingest.source_rejects);
+    for (guint i = 0; i < stats.ingest.workers; i++) {
+        const UvRelayWorkerStats *w = &stats.ingest.worker[i];
+        g_print("relay worker %u: cpu=%d pps=%.0f datagrams=%" G_GUINT64_FORMAT
+                " batches=%" G_GUINT64_FORMAT " drops=%" G_GUINT64_FORMAT
+                " stamps=%s rx_delay median=%.1fus max=%.1fus\n",
+                i, w->cpu, w->pps, w->datagrams, w->batches, w->kernel_drops,
+                w->kernel_timestamps ? "kernel" : "user",
+                w->rx_delay_median_us, w->rx_delay_max_us);
+        g_print("relay worker %u loop: backend=%s syscalls=%" G_GUINT64_FORMAT " (%.3f/datagram)"
+                " batch avg=%.1fus max=%.1fus buffer_stalls=%" G_GUINT64_FORMAT
+                " analytics_overruns=%" G_GUINT64_FORMAT "\n",
+                i, relay_backend_name(w->backend), w->syscalls, w->syscalls_per_datagram,
+                w->batch_us_avg, w->batch_us_max, w->buffer_stalls, w->analytics_overruns);
+    }
+    g_print("relay analytics: %s ring=%u records=%" G_GUINT64_FORMAT " backlog=%u"
+            " overruns=%" G_GUINT64_FORMAT "\n",
+            stats.ingest.analytics_thread ? "thread" : "inline",
+            stats.ingest.analytics_ring_size,
+            stats.ingest.analytics_records,
+            stats.ingest.analytics_backlog,
+            stats.ingest.analytics_overruns);
+    if (stats.ingest.backend == UV_RELAY_BACKEND_REPLAY) {
+        g_print("relay replay: %s%s datagrams=%" G_GUINT64_FORMAT " skipped=%" G_GUINT64_FORMAT
+                " capture=%.1fs wall=%.1fs (%.1fx)\n",
+                stats.ingest.replay_finished ? "finished" : "running",
+                stats.ingest.replay_fast ? " fast" : "",
+                stats.ingest.replay_datagrams, stats.ingest.replay_skipped,
+                stats.ingest.replay_capture_s, stats.ingest.replay_wall_s,
+                stats.ingest.replay_wall_s > 0.0 ? stats.ingest.replay_capture_s / stats.ingest.replay_wall_s : 0.0);
+    }
+    if (stats.ingest.gop_cache_kb > 0) {
+        g_print("relay gop cache: cap=%uKiB sources=%u held=%.1fKiB overflows=%" G_GUINT64_FORMAT
+                " flushes=%" G_GUINT64_FORMAT " last=%u frames/%u pkts/%" G_GUINT64_FORMAT " bytes\n",
+                stats.ingest.gop_cache_kb, stats.ingest.gop_cache_sources,
+                (double)stats.ingest.gop_cache_bytes / 1024.0, stats.ingest.gop_cache_overflows,
+                stats.ingest.gop_flushes, stats.ingest.gop_flush_frames,
+                stats.ingest.gop_flush_packets, stats.ingest.gop_flush_bytes);
+        for (guint i = 0; i < stats.sources->len; i++) {
+            const UvSourceStats *s = &g_array_index(stats.sources, UvSourceStats, i);
+            if (s->gop_cache_bytes == 0) continue;
+            g_print("  [%u] %s gop=%.1fKiB\n", i, s->address, (double)s->gop_cache_bytes / 1024.0);
+        }
+    }
+    if (stats.ingest.direct_au) {
+        g_print("relay direct au: loss=%s aus=%" G_GUINT64_FORMAT " bytes=%" G_GUINT64_FORMAT
+                " partial=%" G_GUINT64_FORMAT " dropped=%" G_GUINT64_FORMAT
+                " nals_dropped=%" G_GUINT64_FORMAT " lost_pkts=%" G_GUINT64_FORMAT
+                " late_pkts=%" G_GUINT64_FORMAT "\n",
+                direct_au_loss_name(stats.ingest.direct_au_loss),
+                stats.ingest.direct_aus, stats.ingest.direct_au_bytes,
+                stats.ingest.direct_au_partial, stats.ingest.direct_au_dropped,
+                stats.ingest.direct_nals_dropped, stats.ingest.direct_lost_packets,
+                stats.ingest.direct_late_packets);
+    }
+    if (stats.ingest.hold_enabled) {
+        g_print("relay marker release: latency=%ums frames=%" G_GUINT64_FORMAT " timeouts=%" G_GUINT64_FORMAT
+                " hold avg=%.2fms max=%.2fms saved avg=%.2fms/frame lost_pkts=%" G_GUINT64_FORMAT
+                " late_pkts=%" G_GUINT64_FORMAT " overflows=%" G_GUINT64_FORMAT "\n",
+                stats.ingest.hold_latency_ms, stats.ingest.hold_frames, stats.ingest.hold_timeouts,
+                stats.ingest.hold_avg_ms, stats.ingest.hold_max_ms, stats.ingest.hold_saved_avg_ms,
+                stats.ingest.hold_lost_packets, stats.ingest.hold_late_packets,
+                stats.ingest.hold_overflows);
+    }
+    if (stats.restream.enabled) {
+        if (stats.restream.pace_spread > 0.0) {
+            g_print("restream pacing: spread=%.2f of frame period=%.2fms\n",
+                    stats.restream.pace_spread, stats.restream.frame_period_ms);
+        }
+        for (guint i = 0; i < stats.restream.target_count; i++) {
+            const UvRestreamTargetStats *t = &stats.restream.targets[i];
+            g_print("restream %u -> %s:%u: tx=%" G_GUINT64_FORMAT " pkts / %" G_GUINT64_FORMAT " bytes"
+                    " errors=%" G_GUINT64_FORMAT " dropped=%" G_GUINT64_FORMAT
+                    " queue=%u/%u peak=%u sendmmsg=%" G_GUINT64_FORMAT
+                    " delay avg=%.0fus max=%.0fus\n",
+                    i, t->address, t->port, t->tx_packets, t->tx_bytes, t->tx_errors, t->dropped,
+                    t->queued, t->queue_depth, t->queue_peak, t->send_calls,
+                    t->delay_us_avg, t->delay_us_max);
+        }
+    }
+    if (stats.record.enabled) {
+        g_print("record %s: %s%s records=%" G_GUINT64_FORMAT " dropped=%" G_GUINT64_FORMAT
+                " written=%" G_GUINT64_FORMAT " bytes in %" G_GUINT64_FORMAT " writes"
+                " (avg=%.0fus max=%.0fus %.1fMiB/s) backlog=%" G_GUINT64_FORMAT "/%" G_GUINT64_FORMAT
+                " peak=%" G_GUINT64_FORMAT " errors=%" G_GUINT64_FORMAT "\n",
+                stats.record.path,
+                stats.record.failed ? "failed" : stats.record.active ? "active" : "idle",
+                stats.record.direct ? " O_DIRECT" : "",
+                stats.record.records, stats.record.dropped,
+                stats.record.bytes_written, stats.record.write_calls,
+                stats.record.write_us_avg, stats.record.write_us_max, stats.record.write_mib_s,
+                stats.record.backlog_bytes, stats.record.ring_bytes, stats.record.backlog_peak,
+                stats.record.write_errors);
+    }
+    g_print("stats snapshot: calls=%" G_GUINT64_FORMAT " last=%.0fus avg=%.1fus max=%.0fus"
+            " retries=%" G_GUINT64_FORMAT "\n",
+            stats.snapshot.snapshots,
+            stats.snapshot.last_us,
+            stats.snapshot.avg_us,
+            stats.snapshot.max_us,
+            stats.snapshot.reader_retries);
+
     g_print("---- Pipeline ----\n");
     if (stats.queue0_valid) {
         g_print("queue0: level buffers=%d bytes=%u time=%.1fms\n",
@@ -147,6 +322,15 @@ static void print_stats(UvViewer *viewer, int clock_rate) {
         g_print("\n");
     }
 
+    if (stats.reconfig.updates > 0 || stats.reconfig.pending || stats.reconfig.failures > 0) {
+        g_print("live updates: %u%s%s last=[%s] %.2fms frames_lost=%" G_GUINT64_FORMAT
+                " max=%.2fms lost_total=%" G_GUINT64_FORMAT " failed_relinks=%u\n",
+                stats.reconfig.updates, stats.reconfig.pending ? " (relink pending)" : "",
+                stats.reconfig.failed ? " (last relink failed, restart needed)" : "",
+                stats.reconfig.last_change, stats.reconfig.last_ms, stats.reconfig.last_frames_lost,
+                stats.reconfig.max_ms, stats.reconfig.frames_lost_total, stats.reconfig.failures);
+    }
+    print_latency(&stats.latency);
     print_qos(&stats);
     uv_viewer_stats_clear(&stats);
     (void)clock_rate;
@@ -4179,35 +4179,89 @@ static gboolean gui_restart_with_config(GuiContext *ctx, const UvViewerConfig *c
     return gui_restart_with_config_ex(ctx, cfg, FALSE);
 }
 
+/* TRUE when a and b would build the same viewer. */
+static gboolean gui_config_same(const UvViewerConfig *a, const UvViewerConfig *b) {
+    return a->listen_port == b->listen_port &&
+           a->sync_to_clock == b->sync_to_clock &&
+           a->jitter_latency_ms == b->jitter_latency_ms &&
+           a->queue_max_buffers == b->queue_max_buffers &&
+           a->videorate_enabled == b->videorate_enabled &&
+           a->videorate_fps_numerator == b->videorate_fps_numerator &&
+           a->videorate_fps_denominator == b->videorate_fps_denominator &&
+           a->decoder_preference == b->decoder_preference &&
+           a->video_sink_preference == b->video_sink_preference &&
+           a->audio_enabled == b->audio_enabled &&
+           a->audio_payload_type == b->audio_payload_type &&
+           a->audio_clock_rate == b->audio_clock_rate &&
+           a->audio_jitter_latency_ms == b->audio_jitter_latency_ms &&
+           a->audio_use_separate_port == b->audio_use_separate_port &&
+           a->audio_listen_port == b->audio_listen_port &&
+           a->shm_enabled == b->shm_enabled &&
+           g_strcmp0(a->shm_name, b->shm_name) == 0 &&
+           a->jitter_drop_on_latency == b->jitter_drop_on_latency &&
+           a->jitter_do_lost == b->jitter_do_lost &&
+           a->jitter_post_drop_messages == b->jitter_post_drop_messages;
+}
+
+/* Settings the running pipeline takes in place (jitter latency, ingress
+ * queue limit, sink sync, videorate): when nothing else changed, apply
+ * them through uv_viewer_update_pipeline() and keep the viewer, so the
+ * decoder keeps its state. FALSE means a restart is needed. */
+static gboolean gui_apply_live(GuiContext *ctx, const UvViewerConfig *cfg) {
+    const UvViewerConfig *cur = &ctx->current_cfg;
+    UvViewerConfig rest = *cfg;
+    rest.jitter_latency_ms = cur->jitter_latency_ms;
+    rest.queue_max_buffers = cur->queue_max_buffers;
+    rest.sync_to_clock = cur->sync_to_clock;
+    rest.videorate_enabled = cur->videorate_enabled;
+    rest.videorate_fps_numerator = cur->videorate_fps_numerator;
+    rest.videorate_fps_denominator = cur->videorate_fps_denominator;
+    if (!gui_config_same(&rest, cur)) return FALSE;
+
+    UvPipelineOverrides overrides = {0};
+    overrides.set_jitter_latency = cfg->jitter_latency_ms != cur->jitter_latency_ms;
+    overrides.jitter_latency_ms = cfg->jitter_latency_ms;
+    overrides.set_queue_max_buffers = cfg->queue_max_buffers != cur->queue_max_buffers;
+    overrides.queue_max_buffers = cfg->queue_max_buffers;
+    overrides.set_sync = cfg->sync_to_clock != cur->sync_to_clock;
+    overrides.sync_to_clock = cfg->sync_to_clock;
+    overrides.set_videorate = cfg->videorate_enabled != cur->videorate_enabled ||
+                              cfg->videorate_fps_numerator != cur->videorate_fps_numerator ||
+                              cfg->videorate_fps_denominator != cur->videorate_fps_denominator;
+    overrides.videorate_enabled = cfg->videorate_enabled;
+    overrides.videorate_fps_numerator = cfg->videorate_fps_numerator;
+    overrides.videorate_fps_denominator = cfg->videorate_fps_denominator;
+
+    GError *error = NULL;
+    if (!uv_viewer_update_pipeline(ctx->viewer, &overrides, &error)) {
+        uv_log_warn("Live settings update failed (%s); restarting the viewer",
+                    error ? error->message : "unknown error");
+        if (error) g_error_free(error);
+        return FALSE;
+    }
+    ctx->current_cfg = *cfg;
+    if (ctx->cfg_slot) {
+        *ctx->cfg_slot = *cfg;
+    }
+    update_info_label(ctx);
+    sync_settings_controls(ctx);
+    refresh_stats(ctx);
+    update_status(ctx, "Settings applied live");
+    return TRUE;
+}
+
 static gboolean gui_restart_with_config_ex(GuiContext *ctx,
                                             const UvViewerConfig *cfg,
                                             gboolean force_restart) {
     if (!ctx || !ctx->viewer || !cfg) return FALSE;
 
-    if (!force_restart &&
-        cfg->listen_port == ctx->current_cfg.listen_port &&
-        cfg->sync_to_clock == ctx->current_cfg.sync_to_clock &&
-        cfg->jitter_latency_ms == ctx->current_cfg.jitter_latency_ms &&
-        cfg->queue_max_buffers == ctx->current_cfg.queue_max_buffers &&
-        cfg->videorate_enabled == ctx->current_cfg.videorate_enabled &&
-        cfg->videorate_fps_numerator == ctx->current_cfg.videorate_fps_numerator &&
-        cfg->videorate_fps_denominator == ctx->current_cfg.videorate_fps_denominator &&
-        cfg->decoder_preference == ctx->current_cfg.decoder_preference &&
-        cfg->video_sink_preference == ctx->current_cfg.video_sink_preference &&
-        cfg->audio_enabled == ctx->current_cfg.audio_enabled &&
-        cfg->audio_payload_type == ctx->current_cfg.audio_payload_type &&
-        cfg->audio_clock_rate == ctx->current_cfg.audio_clock_rate &&
-        cfg->audio_jitter_latency_ms == ctx->current_cfg.audio_jitter_latency_ms &&
-        cfg->audio_use_separate_port == ctx->current_cfg.audio_use_separate_port &&
-        cfg->audio_listen_port == ctx->current_cfg.audio_listen_port &&
-        cfg->shm_enabled == ctx->current_cfg.shm_enabled &&
-        g_strcmp0(cfg->shm_name, ctx->current_cfg.shm_name) == 0 &&
-        cfg->jitter_drop_on_latency == ctx->current_cfg.jitter_drop_on_latency &&
-        cfg->jitter_do_lost == ctx->current_cfg.jitter_do_lost &&
-        cfg->jitter_post_drop_messages == ctx->current_cfg.jitter_post_drop_messages) {
+    if (!force_restart && gui_config_same(cfg, &ctx->current_cfg)) {
         update_status(ctx, "Settings unchanged");
         return TRUE;
     }
+    if (!force_restart && gui_apply_live(ctx, cfg)) {
+        return TRUE;
+    }
 
     UvViewer *old_viewer = ctx->viewer;
     uv_viewer_set_event_callback(old_viewer, NULL, NULL);
@@ -4732,11 +4786,14 @@ static void update_restream_status_label(GuiContext *ctx, const UvRestreamStats
     } else if (!rs->active) {
         g_snprintf(line, sizeof(line), "Restream: enabled (no valid destination)");
     } else {
+        char more[32] = "";
+        if (rs->target_count > 1) g_snprintf(more, sizeof(more), " +%u", rs->target_count - 1);
         g_snprintf(line, sizeof(line),
-                   "Restream \xE2\x86\x92 %s:%u   tx=%" G_GUINT64_FORMAT " pkts / %.1f MB%s",
-                   rs->address, rs->port, rs->tx_packets,
+                   "Restream \xE2\x86\x92 %s:%u%s   tx=%" G_GUINT64_FORMAT " pkts / %.1f MB%s%s",
+                   rs->address, rs->port, more, rs->tx_packets,
                    (double)rs->tx_bytes / (1024.0 * 1024.0),
-                   rs->tx_errors ? "   (send errors)" : "");
+                   rs->tx_errors ? "   (send errors)" : "",
+                   rs->dropped ? "   (queue drops)" : "");
     }
     gtk_label_set_text(ctx->restream_status_label, line);
 }
@@ -12,8 +12,22 @@ static void print_usage(const char *argv0) {
                " [--decoder auto|intel|nvidia|vaapi|software]"
                " [--video-sink auto|gtk4|wayland|gl|xv|autovideo|fakesink]"
                " [--idr-port N] [--sidecar] [--no-sidecar] [--sidecar-port N]"
-               " [--restream HOST:PORT] [--no-restream]"
-               " [--shm] [--no-shm] [--shm-name NAME]\n",
+               " [--restream HOST:PORT]... [--no-restream] [--restream-queue N]"
+               " [--restream-pace FRACTION] [--no-restream-pace]"
+               " [--shm] [--no-shm] [--shm-name NAME] [--shm-zero-copy] [--no-shm-zero-copy]"
+               " [--shm-inflight N]"
+               " [--recv-batch N]"
+               " [--relay-pool N] [--max-sources N]"
+               " [--relay-workers N] [--relay-pin] [--no-relay-pin]"
+               " [--kernel-timestamps] [--no-kernel-timestamps]"
+               " [--relay-backend socket|packet-ring|io-uring] [--ring-if IFNAME]"
+               " [--analytics-ring N]"
+               " [--record FILE] [--record-format pcap|rtpdump] [--record-all]"
+               " [--record-buffer MB] [--record-direct]"
+               " [--replay FILE] [--replay-fast] [--replay-decode]"
+               " [--latency-trace] [--gop-cache KB]"
+               " [--direct-au] [--direct-au-loss pass|drop-au|wait-irap]"
+               " [--marker-release]\n",
                argv0);
 }
 
@@ -188,7 +202,9 @@ static gboolean parse_args(int argc, char **argv, UvViewerConfig *cfg) {
             }
             cfg->sidecar_port = (guint)port;
         } else if (!strcmp(argv[i], "--restream") && i + 1 < argc) {
-            /* HOST:PORT — verbatim UDP forward of the selected source. */
+            /* HOST:PORT — verbatim UDP forward of the selected source. The
+             * first one is the primary destination; each further one adds
+             * a fan-out destination. */
             const char *spec = argv[++i];
             const char *colon = strrchr(spec, ':');
             if (!colon || colon == spec) {
@@ -205,12 +221,40 @@ static gboolean parse_args(int argc, char **argv, UvViewerConfig *cfg) {
                 g_printerr("--restream host too long: %s\n", spec);
                 return FALSE;
             }
-            memcpy(cfg->restream_address, spec, hostlen);
-            cfg->restream_address[hostlen] = '\0';
-            cfg->restream_port = (guint16)port;
+            char *host = cfg->restream_address;
+            guint16 *host_port = &cfg->restream_port;
+            if (cfg->restream_enabled) {
+                if (cfg->restream_extra_count >= G_N_ELEMENTS(cfg->restream_extra)) {
+                    g_printerr("Too many --restream destinations (max %u)\n", UV_RESTREAM_TARGETS_MAX);
+                    return FALSE;
+                }
+                UvRestreamTarget *extra = &cfg->restream_extra[cfg->restream_extra_count++];
+                host = extra->address;
+                host_port = &extra->port;
+            }
+            memcpy(host, spec, hostlen);
+            host[hostlen] = '\0';
+            *host_port = (guint16)port;
             cfg->restream_enabled = TRUE;
         } else if (!strcmp(argv[i], "--no-restream")) {
             cfg->restream_enabled = FALSE;
+            cfg->restream_extra_count = 0;
+        } else if (!strcmp(argv[i], "--restream-queue") && i + 1 < argc) {
+            int depth = atoi(argv[++i]);
+            if (depth < 1 || depth > (int)UV_RESTREAM_QUEUE_MAX) {
+                g_printerr("Invalid restream queue depth (1-%u): %s\n", UV_RESTREAM_QUEUE_MAX, argv[i]);
+                return FALSE;
+            }
+            cfg->restream_queue_depth = (guint)depth;
+        } else if (!strcmp(argv[i], "--restream-pace") && i + 1 < argc) {
+            double spread = g_ascii_strtod(argv[++i], NULL);
+            if (!(spread > 0.0 && spread <= 1.0)) {
+                g_printerr("Invalid restream pace fraction (0-1]: %s\n", argv[i]);
+                return FALSE;
+            }
+            cfg->restream_pace_spread = spread;
+        } else if (!strcmp(argv[i], "--no-restream-pace")) {
+            cfg->restream_pace_spread = 0.0;
         } else if (!strcmp(argv[i], "--shm")) {
             cfg->shm_enabled = TRUE;
         } else if (!strcmp(argv[i], "--no-shm")) {
@@ -223,6 +267,145 @@ static gboolean parse_args(int argc, char **argv, UvViewerConfig *cfg) {
             }
             g_strlcpy(cfg->shm_name, name, sizeof(cfg->shm_name));
             cfg->shm_enabled = TRUE;
+        } else if (!strcmp(argv[i], "--shm-zero-copy")) {
+            cfg->shm_zero_copy = TRUE;
+        } else if (!strcmp(argv[i], "--no-shm-zero-copy")) {
+            cfg->shm_zero_copy = FALSE;
+        } else if (!strcmp(argv[i], "--shm-inflight") && i + 1 < argc) {
+            int inflight = atoi(argv[++i]);
+            if (inflight < 1) {
+                g_printerr("Invalid SHM in-flight slot count: %s\n", argv[i]);
+                return FALSE;
+            }
+            cfg->shm_max_inflight = (guint)inflight;
+        } else if (!strcmp(argv[i], "--recv-batch") && i + 1 < argc) {
+            int batch = atoi(argv[++i]);
+            if (batch < 1 || batch > (int)UV_RELAY_BATCH_MAX) {
+                g_printerr("Invalid receive batch (1-%u): %s\n", UV_RELAY_BATCH_MAX, argv[i]);
+                return FALSE;
+            }
+            cfg->relay_batch_size = (guint)batch;
+        } else if (!strcmp(argv[i], "--relay-pool") && i + 1 < argc) {
+            int buffers = atoi(argv[++i]);
+            if (buffers < 0) {
+                g_printerr("Invalid relay pool size: %s\n", argv[i]);
+                return FALSE;
+            }
+            cfg->relay_pool_buffers = (guint)buffers;
+        } else if (!strcmp(argv[i], "--max-sources") && i + 1 < argc) {
+            int sources = atoi(argv[++i]);
+            if (sources < 1 || sources > (int)UV_RELAY_SOURCES_MAX) {
+                g_printerr("Invalid source limit (1-%u): %s\n", UV_RELAY_SOURCES_MAX, argv[i]);
+                return FALSE;
+            }
+            cfg->relay_max_sources = (guint)sources;
+        } else if (!strcmp(argv[i], "--relay-workers") && i + 1 < argc) {
+            int workers = atoi(argv[++i]);
+            if (workers < 1 || workers > (int)UV_RELAY_WORKERS_MAX) {
+                g_printerr("Invalid relay worker count (1-%u): %s\n", UV_RELAY_WORKERS_MAX, argv[i]);
+                return FALSE;
+            }
+            cfg->relay_workers = (guint)workers;
+        } else if (!strcmp(argv[i], "--relay-pin")) {
+            cfg->relay_pin_workers = TRUE;
+        } else if (!strcmp(argv[i], "--no-relay-pin")) {
+            cfg->relay_pin_workers = FALSE;
+        } else if (!strcmp(argv[i], "--kernel-timestamps")) {
+            cfg->relay_kernel_timestamps = TRUE;
+        } else if (!strcmp(argv[i], "--no-kernel-timestamps")) {
+            cfg->relay_kernel_timestamps = FALSE;
+        } else if (!strcmp(argv[i], "--relay-backend") && i + 1 < argc) {
+            const char *backend = argv[++i];
+            if (g_ascii_strcasecmp(backend, "socket") == 0) {
+                cfg->relay_backend = UV_RELAY_BACKEND_SOCKET;
+            } else if (g_ascii_strcasecmp(backend, "packet-ring") == 0 ||
+                       g_ascii_strcasecmp(backend, "ring") == 0) {
+                cfg->relay_backend = UV_RELAY_BACKEND_PACKET_RING;
+            } else if (g_ascii_strcasecmp(backend, "io-uring") == 0 ||
+                       g_ascii_strcasecmp(backend, "uring") == 0) {
+                cfg->relay_backend = UV_RELAY_BACKEND_IO_URING;
+            } else {
+                g_printerr("Unknown relay backend: %s\n", backend);
+                return FALSE;
+            }
+        } else if (!strcmp(argv[i], "--ring-if") && i + 1 < argc) {
+            const char *ifname = argv[++i];
+            if (!ifname[0] || strlen(ifname) >= sizeof(cfg->relay_ring_ifname)) {
+                g_printerr("Invalid ring interface: %s\n", ifname);
+                return FALSE;
+            }
+            g_strlcpy(cfg->relay_ring_ifname, ifname, sizeof(cfg->relay_ring_ifname));
+        } else if (!strcmp(argv[i], "--analytics-ring") && i + 1 < argc) {
+            int records = atoi(argv[++i]);
+            if (records < 1 || records > (int)UV_RELAY_ANALYTICS_RING_MAX) {
+                g_printerr("Invalid analytics ring size (1-%u): %s\n", UV_RELAY_ANALYTICS_RING_MAX, argv[i]);
+                return FALSE;
+            }
+            cfg->relay_analytics_ring = (guint)records;
+        } else if (!strcmp(argv[i], "--record") && i + 1 < argc) {
+            const char *path = argv[++i];
+            if (!path[0] || strlen(path) >= sizeof(cfg->record_path)) {
+                g_printerr("Invalid record path: %s\n", path);
+                return FALSE;
+            }
+            g_strlcpy(cfg->record_path, path, sizeof(cfg->record_path));
+        } else if (!strcmp(argv[i], "--record-format") && i + 1 < argc) {
+            const char *format = argv[++i];
+            if (g_ascii_strcasecmp(format, "pcap") == 0) {
+                cfg->record_format = UV_RECORD_FORMAT_PCAP;
+            } else if (g_ascii_strcasecmp(format, "rtpdump") == 0) {
+                cfg->record_format = UV_RECORD_FORMAT_RTPDUMP;
+            } else {
+                g_printerr("Unknown record format: %s\n", format);
+                return FALSE;
+            }
+        } else if (!strcmp(argv[i], "--record-all")) {
+            cfg->record_all_sources = TRUE;
+        } else if (!strcmp(argv[i], "--record-buffer") && i + 1 < argc) {
+            int mb = atoi(argv[++i]);
+            if (mb < 1 || mb > (int)UV_RECORD_BUFFER_MAX_MB) {
+                g_printerr("Invalid record buffer size in MiB (1-%u): %s\n", UV_RECORD_BUFFER_MAX_MB, argv[i]);
+                return FALSE;
+            }
+            cfg->record_buffer_mb = (guint)mb;
+        } else if (!strcmp(argv[i], "--record-direct")) {
+            cfg->record_direct = TRUE;
+        } else if (!strcmp(argv[i], "--replay") && i + 1 < argc) {
+            const char *path = argv[++i];
+            if (!path[0] || strlen(path) >= sizeof(cfg->replay_path)) {
+                g_printerr("Invalid replay path: %s\n", path);
+                return FALSE;
+            }
+            g_strlcpy(cfg->replay_path, path, sizeof(cfg->replay_path));
+        } else if (!strcmp(argv[i], "--replay-fast")) {
+            cfg->replay_fast = TRUE;
+        } else if (!strcmp(argv[i], "--replay-decode")) {
+            cfg->replay_decode = TRUE;
+        } else if (!strcmp(argv[i], "--latency-trace")) {
+            cfg->latency_trace = TRUE;
+        } else if (!strcmp(argv[i], "--gop-cache") && i + 1 < argc) {
+            int kb = atoi(argv[++i]);
+            if (kb < 0 || kb > (int)UV_GOP_CACHE_MAX_KB) {
+                g_printerr("Invalid GOP cache size in KiB (0-%u): %s\n", UV_GOP_CACHE_MAX_KB, argv[i]);
+                return FALSE;
+            }
+            cfg->gop_cache_kb = (guint)kb;
+        } else if (!strcmp(argv[i], "--direct-au")) {
+            cfg->direct_au = TRUE;
+        } else if (!strcmp(argv[i], "--direct-au-loss") && i + 1 < argc) {
+            const char *loss = argv[++i];
+            if (g_ascii_strcasecmp(loss, "pass") == 0) {
+                cfg->direct_au_loss = UV_DIRECT_AU_LOSS_PASS;
+            } else if (g_ascii_strcasecmp(loss, "drop-au") == 0) {
+                cfg->direct_au_loss = UV_DIRECT_AU_LOSS_DROP_AU;
+            } else if (g_ascii_strcasecmp(loss, "wait-irap") == 0) {
+                cfg->direct_au_loss = UV_DIRECT_AU_LOSS_WAIT_IRAP;
+            } else {
+                g_printerr("Unknown direct AU loss policy: %s\n", loss);
+                return FALSE;
+            }
+        } else if (!strcmp(argv[i], "--marker-release")) {
+            cfg->marker_release = TRUE;
         } else if (!strcmp(argv[i], "--help") || !strcmp(argv[i], "-h")) {
             print_usage(argv[0]);
             exit(EXIT_SUCCESS);
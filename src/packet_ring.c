@@ -0,0 +1,259 @@
+#define _GNU_SOURCE
+#include "uv_internal.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/filter.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <netinet/ip.h>
+#include <netinet/udp.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifndef PACKET_IGNORE_OUTGOING
+#define PACKET_IGNORE_OUTGOING 23
+#endif
+
+/* Ring geometry. Blocks must be a multiple of the page size and hold the
+ * largest datagram lo can carry (64 KiB MTU); the kernel retires a
+ * partially filled block after UV_PACKET_RING_BLOCK_TOV_MS so a slow
+ * stream is not held back waiting for the block to fill. */
+#define UV_PACKET_RING_BLOCK_SIZE (1u << 20)
+#define UV_PACKET_RING_BLOCK_NR 16u
+#define UV_PACKET_RING_FRAME_SIZE 2048u
+#define UV_PACKET_RING_BLOCK_TOV_MS 1u
+
+static struct tpacket_block_desc *packet_ring_block(const PacketRing *pr, guint index) {
+    return (struct tpacket_block_desc *)(pr->map + (gsize)index * pr->block_size);
+}
+
+/* Classic BPF over the cooked (SOCK_DGRAM) frame, which starts at the IPv4
+ * header: accept unfragmented UDP to port addressed to this host and
+ * nothing else, so the ring only ever holds relay traffic. Frames for
+ * other hosts (a promiscuous interface) and broadcast or multicast, which
+ * the UDP socket would not have joined, are refused. The ring sits below
+ * IP reassembly; a datagram the sender's path fragmented is dropped here. */
+static gboolean packet_ring_attach_filter(int fd, int port) {
+    struct sock_filter code[] = {
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, SKF_AD_OFF + SKF_AD_PKTTYPE),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, PACKET_HOST, 0, 11),
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 0),
+        BPF_STMT(BPF_ALU | BPF_AND | BPF_K, 0xf0),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0x40, 0, 8),
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 9),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_UDP, 0, 6),
+        BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 6),
+        BPF_JUMP(BPF_JMP | BPF_JSET | BPF_K, 0x3fff, 4, 0),
+        BPF_STMT(BPF_LDX | BPF_B | BPF_MSH, 0),
+        BPF_STMT(BPF_LD | BPF_H | BPF_IND, 2),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, (uint32_t)port, 0, 1),
+        BPF_STMT(BPF_RET | BPF_K, 0xffffffffu),
+        BPF_STMT(BPF_RET | BPF_K, 0),
+    };
+    struct sock_fprog prog = { .len = G_N_ELEMENTS(code), .filter = code };
+    return setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)) == 0;
+}
+
+/* The ring taps traffic below the UDP layer, so nothing would be bound to
+ * the port and every datagram would bounce an ICMP port unreachable back
+ * at the sender. A plain UDP socket holds the port; its drop-all filter
+ * keeps the kernel from queueing a second copy of each datagram there. */
+static int packet_ring_hold_port(int port) {
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    struct sock_filter drop = BPF_STMT(BPF_RET | BPF_K, 0);
+    struct sock_fprog prog = { .len = 1, .filter = &drop };
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons((uint16_t)port),
+        .sin_addr.s_addr = htonl(INADDR_ANY)
+    };
+    if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)) < 0 ||
+        bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return -1;
+    }
+    return fd;
+}
+
+gboolean packet_ring_open(PacketRing *pr, const char *ifname, int port) {
+    memset(pr, 0, sizeof(*pr));
+    pr->fd = -1;
+    pr->port_fd = -1;
+    pr->port = port;
+
+    unsigned int ifindex = 0;
+    if (ifname && ifname[0] && strcmp(ifname, "any") != 0) {
+        ifindex = if_nametoindex(ifname);
+        if (ifindex == 0) {
+            uv_log_error("Relay: packet ring interface %s: %s", ifname, g_strerror(errno));
+            return FALSE;
+        }
+    }
+
+    pr->fd = socket(AF_PACKET, SOCK_DGRAM | SOCK_CLOEXEC, htons(ETH_P_IP));
+    if (pr->fd < 0) {
+        uv_log_error("Relay: AF_PACKET socket failed: %s%s", g_strerror(errno),
+                     errno == EPERM ? " (needs CAP_NET_RAW)" : "");
+        return FALSE;
+    }
+
+    /* Filter before the ring exists so it never sees foreign traffic. */
+    if (!packet_ring_attach_filter(pr->fd, port)) {
+        uv_log_error("Relay: packet ring filter failed: %s", g_strerror(errno));
+        goto fail;
+    }
+    /* On lo every datagram passes the tap twice, once outgoing. */
+    int one = 1;
+    setsockopt(pr->fd, SOL_PACKET, PACKET_IGNORE_OUTGOING, &one, sizeof(one));
+
+    int version = TPACKET_V3;
+    if (setsockopt(pr->fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) {
+        uv_log_error("Relay: TPACKET_V3 unsupported: %s", g_strerror(errno));
+        goto fail;
+    }
+    struct tpacket_req3 req = {
+        .tp_block_size = UV_PACKET_RING_BLOCK_SIZE,
+        .tp_block_nr = UV_PACKET_RING_BLOCK_NR,
+        .tp_frame_size = UV_PACKET_RING_FRAME_SIZE,
+        .tp_frame_nr = (UV_PACKET_RING_BLOCK_SIZE / UV_PACKET_RING_FRAME_SIZE) * UV_PACKET_RING_BLOCK_NR,
+        .tp_retire_blk_tov = UV_PACKET_RING_BLOCK_TOV_MS,
+    };
+    if (setsockopt(pr->fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0) {
+        uv_log_error("Relay: PACKET_RX_RING failed: %s", g_strerror(errno));
+        goto fail;
+    }
+    pr->block_size = req.tp_block_size;
+    pr->block_nr = req.tp_block_nr;
+    pr->map_len = (gsize)req.tp_block_size * req.tp_block_nr;
+    pr->map = mmap(NULL, pr->map_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED | MAP_POPULATE,
+                   pr->fd, 0);
+    if (pr->map == MAP_FAILED) {
+        /* MAP_LOCKED needs RLIMIT_MEMLOCK headroom; the ring works unlocked. */
+        pr->map = mmap(NULL, pr->map_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, pr->fd, 0);
+    }
+    if (pr->map == MAP_FAILED) {
+        pr->map = NULL;
+        uv_log_error("Relay: packet ring mmap failed: %s", g_strerror(errno));
+        goto fail;
+    }
+
+    struct sockaddr_ll ll = {
+        .sll_family = AF_PACKET,
+        .sll_protocol = htons(ETH_P_IP),
+        .sll_ifindex = (int)ifindex,
+    };
+    if (bind(pr->fd, (struct sockaddr *)&ll, sizeof(ll)) < 0) {
+        uv_log_error("Relay: packet ring bind failed: %s", g_strerror(errno));
+        goto fail;
+    }
+
+    pr->port_fd = packet_ring_hold_port(port);
+    if (pr->port_fd < 0) {
+        uv_log_warn("Relay: could not hold UDP port %d (%s); senders may see ICMP unreachable",
+                    port, g_strerror(errno));
+    }
+    return TRUE;
+
+fail:
+    packet_ring_close(pr);
+    return FALSE;
+}
+
+void packet_ring_close(PacketRing *pr) {
+    if (pr->map) munmap(pr->map, pr->map_len);
+    if (pr->fd >= 0) close(pr->fd);
+    if (pr->port_fd >= 0) close(pr->port_fd);
+    pr->map = NULL;
+    pr->fd = -1;
+    pr->port_fd = -1;
+}
+
+gboolean packet_ring_ready(const PacketRing *pr) {
+    if (pr->pkts_left > 0) return TRUE;
+    const struct tpacket_block_desc *bd = packet_ring_block(pr, pr->block_cur);
+    return (__atomic_load_n(&bd->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) != 0;
+}
+
+/* Fill out[] from the current block, opening it if the kernel has retired
+ * it. Packets point into the mapping and stay valid until
+ * packet_ring_release() hands the block back; a block holding more than
+ * max packets is drained over several calls. Frames that are not a
+ * well-formed UDP datagram for our port (the filter already checked the
+ * headers it can reach) are skipped. */
+guint packet_ring_next(PacketRing *pr, PacketRingPacket *out, guint max) {
+    struct tpacket_block_desc *bd = packet_ring_block(pr, pr->block_cur);
+    if (pr->pkts_left == 0) {
+        if (pr->cursor) return 0; /* drained, awaiting packet_ring_release() */
+        if (!(__atomic_load_n(&bd->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER)) {
+            return 0;
+        }
+        pr->pkts_left = bd->hdr.bh1.num_pkts;
+        pr->cursor = (unsigned char *)bd + bd->hdr.bh1.offset_to_first_pkt;
+        pr->blocks++;
+        if (pr->pkts_left == 0) return 0;
+    }
+
+    guint n = 0;
+    while (pr->pkts_left > 0 && n < max) {
+        const struct tpacket3_hdr *h = (const struct tpacket3_hdr *)pr->cursor;
+        pr->cursor += h->tp_next_offset;
+        pr->pkts_left--;
+
+        const struct sockaddr_ll *ll = (const struct sockaddr_ll *)
+            ((const unsigned char *)h + TPACKET_ALIGN(sizeof(struct tpacket3_hdr)));
+        /* The filter already holds the ring to this host's frames. */
+        if (ll->sll_pkttype != PACKET_HOST) continue;
+
+        const unsigned char *ip = (const unsigned char *)h + h->tp_net;
+        size_t caplen = h->tp_snaplen;
+        if (caplen < 20 || (ip[0] >> 4) != 4) continue;
+        size_t ihl = (size_t)(ip[0] & 0x0f) * 4u;
+        size_t total = ((size_t)ip[2] << 8) | ip[3];
+        if (ihl < 20 || total > caplen || total < ihl + 8u) continue;
+        if (ip[9] != IPPROTO_UDP || (((ip[6] << 8) | ip[7]) & 0x3fff) != 0) continue;
+        const unsigned char *udp = ip + ihl;
+        size_t udp_len = ((size_t)udp[4] << 8) | udp[5];
+        if ((((int)udp[2] << 8) | udp[3]) != pr->port || udp_len < 8u || udp_len > total - ihl) continue;
+
+        PacketRingPacket *p = &out[n++];
+        p->data = udp + 8;
+        p->len = udp_len - 8u;
+        memset(&p->from, 0, sizeof(p->from));
+        p->from.sin_family = AF_INET;
+        memcpy(&p->from.sin_addr.s_addr, ip + 12, 4);
+        memcpy(&p->from.sin_port, udp, 2);
+        p->rx_realtime_ns = (int64_t)h->tp_sec * 1000000000ll + h->tp_nsec;
+    }
+    return n;
+}
+
+/* Hand the current block back to the kernel once every packet in it has
+ * been returned by packet_ring_next() and the caller is done with them. */
+void packet_ring_release(PacketRing *pr) {
+    if (pr->pkts_left > 0 || !pr->cursor) return;
+    struct tpacket_block_desc *bd = packet_ring_block(pr, pr->block_cur);
+    __atomic_store_n(&bd->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+    pr->cursor = NULL;
+    pr->block_cur = (pr->block_cur + 1u) % pr->block_nr;
+}
+
+/* Frames the kernel dropped because every block was still owned by us,
+ * cumulative since open. PACKET_STATISTICS resets on read, so the running
+ * total is kept here. */
+uint64_t packet_ring_drops(PacketRing *pr) {
+    struct tpacket_stats_v3 st;
+    socklen_t len = sizeof(st);
+    if (getsockopt(pr->fd, SOL_PACKET, PACKET_STATISTICS, &st, &len) == 0) {
+        pr->drops += st.tp_drops;
+    }
+    return pr->drops;
+}
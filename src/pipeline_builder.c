@@ -2,6 +2,10 @@
 
 #include <string.h>
 
+/* How long pipeline_controller_update() waits for a videorate relink to
+ * run before returning with it still pending. */
+#define UV_RECONFIG_WAIT_US (250 * 1000)
+
 static void ensure_gstreamer_initialized(void) {
     static gsize gst_init_once = 0;
     if (g_once_init_enter(&gst_init_once)) {
@@ -232,6 +236,155 @@ static GstPadProbeReturn dec_src_probe(GstPad *pad, GstPadProbeInfo *info, gpoin
     return GST_PAD_PROBE_OK;
 }
 
+/* Latency tracing probes. appsrc sees what ingest pushed: RTP datagrams,
+ * of which a frame's marker (last) datagram stamps it by RTP timestamp, or
+ * SHM access units with their pts in the buffer offset, which also learn
+ * their PTS there. For RTP the PTS is the jitterbuffer's, picked up on the
+ * depayloader's sink pad. Past that point frames are found by PTS. */
+static inline guint32 latency_rtp_ts(const guint8 *p) {
+    return (guint32)((p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3]);
+}
+
+static GstPadProbeReturn latency_appsrc_probe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
+    (void)pad;
+    LatencyProbe *probe = (LatencyProbe *)user_data;
+    GstBuffer *buf = GST_PAD_PROBE_INFO_BUFFER(info);
+    if (!buf) return GST_PAD_PROBE_OK;
+    if (probe->tracer->shm) {
+        guint32 key = (guint32)GST_BUFFER_OFFSET(buf);
+        uv_internal_latency_link(probe->tracer, key, GST_BUFFER_PTS(buf));
+        uv_internal_latency_stamp_key(probe->tracer, key, probe->stage, g_get_monotonic_time());
+        return GST_PAD_PROBE_OK;
+    }
+    guint8 hdr[8];
+    if (gst_buffer_extract(buf, 0, hdr, sizeof(hdr)) == sizeof(hdr) && (hdr[1] & 0x80)) {
+        uv_internal_latency_stamp_key(probe->tracer, latency_rtp_ts(hdr + 4), probe->stage,
+                                      g_get_monotonic_time());
+    }
+    return GST_PAD_PROBE_OK;
+}
+
+static GstPadProbeReturn latency_link_probe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
+    (void)pad;
+    LatencyProbe *probe = (LatencyProbe *)user_data;
+    GstBuffer *buf = GST_PAD_PROBE_INFO_BUFFER(info);
+    guint8 ts[4];
+    if (buf && gst_buffer_extract(buf, 4, ts, sizeof(ts)) == sizeof(ts)) {
+        uv_internal_latency_link(probe->tracer, latency_rtp_ts(ts), GST_BUFFER_PTS(buf));
+    }
+    return GST_PAD_PROBE_OK;
+}
+
+static GstPadProbeReturn latency_stage_probe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
+    (void)pad;
+    LatencyProbe *probe = (LatencyProbe *)user_data;
+    GstBuffer *buf = GST_PAD_PROBE_INFO_BUFFER(info);
+    if (buf) {
+        uv_internal_latency_stamp_pts(probe->tracer, GST_BUFFER_PTS(buf), probe->stage,
+                                      g_get_monotonic_time());
+    }
+    return GST_PAD_PROBE_OK;
+}
+
+static gulong pipeline_trace_pad(PipelineController *pc, GstElement *element, const char *pad_name,
+                                 UvLatencyStage stage, GstPadProbeCallback cb) {
+    if (!pc->viewer->config.latency_trace || !element) return 0;
+    GstPad *pad = gst_element_get_static_pad(element, pad_name);
+    if (!pad) return 0;
+    LatencyProbe *probe = &pc->latency_probes[stage];
+    probe->tracer = &pc->viewer->latency;
+    probe->stage = stage;
+    gulong id = gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, cb, probe, NULL);
+    gst_object_unref(pad);
+    return id;
+}
+
+/* videorate retimes and duplicates frames, so with it the trace ends at
+ * the post-decode queue and the sink is not probed. */
+static void pipeline_trace_sink(PipelineController *pc) {
+    pc->latency_sink_probe_id = pc->use_videorate ? 0 :
+        pipeline_trace_pad(pc, pc->sink, "sink", UV_LATENCY_STAGE_SINK, latency_stage_probe);
+}
+
+static void pipeline_untrace_sink(PipelineController *pc) {
+    if (pc->latency_sink_probe_id && pc->sink) {
+        GstPad *pad = gst_element_get_static_pad(pc->sink, "sink");
+        if (pad) {
+            gst_pad_remove_probe(pad, pc->latency_sink_probe_id);
+            gst_object_unref(pad);
+        }
+    }
+    pc->latency_sink_probe_id = 0;
+}
+
+/* Live updates. An update is timed from the call until it is in effect;
+ * its loss window stays open until the next frame into video_convert,
+ * counted here. Frames out of the decoder plus those queued behind it at
+ * the start, less frames converted plus those still queued at the end,
+ * is what the update dropped. */
+static guint64 pipeline_decoded_frames(PipelineController *pc) {
+    g_mutex_lock(&pc->viewer->decoder.lock);
+    guint64 frames = pc->viewer->decoder.frames_total;
+    g_mutex_unlock(&pc->viewer->decoder.lock);
+    return frames;
+}
+
+static guint64 pipeline_queued_frames(PipelineController *pc) {
+    guint64 total = 0;
+    GstElement *queues[] = { pc->queue_postdec, pc->queue_postrate };
+    for (guint i = 0; i < G_N_ELEMENTS(queues); i++) {
+        guint level = 0;
+        if (queues[i]) g_object_get(queues[i], "current-level-buffers", &level, NULL);
+        total += level;
+    }
+    return total;
+}
+
+static void pipeline_reconfig_settle(PipelineController *pc, guint64 converted_total) {
+    g_mutex_lock(&pc->reconfig.lock);
+    if (__atomic_load_n(&pc->settling, __ATOMIC_RELAXED) && !pc->reconfig.stats.pending) {
+        guint64 decoded = pipeline_decoded_frames(pc) - pc->reconfig.dec_start + pc->reconfig.queued_start;
+        guint64 converted = converted_total - pc->reconfig.conv_start + pipeline_queued_frames(pc);
+        guint64 lost = decoded > converted ? decoded - converted : 0;
+        pc->reconfig.stats.last_frames_lost = lost;
+        pc->reconfig.stats.frames_lost_total += lost;
+        __atomic_store_n(&pc->settling, 0, __ATOMIC_RELAXED);
+    }
+    g_mutex_unlock(&pc->reconfig.lock);
+}
+
+static GstPadProbeReturn convert_count_probe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
+    (void)pad; (void)info;
+    PipelineController *pc = (PipelineController *)user_data;
+    guint64 n = __atomic_add_fetch(&pc->convert_frames, 1, __ATOMIC_RELAXED);
+    if (__atomic_load_n(&pc->settling, __ATOMIC_ACQUIRE)) pipeline_reconfig_settle(pc, n);
+    return GST_PAD_PROBE_OK;
+}
+
+/* Caller holds reconfig.lock. */
+static void pipeline_reconfig_done_locked(PipelineController *pc) {
+    UvReconfigStats *st = &pc->reconfig.stats;
+    st->last_ms = (double)(g_get_monotonic_time() - pc->reconfig.start_us) / 1000.0;
+    if (st->last_ms > st->max_ms) st->max_ms = st->last_ms;
+    st->updates++;
+    st->pending = FALSE;
+    st->last_frames_lost = 0;
+    __atomic_store_n(&pc->settling, 1, __ATOMIC_RELEASE);
+}
+
+/* Take the videorate elements out of the pipeline (removal unlinks them). */
+static void pipeline_videorate_drop(PipelineController *pc) {
+    GstElement *gone[] = { pc->videorate, pc->videorate_caps, pc->queue_postrate };
+    for (guint i = 0; i < G_N_ELEMENTS(gone); i++) {
+        if (!gone[i]) continue;
+        gst_element_set_state(gone[i], GST_STATE_NULL);
+        gst_bin_remove(GST_BIN(pc->pipeline), gone[i]);
+    }
+    pc->videorate = NULL;
+    pc->videorate_caps = NULL;
+    pc->queue_postrate = NULL;
+}
+
 static GstPadProbeReturn audio_src_probe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
     (void)pad;
     PipelineController *pc = (PipelineController *)user_data;
@@ -278,6 +431,12 @@ static void remove_audio_probe(PipelineController *pc) {
     pc->audio_probe_id = 0;
 }
 
+/* Whether the appsrc carries Annex-B access units rather than RTP: SHM
+ * ingress, or UDP with the relay depacketizing (direct AU mode). */
+static gboolean pipeline_au_ingress(PipelineController *pc) {
+    return pipeline_controller_ingress_mode(pc) == UV_INGRESS_SHM || pc->direct_au;
+}
+
 static void on_need_data(GstAppSrc *src, guint length, gpointer user_data) {
     (void)src; (void)length;
     PipelineController *pc = (PipelineController *)user_data;
@@ -315,6 +474,7 @@ static gboolean pipeline_swap_to_fakesink(PipelineController *pc) {
 
     pc->sink = fakesink;
     pc->sink_is_fakesink = TRUE;
+    pipeline_trace_sink(pc);
     return TRUE;
 }
 
@@ -369,6 +529,7 @@ static void pipeline_detach_current_sink(PipelineController *pc) {
     gst_bin_remove(GST_BIN(pc->pipeline), pc->sink);
     pc->sink = NULL;
     pc->sink_is_fakesink = FALSE;
+    pc->latency_sink_probe_id = 0;
 }
 
 static gboolean pipeline_attach_sink_at(PipelineController *pc, guint index) {
@@ -403,6 +564,7 @@ static gboolean pipeline_attach_sink_at(PipelineController *pc, guint index) {
     pc->sink = sink;
     pc->sink_is_fakesink = is_fakesink;
     pc->sink_factory_index = index;
+    pipeline_trace_sink(pc);
     return TRUE;
 }
 
@@ -420,7 +582,8 @@ static gboolean build_pipeline(PipelineController *pc, GError **error) {
     UvViewer *viewer = pc->viewer;
     pc->appsrc_element   = gst_element_factory_make("appsrc", "src");
     pc->queue0           = gst_element_factory_make("queue", "queue_ingress");
-    if (pc->ingress_mode == UV_INGRESS_UDP) {
+    gboolean au_ingress = pipeline_au_ingress(pc);
+    if (!au_ingress) {
         pc->tee = gst_element_factory_make("tee", "tee");
         pc->queue_video_in = gst_element_factory_make("queue", "queue_video_in");
         pc->capsfilter_rtp_video = gst_element_factory_make("capsfilter", "cf_rtp_video");
@@ -548,7 +711,7 @@ static gboolean build_pipeline(PipelineController *pc, GError **error) {
     }
 
     if (!pc->appsrc_element || !pc->queue0 ||
-        (pc->ingress_mode == UV_INGRESS_UDP &&
+        (!au_ingress &&
          (!pc->tee || !pc->queue_video_in || !pc->capsfilter_rtp_video ||
           !pc->jitterbuffer || !pc->depay)) ||
         !pc->parser || !pc->capsfilter || !pc->decoder ||
@@ -590,7 +753,7 @@ static gboolean build_pipeline(PipelineController *pc, GError **error) {
         return FALSE;
     }
 
-    GstCaps *caps_appsrc = pc->ingress_mode == UV_INGRESS_SHM
+    GstCaps *caps_appsrc = au_ingress
                          ? gst_caps_from_string("video/x-h265,stream-format=byte-stream,alignment=au")
                          : gst_caps_new_empty_simple("application/x-rtp");
     if (!caps_appsrc) {
@@ -609,8 +772,8 @@ static gboolean build_pipeline(PipelineController *pc, GError **error) {
 
     g_object_set(pc->appsrc_element,
                  "is-live", TRUE,
-                 "format", pc->ingress_mode == UV_INGRESS_SHM ? GST_FORMAT_TIME : GST_FORMAT_BYTES,
-                 "do-timestamp", pc->ingress_mode == UV_INGRESS_SHM,
+                 "format", au_ingress ? GST_FORMAT_TIME : GST_FORMAT_BYTES,
+                 "do-timestamp", au_ingress,
                  "block", FALSE,
                  "max-bytes", (guint64)(2 * 1024 * 1024),
                  "stream-type", GST_APP_STREAM_TYPE_STREAM,
@@ -634,20 +797,22 @@ static gboolean build_pipeline(PipelineController *pc, GError **error) {
                      NULL);
     }
 
+    /* Under marker release the relay does the waiting, and only as long
+     * as a frame is incomplete. */
     if (pc->jitterbuffer) g_object_set(pc->jitterbuffer,
-                 "latency", (guint)MAX(viewer->config.jitter_latency_ms, 0u),
+                 "latency", viewer->config.marker_release ? 0u : viewer->config.jitter_latency_ms,
                  "drop-on-latency", viewer->config.jitter_drop_on_latency,
                  "do-lost", viewer->config.jitter_do_lost,
                  "post-drop-messages", viewer->config.jitter_post_drop_messages,
                  NULL);
 
-    GstCaps *caps_rtp_video = pc->ingress_mode == UV_INGRESS_UDP ? gst_caps_new_simple("application/x-rtp",
+    GstCaps *caps_rtp_video = !au_ingress ? gst_caps_new_simple("application/x-rtp",
                                                   "media", G_TYPE_STRING, "video",
                                                   "encoding-name", G_TYPE_STRING, "H265",
                                                   "payload", G_TYPE_INT, pc->payload_type,
                                                   "clock-rate", G_TYPE_INT, pc->clock_rate,
                                                   NULL) : NULL;
-    if (pc->ingress_mode == UV_INGRESS_UDP && !caps_rtp_video) {
+    if (!au_ingress && !caps_rtp_video) {
         gst_caps_unref(caps_h265);
         g_set_error(error, g_quark_from_static_string("uv-viewer"), 16,
                     "Failed to build video RTP caps");
@@ -751,7 +916,7 @@ static gboolean build_pipeline(PipelineController *pc, GError **error) {
     }
 
     gst_bin_add_many(GST_BIN(pc->pipeline), pc->appsrc_element, pc->queue0, NULL);
-    if (pc->ingress_mode == UV_INGRESS_UDP) {
+    if (!au_ingress) {
         gst_bin_add_many(GST_BIN(pc->pipeline), pc->tee, pc->queue_video_in,
                          pc->capsfilter_rtp_video, pc->jitterbuffer, pc->depay, NULL);
     }
@@ -792,7 +957,7 @@ static gboolean build_pipeline(PipelineController *pc, GError **error) {
     }
 
     gboolean video_linked;
-    if (pc->ingress_mode == UV_INGRESS_SHM) {
+    if (au_ingress) {
         video_linked = gst_element_link_many(pc->queue0, pc->parser, pc->capsfilter,
                                              pc->decoder, pc->queue_postdec, NULL);
     } else {
@@ -914,6 +1079,22 @@ static gboolean build_pipeline(PipelineController *pc, GError **error) {
         gst_object_unref(dec_src);
     }
 
+    GstPad *convert_sink = gst_element_get_static_pad(pc->video_convert, "sink");
+    if (convert_sink) {
+        gst_pad_add_probe(convert_sink, GST_PAD_PROBE_TYPE_BUFFER, convert_count_probe, pc, NULL);
+        gst_object_unref(convert_sink);
+    }
+
+    uv_internal_latency_reset(&viewer->latency, viewer->config.latency_trace,
+                              au_ingress,
+                              pc->use_videorate ? UV_LATENCY_STAGE_QUEUE_POSTDEC : UV_LATENCY_STAGE_SINK);
+    pipeline_trace_pad(pc, pc->appsrc_element, "src", UV_LATENCY_STAGE_APPSRC, latency_appsrc_probe);
+    pipeline_trace_pad(pc, pc->depay, "sink", UV_LATENCY_STAGE_DEPAY, latency_link_probe);
+    pipeline_trace_pad(pc, pc->depay, "src", UV_LATENCY_STAGE_DEPAY, latency_stage_probe);
+    pipeline_trace_pad(pc, pc->parser, "src", UV_LATENCY_STAGE_PARSER, latency_stage_probe);
+    pipeline_trace_pad(pc, pc->decoder, "src", UV_LATENCY_STAGE_DECODER, latency_stage_probe);
+    pipeline_trace_pad(pc, pc->queue_postdec, "src", UV_LATENCY_STAGE_QUEUE_POSTDEC, latency_stage_probe);
+
     if (pc->audio_enabled && pc->audio_resample) {
         GstPad *audio_pad = gst_element_get_static_pad(pc->audio_resample, "src");
         if (audio_pad) {
@@ -988,6 +1169,7 @@ gboolean pipeline_controller_init(PipelineController *pc, struct _UvViewer *view
     g_return_val_if_fail(pc != NULL, FALSE);
     memset(pc, 0, sizeof(*pc));
     pc->ingress_mode = UV_INGRESS_UDP;
+    pc->direct_au = viewer->config.direct_au;
     pc->viewer = viewer;
     pc->payload_type = viewer->config.payload_type;
     pc->clock_rate = viewer->config.clock_rate;
@@ -1023,6 +1205,8 @@ gboolean pipeline_controller_init(PipelineController *pc, struct _UvViewer *view
     pc->audio_last_buffer_us = 0;
     pc->audio_active_cached = FALSE;
     g_mutex_init(&pc->audio_lock);
+    g_mutex_init(&pc->reconfig.lock);
+    g_cond_init(&pc->reconfig.done);
     pc->sink_factories = NULL;
     pc->sink_factory_index = 0;
     return TRUE;
@@ -1067,6 +1251,8 @@ void pipeline_controller_deinit(PipelineController *pc) {
     pc->audio_last_buffer_us = 0;
     pc->audio_active_cached = FALSE;
     g_mutex_clear(&pc->audio_lock);
+    g_mutex_clear(&pc->reconfig.lock);
+    g_cond_clear(&pc->reconfig.done);
     if (pc->loop) {
         g_main_loop_unref(pc->loop);
         pc->loop = NULL;
@@ -1195,6 +1381,22 @@ void pipeline_controller_stop(PipelineController *pc) {
     if (pc->pipeline) {
         gst_element_set_state(pc->pipeline, GST_STATE_NULL);
     }
+    /* A relink that never ran is abandoned: its probe goes, and so do
+     * videorate elements it would have linked. */
+    g_mutex_lock(&pc->reconfig.lock);
+    if (pc->reconfig.probe_pad) {
+        if (pc->reconfig.probe_id) gst_pad_remove_probe(pc->reconfig.probe_pad, pc->reconfig.probe_id);
+        gst_object_unref(pc->reconfig.probe_pad);
+        pc->reconfig.probe_pad = NULL;
+        pc->reconfig.probe_id = 0;
+    }
+    if (pc->reconfig.stats.pending) {
+        if (pc->reconfig.enable_videorate && pc->pipeline) pipeline_videorate_drop(pc);
+        pc->reconfig.stats.pending = FALSE;
+        g_cond_broadcast(&pc->reconfig.done);
+    }
+    __atomic_store_n(&pc->settling, 0, __ATOMIC_RELAXED);
+    g_mutex_unlock(&pc->reconfig.lock);
     g_mutex_lock(&pc->audio_lock);
     pc->audio_last_buffer_us = 0;
     pc->audio_active_cached = FALSE;
@@ -1300,6 +1502,10 @@ void pipeline_controller_snapshot(PipelineController *pc, UvViewerStats *stats)
     pc->viewer->decoder.last_snapshot_fps = inst_fps;
     g_mutex_unlock(&pc->viewer->decoder.lock);
 
+    g_mutex_lock(&pc->reconfig.lock);
+    stats->reconfig = pc->reconfig.stats;
+    g_mutex_unlock(&pc->reconfig.lock);
+
     stats->decoder.frames_total = frames_total;
     stats->decoder.instantaneous_fps = inst_fps;
     stats->decoder.average_fps = avg_fps;
@@ -1322,11 +1528,238 @@ void pipeline_controller_snapshot(PipelineController *pc, UvViewerStats *stats)
     }
 }
 
+static GstCaps *pipeline_videorate_caps(guint num, guint den) {
+    return gst_caps_new_simple("video/x-raw",
+                               "framerate", GST_TYPE_FRACTION, (gint)num, (gint)den,
+                               NULL);
+}
+
+/* Videorate on or off: an idle probe on the pad feeding video_convert
+ * (post-decode queue, or the hardware converter) relinks the tail while
+ * nothing is being pushed through it. Going on, the new elements are
+ * brought to the pipeline's state before they are linked. Going off, they
+ * are shut down before their queue is unlinked, so its task stops on
+ * flushing instead of erroring on not-linked; whatever it held is lost.
+ * A failed relink is recorded as such; if it left the video branch
+ * unlinked, an error goes on the bus as well. */
+static GstPadProbeReturn pipeline_videorate_relink(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
+    (void)pad; (void)info;
+    PipelineController *pc = (PipelineController *)user_data;
+    GstElement *tail = pc->video_hw_convert ? pc->video_hw_convert : pc->queue_postdec;
+    g_mutex_lock(&pc->reconfig.lock);
+    gboolean enable = pc->reconfig.enable_videorate;
+    g_mutex_unlock(&pc->reconfig.lock);
+
+    gboolean linked;
+    gboolean branch_linked;
+    pipeline_untrace_sink(pc);
+    if (enable) {
+        gst_element_unlink(tail, pc->video_convert);
+        gst_element_sync_state_with_parent(pc->queue_postrate);
+        gst_element_sync_state_with_parent(pc->videorate_caps);
+        gst_element_sync_state_with_parent(pc->videorate);
+        linked = gst_element_link_many(tail, pc->videorate, pc->videorate_caps,
+                                       pc->queue_postrate, pc->video_convert, NULL);
+        branch_linked = linked;
+        if (!linked) {
+            pipeline_videorate_drop(pc);
+            branch_linked = gst_element_link(tail, pc->video_convert);
+        }
+    } else {
+        gst_element_unlink(tail, pc->videorate);
+        pipeline_videorate_drop(pc);
+        linked = gst_element_link(tail, pc->video_convert);
+        branch_linked = linked;
+    }
+    pc->use_videorate = enable && linked;
+    pipeline_trace_sink(pc);
+    uv_internal_latency_reset(&pc->viewer->latency, pc->viewer->config.latency_trace,
+                              pipeline_au_ingress(pc),
+                              pc->use_videorate ? UV_LATENCY_STAGE_QUEUE_POSTDEC : UV_LATENCY_STAGE_SINK);
+
+    g_mutex_lock(&pc->reconfig.lock);
+    if (linked) {
+        pipeline_reconfig_done_locked(pc);
+        uv_log_info("Pipeline: videorate %s in %.1f ms", enable ? "on" : "off", pc->reconfig.stats.last_ms);
+    } else {
+        pc->reconfig.stats.pending = FALSE;
+        pc->reconfig.stats.failed = TRUE;
+        pc->reconfig.stats.failures++;
+        uv_log_warn("Pipeline: relink with videorate %s failed; the pipeline needs a restart",
+                    enable ? "on" : "off");
+    }
+    if (pc->reconfig.probe_pad) gst_object_unref(pc->reconfig.probe_pad);
+    pc->reconfig.probe_pad = NULL;
+    pc->reconfig.probe_id = 0;
+    g_cond_broadcast(&pc->reconfig.done);
+    g_mutex_unlock(&pc->reconfig.lock);
+
+    if (!branch_linked) {
+        GError *err = g_error_new(g_quark_from_static_string("uv-viewer"), 32,
+                                  "Videorate relink left the video branch unlinked");
+        gst_element_post_message(pc->pipeline,
+                                 gst_message_new_error(GST_OBJECT(pc->pipeline), err, NULL));
+        g_error_free(err);
+    }
+    return GST_PAD_PROBE_REMOVE;
+}
+
+/* Apply overrides to the running graph: element properties where the
+ * element takes them live, a relink for videorate on/off. The viewer
+ * config follows, so a later rebuild keeps them. Without a pipeline they
+ * are only recorded. */
 gboolean pipeline_controller_update(PipelineController *pc, const UvPipelineOverrides *overrides, GError **error) {
-    (void)pc; (void)overrides;
-    g_set_error(error, g_quark_from_static_string("uv-viewer"), 30,
-                "Pipeline overrides not implemented yet");
-    return FALSE;
+    g_return_val_if_fail(pc != NULL && overrides != NULL, FALSE);
+    if (overrides->descriptive_name || overrides->custom_decoder) {
+        g_set_error(error, g_quark_from_static_string("uv-viewer"), 30,
+                    "Decoder overrides need a pipeline restart");
+        return FALSE;
+    }
+    UvViewerConfig *cfg = &pc->viewer->config;
+    gboolean live = pc->pipeline != NULL;
+
+    guint fps_num = pc->videorate_fps_num;
+    guint fps_den = pc->videorate_fps_den;
+    gboolean want_videorate = pc->use_videorate;
+    if (overrides->set_videorate) {
+        fps_num = overrides->videorate_fps_numerator;
+        fps_den = overrides->videorate_fps_denominator ? overrides->videorate_fps_denominator : 1;
+        want_videorate = overrides->videorate_enabled && fps_num > 0;
+        if (overrides->videorate_enabled && fps_num == 0) {
+            uv_log_warn("Videorate requested but invalid target FPS %u/%u; disabling", fps_num, fps_den);
+        }
+    }
+    gboolean relink = live && want_videorate != pc->use_videorate;
+
+    g_mutex_lock(&pc->reconfig.lock);
+    if (pc->reconfig.stats.pending) {
+        g_mutex_unlock(&pc->reconfig.lock);
+        g_set_error(error, g_quark_from_static_string("uv-viewer"), 31,
+                    "A pipeline update is still in progress");
+        return FALSE;
+    }
+    if (relink && want_videorate) {
+        GstElement *rate = gst_element_factory_make("videorate", "videorate");
+        GstElement *rate_caps = gst_element_factory_make("capsfilter", "videorate_caps");
+        GstElement *postrate = gst_element_factory_make("queue", "queue_postrate");
+        GstCaps *caps = pipeline_videorate_caps(fps_num, fps_den);
+        if (!rate || !rate_caps || !postrate || !caps) {
+            if (rate) gst_object_unref(rate);
+            if (rate_caps) gst_object_unref(rate_caps);
+            if (postrate) gst_object_unref(postrate);
+            if (caps) gst_caps_unref(caps);
+            g_mutex_unlock(&pc->reconfig.lock);
+            g_set_error(error, g_quark_from_static_string("uv-viewer"), 15,
+                        "Failed to create videorate elements");
+            return FALSE;
+        }
+        g_object_set(rate, "drop-only", FALSE, NULL);
+        g_object_set(rate_caps, "caps", caps, NULL);
+        gst_caps_unref(caps);
+        gst_bin_add_many(GST_BIN(pc->pipeline), rate, rate_caps, postrate, NULL);
+        pc->videorate = rate;
+        pc->videorate_caps = rate_caps;
+        pc->queue_postrate = postrate;
+    }
+
+    pc->reconfig.stats.failed = FALSE;
+    pc->reconfig.start_us = g_get_monotonic_time();
+    pc->reconfig.dec_start = pipeline_decoded_frames(pc);
+    pc->reconfig.conv_start = __atomic_load_n(&pc->convert_frames, __ATOMIC_RELAXED);
+    pc->reconfig.queued_start = pipeline_queued_frames(pc);
+    __atomic_store_n(&pc->settling, 0, __ATOMIC_RELAXED);
+    char *change = pc->reconfig.stats.last_change;
+    change[0] = '\0';
+
+    if (overrides->set_jitter_latency) {
+        /* The relay reads it per frame under marker release. */
+        __atomic_store_n(&cfg->jitter_latency_ms, overrides->jitter_latency_ms, __ATOMIC_RELAXED);
+        if (pc->jitterbuffer && !cfg->marker_release) {
+            g_object_set(pc->jitterbuffer, "latency", cfg->jitter_latency_ms, NULL);
+        }
+        g_strlcat(change, "latency ", sizeof(pc->reconfig.stats.last_change));
+    }
+    if (overrides->set_queue_max_buffers) {
+        cfg->queue_max_buffers = overrides->queue_max_buffers;
+        if (pc->queue0) g_object_set(pc->queue0, "max-size-buffers", cfg->queue_max_buffers, NULL);
+        g_strlcat(change, "queue ", sizeof(pc->reconfig.stats.last_change));
+    }
+    if (overrides->set_sync) {
+        cfg->sync_to_clock = overrides->sync_to_clock;
+        pc->sync_to_clock = overrides->sync_to_clock;
+        if (pc->sink && !pc->sink_is_fakesink) {
+            g_object_set(pc->sink, "sync", pc->sync_to_clock ? TRUE : FALSE, NULL);
+        }
+        g_strlcat(change, "sync ", sizeof(pc->reconfig.stats.last_change));
+    }
+    if (overrides->set_videorate) {
+        cfg->videorate_enabled = overrides->videorate_enabled;
+        cfg->videorate_fps_numerator = fps_num;
+        cfg->videorate_fps_denominator = fps_den;
+        pc->videorate_fps_num = fps_num;
+        pc->videorate_fps_den = fps_den;
+        if (!live) {
+            pc->use_videorate = want_videorate;
+        } else if (!relink && pc->use_videorate) {
+            /* Already in the graph: the capsfilter renegotiates. */
+            GstCaps *caps = pipeline_videorate_caps(fps_num, fps_den);
+            if (caps) {
+                g_object_set(pc->videorate_caps, "caps", caps, NULL);
+                gst_caps_unref(caps);
+            }
+        }
+        g_strlcat(change, "videorate ", sizeof(pc->reconfig.stats.last_change));
+    }
+    size_t change_len = strlen(change);
+    if (change_len > 0) change[change_len - 1] = '\0';
+    if (!live) {
+        g_mutex_unlock(&pc->reconfig.lock);
+        return TRUE;
+    }
+    /* The jitterbuffer's latency is part of the pipeline's; let the sinks
+     * pick up the new total. */
+    if (overrides->set_jitter_latency && pc->jitterbuffer && !cfg->marker_release) {
+        gst_bin_recalculate_latency(GST_BIN(pc->pipeline));
+    }
+
+    if (!relink) {
+        pipeline_reconfig_done_locked(pc);
+        uv_log_info("Pipeline: updated %s in %.2f ms", change, pc->reconfig.stats.last_ms);
+        g_mutex_unlock(&pc->reconfig.lock);
+        return TRUE;
+    }
+    GstElement *tail = pc->video_hw_convert ? pc->video_hw_convert : pc->queue_postdec;
+    GstPad *pad = gst_element_get_static_pad(tail, "src");
+    if (!pad) {
+        if (want_videorate) pipeline_videorate_drop(pc);
+        g_mutex_unlock(&pc->reconfig.lock);
+        g_set_error(error, g_quark_from_static_string("uv-viewer"), 14,
+                    "Failed to find the pad to relink videorate at");
+        return FALSE;
+    }
+    pc->reconfig.enable_videorate = want_videorate;
+    pc->reconfig.stats.pending = TRUE;
+    pc->reconfig.probe_pad = pad;
+    g_mutex_unlock(&pc->reconfig.lock);
+
+    /* The idle probe may run right here when the pad is idle, so it is
+     * added without the lock held. Wait a little for it, so a failed
+     * relink is reported to the caller, who can restart instead. */
+    gulong id = gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_IDLE, pipeline_videorate_relink, pc, NULL);
+    g_mutex_lock(&pc->reconfig.lock);
+    if (pc->reconfig.stats.pending) pc->reconfig.probe_id = id;
+    gint64 deadline = g_get_monotonic_time() + UV_RECONFIG_WAIT_US;
+    while (pc->reconfig.stats.pending) {
+        if (!g_cond_wait_until(&pc->reconfig.done, &pc->reconfig.lock, deadline)) break;
+    }
+    gboolean failed = !pc->reconfig.stats.pending && pc->reconfig.stats.failed;
+    g_mutex_unlock(&pc->reconfig.lock);
+    if (failed) {
+        g_set_error(error, g_quark_from_static_string("uv-viewer"), 32,
+                    "Videorate relink failed; the pipeline needs a restart");
+        return FALSE;
+    }
+    return TRUE;
 }
 
 GstElement *pipeline_controller_get_sink(PipelineController *pc) {
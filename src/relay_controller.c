@@ -1,12 +1,22 @@
+#define _GNU_SOURCE
 #include "uv_internal.h"
 
 #include <errno.h>
 #include <fcntl.h>
 #include <inttypes.h>
+#include <linux/io_uring.h>
+#include <linux/net_tstamp.h>
 #include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
+#include <time.h>
 #include <unistd.h>
 
 #define UV_FRAME_BLOCK_DEFAULT_WIDTH   60u
@@ -302,12 +312,7 @@ gboolean relay_controller_get_selected_address(RelayController *rc, char *out, s
     return found;
 }
 
-/* RFC 3550 sequence-validity constants. A forward gap below MAX_DROPOUT is a
- * normal loss burst; a backward step within MAX_MISORDER is genuine reordering.
- * Anything else means the sender's sequence space jumped — typically a Wi-Fi
- * link recovering after the encoder restarted with a fresh (often reset) seq. */
-#define UV_RTP_MAX_DROPOUT   3000u
-#define UV_RTP_MAX_MISORDER  100u
+/* rtp_bad_seq with no restart on probation (UV_RTP_MAX_* are in rtp_seq.h). */
 #define UV_RTP_BAD_SEQ_NONE  0xffffffffu
 
 static void relay_source_clear_stats(UvRelaySource *src, gboolean reset_totals) {
@@ -319,8 +324,6 @@ static void relay_source_clear_stats(UvRelaySource *src, gboolean reset_totals)
         src->forwarded_bytes = 0;
     }
     src->last_seen_us = 0;
-    src->prev_bytes = 0;
-    src->prev_timestamp_us = 0;
     src->rtp_initialized = FALSE;
     src->rtp_cycles = 0;
     src->rtp_first_ext_seq = 0;
@@ -330,44 +333,24 @@ static void relay_source_clear_stats(UvRelaySource *src, gboolean reset_totals)
     src->rtp_duplicate_packets = 0;
     src->rtp_reordered_packets = 0;
     src->rtp_marker_frames = 0;
-    src->frame_times_head = 0;
-    src->frame_times_count = 0;
-    memset(src->frame_times_us, 0, sizeof(src->frame_times_us));
-    for (guint i = 0; i < UV_RTP_WIN_SIZE; ++i) {
-        src->rtp_seq_slot[i] = UV_RTP_SLOT_EMPTY;
-    }
+    src->rtp_window_lost = 0;
     src->jitter_initialized = FALSE;
     src->jitter_prev_transit = 0;
-    src->jitter_value = 0.0;
-    if (src->frame_block) {
-        frame_block_state_reset(src->frame_block);
-    }
-    src->frame_block_accum_bytes = 0;
-    src->frame_open = FALSE;
-    src->frame_first_pkt_us = 0;
-    src->frame_chunk_count = 0;
-    src->frame_pkts = 0;
-    src->frame_overlap = FALSE;
-    src->last_pkt_us = 0;
-    src->chunk_open = FALSE;
-    src->chunk_start_us = 0;
-    src->chunk_gap_ms = 0.0;
-    src->chunk_pkts = 0;
-    src->chunk_bytes = 0;
-    src->chunk_frames = 0;
-    src->chunk_last_ts = 0;
-    if (src->release_ring) { g_free(src->release_ring); src->release_ring = NULL; }
-    if (src->frame_ring)   { g_free(src->frame_ring);   src->frame_ring = NULL; }
-    src->release_head = 0;
-    src->release_count = 0;
-    src->release_total = 0;
-    src->release_overlap = 0;
-    src->have_marker_baseline = FALSE;
-    src->last_marker_us = 0;
-    src->last_marker_ts = 0;
-    src->frame_period_ms = 0.0;
-    src->frame_ring_head = 0;
-    src->frame_ring_count = 0;
+    src->jitter_q4 = 0;
+    UvRelaySourceCold *cold = src->cold;
+    if (cold) {
+        /* Keep the grid allocation and generation; everything else restarts. */
+        UvFrameBlockState *frame_block = cold->frame_block;
+        guint frame_block_gen = cold->frame_block_gen;
+        g_free(cold->release_ring);
+        g_free(cold->frame_ring);
+        memset(cold, 0, sizeof(*cold));
+        cold->frame_block = frame_block;
+        cold->frame_block_gen = frame_block_gen;
+        if (frame_block) {
+            frame_block_state_reset(frame_block);
+        }
+    }
     src->hevc_idr_count = 0;
     src->hevc_cra_count = 0;
     src->hevc_trail_count = 0;
@@ -383,50 +366,367 @@ static void relay_source_clear_stats(UvRelaySource *src, gboolean reset_totals)
     src->prev_keyframe_us = 0;
 }
 
-static bool relay_add_or_find(RelayController *rc, const struct sockaddr_in *from, socklen_t fromlen, int *out_idx) {
-    for (guint i = 0; i < rc->sources_count; i++) {
-        UvRelaySource *slot = &rc->sources[i];
-        if (!slot->in_use) continue;
-        if (slot->kind != UV_SOURCE_UDP) continue;
-        if (slot->addr.sin_family == from->sin_family &&
-            slot->addr.sin_addr.s_addr == from->sin_addr.s_addr) {
-            if (slot->addr.sin_port != from->sin_port) {
-                relay_source_clear_stats(slot, TRUE);
+static inline uint64_t relay_clock_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* The relay's clock for arrivals, rates and publish intervals: monotonic
+ * time, or while replaying a capture the capture's own (see
+ * RelayController.replay). */
+static inline gint64 relay_now_us(const RelayController *rc) {
+    if (rc->backend == UV_RELAY_BACKEND_REPLAY) return __atomic_load_n(&rc->replay.clock_us, __ATOMIC_RELAXED);
+    return g_get_monotonic_time();
+}
+
+/* Take a lock and account for how long it made us wait. The uncontended
+ * path is a plain trylock; only an acquisition that finds the lock held pays
+ * for the two clock reads. *st is updated after acquiring, so it needs no
+ * guard of its own when it lives under the lock being taken or is private
+ * to the calling thread. */
+static void relay_lock_timed(GMutex *lock, UvLockStats *st) {
+    uint64_t waited = 0;
+    if (!g_mutex_trylock(lock)) {
+        uint64_t t0 = relay_clock_ns();
+        g_mutex_lock(lock);
+        waited = relay_clock_ns() - t0;
+        st->contended++;
+    }
+    st->acquisitions++;
+    st->wait_ns_total += waited;
+    if (waited > st->wait_ns_max) st->wait_ns_max = waited;
+}
+
+static void relay_lock_stats_merge(UvLockStats *dst, UvLockStats *src) {
+    dst->acquisitions += src->acquisitions;
+    dst->contended += src->contended;
+    dst->wait_ns_total += src->wait_ns_total;
+    if (src->wait_ns_max > dst->wait_ns_max) dst->wait_ns_max = src->wait_ns_max;
+    memset(src, 0, sizeof(*src));
+}
+
+static void relay_lock_stats_export(const UvLockStats *in, UvLockStats *out) {
+    *out = *in;
+    out->wait_ns_avg = in->acquisitions > 0
+        ? (double)in->wait_ns_total / (double)in->acquisitions : 0.0;
+}
+
+/* Zero a slot for reuse. The slot lock is initialised once for the life of
+ * the controller and is carried across, and so is everything from the
+ * reader-owned bitrate baseline through the published view: a lock-free
+ * reader may be copying it, so it only ever changes through a publish.
+ * Callers hold rc->lock on a slot no other thread can reach yet, or hold
+ * the slot's own lock as well when recycling it. */
+static void relay_source_publish(UvRelaySource *src, int clock_rate, gint64 now_us);
+static void relay_stream_restart(RelayController *rc);
+
+static void relay_source_wipe(UvRelaySource *src) {
+    char *base = (char *)src;
+    size_t head = offsetof(UvRelaySource, lock) + sizeof(src->lock);
+    memset(base + head, 0, offsetof(UvRelaySource, prev_bytes) - head);
+    src->lru_prev = -1;
+    src->lru_next = -1;
+}
+
+/* Release a slot's out-of-line storage (the cold block). Must precede
+ * relay_source_wipe() on a slot that has carried traffic. */
+static void relay_source_free_storage(UvRelaySource *src) {
+    UvRelaySourceCold *cold = src->cold;
+    if (cold) {
+        frame_block_state_free(cold->frame_block);
+        g_free(cold->release_ring);
+        g_free(cold->frame_ring);
+        g_free(cold);
+        src->cold = NULL;
+    }
+}
+
+/* Drop a slot's GOP cache and its share of the totals. Caller holds
+ * rc->lock; must precede relay_source_wipe() like the above. */
+static void relay_gop_free(RelayController *rc, UvRelaySource *src) {
+    UvGopCache *g = src->gop;
+    if (!g) return;
+    rc->gop.bytes -= g->used;
+    if (g->valid) rc->gop.sources--;
+    g_free(g->buf);
+    g_free(g);
+    src->gop = NULL;
+    __atomic_store_n(&src->gop_bytes, 0, __ATOMIC_RELAXED);
+}
+
+/* The cold block for src, allocated on first use. Caller holds src->lock. */
+static UvRelaySourceCold *relay_source_cold(UvRelaySource *src) {
+    if (G_UNLIKELY(!src->cold)) src->cold = g_new0(UvRelaySourceCold, 1);
+    return src->cold;
+}
+
+/* ---- Source index (guarded by rc->lock) ---- */
+
+static inline uint32_t relay_index_hash(uint32_t addr, uint16_t port, uint32_t ssrc,
+                                        gboolean endpoint) {
+    uint64_t h = ((uint64_t)addr << 32) | ((uint64_t)port << 1) | (endpoint ? 1u : 0u);
+    h ^= (uint64_t)ssrc * 0x9e3779b97f4a7c15ull;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return (uint32_t)h;
+}
+
+/* Bucket holding the key, or the empty bucket that ends its probe run. */
+static guint relay_index_probe(RelayController *rc, uint32_t addr, uint16_t port,
+                               uint32_t ssrc, gboolean endpoint) {
+    guint mask = rc->index.mask;
+    guint i = relay_index_hash(addr, port, ssrc, endpoint) & mask;
+    rc->index.lookups++;
+    for (;;) {
+        const UvRelayIndexEntry *e = &rc->index.entries[i];
+        rc->index.probes++;
+        if (e->slot < 0) return i;
+        if (e->addr == addr && e->port == port && e->endpoint == (endpoint ? 1u : 0u) &&
+            (endpoint || e->ssrc == ssrc)) {
+            return i;
+        }
+        i = (i + 1) & mask;
+    }
+}
+
+static int relay_index_get(RelayController *rc, uint32_t addr, uint16_t port,
+                           uint32_t ssrc, gboolean endpoint) {
+    return rc->index.entries[relay_index_probe(rc, addr, port, ssrc, endpoint)].slot;
+}
+
+/* Insert or repoint a key. The table is sized so it never fills. */
+static void relay_index_set(RelayController *rc, uint32_t addr, uint16_t port,
+                            uint32_t ssrc, gboolean endpoint, int slot) {
+    UvRelayIndexEntry *e = &rc->index.entries[relay_index_probe(rc, addr, port, ssrc, endpoint)];
+    e->addr = addr;
+    e->port = port;
+    e->endpoint = endpoint ? 1u : 0u;
+    e->ssrc = endpoint ? 0u : ssrc;
+    e->slot = slot;
+}
+
+/* Drop a key if it still points at slot. Deletion shifts later members of
+ * the probe run back into the hole, so lookups never need tombstones. */
+static void relay_index_remove(RelayController *rc, uint32_t addr, uint16_t port,
+                               uint32_t ssrc, gboolean endpoint, int slot) {
+    guint mask = rc->index.mask;
+    UvRelayIndexEntry *entries = rc->index.entries;
+    guint hole = relay_index_probe(rc, addr, port, ssrc, endpoint);
+    if (entries[hole].slot != slot) return;
+    for (guint j = (hole + 1) & mask; entries[j].slot >= 0; j = (j + 1) & mask) {
+        const UvRelayIndexEntry *e = &entries[j];
+        guint home = relay_index_hash(e->addr, e->port, e->ssrc, e->endpoint) & mask;
+        /* e may fill the hole only if the hole lies on its probe path. */
+        if (((j - home) & mask) >= ((j - hole) & mask)) {
+            entries[hole] = *e;
+            hole = j;
+        }
+    }
+    entries[hole].slot = -1;
+}
+
+/* ---- LRU order of the UDP sources (guarded by rc->lock) ---- */
+
+static void relay_lru_unlink(RelayController *rc, int idx) {
+    UvRelaySource *src = &rc->sources[idx];
+    if (src->lru_prev >= 0) rc->sources[src->lru_prev].lru_next = src->lru_next;
+    else rc->index.lru_head = src->lru_next;
+    if (src->lru_next >= 0) rc->sources[src->lru_next].lru_prev = src->lru_prev;
+    else rc->index.lru_tail = src->lru_prev;
+    src->lru_prev = -1;
+    src->lru_next = -1;
+}
+
+static void relay_lru_push_front(RelayController *rc, int idx) {
+    UvRelaySource *src = &rc->sources[idx];
+    src->lru_prev = -1;
+    src->lru_next = rc->index.lru_head;
+    if (rc->index.lru_head >= 0) rc->sources[rc->index.lru_head].lru_prev = idx;
+    rc->index.lru_head = idx;
+    if (rc->index.lru_tail < 0) rc->index.lru_tail = idx;
+}
+
+static inline void relay_lru_touch(RelayController *rc, int idx, gint64 now_us) {
+    rc->sources[idx].lru_touch_us = now_us;
+    if (rc->index.lru_head == idx) return;
+    relay_lru_unlink(rc, idx);
+    relay_lru_push_front(rc, idx);
+}
+
+/* Find a slot for a new source: the next unused one, else the least
+ * recently heard UDP source that has been silent for UV_RELAY_EVICT_IDLE_US
+ * and is not selected. A recycled slot is unindexed and wiped under its own
+ * lock (a grid setter may still visit it). Returns -1 when nothing is free. */
+static int relay_source_claim(RelayController *rc, gint64 now_us, gboolean *evicted) {
+    *evicted = FALSE;
+    if (rc->sources_count < rc->sources_max) {
+        int idx = (int)rc->sources_count;
+        relay_source_wipe(&rc->sources[idx]);
+        return idx;
+    }
+    for (int idx = rc->index.lru_tail; idx >= 0; idx = rc->sources[idx].lru_prev) {
+        UvRelaySource *old = &rc->sources[idx];
+        if (now_us - old->lru_touch_us < UV_RELAY_EVICT_IDLE_US) break;
+        if (idx == rc->selected_index) continue;
+
+        uint32_t addr = old->addr.sin_addr.s_addr;
+        uint16_t port = old->addr.sin_port;
+        if (old->ssrc_bound) relay_index_remove(rc, addr, port, old->ssrc, FALSE, idx);
+        relay_index_remove(rc, addr, port, 0, TRUE, idx);
+        relay_lru_unlink(rc, idx);
+
+        relay_gop_free(rc, old);
+        g_mutex_lock(&old->lock);
+        relay_source_free_storage(old);
+        relay_source_wipe(old);
+        g_mutex_unlock(&old->lock);
+
+        rc->index.evictions++;
+        *evicted = TRUE;
+        return idx;
+    }
+    return -1;
+}
+
+/* Point an endpoint's slot at a new SSRC: the sender restarted. Its
+ * counters start over, as after a sequence restart, and so does the GOP
+ * cache. Caller holds rc->lock. */
+static void relay_source_rebind(RelayController *rc, int idx, uint32_t ssrc, gint64 now_us) {
+    UvRelaySource *slot = &rc->sources[idx];
+    uint32_t addr = slot->addr.sin_addr.s_addr;
+    uint16_t port = slot->addr.sin_port;
+    relay_index_remove(rc, addr, port, slot->ssrc, FALSE, idx);
+    slot->ssrc = ssrc;
+    slot->ssrc_seen_us = now_us;
+    relay_index_set(rc, addr, port, ssrc, FALSE, idx);
+    relay_gop_free(rc, slot);
+    g_mutex_lock(&slot->lock);
+    relay_source_clear_stats(slot, FALSE);
+    relay_source_publish(slot, rc->viewer->config.clock_rate, now_us);
+    g_mutex_unlock(&slot->lock);
+    if (idx == rc->selected_index) relay_stream_restart(rc);
+}
+
+/* Resolve a datagram to its source, creating one for a new key. Packets of
+ * the video payload type are keyed by (address, port, SSRC); anything else
+ * (audio sharing the port, non-RTP) follows the endpoint key to the video
+ * source last seen on that address:port. A source first created by such a
+ * packet adopts the first video SSRC that arrives on its endpoint.
+ *
+ * A new SSRC on an endpoint whose slot is bound to another takes that slot
+ * over when the old SSRC has gone quiet (a restarted encoder). Otherwise
+ * it gets a slot of its own, and if the endpoint's slot was selected the
+ * selection moves with it, as the endpoint key does: the sender is now
+ * sending that SSRC. */
+static bool relay_add_or_find(RelayController *rc, const struct sockaddr_in *from,
+                              socklen_t fromlen, const unsigned char *pkt, size_t len,
+                              gint64 now_us, int *out_idx, gboolean *evicted) {
+    uint32_t addr = from->sin_addr.s_addr;
+    uint16_t port = from->sin_port;
+    gboolean video = len >= 12 && (pkt[0] >> 6) == 2 &&
+                     (pkt[1] & 0x7F) == rc->viewer->config.payload_type;
+    uint32_t ssrc = video ? ((uint32_t)pkt[8] << 24) | ((uint32_t)pkt[9] << 16) |
+                            ((uint32_t)pkt[10] << 8) | (uint32_t)pkt[11]
+                          : 0u;
+    *evicted = FALSE;
+
+    int idx = video ? relay_index_get(rc, addr, port, ssrc, FALSE) : -1;
+    int follow = -1;
+    if (idx < 0) {
+        idx = relay_index_get(rc, addr, port, 0, TRUE);
+        if (idx >= 0 && video) {
+            UvRelaySource *slot = &rc->sources[idx];
+            if (!slot->ssrc_bound) {
+                slot->ssrc = ssrc;
+                slot->ssrc_bound = TRUE;
+                relay_index_set(rc, addr, port, ssrc, FALSE, idx);
+            } else if (now_us - slot->ssrc_seen_us >= UV_RELAY_SSRC_REBIND_US) {
+                char addr_str[64];
+                addr_to_str(&slot->addr, addr_str, sizeof(addr_str));
+                uv_log_info("Relay: source [%d] %s:%u restarted as SSRC %08x", idx, addr_str,
+                            (unsigned)ntohs(port), ssrc);
+                relay_source_rebind(rc, idx, ssrc, now_us);
+            } else {
+                if (idx == rc->selected_index) follow = idx;
+                idx = -1;
             }
-            slot->addr = *from;
-            slot->addrlen = fromlen;
-            if (out_idx) *out_idx = (int)i;
-            return FALSE;
         }
     }
-    if (rc->sources_count >= UV_RELAY_MAX_SOURCES) return FALSE;
-    UvRelaySource *ns = &rc->sources[rc->sources_count];
-    memset(ns, 0, sizeof(*ns));
+    if (idx >= 0) {
+        if (video) rc->sources[idx].ssrc_seen_us = now_us;
+        relay_lru_touch(rc, idx, now_us);
+        if (out_idx) *out_idx = idx;
+        return FALSE;
+    }
+
+    idx = relay_source_claim(rc, now_us, evicted);
+    if (idx < 0) {
+        rc->index.rejects++;
+        return FALSE;
+    }
+    UvRelaySource *ns = &rc->sources[idx];
     ns->kind = UV_SOURCE_UDP;
     ns->addr = *from;
     ns->addrlen = fromlen;
+    ns->ssrc = ssrc;
+    ns->ssrc_bound = video;
+    ns->ssrc_seen_us = now_us;
     ns->in_use = TRUE;
     relay_source_clear_stats(ns, TRUE);
-    if (out_idx) *out_idx = (int)rc->sources_count;
-    rc->sources_count++;
+    if (video) relay_index_set(rc, addr, port, ssrc, FALSE, idx);
+    relay_index_set(rc, addr, port, 0, TRUE, idx);
+    ns->lru_touch_us = now_us;
+    relay_lru_push_front(rc, idx);
+    relay_source_publish(ns, rc->viewer->config.clock_rate, now_us);
+    if (out_idx) *out_idx = idx;
+    /* Lock-free readers bound their scan by sources_count: publish the
+     * slot before making it reachable. */
+    if ((guint)idx == rc->sources_count) g_atomic_int_inc(&rc->sources_count);
+    if (follow >= 0 && follow == rc->selected_index) {
+        g_atomic_int_set(&rc->selected_index, idx);
+        relay_stream_restart(rc);
+    }
     return TRUE;
 }
 
-/* Compute the 32-bit extended sequence for a 16-bit RTP seq, advancing the
- * cycle counter on a normal wrap. Measures the delta against the running max
- * (not just the previous packet) so a reset sequence space is recognised as a
- * discontinuity via *jumped rather than masquerading as a flood of reorders. */
-static inline uint32_t rtp_ext_seq(UvRelaySource *s, uint16_t seq16, gboolean *jumped) {
-    *jumped = FALSE;
-    uint16_t max_seq16 = (uint16_t)(s->rtp_max_ext_seq & 0xffffu);
-    uint16_t udelta = (uint16_t)(seq16 - max_seq16);
-    if (udelta < UV_RTP_MAX_DROPOUT) {
-        if (seq16 < max_seq16) s->rtp_cycles += 1u << 16; /* in-order wrap */
-    } else if (udelta <= (uint16_t)(0x10000u - UV_RTP_MAX_MISORDER)) {
-        *jumped = TRUE; /* large gap or reset: sequence space is discontinuous */
+/* Start the sequence window at ext: everything before it reads as arrived
+ * (it was never expected), ext itself as not yet seen. */
+static inline void rtp_window_reset(UvRelaySource *s, uint32_t ext) {
+    memset(s->rtp_seq_bits, 0xff, sizeof(s->rtp_seq_bits));
+    guint pos = ext % UV_RTP_WIN_SIZE;
+    s->rtp_seq_bits[pos >> 6] &= ~(1ull << (pos & 63u));
+}
+
+/* Slide the window's top from rtp_max_ext_seq up to ext. The positions
+ * (max, ext] are recycled a word at a time; whatever they still held for
+ * the sequence numbers one window earlier and never saw is final loss. */
+static inline void rtp_window_advance(UvRelaySource *s, uint32_t ext) {
+    uint32_t d = ext - s->rtp_max_ext_seq;
+    uint64_t lost = 0;
+    if (d >= UV_RTP_WIN_SIZE) {
+        for (guint w = 0; w < UV_RTP_WIN_WORDS; w++) {
+            lost += 64u - (guint)__builtin_popcountll(s->rtp_seq_bits[w]);
+            s->rtp_seq_bits[w] = 0;
+        }
+        lost += d - UV_RTP_WIN_SIZE;
+    } else {
+        guint pos = (s->rtp_max_ext_seq + 1u) % UV_RTP_WIN_SIZE;
+        while (d > 0) {
+            guint bit = pos & 63u;
+            guint n = MIN(64u - bit, d);
+            uint64_t mask = (n == 64u) ? ~0ull : ((1ull << n) - 1u) << bit;
+            uint64_t *word = &s->rtp_seq_bits[pos >> 6];
+            lost += n - (guint)__builtin_popcountll(*word & mask);
+            *word &= ~mask;
+            pos = (pos + n) % UV_RTP_WIN_SIZE;
+            d -= n;
+        }
     }
-    /* else: small step backwards — a genuine duplicate or reordered packet. */
-    return s->rtp_cycles + seq16;
+    s->rtp_window_lost += lost;
 }
 
 /* Rebase RTP tracking onto a fresh sequence space after a confirmed restart so
@@ -439,18 +739,24 @@ static inline void rtp_resync(UvRelaySource *s, uint16_t seq16) {
     s->rtp_unique_packets = 0;
     s->rtp_duplicate_packets = 0;
     s->rtp_reordered_packets = 0;
-    for (guint i = 0; i < UV_RTP_WIN_SIZE; ++i) {
-        s->rtp_seq_slot[i] = UV_RTP_SLOT_EMPTY;
-    }
+    s->rtp_window_lost = 0;
+    rtp_window_reset(s, seq16);
     s->jitter_initialized = FALSE;
     s->jitter_prev_transit = 0;
-    s->jitter_value = 0.0;
+    s->jitter_q4 = 0;
 }
 
+/* floor(us * clock_rate / 1e6) modulo 2^32, in integers: whole seconds
+ * scale by the rate exactly, and the sub-second remainder times the rate
+ * stays below 2^52 for any sane rate. Both divisions are by a constant, so
+ * they compile to multiply-shift; nothing here touches the FPU (long double
+ * is soft-float quad precision on AArch64). */
 static inline uint32_t rtp_now_ts_from_us(int clock_rate, gint64 us) {
-    long double ts = ((long double)us * (long double)clock_rate) / 1000000.0L;
-    if (ts < 0) ts = 0;
-    return (uint32_t)((uint64_t)ts);
+    if (us <= 0 || clock_rate <= 0) return 0;
+    uint64_t sec = (uint64_t)us / 1000000u;
+    uint64_t rem = (uint64_t)us % 1000000u;
+    uint64_t rate = (uint64_t)clock_rate;
+    return (uint32_t)(sec * rate + (rem * rate) / 1000000u);
 }
 
 static inline uint32_t rtp_now_ts(int clock_rate) {
@@ -461,27 +767,29 @@ static void source_record_marker_frame(UvRelaySource *src, gint64 arrival_us) {
     if (!src || arrival_us <= 0) return;
 
     src->rtp_marker_frames++;
-    src->frame_times_us[src->frame_times_head] = arrival_us;
-    src->frame_times_head = (src->frame_times_head + 1u) % UV_SOURCE_FRAME_FPS_WINDOW_SAMPLES;
-    if (src->frame_times_count < UV_SOURCE_FRAME_FPS_WINDOW_SAMPLES) {
-        src->frame_times_count++;
+    UvRelaySourceCold *cold = relay_source_cold(src);
+    cold->frame_times_us[cold->frame_times_head] = arrival_us;
+    cold->frame_times_head = (cold->frame_times_head + 1u) % UV_SOURCE_FRAME_FPS_WINDOW_SAMPLES;
+    if (cold->frame_times_count < UV_SOURCE_FRAME_FPS_WINDOW_SAMPLES) {
+        cold->frame_times_count++;
     }
 }
 
 static void hevc_count_nal_type(UvRelaySource *s, uint8_t nal_type, gint64 arrival_us);
 
 static double source_marker_window_fps(const UvRelaySource *src, gint64 now_us) {
-    if (!src || src->frame_times_count < 2 || now_us <= 0) return 0.0;
+    const UvRelaySourceCold *cold = src ? src->cold : NULL;
+    if (!cold || cold->frame_times_count < 2 || now_us <= 0) return 0.0;
 
     const gint64 window_start_us = now_us - G_USEC_PER_SEC;
     const guint capacity = UV_SOURCE_FRAME_FPS_WINDOW_SAMPLES;
-    const guint oldest = (src->frame_times_head + capacity - src->frame_times_count) % capacity;
+    const guint oldest = (cold->frame_times_head + capacity - cold->frame_times_count) % capacity;
     guint count = 0;
     gint64 first_us = 0;
     gint64 last_us = 0;
 
-    for (guint i = 0; i < src->frame_times_count; i++) {
-        gint64 ts = src->frame_times_us[(oldest + i) % capacity];
+    for (guint i = 0; i < cold->frame_times_count; i++) {
+        gint64 ts = cold->frame_times_us[(oldest + i) % capacity];
         if (ts < window_start_us || ts > now_us) continue;
         if (count == 0) first_us = ts;
         last_us = ts;
@@ -514,6 +822,7 @@ void uv_internal_populate_source_stats(const UvRelaySource *src, int clock_rate,
         out->rtp_lost_packets = UINT64_MAX;
         out->rtp_duplicate_packets = UINT64_MAX;
         out->rtp_reordered_packets = UINT64_MAX;
+        out->rtp_window_lost_packets = UINT64_MAX;
         out->rtp_ap_packets = UINT64_MAX;
         out->rtp_fu_packets = UINT64_MAX;
         out->rfc3550_jitter_ms = -1.0;
@@ -527,11 +836,12 @@ void uv_internal_populate_source_stats(const UvRelaySource *src, int clock_rate,
     if (src->kind != UV_SOURCE_SHM) {
         out->rtp_duplicate_packets = src->rtp_duplicate_packets;
         out->rtp_reordered_packets = src->rtp_reordered_packets;
+        out->rtp_window_lost_packets = src->rtp_window_lost;
     }
     out->rtp_marker_frames = src->rtp_marker_frames;
     out->rtp_marker_fps = source_marker_window_fps(src, now_us);
-    if (src->kind != UV_SOURCE_SHM && src->jitter_value > 0.0) {
-        out->rfc3550_jitter_ms = (src->jitter_value * 1000.0) / (double)MAX(clock_rate, 1);
+    if (src->kind != UV_SOURCE_SHM && src->jitter_q4 > 0) {
+        out->rfc3550_jitter_ms = ((double)src->jitter_q4 * 1000.0 / 16.0) / (double)MAX(clock_rate, 1);
     }
     if (src->last_seen_us > 0) {
         out->seconds_since_last_seen = (double)(now_us - src->last_seen_us) / 1e6;
@@ -540,9 +850,221 @@ void uv_internal_populate_source_stats(const UvRelaySource *src, int clock_rate,
     }
 }
 
+/* Publish the source's counters for lock-free readers. Caller holds
+ * src->lock, or owns a slot no other thread can reach yet. */
+static void relay_source_publish(UvRelaySource *src, int clock_rate, gint64 now_us) {
+    UvSourcePub p;
+    memset(&p, 0, sizeof(p));
+    UvSourceStats *s = &p.stats;
+    uv_internal_populate_source_stats(src, clock_rate, now_us, s);
+    s->hevc_idr_count       = src->hevc_idr_count;
+    s->hevc_cra_count       = src->hevc_cra_count;
+    s->hevc_trail_count     = src->hevc_trail_count;
+    s->hevc_vps_count       = src->hevc_vps_count;
+    s->hevc_sps_count       = src->hevc_sps_count;
+    s->hevc_pps_count       = src->hevc_pps_count;
+    s->hevc_aud_count       = src->hevc_aud_count;
+    s->hevc_sei_count       = src->hevc_sei_count;
+    s->hevc_other_nal_count = src->hevc_other_nal_count;
+    if (src->kind != UV_SOURCE_SHM) {
+        s->rtp_ap_packets = src->rtp_ap_packets;
+        s->rtp_fu_packets = src->rtp_fu_packets;
+    }
+    s->seconds_since_keyframe = -1.0;
+    if (src->last_keyframe_us > 0 && src->prev_keyframe_us > 0
+        && src->last_keyframe_us > src->prev_keyframe_us) {
+        s->last_keyframe_interval_seconds =
+            (double)(src->last_keyframe_us - src->prev_keyframe_us) / 1e6;
+    } else {
+        s->last_keyframe_interval_seconds = -1.0;
+    }
+    p.published_us = now_us;
+    p.last_seen_us = src->last_seen_us;
+    p.last_keyframe_us = src->last_keyframe_us;
+    uv_seqlock_publish(&src->pub_seq, &src->pub, &p, sizeof(p));
+    src->pub_dirty = FALSE;
+}
+
+/* Note that the source's counters moved and publish them if the last
+ * publish is older than UV_STATS_PUBLISH_INTERVAL_US. Anything left dirty
+ * is flushed by the relay thread's sweep. Caller holds src->lock. */
+static void relay_source_touch(UvRelaySource *src, int clock_rate, gint64 now_us) {
+    if (now_us - src->pub.published_us >= UV_STATS_PUBLISH_INTERVAL_US) {
+        relay_source_publish(src, clock_rate, now_us);
+    } else {
+        src->pub_dirty = TRUE;
+    }
+}
+
+/* Publish the controller-level reader view. Caller holds rc->lock, which
+ * also serialises the writers. */
+static void relay_publish_locked(RelayController *rc, gint64 now_us) {
+    UvRelayPub p;
+    memset(&p, 0, sizeof(p));
+
+    UvIngestStats *ing = &p.ingest;
+    ing->backend = rc->backend;
+    ing->recv_batch_size = rc->ingest.batch_size;
+    ing->recv_batches = rc->ingest.batches;
+    ing->recv_datagrams = rc->ingest.datagrams;
+    ing->recv_batch_last = rc->ingest.batch_last;
+    ing->recv_batch_peak = rc->ingest.batch_peak;
+    if (rc->ingest.batches > 0) {
+        ing->recv_batch_avg = (double)rc->ingest.datagrams / (double)rc->ingest.batches;
+    }
+    ing->pool_buffers = rc->ingest.pool_buffers;
+    ing->pool_buffer_size = rc->ingest.pool_buffers > 0 ? UV_RELAY_POOL_BUF_SIZE : 0u;
+    ing->pool_allocated = rc->ingest.pool_allocated;
+    ing->pool_recycled = rc->ingest.pool_recycled;
+    ing->pool_copies = rc->ingest.pool_copies;
+    relay_lock_stats_export(&rc->ingest.registry_lock, &ing->registry_lock);
+    relay_lock_stats_export(&rc->ingest.source_lock, &ing->source_lock);
+    ing->sources_max = rc->sources_max;
+    ing->sources_used = rc->sources_count;
+    ing->source_lookups = rc->index.lookups;
+    if (rc->index.lookups > 0) {
+        ing->source_probe_avg = (double)rc->index.probes / (double)rc->index.lookups;
+    }
+    ing->source_evictions = rc->index.evictions;
+    ing->source_rejects = rc->index.rejects;
+    ing->workers = rc->workers_count;
+    ing->rx_delay_median_us = -1.0;
+    for (guint i = 0; i < rc->workers_count; i++) {
+        const UvRelayWorker *w = &rc->workers[i];
+        ing->worker[i].cpu = w->cpu;
+        ing->worker[i].batches = w->batches;
+        ing->worker[i].datagrams = w->datagrams;
+        ing->worker[i].kernel_drops = w->kernel_drops;
+        ing->worker[i].kernel_timestamps = w->kernel_ts;
+        ing->worker[i].backend = w->backend;
+        ing->worker[i].syscalls = w->syscalls;
+        if (w->datagrams > 0) {
+            ing->worker[i].syscalls_per_datagram = (double)w->syscalls / (double)w->datagrams;
+        }
+        if (w->batches > 0) {
+            ing->worker[i].batch_us_avg = (double)w->batch_ns_total / (double)w->batches / 1000.0;
+        }
+        ing->worker[i].batch_us_max = (double)w->batch_ns_max / 1000.0;
+        ing->worker[i].buffer_stalls = w->buffer_stalls;
+        ing->worker[i].rx_delay_median_us = w->rx_delay_median_ns >= 0
+            ? (double)w->rx_delay_median_ns / 1000.0 : -1.0;
+        ing->worker[i].rx_delay_max_us = w->rx_delay_max_ns >= 0
+            ? (double)w->rx_delay_max_ns / 1000.0 : -1.0;
+        ing->rx_delay_median_us = MAX(ing->rx_delay_median_us, ing->worker[i].rx_delay_median_us);
+        ing->worker[i].analytics_overruns = w->analytics_overruns;
+        ing->analytics_overruns += w->analytics_overruns;
+        uint64_t tail = __atomic_load_n(&w->analytics.tail, __ATOMIC_RELAXED);
+        ing->analytics_records += tail;
+        ing->analytics_backlog += (guint)(__atomic_load_n(&w->analytics.head, __ATOMIC_RELAXED) - tail);
+    }
+    ing->analytics_thread = rc->analytics.thread != NULL;
+    ing->analytics_ring_size = rc->analytics.ring_size;
+    if (rc->backend == UV_RELAY_BACKEND_REPLAY) {
+        ing->replay_finished = g_atomic_int_get(&rc->replay.finished) != 0;
+        ing->replay_fast = rc->replay.fast;
+        ing->replay_datagrams = __atomic_load_n(&rc->replay.datagrams, __ATOMIC_RELAXED);
+        ing->replay_skipped = __atomic_load_n(&rc->replay.skipped, __ATOMIC_RELAXED);
+        ing->replay_capture_s = (double)__atomic_load_n(&rc->replay.capture_us, __ATOMIC_RELAXED) / 1e6;
+        ing->replay_wall_s = (double)__atomic_load_n(&rc->replay.wall_us, __ATOMIC_RELAXED) / 1e6;
+    }
+    ing->gop_cache_kb = (guint)(rc->gop.cap / 1024u);
+    ing->gop_cache_sources = rc->gop.sources;
+    ing->gop_cache_bytes = rc->gop.bytes;
+    ing->gop_cache_overflows = rc->gop.overflows;
+    ing->gop_flushes = rc->gop.flushes;
+    ing->gop_flush_frames = rc->gop.flush_frames;
+    ing->gop_flush_packets = rc->gop.flush_packets;
+    ing->gop_flush_bytes = rc->gop.flush_bytes;
+    ing->direct_au = rc->direct_au;
+    if (rc->direct_au) {
+        g_mutex_lock(&rc->direct.lock);
+        ing->direct_au_loss = rc->direct.loss;
+        ing->direct_aus = rc->direct.aus;
+        ing->direct_au_bytes = rc->direct.bytes;
+        ing->direct_au_partial = rc->direct.partial;
+        ing->direct_au_dropped = rc->direct.dropped;
+        ing->direct_nals_dropped = rc->direct.nals_dropped;
+        ing->direct_lost_packets = rc->direct.lost_packets;
+        ing->direct_late_packets = rc->direct.late_packets;
+        g_mutex_unlock(&rc->direct.lock);
+    }
+    ing->hold_enabled = rc->marker_release;
+    if (rc->marker_release) {
+        g_mutex_lock(&rc->hold.lock);
+        const RelayHold *h = &rc->hold;
+        uint64_t released = h->frames + h->timeouts;
+        ing->hold_latency_ms = __atomic_load_n(&rc->viewer->config.jitter_latency_ms, __ATOMIC_RELAXED);
+        ing->hold_frames = h->frames;
+        ing->hold_timeouts = h->timeouts;
+        ing->hold_lost_packets = h->lost_packets;
+        ing->hold_late_packets = h->late_packets;
+        ing->hold_overflows = h->overflows;
+        ing->hold_max_ms = (double)h->hold_us_max / 1000.0;
+        if (released > 0) {
+            ing->hold_avg_ms = (double)h->hold_us_total / 1000.0 / (double)released;
+            ing->hold_saved_avg_ms = (double)h->saved_us_total / 1000.0 / (double)released;
+        }
+        g_mutex_unlock(&rc->hold.lock);
+    }
+
+    /* Restream counters live in the fan-out and are read there by
+     * relay_controller_restream_snapshot(); only the switch is published. */
+    p.restream.enabled = rc->restream.enabled;
+
+    UvFrameBlockStats *fb = &p.frame_block;
+    fb->active = rc->frame_block.enabled;
+    fb->paused = rc->frame_block.paused;
+    fb->snapshot_mode = rc->frame_block.snapshot_mode;
+    fb->width = rc->frame_block.width;
+    fb->height = rc->frame_block.height;
+    memcpy(fb->thresholds_lateness_ms, rc->frame_block.thresholds_ms, sizeof(fb->thresholds_lateness_ms));
+    memcpy(fb->thresholds_size_kb, rc->frame_block.thresholds_kb, sizeof(fb->thresholds_size_kb));
+    memcpy(fb->thresholds_span_ms, rc->frame_block.thresholds_span, sizeof(fb->thresholds_span_ms));
+    memcpy(fb->thresholds_chunks, rc->frame_block.thresholds_chunks, sizeof(fb->thresholds_chunks));
+    memcpy(fb->thresholds_fpc, rc->frame_block.thresholds_fpc, sizeof(fb->thresholds_fpc));
+
+    UvReleaseStats *fr = &p.frame_release;
+    fr->active = rc->frame_release.enabled;
+    fr->paused = rc->frame_release.paused;
+    fr->gap_us = rc->frame_release.gap_us > 0.0 ? rc->frame_release.gap_us
+                                                : UV_RELEASE_DEFAULT_GAP_US;
+    fr->calib_active = rc->frame_release.calib_active;
+    fr->calib_seq = rc->frame_release.calib_seq;
+    fr->calib_gap_us = rc->frame_release.calib_gap_us;
+    fr->calib_confident = rc->frame_release.calib_confident;
+
+    p.published_us = now_us;
+    uv_seqlock_publish(&rc->pub_seq, &rc->pub, &p, sizeof(p));
+}
+
+/* Flush sources left dirty by rate limiting, then the controller view.
+ * Runs on the relay thread. Returns TRUE while something is still waiting
+ * out its publish interval. */
+static gboolean relay_publish_sweep(RelayController *rc, UvLockStats *source_lock,
+                                    int clock_rate, gint64 now_us) {
+    gboolean pending = FALSE;
+    guint count = g_atomic_int_get(&rc->sources_count);
+    for (guint i = 0; i < count; i++) {
+        UvRelaySource *src = &rc->sources[i];
+        relay_lock_timed(&src->lock, source_lock);
+        if (src->pub_dirty) {
+            if (now_us - src->pub.published_us >= UV_STATS_PUBLISH_INTERVAL_US) {
+                relay_source_publish(src, clock_rate, now_us);
+            } else {
+                pending = TRUE;
+            }
+        }
+        g_mutex_unlock(&src->lock);
+    }
+    relay_lock_timed(&rc->lock, &rc->ingest.registry_lock);
+    relay_publish_locked(rc, now_us);
+    g_mutex_unlock(&rc->lock);
+    return pending;
+}
+
 int relay_controller_register_shm(RelayController *rc, const char *label) {
     int index = -1;
-    UvRelaySource snapshot = {0};
+    UvSourceStats snapshot = {0};
     gboolean added = FALSE;
     g_mutex_lock(&rc->lock);
     for (guint i = 0; i < rc->sources_count; i++) {
@@ -552,17 +1074,24 @@ int relay_controller_register_shm(RelayController *rc, const char *label) {
             break;
         }
     }
-    if (index < 0 && rc->sources_count < UV_RELAY_MAX_SOURCES) {
-        index = (int)rc->sources_count++;
+    if (index < 0 && rc->sources_count < rc->sources_max) {
+        index = (int)rc->sources_count;
         UvRelaySource *src = &rc->sources[index];
-        memset(src, 0, sizeof(*src));
+        relay_source_wipe(src);
         src->kind = UV_SOURCE_SHM;
         src->in_use = TRUE;
         g_strlcpy(src->label, label, sizeof(src->label));
         relay_source_clear_stats(src, TRUE);
+        relay_source_publish(src, rc->viewer->config.clock_rate, relay_now_us(rc));
+        g_atomic_int_inc(&rc->sources_count);
         added = TRUE;
     }
-    if (index >= 0) snapshot = rc->sources[index];
+    if (index >= 0) {
+        g_mutex_lock(&rc->sources[index].lock);
+        uv_internal_populate_source_stats(&rc->sources[index], rc->viewer->config.clock_rate,
+                                          relay_now_us(rc), &snapshot);
+        g_mutex_unlock(&rc->sources[index].lock);
+    }
     g_mutex_unlock(&rc->lock);
     if (added) uv_internal_emit_event(rc->viewer, UV_VIEWER_EVENT_SOURCE_ADDED,
                                       index, &snapshot, NULL);
@@ -571,50 +1100,47 @@ int relay_controller_register_shm(RelayController *rc, const char *label) {
 
 static void hevc_parse_annex_b_stats(UvRelaySource *src, const uint8_t *au,
                                      size_t len, gint64 now_us) {
-    size_t i = 0;
-    while (i + 4 <= len) {
-        size_t start = SIZE_MAX;
-        for (; i + 3 <= len; i++) {
-            if (au[i] == 0 && au[i + 1] == 0 && au[i + 2] == 1) {
-                start = i + 3;
-                break;
-            }
-            if (i + 4 <= len && au[i] == 0 && au[i + 1] == 0 &&
-                au[i + 2] == 0 && au[i + 3] == 1) {
-                start = i + 4;
-                break;
-            }
-        }
-        if (start == SIZE_MAX || start >= len) break;
-        hevc_count_nal_type(src, (uint8_t)((au[start] >> 1) & 0x3f), now_us);
-        i = start + 1;
+    size_t pos = 0;
+    while ((pos = annexb_find_start_code(au, len, pos)) + 3 < len) {
+        hevc_count_nal_type(src, (uint8_t)((au[pos + 3] >> 1) & 0x3f), now_us);
+        pos += 4;
     }
 }
 
 void relay_controller_shm_frame(RelayController *rc, int idx, const uint8_t *au,
                                 size_t len, const VencFrameMeta *meta) {
     (void)meta;
-    gint64 now_us = g_get_monotonic_time();
+    gint64 now_us = relay_now_us(rc);
+    UvRelaySource *src = NULL;
     g_mutex_lock(&rc->lock);
     if (idx >= 0 && (guint)idx < rc->sources_count &&
         rc->sources[idx].kind == UV_SOURCE_SHM) {
-        UvRelaySource *src = &rc->sources[idx];
-        src->rx_packets++;
-        src->rx_bytes += len;
-        src->last_seen_us = now_us;
-        source_record_marker_frame(src, now_us);
-        hevc_parse_annex_b_stats(src, au, len, now_us);
+        src = &rc->sources[idx];
     }
     g_mutex_unlock(&rc->lock);
+    if (!src) return;
+
+    /* The Annex-B walk covers the whole AU; keep it off the controller lock. */
+    g_mutex_lock(&src->lock);
+    src->rx_packets++;
+    src->rx_bytes += len;
+    src->last_seen_us = now_us;
+    source_record_marker_frame(src, now_us);
+    hevc_parse_annex_b_stats(src, au, len, now_us);
+    relay_source_touch(src, rc->viewer->config.clock_rate, now_us);
+    g_mutex_unlock(&src->lock);
 }
 
 void relay_controller_shm_reattached(RelayController *rc, int idx) {
-    UvRelaySource snapshot = {0};
+    UvSourceStats snapshot = {0};
     gboolean selected = FALSE;
     g_mutex_lock(&rc->lock);
     if (idx >= 0 && (guint)idx < rc->sources_count &&
         rc->sources[idx].kind == UV_SOURCE_SHM && rc->selected_index == idx) {
-        snapshot = rc->sources[idx];
+        g_mutex_lock(&rc->sources[idx].lock);
+        uv_internal_populate_source_stats(&rc->sources[idx], rc->viewer->config.clock_rate,
+                                          relay_now_us(rc), &snapshot);
+        g_mutex_unlock(&rc->sources[idx].lock);
         selected = TRUE;
     }
     g_mutex_unlock(&rc->lock);
@@ -637,17 +1163,67 @@ UvSourceKind relay_controller_source_kind(RelayController *rc, int index) {
 }
 
 /* Push a completed frame into the per-source cadence ring (oldest overwritten). */
-static void frame_ring_push(UvRelaySource *src, const UvReleaseFrame *frec) {
-    if (!src->frame_ring) return;
-    src->frame_ring[src->frame_ring_head] = *frec;
-    src->frame_ring_head = (src->frame_ring_head + 1u) % UV_RELEASE_FRAME_RING;
-    if (src->frame_ring_count < UV_RELEASE_FRAME_RING) src->frame_ring_count++;
+static void frame_ring_push(UvRelaySourceCold *cold, const UvReleaseFrame *frec) {
+    if (!cold->frame_ring) return;
+    cold->frame_ring[cold->frame_ring_head] = *frec;
+    cold->frame_ring_head = (cold->frame_ring_head + 1u) % UV_RELEASE_FRAME_RING;
+    if (cold->frame_ring_count < UV_RELEASE_FRAME_RING) cold->frame_ring_count++;
+}
+
+/* The analysis settings as the per-packet path sees them. The relay thread
+ * copies them out of rc->frame_block / rc->frame_release once per batch under
+ * rc->lock (relay_analysis_load), so the analytics below run under the source
+ * lock alone. Auto-calibration samples are collected here and folded back
+ * into rc->frame_release after the batch (relay_analysis_fold). */
+typedef struct {
+    gboolean fb_enabled;
+    gboolean fb_paused;
+    gboolean fb_snapshot_mode;
+    guint    fb_width;
+    guint    fb_height;
+    guint    fb_generation;
+    double   fb_thresholds_ms[3];
+    double   fb_thresholds_kb[3];
+    gboolean fr_enabled;
+    gboolean fr_paused;
+    double   fr_gap_us;
+    gboolean calib_active;
+    guint    calib_room;       /* samples still wanted, <= calib_capacity */
+    guint    calib_capacity;   /* size of calib_samples */
+    guint    calib_count;
+    double  *calib_samples;    /* log10(delta_us) collected this batch */
+    RestreamFanout *pace;      /* paced restream fed the frame period, NULL = off */
+} UvRelayAnalysis;
+
+/* Bring a source's grid in line with the analysis config: allocate it at the
+ * configured geometry, or re-apply the thresholds if the config has moved on
+ * since the grid last saw it. Caller holds src->lock. */
+static UvFrameBlockState *frame_block_sync(UvRelaySource *src, const UvRelayAnalysis *an) {
+    UvRelaySourceCold *cold = relay_source_cold(src);
+    UvFrameBlockState *state = cold->frame_block;
+    if (state && cold->frame_block_gen != an->fb_generation &&
+        (state->width != MAX(an->fb_width, 1u) || state->height != MAX(an->fb_height, 1u))) {
+        frame_block_state_free(state);
+        state = NULL;
+    }
+    if (!state) {
+        state = frame_block_state_new(an->fb_width, an->fb_height);
+        frame_block_state_apply_lateness_thresholds(state, an->fb_thresholds_ms);
+        frame_block_state_apply_size_thresholds(state, an->fb_thresholds_kb);
+        cold->frame_block = state;
+        cold->frame_block_gen = an->fb_generation;
+    } else if (cold->frame_block_gen != an->fb_generation) {
+        frame_block_state_apply_lateness_thresholds(state, an->fb_thresholds_ms);
+        frame_block_state_apply_size_thresholds(state, an->fb_thresholds_kb);
+        cold->frame_block_gen = an->fb_generation;
+    }
+    return state;
 }
 
 /* Record one completed frame into the frame-block grid. Caller has already
  * confirmed the grid is enabled+selected and computed the per-frame span /
  * chunks-per-frame / frames-per-chunk values. */
-static void frame_block_grid_record(RelayController *rc,
+static void frame_block_grid_record(const UvRelayAnalysis *an,
                                     UvRelaySource *src,
                                     uint32_t ts,
                                     gint64 arrival_us,
@@ -656,25 +1232,7 @@ static void frame_block_grid_record(RelayController *rc,
                                     double span_ms,
                                     double chunks_pf,
                                     double fpc) {
-    UvFrameBlockState *state = src->frame_block;
-    if (!state) {
-        state = frame_block_state_new(rc->frame_block.width, rc->frame_block.height);
-        frame_block_state_apply_lateness_thresholds(state, rc->frame_block.thresholds_ms);
-        frame_block_state_apply_size_thresholds(state, rc->frame_block.thresholds_kb);
-        src->frame_block = state;
-    }
-
-    if (rc->frame_block.reset_requested) {
-        frame_block_state_reset(state);
-    }
-    if (rc->frame_block.thresholds_dirty_ms) {
-        frame_block_state_apply_lateness_thresholds(state, rc->frame_block.thresholds_ms);
-        rc->frame_block.thresholds_dirty_ms = FALSE;
-    }
-    if (rc->frame_block.thresholds_dirty_kb) {
-        frame_block_state_apply_size_thresholds(state, rc->frame_block.thresholds_kb);
-        rc->frame_block.thresholds_dirty_kb = FALSE;
-    }
+    UvFrameBlockState *state = frame_block_sync(src, an);
 
     if (!state->have_baseline) {
         state->last_frame_ts = ts;
@@ -720,7 +1278,7 @@ static void frame_block_grid_record(RelayController *rc,
     state->last_frame_arrival_us = arrival_us;
     state->have_baseline = TRUE;
 
-    if (rc->frame_block.paused) return;
+    if (an->fb_paused) return;
 
     if (missing > 0) {
         if (state->last_missing_estimate == missing) {
@@ -746,12 +1304,12 @@ static void frame_block_grid_record(RelayController *rc,
     if (missing > 0) {
         for (guint m = 0; m < missing; m++) {
             frame_block_state_record(state, 0.0, 0.0, 0.0, 0.0, 0.0,
-                                     rc->frame_block.snapshot_mode, TRUE);
+                                     an->fb_snapshot_mode, TRUE);
         }
     }
 
     frame_block_state_record(state, lateness_ms, size_kb, span_ms, chunks_pf, fpc,
-                             rc->frame_block.snapshot_mode, FALSE);
+                             an->fb_snapshot_mode, FALSE);
 
     if (normalized_expected_ms > 0.0) {
         if (!state->have_expected_period) {
@@ -766,9 +1324,10 @@ static void frame_block_grid_record(RelayController *rc,
 
 /* Marker-packet handler: finalizes one frame. Computes the per-frame metrics
  * (span, chunks/frame, frames/chunk), maintains an independent marker-cadence
- * baseline (so the cadence ring + frame period work even when the grid is off),
- * pushes the frame to the cadence ring, and records into the grid when enabled. */
-static void frame_block_process_packet(RelayController *rc,
+ * baseline (so the cadence ring + frame period work even when the grid is off;
+ * the period also paces restream), pushes the frame to the cadence ring, and
+ * records into the grid when enabled. */
+static void frame_block_process_packet(const UvRelayAnalysis *an,
                                        UvRelaySource *src,
                                        uint32_t ts,
                                        gboolean marker,
@@ -776,124 +1335,129 @@ static void frame_block_process_packet(RelayController *rc,
                                        int clock_rate,
                                        gboolean is_selected,
                                        uint64_t frame_size_bytes) {
-    if (!rc || !src) return;
+    if (!an || !src) return;
     if (!marker) return;
 
-    gboolean grid_on = rc->frame_block.enabled && is_selected;
-    gboolean ring_on = rc->frame_release.enabled && is_selected;
+    gboolean grid_on = an->fb_enabled && is_selected;
+    gboolean ring_on = an->fr_enabled && is_selected;
+    gboolean pace_on = an->pace && is_selected;
 
-    if (!grid_on && !ring_on) {
-        if (src->frame_block) src->frame_block->have_baseline = FALSE;
-        src->have_marker_baseline = FALSE;
-        src->frame_open = FALSE;
+    UvRelaySourceCold *cold = src->cold;
+    if (!grid_on && !ring_on && !pace_on) {
+        if (!cold) return;
+        if (cold->frame_block) cold->frame_block->have_baseline = FALSE;
+        cold->have_marker_baseline = FALSE;
+        cold->frame_open = FALSE;
         return;
     }
+    cold = relay_source_cold(src);
 
     /* Per-frame metrics (independent of the grid). */
     double span_ms = 0.0;
-    if (src->frame_open && src->frame_first_pkt_us > 0 && arrival_us > src->frame_first_pkt_us) {
-        span_ms = (double)(arrival_us - src->frame_first_pkt_us) / 1000.0;
+    if (cold->frame_open && cold->frame_first_pkt_us > 0 && arrival_us > cold->frame_first_pkt_us) {
+        span_ms = (double)(arrival_us - cold->frame_first_pkt_us) / 1000.0;
     }
-    double chunks_pf = (double)src->frame_chunk_count;
-    double fpc = src->frame_overlap ? 2.0 : 1.0;
+    double chunks_pf = (double)cold->frame_chunk_count;
+    double fpc = cold->frame_overlap ? 2.0 : 1.0;
 
     /* Independent marker-cadence baseline → cadence lateness + frame period. */
     double cad_lateness_ms = 0.0;
-    if (src->have_marker_baseline) {
-        uint32_t cad_tsd = ts - src->last_marker_ts;
+    if (cold->have_marker_baseline) {
+        uint32_t cad_tsd = ts - cold->last_marker_ts;
         double cad_expected_ms = (clock_rate > 0)
             ? ((double)cad_tsd * 1000.0 / (double)clock_rate) : 0.0;
-        double cad_adl = (arrival_us > src->last_marker_us)
-            ? (double)(arrival_us - src->last_marker_us) / 1000.0 : 0.0;
+        double cad_adl = (arrival_us > cold->last_marker_us)
+            ? (double)(arrival_us - cold->last_marker_us) / 1000.0 : 0.0;
         cad_lateness_ms = cad_adl - cad_expected_ms;
         if (cad_lateness_ms < 0.0) cad_lateness_ms = 0.0;
         if (cad_expected_ms > 0.0 && cad_expected_ms < 10000.0) {
-            if (src->frame_period_ms <= 0.0) src->frame_period_ms = cad_expected_ms;
-            else src->frame_period_ms = 0.875 * src->frame_period_ms + 0.125 * cad_expected_ms;
+            if (cold->frame_period_ms <= 0.0) cold->frame_period_ms = cad_expected_ms;
+            else cold->frame_period_ms = 0.875 * cold->frame_period_ms + 0.125 * cad_expected_ms;
         }
+        if (pace_on) restream_fanout_set_frame_period(an->pace, cold->frame_period_ms);
     }
-    src->last_marker_ts = ts;
-    src->last_marker_us = arrival_us;
-    src->have_marker_baseline = TRUE;
+    cold->last_marker_ts = ts;
+    cold->last_marker_us = arrival_us;
+    cold->have_marker_baseline = TRUE;
 
-    if (ring_on && !rc->frame_release.paused) {
+    if (ring_on && !an->fr_paused) {
         UvReleaseFrame frec;
-        frec.first_us = (src->frame_open && src->frame_first_pkt_us > 0)
-                        ? src->frame_first_pkt_us : arrival_us;
+        frec.first_us = (cold->frame_open && cold->frame_first_pkt_us > 0)
+                        ? cold->frame_first_pkt_us : arrival_us;
         frec.marker_us = arrival_us;
-        frec.pkts = src->frame_pkts;
-        frec.chunks = src->frame_chunk_count;
+        frec.pkts = cold->frame_pkts;
+        frec.chunks = cold->frame_chunk_count;
         frec.lateness_ms = cad_lateness_ms;
-        frec.overlap = src->frame_overlap;
-        frame_ring_push(src, &frec);
+        frec.overlap = cold->frame_overlap;
+        frame_ring_push(cold, &frec);
     }
 
     if (grid_on) {
-        frame_block_grid_record(rc, src, ts, arrival_us, clock_rate,
+        frame_block_grid_record(an, src, ts, arrival_us, clock_rate,
                                 frame_size_bytes, span_ms, chunks_pf, fpc);
     }
 
-    src->frame_open = FALSE;
+    cold->frame_open = FALSE;
 }
 
 /* Lazily (de)allocate the per-source rings. Only the selected source with
  * frame_release enabled holds them, so the steady-state footprint is ~one
  * source's worth (~60 KB) instead of ~15 MB across all 256 slots. */
-static void release_rings_alloc(UvRelaySource *src) {
-    if (!src->release_ring) src->release_ring = g_new0(UvReleaseChunk, UV_RELEASE_CHUNK_RING);
-    if (!src->frame_ring)   src->frame_ring   = g_new0(UvReleaseFrame, UV_RELEASE_FRAME_RING);
+static void release_rings_alloc(UvRelaySourceCold *cold) {
+    if (!cold->release_ring) cold->release_ring = g_new0(UvReleaseChunk, UV_RELEASE_CHUNK_RING);
+    if (!cold->frame_ring)   cold->frame_ring   = g_new0(UvReleaseFrame, UV_RELEASE_FRAME_RING);
 }
 
-static void release_rings_free(UvRelaySource *src) {
-    if (src->release_ring) { g_free(src->release_ring); src->release_ring = NULL; }
-    if (src->frame_ring)   { g_free(src->frame_ring);   src->frame_ring = NULL; }
-    src->release_head = 0;
-    src->release_count = 0;
-    src->frame_ring_head = 0;
-    src->frame_ring_count = 0;
-    src->chunk_open = FALSE;
+static void release_rings_free(UvRelaySourceCold *cold) {
+    if (cold->release_ring) { g_free(cold->release_ring); cold->release_ring = NULL; }
+    if (cold->frame_ring)   { g_free(cold->frame_ring);   cold->frame_ring = NULL; }
+    cold->release_head = 0;
+    cold->release_count = 0;
+    cold->frame_ring_head = 0;
+    cold->frame_ring_count = 0;
+    cold->chunk_open = FALSE;
 }
 
 /* Push a finalized release burst into the per-source ring (oldest overwritten). */
-static void release_ring_push(UvRelaySource *src, gint64 t_us, guint pkts,
+static void release_ring_push(UvRelaySourceCold *cold, gint64 t_us, guint pkts,
                               guint frames, guint bytes, double gap_ms) {
-    if (!src->release_ring) return;
-    UvReleaseChunk *rec = &src->release_ring[src->release_head];
+    if (!cold->release_ring) return;
+    UvReleaseChunk *rec = &cold->release_ring[cold->release_head];
     rec->t_us = t_us;
     rec->pkts = pkts;
     rec->frames = frames;
     rec->bytes = bytes;
     rec->gap_ms = gap_ms;
     rec->overlap = (frames >= 2u);
-    src->release_head = (src->release_head + 1u) % UV_RELEASE_CHUNK_RING;
-    if (src->release_count < UV_RELEASE_CHUNK_RING) src->release_count++;
-    src->release_total++;
-    if (frames >= 2u) src->release_overlap++;
+    cold->release_head = (cold->release_head + 1u) % UV_RELEASE_CHUNK_RING;
+    if (cold->release_count < UV_RELEASE_CHUNK_RING) cold->release_count++;
+    cold->release_total++;
+    if (frames >= 2u) cold->release_overlap++;
 }
 
-static void release_close_chunk(RelayController *rc, UvRelaySource *src) {
-    if (!src->chunk_open) return;
-    if (rc->frame_release.enabled && !rc->frame_release.paused) {
-        release_ring_push(src, src->chunk_start_us, src->chunk_pkts,
-                          src->chunk_frames, src->chunk_bytes, src->chunk_gap_ms);
+static void release_close_chunk(const UvRelayAnalysis *an, UvRelaySourceCold *cold) {
+    if (!cold->chunk_open) return;
+    if (an->fr_enabled && !an->fr_paused) {
+        release_ring_push(cold, cold->chunk_start_us, cold->chunk_pkts,
+                          cold->chunk_frames, cold->chunk_bytes, cold->chunk_gap_ms);
     }
-    src->chunk_open = FALSE;
+    cold->chunk_open = FALSE;
 }
 
-static void release_state_clear(UvRelaySource *src) {
-    src->release_head = 0;
-    src->release_count = 0;
-    src->release_total = 0;
-    src->release_overlap = 0;
-    src->chunk_open = FALSE;
-    src->frame_open = FALSE;
-    src->last_pkt_us = 0;
-    src->frame_pkts = 0;
-    src->frame_overlap = FALSE;
-    src->frame_ring_head = 0;
-    src->frame_ring_count = 0;
-    src->have_marker_baseline = FALSE;
-    src->frame_period_ms = 0.0;
+static void release_state_clear(UvRelaySourceCold *cold) {
+    cold->release_head = 0;
+    cold->release_count = 0;
+    cold->release_total = 0;
+    cold->release_overlap = 0;
+    cold->chunk_open = FALSE;
+    cold->frame_open = FALSE;
+    cold->last_pkt_us = 0;
+    cold->frame_pkts = 0;
+    cold->frame_overlap = FALSE;
+    cold->frame_ring_head = 0;
+    cold->frame_ring_count = 0;
+    cold->have_marker_baseline = FALSE;
+    cold->frame_period_ms = 0.0;
 }
 
 /* Finish a gap auto-calibration pass: 1-D 2-means over the collected
@@ -954,110 +1518,145 @@ static void release_calib_finish(RelayController *rc) {
     rc->frame_release.calib_seq++;
 }
 
+/* Snapshot the analysis config for one batch. Caller holds rc->lock. The
+ * calibration collector (capacity entries) is owned by the caller. */
+static void relay_analysis_load(RelayController *rc, UvRelayAnalysis *an,
+                                double *calib_samples, guint capacity) {
+    an->fb_enabled = rc->frame_block.enabled;
+    an->fb_paused = rc->frame_block.paused;
+    an->fb_snapshot_mode = rc->frame_block.snapshot_mode;
+    an->fb_width = rc->frame_block.width ? rc->frame_block.width : UV_FRAME_BLOCK_DEFAULT_WIDTH;
+    an->fb_height = rc->frame_block.height ? rc->frame_block.height : UV_FRAME_BLOCK_DEFAULT_HEIGHT;
+    an->fb_generation = rc->frame_block.generation;
+    memcpy(an->fb_thresholds_ms, rc->frame_block.thresholds_ms, sizeof(an->fb_thresholds_ms));
+    memcpy(an->fb_thresholds_kb, rc->frame_block.thresholds_kb, sizeof(an->fb_thresholds_kb));
+    an->fr_enabled = rc->frame_release.enabled;
+    an->fr_paused = rc->frame_release.paused;
+    an->fr_gap_us = rc->frame_release.gap_us;
+    an->calib_active = rc->frame_release.calib_active && calib_samples && capacity > 0;
+    an->calib_capacity = capacity;
+    an->calib_room = 0;
+    if (an->calib_active && rc->frame_release.calib_count < UV_RELEASE_CALIB_SAMPLES) {
+        an->calib_room = MIN(capacity, UV_RELEASE_CALIB_SAMPLES - rc->frame_release.calib_count);
+    }
+    an->calib_count = 0;
+    an->calib_samples = calib_samples;
+    an->pace = rc->restream.enabled && rc->restream.fanout.pace_spread > 0.0 ? &rc->restream.fanout : NULL;
+}
+
+/* Append the batch's calibration samples and finish the pass once enough
+ * have landed. Caller holds rc->lock. A pass restarted mid-batch simply
+ * takes these samples as its first. */
+static void relay_analysis_fold(RelayController *rc, UvRelayAnalysis *an) {
+    guint n = an->calib_count;
+    an->calib_count = 0;
+    if (n == 0 || !rc->frame_release.calib_active) return;
+    if (!rc->frame_release.calib_samples) {
+        rc->frame_release.calib_samples = g_new0(double, UV_RELEASE_CALIB_SAMPLES);
+    }
+    guint room = UV_RELEASE_CALIB_SAMPLES - MIN(rc->frame_release.calib_count, UV_RELEASE_CALIB_SAMPLES);
+    n = MIN(n, room);
+    memcpy(rc->frame_release.calib_samples + rc->frame_release.calib_count,
+           an->calib_samples, n * sizeof(double));
+    rc->frame_release.calib_count += n;
+    if (rc->frame_release.calib_count >= UV_RELEASE_CALIB_SAMPLES) {
+        release_calib_finish(rc);
+    }
+}
+
 /* Per-unique-packet release tracking, run on the relay recv thread under
- * rc->lock. Groups packets into bursts ("chunks") separated by an idle gap >
+ * the source lock. Groups packets into bursts ("chunks") separated by an idle gap >
  * frame_release.gap_us — i.e. wfb-ng FEC block releases — and tracks how many
  * distinct frames each burst touches (>=2 == cross-frame overlap, the
  * drop-causing condition). Also drives the per-frame span / chunks-per-frame
  * metrics consumed by the frame-block grid. */
-static void release_process_packet(RelayController *rc, UvRelaySource *src,
+static void release_process_packet(UvRelayAnalysis *an, UvRelaySource *src,
                                    uint32_t ts, gboolean marker,
                                    gint64 arrival_us, guint len,
                                    gboolean is_selected) {
     (void)marker;
-    if (!rc || !src) return;
+    if (!an || !src) return;
 
-    gboolean track = is_selected && (rc->frame_block.enabled || rc->frame_release.enabled);
-    gboolean ring_on = is_selected && rc->frame_release.enabled;
+    gboolean track = is_selected && (an->fb_enabled || an->fr_enabled);
+    gboolean ring_on = is_selected && an->fr_enabled;
+    UvRelaySourceCold *cold = src->cold;
     if (!track) {
+        if (!cold) return;
         /* Feature off / not selected: drop in-flight state and release the
          * rings. The trailing in-flight burst (if any) is intentionally not
          * flushed — during steady capture the ring lags by at most one burst,
          * which closes on the next gap; at a transition the source's view is
          * discarded anyway. */
-        src->chunk_open = FALSE;
-        src->frame_open = FALSE;
-        src->last_pkt_us = 0;
-        release_rings_free(src);
+        cold->chunk_open = FALSE;
+        cold->frame_open = FALSE;
+        cold->last_pkt_us = 0;
+        release_rings_free(cold);
         return;
     }
+    cold = relay_source_cold(src);
 
     /* Rings exist only while the cadence/burst capture is on for this source. */
-    if (ring_on && !src->release_ring) release_rings_alloc(src);
-    else if (!ring_on && src->release_ring) release_rings_free(src);
-
-    if (rc->frame_release.reset_requested) {
-        release_state_clear(src);
-        rc->frame_release.reset_requested = FALSE;
-    }
+    if (ring_on && !cold->release_ring) release_rings_alloc(cold);
+    else if (!ring_on && cold->release_ring) release_rings_free(cold);
 
-    double gap_us = rc->frame_release.gap_us;
+    double gap_us = an->fr_gap_us;
     if (gap_us <= 0.0) gap_us = UV_RELEASE_DEFAULT_GAP_US;
 
     gboolean new_chunk = FALSE;
     double gap_ms = 0.0;
-    if (!src->chunk_open) {
+    if (!cold->chunk_open) {
         new_chunk = TRUE;
-    } else if (src->last_pkt_us > 0 && arrival_us > src->last_pkt_us) {
-        double delta_us = (double)(arrival_us - src->last_pkt_us);
+    } else if (cold->last_pkt_us > 0 && arrival_us > cold->last_pkt_us) {
+        double delta_us = (double)(arrival_us - cold->last_pkt_us);
         if (delta_us > gap_us) {
             gap_ms = delta_us / 1000.0;
-            release_close_chunk(rc, src);
+            release_close_chunk(an, cold);
             new_chunk = TRUE;
         }
     }
 
     if (new_chunk) {
-        src->chunk_open = TRUE;
-        src->chunk_start_us = arrival_us;
-        src->chunk_gap_ms = gap_ms;
-        src->chunk_pkts = 0;
-        src->chunk_bytes = 0;
-        src->chunk_frames = 0;
-        src->chunk_last_ts = 0;
+        cold->chunk_open = TRUE;
+        cold->chunk_start_us = arrival_us;
+        cold->chunk_gap_ms = gap_ms;
+        cold->chunk_pkts = 0;
+        cold->chunk_bytes = 0;
+        cold->chunk_frames = 0;
+        cold->chunk_last_ts = 0;
         /* A frame that is still open has now been split across another burst. */
-        if (src->frame_open) src->frame_chunk_count++;
+        if (cold->frame_open) cold->frame_chunk_count++;
     }
 
-    src->chunk_pkts++;
-    src->chunk_bytes += len;
-    if (src->chunk_frames == 0u || ts != src->chunk_last_ts) {
-        src->chunk_frames++;
+    cold->chunk_pkts++;
+    cold->chunk_bytes += len;
+    if (cold->chunk_frames == 0u || ts != cold->chunk_last_ts) {
+        cold->chunk_frames++;
     }
-    src->chunk_last_ts = ts;
+    cold->chunk_last_ts = ts;
 
-    if (!src->frame_open) {
-        src->frame_open = TRUE;
-        src->frame_first_pkt_us = arrival_us;
-        src->frame_chunk_count = 1u; /* counts the burst this first packet is in */
-        src->frame_pkts = 0u;
+    if (!cold->frame_open) {
+        cold->frame_open = TRUE;
+        cold->frame_first_pkt_us = arrival_us;
+        cold->frame_chunk_count = 1u; /* counts the burst this first packet is in */
+        cold->frame_pkts = 0u;
         /* If the first packet did NOT start a new burst, it joined the burst
          * still carrying the previous frame's tail = a cross-frame burst. */
-        src->frame_overlap = !new_chunk;
+        cold->frame_overlap = !new_chunk;
     }
-    src->frame_pkts++;
+    cold->frame_pkts++;
 
     /* Auto-calibration: log every raw inter-arrival delta (independent of the
      * current gap threshold) until we have enough to 2-means the distribution. */
-    if (rc->frame_release.calib_active && src->last_pkt_us > 0 &&
-        arrival_us > src->last_pkt_us) {
-        double d = (double)(arrival_us - src->last_pkt_us);
-        if (d >= 1.0 && d <= 100000.0) { /* 1µs..100ms sane window */
-            if (!rc->frame_release.calib_samples) {
-                rc->frame_release.calib_samples =
-                    g_new0(double, UV_RELEASE_CALIB_SAMPLES);
-            }
-            if (rc->frame_release.calib_count < UV_RELEASE_CALIB_SAMPLES) {
-                rc->frame_release.calib_samples[rc->frame_release.calib_count++] =
-                    log10(d);
-            }
-            if (rc->frame_release.calib_count >= UV_RELEASE_CALIB_SAMPLES) {
-                release_calib_finish(rc);
-            }
+    if (an->calib_active && cold->last_pkt_us > 0 &&
+        arrival_us > cold->last_pkt_us) {
+        double d = (double)(arrival_us - cold->last_pkt_us);
+        if (d >= 1.0 && d <= 100000.0 && /* 1µs..100ms sane window */
+            an->calib_count < an->calib_room) {
+            an->calib_samples[an->calib_count++] = log10(d);
         }
     }
 
-    src->last_pkt_us = arrival_us;
+    cold->last_pkt_us = arrival_us;
 }
 
 /* Bump the matching counter for an HEVC NAL unit type. NAL types 19/20/21
@@ -1085,84 +1684,116 @@ static void hevc_count_nal_type(UvRelaySource *s, uint8_t nal_type, gint64 arriv
     }
 }
 
-/* Parse the HEVC payload of a single unique RTP packet (RFC 7798) and
- * fold its NAL units into the per-source counters. Only called once per
- * unique sequence number so duplicates / retransmits don't inflate the
- * NAL totals. */
-static void hevc_parse_payload_stats(UvRelaySource *s,
-                                     const unsigned char *payload,
-                                     size_t payload_len,
-                                     gint64 arrival_us) {
+/* Note the RFC 7798 payload structure of one RTP packet in its metadata
+ * record: the payload header type and the NAL unit types it starts. Only
+ * the start fragment of an FU carries the real NAL type (middle / end
+ * fragments would otherwise double-count); an aggregation packet keeps
+ * its first UV_PACKET_META_NALS units. Runs on the relay worker. */
+static void hevc_parse_payload_meta(UvPacketMeta *m, const unsigned char *payload,
+                                    size_t payload_len) {
     if (payload_len < 2) return;
-    uint8_t b0 = payload[0];
-    uint8_t nal_type = (uint8_t)((b0 >> 1) & 0x3F);
+    uint8_t nal_type = (uint8_t)((payload[0] >> 1) & 0x3F);
+    m->flags |= UV_PACKET_META_PAYLOAD;
+    m->hdr_type = nal_type;
 
     if (nal_type == 49) {
-        /* Fragmentation Unit. Only the start fragment carries the real NAL
-         * type — middle / end fragments would otherwise double-count. */
-        s->rtp_fu_packets++;
+        /* Fragmentation Unit. */
         if (payload_len < 3) return;
         uint8_t fu = payload[2];
-        gboolean start = (fu & 0x80) != 0;
-        if (!start) return;
-        hevc_count_nal_type(s, (uint8_t)(fu & 0x3F), arrival_us);
+        if (fu & 0x80) m->nals[m->nal_count++] = (uint8_t)(fu & 0x3F);
         return;
     }
 
     if (nal_type == 48) {
         /* Aggregation Packet: 2-byte size prefix + NAL, repeated. */
-        s->rtp_ap_packets++;
         size_t pos = 2; /* skip PayloadHdr */
-        while (pos + 2 <= payload_len) {
+        while (pos + 2 <= payload_len && m->nal_count < UV_PACKET_META_NALS) {
             uint16_t nalu_size = (uint16_t)((payload[pos] << 8) | payload[pos + 1]);
             pos += 2;
             if (nalu_size < 2 || pos + nalu_size > payload_len) break;
-            uint8_t inner = (uint8_t)((payload[pos] >> 1) & 0x3F);
-            hevc_count_nal_type(s, inner, arrival_us);
+            m->nals[m->nal_count++] = (uint8_t)((payload[pos] >> 1) & 0x3F);
             pos += nalu_size;
         }
         return;
     }
 
-    if (nal_type == 50) {
-        /* PACI: payload content information — rare. Count as other. */
-        s->hevc_other_nal_count++;
-        return;
-    }
-
-    /* Single NAL unit packet: nal_type IS the actual NAL type. */
-    hevc_count_nal_type(s, nal_type, arrival_us);
+    /* PACI (50) is counted as other on the analytics side; for a single
+     * NAL unit packet nal_type IS the actual NAL type. */
+    if (nal_type != 50) m->nals[m->nal_count++] = nal_type;
 }
 
-static inline void rtp_update_stats(RelayController *rc,
-                                    UvRelaySource *s,
-                                    const unsigned char *p,
-                                    size_t len,
-                                    int clock_rate,
-                                    int primary_payload_type,
-                                    gboolean is_selected) {
-    if (len < 12) return;
-    if ((p[0] & 0xC0) != 0x80) return;
-
-    if (primary_payload_type >= 0) {
-        int payload_type = p[1] & 0x7F;
-        if (payload_type != primary_payload_type) {
-            return; // ignore non-primary RTP payload types for stats tracking
-        }
+/* Fill the metadata record for one datagram. Returns FALSE for anything
+ * the RTP stats ignore: not RTP version 2, or another payload type than
+ * the primary one. The arrival time is fixed here, so a record's age in
+ * the ring never shows up as jitter. */
+static gboolean relay_packet_meta(UvPacketMeta *m, UvRelaySource *src,
+                                  const unsigned char *p, size_t len, gint64 arrival_us,
+                                  int primary_payload_type, gboolean is_selected) {
+    if (len < 12) return FALSE;
+    if ((p[0] & 0xC0) != 0x80) return FALSE;
+    if (primary_payload_type >= 0 && (p[1] & 0x7F) != primary_payload_type) {
+        return FALSE; // ignore non-primary RTP payload types for stats tracking
     }
 
-    gboolean marker = (p[1] & 0x80) != 0;
+    m->src = src;
+    m->arrival_us = arrival_us > 0 ? arrival_us : g_get_monotonic_time();
+    m->seq = (uint16_t)((p[2] << 8) | p[3]);
+    m->ts = (uint32_t)((p[4] << 24) | (p[5] << 16) | (p[6] << 8) | p[7]);
+    m->len = (uint16_t)MIN(len, (size_t)UINT16_MAX);
+    m->flags = 0;
+    if (p[1] & 0x80) m->flags |= UV_PACKET_META_MARKER;
+    if (is_selected) m->flags |= UV_PACKET_META_SELECTED;
+    m->hdr_type = 0;
+    m->nal_count = 0;
+
+    /* Locate the start of the RTP payload: 12-byte fixed header plus
+     * 4 bytes per CSRC entry, plus a variable-length extension header
+     * if the X bit is set. Stays defensive in case the sender adds
+     * either. */
+    size_t hdr = 12u + 4u * (size_t)(p[0] & 0x0F);
+    if (len >= hdr && (p[0] & 0x10)) {
+        if (len < hdr + 4u) return TRUE;
+        uint16_t ext_words = (uint16_t)((p[hdr + 2] << 8) | p[hdr + 3]);
+        hdr += 4u + 4u * (size_t)ext_words;
+    }
+    if (len > hdr + 1u) hevc_parse_payload_meta(m, p + hdr, len - hdr);
+    return TRUE;
+}
 
-    uint16_t seq = (uint16_t)((p[2] << 8) | p[3]);
-    uint32_t ts  = (uint32_t)((p[4] << 24) | (p[5] << 16) | (p[6] << 8) | p[7]);
+/* Fold a unique packet's NAL units into the per-source counters. Only
+ * called once per unique sequence number so duplicates / retransmits
+ * don't inflate the NAL totals. */
+static void hevc_count_payload(UvRelaySource *s, const UvPacketMeta *m) {
+    if (!(m->flags & UV_PACKET_META_PAYLOAD)) return;
+    if (m->hdr_type == 49) s->rtp_fu_packets++;
+    else if (m->hdr_type == 48) s->rtp_ap_packets++;
+    else if (m->hdr_type == 50) s->hevc_other_nal_count++; /* PACI: rare */
+    for (guint i = 0; i < m->nal_count; i++) {
+        hevc_count_nal_type(s, m->nals[i], m->arrival_us);
+    }
+}
 
-    gboolean jumped = FALSE;
-    uint32_t ext = rtp_ext_seq(s, seq, &jumped);
+/* RTP accounting and every per-packet analysis for one record. Runs on
+ * the analytics thread (or the worker, without it) under src->lock. */
+static inline void rtp_update_stats(UvRelayAnalysis *an,
+                                    UvRelaySource *s,
+                                    const UvPacketMeta *m,
+                                    int clock_rate) {
+    gboolean marker = (m->flags & UV_PACKET_META_MARKER) != 0;
+    gboolean is_selected = (m->flags & UV_PACKET_META_SELECTED) != 0;
+    uint16_t seq = m->seq;
+    uint32_t ts = m->ts;
+    size_t len = m->len;
+    gint64 arrival_us = m->arrival_us;
+
+    bool jumped = false;
+    uint32_t ext = rtp_seq_extend(s->rtp_initialized, &s->rtp_cycles, s->rtp_max_ext_seq, seq, &jumped);
     if (!s->rtp_initialized) {
         s->rtp_initialized = TRUE;
         s->rtp_bad_seq = UV_RTP_BAD_SEQ_NONE;
         s->rtp_first_ext_seq = ext;
         s->rtp_max_ext_seq   = ext;
+        rtp_window_reset(s, ext);
     } else if (jumped) {
         /* Confirm a restart with two consecutive in-sequence packets (RFC 3550
          * bad_seq probation) so a lone stray/corrupt seq can't wipe the stats.
@@ -1178,43 +1809,32 @@ static inline void rtp_update_stats(RelayController *rc,
         s->rtp_bad_seq = UV_RTP_BAD_SEQ_NONE;
     }
 
-    guint idx = ext % UV_RTP_WIN_SIZE;
+    /* rtp_seq_extend() treats anything more than UV_RTP_MAX_MISORDER behind the
+     * top as a jump, so ext always falls inside the window here. */
+    if (ext > s->rtp_max_ext_seq) {
+        rtp_window_advance(s, ext);
+        s->rtp_max_ext_seq = ext;
+    }
+    guint pos = ext % UV_RTP_WIN_SIZE;
+    uint64_t bit = 1ull << (pos & 63u);
+    uint64_t *word = &s->rtp_seq_bits[pos >> 6];
     gboolean unique_packet = FALSE;
-    if (s->rtp_seq_slot[idx] == ext) {
+    if (*word & bit) {
         s->rtp_duplicate_packets++;
     } else {
         if (ext < s->rtp_max_ext_seq) s->rtp_reordered_packets++;
-        s->rtp_seq_slot[idx] = ext;
+        *word |= bit;
         s->rtp_unique_packets++;
         unique_packet = TRUE;
-        if (ext > s->rtp_max_ext_seq) s->rtp_max_ext_seq = ext;
-    }
-
-    if (unique_packet && rc->frame_block.enabled && is_selected) {
-        s->frame_block_accum_bytes += (uint64_t)len;
     }
 
-    gint64 arrival_us = g_get_monotonic_time();
-
-    if (unique_packet) {
-        /* Locate the start of the RTP payload: 12-byte fixed header plus
-         * 4 bytes per CSRC entry, plus a variable-length extension header
-         * if the X bit is set. Stays defensive in case the sender adds
-         * either. */
-        size_t hdr = 12u + 4u * (size_t)(p[0] & 0x0F);
-        if (len >= hdr && (p[0] & 0x10)) {
-            if (len < hdr + 4u) goto skip_nal_parse;
-            uint16_t ext_words = (uint16_t)((p[hdr + 2] << 8) | p[hdr + 3]);
-            hdr += 4u + 4u * (size_t)ext_words;
-        }
-        if (len > hdr + 1u) {
-            hevc_parse_payload_stats(s, p + hdr, len - hdr, arrival_us);
-        }
+    if (unique_packet && an->fb_enabled && is_selected) {
+        relay_source_cold(s)->frame_block_accum_bytes += (uint64_t)len;
     }
-skip_nal_parse:
 
     if (unique_packet) {
-        release_process_packet(rc, s, ts, marker, arrival_us, (guint)len, is_selected);
+        hevc_count_payload(s, m);
+        release_process_packet(an, s, ts, marker, arrival_us, (guint)len, is_selected);
     }
 
     uint32_t arrival_ts = rtp_now_ts_from_us(clock_rate, arrival_us);
@@ -1223,45 +1843,169 @@ skip_nal_parse:
         s->jitter_initialized = TRUE;
         s->jitter_prev_transit = transit;
     } else {
+        /* RFC 3550 A.8: J += (|D| - J) / 16 with J held scaled by 16. */
         int32_t d = (int32_t)(transit - s->jitter_prev_transit);
-        if (d < 0) d = -d;
-        s->jitter_value += ((double)d - s->jitter_value) / 16.0;
+        uint64_t ad = d < 0 ? (uint64_t)(-(int64_t)d) : (uint64_t)d;
+        s->jitter_q4 += ad - ((s->jitter_q4 + 8u) >> 4);
         s->jitter_prev_transit = transit;
     }
 
     if (marker && unique_packet) {
-        uint64_t frame_size_bytes = s->frame_block_accum_bytes;
         source_record_marker_frame(s, arrival_us);
-        frame_block_process_packet(rc, s, ts, marker, arrival_us, clock_rate, is_selected, frame_size_bytes);
-        s->frame_block_accum_bytes = 0;
+        UvRelaySourceCold *cold = s->cold;
+        uint64_t frame_size_bytes = cold->frame_block_accum_bytes;
+        frame_block_process_packet(an, s, ts, marker, arrival_us, clock_rate, is_selected, frame_size_bytes);
+        cold->frame_block_accum_bytes = 0;
     }
 }
 
-static GstFlowReturn relay_push_buffer(RelayController *rc, const unsigned char *buf, size_t len) {
-    /* Demux by RTP payload type. With audio sharing the video UDP port,
-     * forwarding every datagram to the video appsrc would feed Opus
-     * packets into the H.265 decoder (green frames). Match each packet
-     * against the configured video/audio PTs and dispatch accordingly;
-     * unknown PTs are dropped. Mirrors waybeam-hub's two-appsrc design. */
-    if (len < 12) return GST_FLOW_OK;
-    int pt = buf[1] & 0x7F;
+/* Records the analytics thread folds per ring per pass, so one busy
+ * worker can't starve the others' rings or hold off a config reload. */
+#define UV_RELAY_ANALYTICS_BATCH 256u
+
+/* Producer side of a worker's analytics ring: the slot for the next
+ * record, or NULL when the ring is full. tail_cache spares the worker a
+ * read of the consumer's line until the ring looks full. */
+static inline UvPacketMeta *analytics_ring_slot(UvAnalyticsRing *r) {
+    uint64_t head = __atomic_load_n(&r->head, __ATOMIC_RELAXED);
+    if (head - r->tail_cache > r->mask) {
+        r->tail_cache = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+        if (head - r->tail_cache > r->mask) return NULL;
+    }
+    return &r->recs[head & r->mask];
+}
 
-    /* Pick the destination appsrc and hold a ref across the push under the lock,
-     * so a concurrent set_appsrc()/teardown can't free it out from under us. */
-    g_mutex_lock(&rc->lock);
-    GstAppSrc *dest = NULL;
-    if (rc->viewer) {
-        if (pt == rc->viewer->config.payload_type) {
-            dest = rc->appsrc;
-        } else if ((guint)pt == rc->viewer->config.audio_payload_type
-                   && rc->audio_appsrc) {
-            dest = rc->audio_appsrc;
+static inline void analytics_ring_commit(UvAnalyticsRing *r) {
+    __atomic_store_n(&r->head, __atomic_load_n(&r->head, __ATOMIC_RELAXED) + 1u, __ATOMIC_RELEASE);
+}
+
+/* Wake the analytics thread after a batch queued records. Returns TRUE
+ * when that took a syscall (the thread had gone to sleep). */
+static gboolean relay_analytics_kick(RelayController *rc) {
+    if (!g_atomic_int_compare_and_exchange(&rc->analytics.sleeping, 1, 0)) return FALSE;
+    uint64_t one = 1;
+    ssize_t r = write(rc->analytics.wake_fd, &one, sizeof(one));
+    (void)r;
+    return TRUE;
+}
+
+/* Consumer side: fold up to max records from one ring into their sources,
+ * holding each source's lock across a run of its records. Sets
+ * *pub_pending when a source was left for the publish sweep. Returns the
+ * number of records folded. */
+static guint relay_analytics_drain(RelayController *rc, UvAnalyticsRing *r, UvRelayAnalysis *an,
+                                   UvLockStats *source_lock, guint max, gboolean *pub_pending) {
+    uint64_t tail = __atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+    guint n = (guint)MIN(__atomic_load_n(&r->head, __ATOMIC_ACQUIRE) - tail, (uint64_t)max);
+    if (n == 0) return 0;
+
+    int clock_rate = rc->viewer->config.clock_rate;
+    gint64 now_us = relay_now_us(rc);
+    UvRelaySource *held = NULL;
+    for (guint i = 0; i < n; i++) {
+        const UvPacketMeta *m = &r->recs[(tail + i) & r->mask];
+        if (m->src != held) {
+            if (held) {
+                relay_source_touch(held, clock_rate, now_us);
+                *pub_pending |= held->pub_dirty;
+                g_mutex_unlock(&held->lock);
+            }
+            relay_lock_timed(&m->src->lock, source_lock);
+            held = m->src;
         }
+        rtp_update_stats(an, held, m, clock_rate);
     }
-    if (dest) gst_object_ref(dest);
-    g_mutex_unlock(&rc->lock);
-    if (!dest) return GST_FLOW_OK;
+    relay_source_touch(held, clock_rate, now_us);
+    *pub_pending |= held->pub_dirty;
+    g_mutex_unlock(&held->lock);
+    __atomic_store_n(&r->tail, tail + n, __ATOMIC_RELEASE);
+    return n;
+}
+
+/* Demux by RTP payload type. With audio sharing the video UDP port,
+ * forwarding every datagram to the video appsrc would feed Opus
+ * packets into the H.265 decoder (green frames). Match each packet
+ * against the configured video/audio PTs and dispatch accordingly;
+ * unknown PTs are dropped. Mirrors waybeam-hub's two-appsrc design.
+ * Caller holds rc->lock and must ref the result before dropping it, so a
+ * concurrent set_appsrc()/teardown can't free it out from under the push. */
+static GstAppSrc *relay_pick_dest_locked(RelayController *rc, const unsigned char *buf, size_t len) {
+    if (len < 12 || !rc->viewer) return NULL;
+    int pt = buf[1] & 0x7F;
+    if (pt == rc->viewer->config.payload_type) return rc->appsrc;
+    if ((guint)pt == rc->viewer->config.audio_payload_type && rc->audio_appsrc) {
+        return rc->audio_appsrc;
+    }
+    return NULL;
+}
+
+/* Zero-copy receive pool. Datagrams land directly in GstBufferPool memory and
+ * the pooled buffer itself is handed to appsrc; it returns to the pool when
+ * downstream drops its last ref. A pool buffer is tagged with qdata
+ * (ingest.pool_seen_quark) the first time the relay sees it, which is how
+ * fresh allocations are told apart from recycled buffers (the pool's
+ * reset_buffer leaves qdata alone). */
+
+static GstBufferPool *relay_pool_new(guint buffers) {
+    GstBufferPool *pool = gst_buffer_pool_new();
+    if (!pool) return NULL;
+    GstStructure *config = gst_buffer_pool_get_config(pool);
+    /* max_buffers = 0: the pool grows instead of blocking the receive thread
+     * when downstream queues hold more than the preallocated set. */
+    gst_buffer_pool_config_set_params(config, NULL, UV_RELAY_POOL_BUF_SIZE, buffers, 0);
+    if (!gst_buffer_pool_set_config(pool, config) || !gst_buffer_pool_set_active(pool, TRUE)) {
+        uv_log_warn("Relay: buffer pool setup failed; falling back to per-packet copies");
+        gst_object_unref(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+typedef struct {
+    GstBuffer *buffer;   /* armed pool buffer, mapped for write; NULL when spent */
+    GstMapInfo map;
+} UvRelayPoolSlot;
+
+/* Make sure a batch slot holds a mapped pool buffer. Returns FALSE if the
+ * pool could not provide one; the slot then receives into scratch only. */
+static gboolean relay_pool_slot_arm(GstBufferPool *pool, GQuark seen, UvRelayPoolSlot *slot,
+                                    uint64_t *allocated, uint64_t *recycled) {
+    if (slot->buffer) return TRUE;
+    GstBuffer *b = NULL;
+    if (gst_buffer_pool_acquire_buffer(pool, &b, NULL) != GST_FLOW_OK || !b) return FALSE;
+    if (!gst_buffer_map(b, &slot->map, GST_MAP_WRITE)) {
+        gst_buffer_unref(b);
+        return FALSE;
+    }
+    GstMiniObject *mo = GST_MINI_OBJECT_CAST(b);
+    if (gst_mini_object_get_qdata(mo, seen)) {
+        (*recycled)++;
+    } else {
+        gst_mini_object_set_qdata(mo, seen, GINT_TO_POINTER(1), NULL);
+        (*allocated)++;
+    }
+    slot->buffer = b;
+    return TRUE;
+}
+
+static void relay_pool_slot_release(UvRelayPoolSlot *slot) {
+    if (!slot->buffer) return;
+    gst_buffer_unmap(slot->buffer, &slot->map);
+    gst_buffer_unref(slot->buffer);
+    slot->buffer = NULL;
+}
+
+/* Hand the slot's pool buffer to appsrc (transfers ownership). */
+static GstFlowReturn relay_push_pooled(GstAppSrc *dest, UvRelayPoolSlot *slot, size_t len) {
+    GstBuffer *b = slot->buffer;
+    gst_buffer_unmap(b, &slot->map);
+    slot->buffer = NULL;
+    gst_buffer_set_size(b, (gssize)len);
+    GST_BUFFER_FLAG_SET(b, GST_BUFFER_FLAG_LIVE);
+    return gst_app_src_push_buffer(dest, b);
+}
 
+static GstFlowReturn relay_push_buffer(GstAppSrc *dest, const unsigned char *buf, size_t len) {
     GstFlowReturn ret = GST_FLOW_ERROR;
     GstBuffer *gbuf = gst_buffer_new_allocate(NULL, (gsize)len, NULL);
     if (gbuf) {
@@ -1273,156 +2017,1711 @@ static GstFlowReturn relay_push_buffer(RelayController *rc, const unsigned char
         GST_BUFFER_FLAG_SET(gbuf, GST_BUFFER_FLAG_LIVE);
         ret = gst_app_src_push_buffer(dest, gbuf);
     }
-    gst_object_unref(dest);
     return ret;
 }
 
-static gpointer relay_thread_run(gpointer data) {
-    RelayController *rc = (RelayController *)data;
-    UvViewer *viewer = rc->viewer;
+/* IDR, CRA or BLA: a picture decoding can start at. */
+static inline gboolean hevc_nal_is_irap(uint8_t type) {
+    return type >= 16 && type <= 21;
+}
 
-    int in_fd = socket(AF_INET, SOCK_DGRAM, 0);
-    if (in_fd < 0) {
-        uv_log_error("Relay: socket() failed: %s", g_strerror(errno));
-        return NULL;
+/* Direct AU mode: RFC 7798 depacketization in the relay. Single NAL unit
+ * packets, aggregation packets and fragmentation units are unpacked into
+ * an Annex-B access unit, which ends at the marker bit or when a datagram
+ * with a later timestamp arrives. DONL fields (sprop-max-don-diff > 0) and
+ * PACI packets are not supported; the latter are skipped. A sequence gap
+ * damages the access unit it falls in, and the next one when it could
+ * have held that one's start; the loss policy decides what becomes of a
+ * damaged access unit. */
+static void relay_direct_append(RelayDirectAu *d, const unsigned char *data, size_t len,
+                                const unsigned char *nal_hdr) {
+    size_t need = d->au_len + 4u + (nal_hdr ? 2u : 0u) + len;
+    if (need > d->au_cap) {
+        d->au_cap = MAX(need, d->au_cap ? d->au_cap * 2u : 65536u);
+        d->au = g_realloc(d->au, d->au_cap);
     }
+    unsigned char *p = d->au + d->au_len;
+    p[0] = 0;
+    p[1] = 0;
+    p[2] = 0;
+    p[3] = 1;
+    p += 4;
+    if (nal_hdr) {
+        p[0] = nal_hdr[0];
+        p[1] = nal_hdr[1];
+        p += 2;
+    }
+    memcpy(p, data, len);
+    d->au_len = need;
+}
 
-    int flags = fcntl(in_fd, F_GETFL, 0);
-    if (flags >= 0) fcntl(in_fd, F_SETFL, flags | O_NONBLOCK);
-
-    int reuse = 1;
-    setsockopt(in_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+static void relay_direct_nal(RelayDirectAu *d, uint8_t type) {
+    if (hevc_nal_is_irap(type)) d->irap = TRUE;
+}
 
-    int rcvbuf = 4 * 1024 * 1024; // allow bursty sources before poll loop catches up
-    setsockopt(in_fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+/* Drop the fragmented NAL unit in progress. */
+static void relay_direct_cut_fu(RelayDirectAu *d) {
+    if (!d->fu_open) return;
+    d->au_len = d->fu_start;
+    d->fu_open = FALSE;
+    d->nals_dropped++;
+}
 
-    struct sockaddr_in bind_addr = {
-        .sin_family = AF_INET,
-        .sin_port = htons((uint16_t)rc->listen_port),
-        .sin_addr.s_addr = htonl(INADDR_ANY)
-    };
-    if (bind(in_fd, (struct sockaddr *)&bind_addr, sizeof(bind_addr)) < 0) {
-        uv_log_error("Relay: bind() failed on port %d: %s", rc->listen_port, g_strerror(errno));
-        close(in_fd);
-        return NULL;
+/* Finish the access unit in progress: push it, or drop it as the loss
+ * policy says. Caller holds d->lock. */
+static void relay_direct_finish(RelayDirectAu *d, GstAppSrc *dest, gboolean trace) {
+    if (!d->have_au) return;
+    d->have_au = FALSE;
+    if (d->fu_open) {
+        relay_direct_cut_fu(d);
+        d->damaged = TRUE;
     }
-
-    uv_log_info("Relay: listening on UDP port %d", rc->listen_port);
-
-    unsigned char *buf = g_malloc0(UV_RELAY_BUF_SIZE);
-    if (!buf) {
-        close(in_fd);
-        return NULL;
+    gboolean push = d->au_len > 0;
+    if (push && d->damaged) {
+        if (d->loss == UV_DIRECT_AU_LOSS_PASS) {
+            d->partial++;
+        } else {
+            if (d->loss == UV_DIRECT_AU_LOSS_WAIT_IRAP) d->wait_irap = TRUE;
+            push = FALSE;
+        }
     }
-
-    struct pollfd fds[1];
-    fds[0].fd = in_fd;
-    fds[0].events = POLLIN;
-
-    while (rc->running) {
-        int pr = poll(fds, 1, 200);
-        if (pr < 0) {
-            if (errno == EINTR) continue;
-            uv_log_warn("Relay: poll() error: %s", g_strerror(errno));
-            break;
+    if (push && d->wait_irap) {
+        if (d->irap && !d->damaged) {
+            d->wait_irap = FALSE;
+            d->discont = TRUE;
+        } else {
+            push = FALSE;
         }
-        if (!(pr > 0 && (fds[0].revents & POLLIN))) continue;
+    }
+    if (!push) {
+        if (d->au_len > 0) d->dropped++;
+        d->au_len = 0;
+        return;
+    }
 
-        struct sockaddr_in from = {0};
-        socklen_t fromlen = sizeof(from);
-        ssize_t r = recvfrom(in_fd, buf, UV_RELAY_BUF_SIZE, 0, (struct sockaddr *)&from, &fromlen);
-        if (r < 0) {
-            if (errno == EAGAIN || errno == EWOULDBLOCK) continue;
-            uv_log_warn("Relay: recvfrom() error: %s", g_strerror(errno));
-            continue;
+    GstBuffer *gbuf = gst_buffer_new_allocate(NULL, (gsize)d->au_len, NULL);
+    if (gbuf) {
+        gst_buffer_fill(gbuf, 0, d->au, d->au_len);
+        if (d->discont) GST_BUFFER_FLAG_SET(gbuf, GST_BUFFER_FLAG_DISCONT);
+        /* The offset carries the RTP timestamp to the tracer's appsrc probe. */
+        if (trace) GST_BUFFER_OFFSET(gbuf) = d->ts;
+        GstFlowReturn ret = gst_app_src_push_buffer(dest, gbuf);
+        if (ret == GST_FLOW_OK) {
+            d->aus++;
+            d->bytes += d->au_len;
+            d->discont = FALSE;
+        } else if (ret != GST_FLOW_FLUSHING) {
+            uv_log_warn("Relay: appsrc push returned %s", gst_flow_get_name(ret));
         }
+    }
+    d->au_len = 0;
+}
 
-        gboolean emit_added = FALSE;
-        gboolean emit_selected = FALSE;
-        int emit_index = -1;
-        UvRelaySource snapshot = {0};
+/* Forget the stream in progress: a new source, a new appsrc or a sender
+ * restart. The next access unit pushed is flagged DISCONT. Caller holds
+ * d->lock. */
+static void relay_direct_reset(RelayDirectAu *d) {
+    d->have_au = FALSE;
+    d->au_len = 0;
+    d->fu_open = FALSE;
+    d->have_seq = FALSE;
+    d->discont = TRUE;
+    if (d->loss == UV_DIRECT_AU_LOSS_WAIT_IRAP) d->wait_irap = TRUE;
+}
 
-        g_mutex_lock(&rc->lock);
-        int idx = -1;
-        bool is_new = relay_add_or_find(rc, &from, fromlen, &idx);
-        UvRelaySource *src = NULL;
-        if (idx >= 0 && (guint)idx < rc->sources_count) src = &rc->sources[idx];
-        if (src) {
-            src->rx_packets++;
-            src->rx_bytes += (uint64_t)r;
-            src->last_seen_us = g_get_monotonic_time();
-            gboolean is_selected = (idx == rc->selected_index);
-            rtp_update_stats(rc,
-                             src,
-                             buf,
-                             (size_t)r,
-                             viewer->config.clock_rate,
-                             viewer->config.payload_type,
-                             is_selected);
-        }
-        if (is_new && src) {
-            char addr[64];
-            addr_to_str(&src->addr, addr, sizeof(addr));
-            uv_log_info("Relay: discovered source [%d] %s", idx, addr);
-            emit_added = TRUE;
-            emit_index = idx;
-            snapshot = *src;
-            if (rc->selected_index < 0) {
-                rc->selected_index = idx;
-                emit_selected = TRUE;
+/* One video datagram of the selected source. Caller holds d->lock. */
+static void relay_direct_feed(RelayDirectAu *d, GstAppSrc *dest, const unsigned char *p, size_t len,
+                              gboolean trace) {
+    if (len < 12 || (p[0] >> 6) != 2) return;
+    size_t hdr = 12u + 4u * (size_t)(p[0] & 0x0F);
+    if (len >= hdr && (p[0] & 0x10)) {
+        if (len < hdr + 4u) return;
+        uint16_t ext_words = (uint16_t)((p[hdr + 2] << 8) | p[hdr + 3]);
+        hdr += 4u + 4u * (size_t)ext_words;
+    }
+    if (p[0] & 0x20) {
+        size_t pad = p[len - 1];
+        if (pad > len) return;
+        len -= pad;
+    }
+    if (len < hdr + 3u) return;
+    uint16_t seq = (uint16_t)((p[2] << 8) | p[3]);
+    uint32_t ts = (uint32_t)((p[4] << 24) | (p[5] << 16) | (p[6] << 8) | p[7]);
+
+    uint16_t gap = 0;
+    if (d->have_seq) {
+        gap = (uint16_t)(seq - d->next_seq);
+        if (gap >= 0x8000u) {
+            if ((uint16_t)(d->next_seq - seq) <= UV_RTP_MAX_MISORDER) {
+                d->late_packets++;
+                return;
             }
+            /* Further back than reordering explains: the sender restarted
+             * its sequence. Start over from this datagram. */
+            relay_direct_reset(d);
+            gap = 0;
         }
-
-        gboolean push_now = rc->push_enabled && rc->selected_index >= 0 && idx == rc->selected_index;
-        int push_index = push_now ? idx : -1;
-
-        /* Verbatim restream: forward every raw datagram from the selected
-         * source to the configured destination, untouched (independent of the
-         * pipeline push gate so it keeps flowing while the local view is
-         * paused). The socket is non-blocking; a full send buffer just drops. */
-        if (rc->restream.enabled && rc->restream.dest_valid && rc->restream.fd >= 0 &&
-            rc->selected_index >= 0 && idx == rc->selected_index) {
-            ssize_t sent = sendto(rc->restream.fd, buf, (size_t)r, 0,
-                                  (struct sockaddr *)&rc->restream.dest,
-                                  sizeof(rc->restream.dest));
-            if (sent == (ssize_t)r) {
-                rc->restream.tx_packets++;
-                rc->restream.tx_bytes += (uint64_t)r;
-            } else {
-                rc->restream.tx_errors++;
-            }
+    }
+    d->have_seq = TRUE;
+    d->next_seq = (uint16_t)(seq + 1);
+    if (gap) {
+        d->lost_packets += gap;
+        if (d->have_au) {
+            d->damaged = TRUE;
+            relay_direct_cut_fu(d);
         }
+    }
+    if (d->have_au && ts != d->ts) relay_direct_finish(d, dest, trace);
+    if (!d->have_au) {
+        d->have_au = TRUE;
+        d->ts = ts;
+        d->damaged = gap != 0;
+        d->irap = FALSE;
+        d->fu_open = FALSE;
+        d->au_len = 0;
+    }
 
-        g_mutex_unlock(&rc->lock);
-
-        if (emit_added) {
-            uv_internal_emit_event(viewer, UV_VIEWER_EVENT_SOURCE_ADDED, emit_index, &snapshot, NULL);
+    const unsigned char *pl = p + hdr;
+    size_t plen = len - hdr;
+    uint8_t type = (pl[0] >> 1) & 0x3F;
+    if (type == 48) {
+        for (size_t off = 2; off + 2u <= plen;) {
+            size_t nal_len = (size_t)((pl[off] << 8) | pl[off + 1]);
+            off += 2;
+            if (nal_len < 2 || nal_len > plen - off) {
+                d->damaged = TRUE;
+                break;
+            }
+            relay_direct_nal(d, (pl[off] >> 1) & 0x3F);
+            relay_direct_append(d, pl + off, nal_len, NULL);
+            off += nal_len;
         }
-        if (emit_selected) {
-            uv_internal_emit_event(viewer, UV_VIEWER_EVENT_SOURCE_SELECTED, rc->selected_index, &snapshot, NULL);
+    } else if (type == 49) {
+        uint8_t fu = pl[2];
+        if (fu & 0x80) {
+            relay_direct_cut_fu(d);
+            unsigned char nal_hdr[2] = { (unsigned char)((pl[0] & 0x81) | ((fu & 0x3F) << 1)), pl[1] };
+            d->fu_start = d->au_len;
+            d->fu_open = TRUE;
+            relay_direct_nal(d, fu & 0x3F);
+            relay_direct_append(d, pl + 3, plen - 3, nal_hdr);
+        } else if (d->fu_open) {
+            /* Continuation: the payload alone, no start code. */
+            size_t need = d->au_len + plen - 3;
+            if (need > d->au_cap) {
+                d->au_cap = MAX(need, d->au_cap * 2u);
+                d->au = g_realloc(d->au, d->au_cap);
+            }
+            memcpy(d->au + d->au_len, pl + 3, plen - 3);
+            d->au_len = need;
+        } else {
+            /* Its start went missing with an earlier gap. */
+            d->damaged = TRUE;
         }
+        if ((fu & 0x40) && d->fu_open) d->fu_open = FALSE;
+    } else if (type != 50) {
+        relay_direct_nal(d, type);
+        relay_direct_append(d, pl, plen, NULL);
+    }
+    if (p[1] & 0x80) relay_direct_finish(d, dest, trace);
+}
+
+/* Marker release. A frame of the selected source leaves the relay as
+ * soon as it is complete instead of after the jitterbuffer's fixed
+ * latency: its marker datagram is held, and so is every sequence number
+ * from the one after the previous frame's marker. Only a frame with a
+ * hole waits, and no longer than that latency. The datagrams go out in
+ * sequence order, so the jitterbuffer downstream runs with no latency;
+ * in direct AU mode they go to the depacketizer instead. */
+static gint64 relay_hold_latency_us(const RelayController *rc) {
+    return (gint64)__atomic_load_n(&rc->viewer->config.jitter_latency_ms, __ATOMIC_RELAXED) * 1000;
+}
+
+static inline RelayHoldSlot *relay_hold_slot(RelayHold *h, guint i) {
+    return &h->slots[(uint16_t)(h->base + i) & (UV_RELAY_HOLD_SLOTS - 1u)];
+}
+
+/* Hand one held datagram on (takes buf). Caller holds h->lock. */
+static void relay_hold_push(RelayController *rc, RelayHold *h, GstBuffer *buf, gboolean trace) {
+    if (rc->direct_au) {
+        GstMapInfo map;
+        if (gst_buffer_map(buf, &map, GST_MAP_READ)) {
+            g_mutex_lock(&rc->direct.lock);
+            relay_direct_feed(&rc->direct, h->dest, map.data, map.size, trace);
+            g_mutex_unlock(&rc->direct.lock);
+            gst_buffer_unmap(buf, &map);
+        }
+        gst_buffer_unref(buf);
+        return;
+    }
+    GstFlowReturn ret = gst_app_src_push_buffer(h->dest, buf);
+    if (ret != GST_FLOW_OK && ret != GST_FLOW_FLUSHING) {
+        uv_log_warn("Relay: appsrc push returned %s", gst_flow_get_name(ret));
+    }
+}
+
+/* Release the n slots from base in order: a complete frame, or what the
+ * latency ran out on. Empty slots among them are lost for good. Caller
+ * holds h->lock. */
+static void relay_hold_release(RelayController *rc, RelayHold *h, guint n, gboolean complete,
+                               gint64 now_us, gboolean trace) {
+    gint64 first_us = 0;
+    for (guint i = 0; i < n; i++) {
+        RelayHoldSlot *slot = relay_hold_slot(h, i);
+        if (!slot->buf) {
+            h->lost_packets++;
+            continue;
+        }
+        if (!first_us || slot->arrival_us < first_us) first_us = slot->arrival_us;
+        relay_hold_push(rc, h, slot->buf, trace);
+        slot->buf = NULL;
+        h->held--;
+    }
+    h->base = (uint16_t)(h->base + n);
+    h->span -= n;
+    h->run = 0;
+    if (complete) h->frames++;
+    else h->timeouts++;
+
+    uint64_t held_us = now_us > first_us ? (uint64_t)(now_us - first_us) : 0;
+    uint64_t latency_us = (uint64_t)relay_hold_latency_us(rc);
+    h->hold_us_total += held_us;
+    if (held_us > h->hold_us_max) h->hold_us_max = held_us;
+    if (held_us < latency_us) h->saved_us_total += latency_us - held_us;
+
+    h->oldest_us = 0;
+    for (guint i = 0; i < h->span && h->held > 0; i++) {
+        const RelayHoldSlot *slot = relay_hold_slot(h, i);
+        if (slot->buf && (!h->oldest_us || slot->arrival_us < h->oldest_us)) h->oldest_us = slot->arrival_us;
+    }
+}
+
+/* Release every frame that is complete. run carries the scan over from
+ * the last call, so each slot is looked at once per frame. */
+static void relay_hold_advance(RelayController *rc, RelayHold *h, gint64 now_us, gboolean trace) {
+    for (guint i = h->run; i < h->span;) {
+        const RelayHoldSlot *slot = relay_hold_slot(h, i);
+        if (!slot->buf) break;
+        i++;
+        if (slot->marker) {
+            relay_hold_release(rc, h, i, TRUE, now_us, trace);
+            i = 0;
+        } else {
+            h->run = i;
+        }
+    }
+}
+
+/* Release what has waited out the latency: up to the first held marker,
+ * or everything when none is held. Caller holds h->lock. */
+static void relay_hold_expire(RelayController *rc, RelayHold *h, gint64 now_us, gboolean trace) {
+    gint64 latency_us = relay_hold_latency_us(rc);
+    gboolean released = FALSE;
+    while (h->held > 0 && now_us - h->oldest_us >= latency_us) {
+        guint n = h->span;
+        for (guint i = 0; i < h->span; i++) {
+            const RelayHoldSlot *slot = relay_hold_slot(h, i);
+            if (slot->buf && slot->marker) {
+                n = i + 1u;
+                break;
+            }
+        }
+        relay_hold_release(rc, h, n, FALSE, now_us, trace);
+        released = TRUE;
+    }
+    if (released) relay_hold_advance(rc, h, now_us, trace);
+}
+
+/* Drop whatever is held and forget the sequence. Caller holds h->lock. */
+static void relay_hold_reset(RelayHold *h) {
+    for (guint i = 0; i < h->span; i++) {
+        RelayHoldSlot *slot = relay_hold_slot(h, i);
+        if (slot->buf) gst_buffer_unref(slot->buf);
+        slot->buf = NULL;
+    }
+    h->have_base = FALSE;
+    h->run = 0;
+    h->span = 0;
+    h->held = 0;
+    h->oldest_us = 0;
+    if (h->dest) gst_object_unref(h->dest);
+    h->dest = NULL;
+}
+
+/* One video datagram of the selected source. Caller holds h->lock. */
+static void relay_hold_feed(RelayController *rc, RelayHold *h, GstAppSrc *dest,
+                            const unsigned char *p, size_t len, gint64 arrival_us,
+                            gint64 now_us, gboolean trace) {
+    if (h->dest != dest) {
+        relay_hold_reset(h);
+        h->dest = GST_APP_SRC(gst_object_ref(dest));
+    }
+    uint16_t seq = (uint16_t)((p[2] << 8) | p[3]);
+    if (!h->have_base) {
+        h->have_base = TRUE;
+        h->base = seq;
+    }
+    int d = rtp_seq_window_offset(h->base, seq, UV_RELAY_HOLD_SLOTS);
+    if (d == UV_RTP_SEQ_LATE) {
+        h->late_packets++;
+        return;
+    }
+    if (d == UV_RTP_SEQ_REBASE) {
+        /* A jump (or a restarted sender): what is held goes out as it is
+         * and the sequence starts over here. */
+        h->overflows++;
+        if (h->held > 0) relay_hold_release(rc, h, h->span, FALSE, now_us, trace);
+        h->base = seq;
+        h->span = 0;
+        h->run = 0;
+        d = 0;
+    }
+    RelayHoldSlot *slot = relay_hold_slot(h, d);
+    if (slot->buf) return;   /* duplicate */
+    GstBuffer *buf = gst_buffer_new_allocate(NULL, (gsize)len, NULL);
+    if (!buf) return;
+    gst_buffer_fill(buf, 0, p, len);
+    GST_BUFFER_FLAG_SET(buf, GST_BUFFER_FLAG_LIVE);
+    slot->buf = buf;
+    slot->arrival_us = arrival_us;
+    slot->marker = (p[1] & 0x80) != 0;
+    h->held++;
+    if ((guint)d >= h->span) h->span = (guint)d + 1u;
+    if (!h->oldest_us || arrival_us < h->oldest_us) h->oldest_us = arrival_us;
+    relay_hold_advance(rc, h, now_us, trace);
+    relay_hold_expire(rc, h, now_us, trace);
+}
+
+/* From the receive loops, so a frame with a hole goes out on time even
+ * when nothing more arrives. */
+static void relay_hold_tick(RelayController *rc) {
+    if (!rc->marker_release) return;
+    g_mutex_lock(&rc->hold.lock);
+    if (rc->hold.held > 0) {
+        relay_hold_expire(rc, &rc->hold, relay_now_us(rc), rc->viewer->config.latency_trace);
+    }
+    g_mutex_unlock(&rc->hold.lock);
+}
+
+/* A new source or a new appsrc: what is held and the AU in progress
+ * belong to neither. */
+static void relay_stream_restart(RelayController *rc) {
+    if (rc->marker_release) {
+        g_mutex_lock(&rc->hold.lock);
+        relay_hold_reset(&rc->hold);
+        g_mutex_unlock(&rc->hold.lock);
+    }
+    if (!rc->direct_au) return;
+    g_mutex_lock(&rc->direct.lock);
+    relay_direct_reset(&rc->direct);
+    g_mutex_unlock(&rc->direct.lock);
+}
+
+/* GOP cache. Every source's video datagrams are appended in the registry
+ * pass, grouped into access units by RTP timestamp; when one carries the
+ * start of an IRAP picture (NAL types 16-21, single, first
+ * fragment or inside an aggregation packet), everything before its access
+ * unit is discarded, so the cache always opens on a decodable picture with
+ * the parameter sets sent alongside it. Late datagrams of an older access
+ * unit are not cached; the jitterbuffer would have had them anyway. */
+static gboolean hevc_rtp_starts_irap(const unsigned char *p, size_t len) {
+    size_t hdr = 12u + 4u * (size_t)(p[0] & 0x0F);
+    if (len >= hdr && (p[0] & 0x10)) {
+        if (len < hdr + 4u) return FALSE;
+        uint16_t ext_words = (uint16_t)((p[hdr + 2] << 8) | p[hdr + 3]);
+        hdr += 4u + 4u * (size_t)ext_words;
+    }
+    if (len < hdr + 3u) return FALSE;
+    const unsigned char *pl = p + hdr;
+    size_t plen = len - hdr;
+    uint8_t type = (pl[0] >> 1) & 0x3F;
+    if (type == 49) return (pl[2] & 0x80) && hevc_nal_is_irap(pl[2] & 0x3F);
+    if (type == 48) {
+        for (size_t off = 2; off + 3u <= plen;) {
+            size_t nal_len = (size_t)((pl[off] << 8) | pl[off + 1]);
+            off += 2;
+            if (nal_len < 2 || nal_len > plen - off) break;
+            if (hevc_nal_is_irap((pl[off] >> 1) & 0x3F)) return TRUE;
+            off += nal_len;
+        }
+        return FALSE;
+    }
+    return hevc_nal_is_irap(type);
+}
+
+/* Caller holds rc->lock; pkt is a video-PT RTP datagram from src. */
+static void relay_gop_append(RelayController *rc, UvRelaySource *src,
+                             const unsigned char *pkt, size_t len) {
+    if (len > UINT16_MAX) return;
+    UvGopCache *g = src->gop;
+    if (!g) {
+        g = src->gop = g_new0(UvGopCache, 1);
+        g->buf = g_malloc(rc->gop.cap);
+    }
+    size_t before = g->used;
+    uint32_t ts = (uint32_t)((pkt[4] << 24) | (pkt[5] << 16) | (pkt[6] << 8) | pkt[7]);
+    if (g->have_au && ts != g->au_ts) {
+        if ((int32_t)(ts - g->au_ts) < 0) return;
+        g->have_au = FALSE;
+    }
+    if (!g->have_au) {
+        /* Until an IRAP shows up, only the access unit in progress is
+         * worth keeping. */
+        if (!g->valid) g->used = 0;
+        else g->frames++;
+        g->au_start = g->used;
+        g->au_ts = ts;
+        g->au_packets = 0;
+        g->au_truncated = FALSE;
+        g->have_au = TRUE;
+    }
+    if (g->au_truncated) goto out;
+
+    if (hevc_rtp_starts_irap(pkt, len) && (!g->valid || g->au_start > 0)) {
+        memmove(g->buf, g->buf + g->au_start, g->used - g->au_start);
+        g->used -= g->au_start;
+        g->au_start = 0;
+        g->frames = 1;
+        g->packets = g->au_packets;
+        if (!g->valid) {
+            g->valid = TRUE;
+            rc->gop.sources++;
+        }
+    }
+    if (g->used + 2u + len > rc->gop.cap) {
+        /* Outgrown: start over at the next access unit; this one has lost
+         * a datagram and can't open a cache. */
+        if (g->valid) {
+            g->valid = FALSE;
+            rc->gop.sources--;
+            rc->gop.overflows++;
+        }
+        g->used = 0;
+        g->au_start = 0;
+        g->frames = 0;
+        g->packets = 0;
+        g->au_truncated = TRUE;
+        goto out;
+    }
+    g->buf[g->used] = (unsigned char)(len >> 8);
+    g->buf[g->used + 1] = (unsigned char)len;
+    memcpy(g->buf + g->used + 2, pkt, len);
+    g->used += 2u + len;
+    g->au_packets++;
+    if (g->valid) g->packets++;
+out:
+    if (g->used != before) {
+        rc->gop.bytes = rc->gop.bytes - before + g->used;
+        __atomic_store_n(&src->gop_bytes, (uint64_t)g->used, __ATOMIC_RELAXED);
+    }
+}
+
+/* Push src's cached GOP to the video appsrc as one buffer list. Called by
+ * select under rc->lock right after the switch, so it lands ahead of any
+ * live datagram routed from src. RTP timestamps are rewritten so access
+ * unit k of n goes out at newest - (n - 1) + k: with their real spacing
+ * the jitterbuffer would replay the GOP in real time behind the live edge;
+ * squeezed into consecutive ticks, it releases them at once and the
+ * newest keeps its own timestamp for live datagrams to follow. */
+static void relay_gop_flush_locked(RelayController *rc, UvRelaySource *src) {
+    UvGopCache *g = src->gop;
+    if (!g || !g->valid || !rc->appsrc) return;
+    if (!rc->push_enabled || (rc->backend == UV_RELAY_BACKEND_REPLAY && !rc->replay.decode)) return;
+
+    if (rc->direct_au) {
+        /* Access units go out as they complete; no timestamps to fix. */
+        gboolean trace = rc->viewer->config.latency_trace;
+        g_mutex_lock(&rc->direct.lock);
+        for (size_t off = 0; off + 2u <= g->used;) {
+            size_t len = (size_t)((g->buf[off] << 8) | g->buf[off + 1]);
+            relay_direct_feed(&rc->direct, rc->appsrc, g->buf + off + 2, len, trace);
+            off += 2u + len;
+        }
+        g_mutex_unlock(&rc->direct.lock);
+    } else {
+        GstBufferList *list = gst_buffer_list_new_sized(g->packets);
+        uint32_t au_ts = g->au_ts - (g->frames - 1u);
+        uint32_t prev_ts = 0;
+        gboolean first = TRUE;
+        for (size_t off = 0; off + 2u <= g->used;) {
+            size_t len = (size_t)((g->buf[off] << 8) | g->buf[off + 1]);
+            const unsigned char *pkt = g->buf + off + 2;
+            off += 2u + len;
+            uint32_t ts = (uint32_t)((pkt[4] << 24) | (pkt[5] << 16) | (pkt[6] << 8) | pkt[7]);
+            if (!first && ts != prev_ts) au_ts++;
+            prev_ts = ts;
+            first = FALSE;
+
+            GstBuffer *gbuf = gst_buffer_new_allocate(NULL, (gsize)len, NULL);
+            if (!gbuf) continue;
+            GstMapInfo map;
+            if (gst_buffer_map(gbuf, &map, GST_MAP_WRITE)) {
+                memcpy(map.data, pkt, len);
+                map.data[4] = (guint8)(au_ts >> 24);
+                map.data[5] = (guint8)(au_ts >> 16);
+                map.data[6] = (guint8)(au_ts >> 8);
+                map.data[7] = (guint8)au_ts;
+                gst_buffer_unmap(gbuf, &map);
+            }
+            GST_BUFFER_FLAG_SET(gbuf, GST_BUFFER_FLAG_LIVE);
+            gst_buffer_list_add(list, gbuf);
+        }
+        GstFlowReturn ret = gst_app_src_push_buffer_list(rc->appsrc, list);
+        if (ret != GST_FLOW_OK) {
+            uv_log_warn("Relay: GOP flush into appsrc failed: %s", gst_flow_get_name(ret));
+            return;
+        }
+    }
+    rc->gop.flushes++;
+    rc->gop.flush_frames = g->frames;
+    rc->gop.flush_packets = g->packets;
+    rc->gop.flush_bytes = g->used - 2u * (uint64_t)g->packets;
+    uv_log_info("Relay: flushed cached GOP (%u frames, %u packets, %" G_GUINT64_FORMAT " bytes)",
+                g->frames, g->packets, rc->gop.flush_bytes);
+    guint queue_max = rc->viewer->config.queue_max_buffers;
+    if (queue_max > 0 && g->packets > queue_max) {
+        uv_log_warn("Relay: GOP flush of %u packets exceeds the ingress queue (%u buffers); "
+                    "its oldest may be dropped", g->packets, queue_max);
+    }
+}
+
+/* Pin the calling worker to its CPU. Failure only costs locality. */
+static void relay_worker_pin(UvRelayWorker *w) {
+    if (w->cpu < 0) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(w->cpu, &set);
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) {
+        uv_log_warn("Relay: worker %u could not pin to CPU %d: %s", w->id, w->cpu, g_strerror(rc));
+        g_mutex_lock(&w->rc->lock);
+        w->cpu = -1;
+        g_mutex_unlock(&w->rc->lock);
+    }
+}
+
+/* Ask the kernel to stamp every datagram at receive. SO_TIMESTAMPING with
+ * software RX stamps is preferred; SO_TIMESTAMPNS carries the same clock on
+ * kernels or sockets that refuse it. Both are CLOCK_REALTIME. */
+static gboolean relay_enable_timestamps(int fd) {
+    int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0) return TRUE;
+    int on = 1;
+    return setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) == 0;
+}
+
+/* Pull the ancillary data the relay asks for out of one datagram: the
+ * SO_RXQ_OVFL drop count (attached only once the socket has dropped
+ * something) and the kernel receive timestamp in CLOCK_REALTIME ns (0 when
+ * absent). */
+static void relay_rx_cmsg(const struct msghdr *mh, uint32_t *drops, gboolean *have_drops,
+                          int64_t *rx_realtime_ns) {
+    *rx_realtime_ns = 0;
+    for (struct cmsghdr *c = CMSG_FIRSTHDR((struct msghdr *)mh); c;
+         c = CMSG_NXTHDR((struct msghdr *)mh, c)) {
+        if (c->cmsg_level != SOL_SOCKET) continue;
+        if (c->cmsg_type == SO_RXQ_OVFL) {
+            memcpy(drops, CMSG_DATA(c), sizeof(*drops));
+            *have_drops = TRUE;
+        } else if (c->cmsg_type == SCM_TIMESTAMPING || c->cmsg_type == SCM_TIMESTAMPNS) {
+            /* scm_timestamping leads with the software stamp, so both
+             * layouts start with the timespec we want. */
+            struct timespec ts;
+            memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+            if (ts.tv_sec != 0 || ts.tv_nsec != 0) {
+                *rx_realtime_ns = (int64_t)ts.tv_sec * 1000000000ll + ts.tv_nsec;
+            }
+        }
+    }
+}
+
+static int relay_cmp_i64(const void *a, const void *b) {
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+#define UV_RELAY_CTRL_SIZE (CMSG_SPACE(sizeof(uint32_t)) + CMSG_SPACE(3 * sizeof(struct timespec)))
+
+/* Per-thread receive state shared by the ingest backends. A backend fills
+ * the first n entries of pkts/lens/from/fromlen/arrival with one wakeup's
+ * datagrams (plus slots, when it receives into pool buffers) and hands
+ * them to relay_batch_process(); everything else here is side state that
+ * has to survive the lock drop between the registry and stats passes
+ * (resolved source, selection, push destination, discovered sources). */
+typedef struct {
+    guint cap;
+    const unsigned char **pkts;
+    size_t *lens;
+    struct sockaddr_in *from;
+    socklen_t *fromlen;
+    gint64 *arrival;            /* monotonic us, 0 = stamp on processing */
+    UvRelayPoolSlot *slots;     /* NULL when the backend does not pool */
+    int *fwd_index;
+    GstAppSrc **dest;
+    int *discovered;
+    gboolean *recycled;
+    UvRelaySource **srcs;
+    gboolean *selected;
+    double *calib;
+    int64_t *delay;             /* receive-delay window, NULL without kernel stamps */
+    guint delay_count;
+    gboolean delay_ready;
+    int64_t delay_median_ns;
+    int64_t delay_max_ns;
+    UvSourceStats snapshot;
+    UvRelayAnalysis analysis;
+    UvLockStats source_lock;
+    uint64_t pool_allocated;
+    uint64_t pool_recycled;
+    uint64_t pool_copies;
+    gboolean pub_pending;
+    gint64 last_sweep_us;
+    /* Receive-loop cost since the last registry pass, folded into the
+     * worker there (so a batch's own time lands with the next one). */
+    uint64_t syscalls;
+    uint64_t batch_ns_total;
+    uint64_t batch_ns_max;
+    uint64_t buffer_stalls;
+    uint64_t analytics_overruns;
+} UvRelayBatch;
+
+static void relay_batch_init(UvRelayBatch *b, guint cap, gboolean pooled, gboolean kernel_ts) {
+    memset(b, 0, sizeof(*b));
+    b->cap = cap;
+    b->pkts = g_new0(const unsigned char *, cap);
+    b->lens = g_new0(size_t, cap);
+    b->from = g_new0(struct sockaddr_in, cap);
+    b->fromlen = g_new0(socklen_t, cap);
+    b->arrival = g_new0(gint64, cap);
+    b->slots = pooled ? g_new0(UvRelayPoolSlot, cap) : NULL;
+    b->fwd_index = g_new0(int, cap);
+    b->dest = g_new0(GstAppSrc *, cap);
+    b->discovered = g_new0(int, cap);
+    b->recycled = g_new0(gboolean, cap);
+    b->srcs = g_new0(UvRelaySource *, cap);
+    b->selected = g_new0(gboolean, cap);
+    b->calib = g_new0(double, cap);
+    b->delay = kernel_ts ? g_new(int64_t, UV_RELAY_DELAY_WINDOW) : NULL;
+    b->delay_median_ns = -1;
+    b->delay_max_ns = -1;
+}
+
+static void relay_batch_clear(UvRelayBatch *b) {
+    if (b->slots) {
+        for (guint i = 0; i < b->cap; i++) relay_pool_slot_release(&b->slots[i]);
+    }
+    g_free(b->delay);
+    g_free(b->calib);
+    g_free(b->selected);
+    g_free(b->srcs);
+    g_free(b->recycled);
+    g_free(b->discovered);
+    g_free(b->dest);
+    g_free(b->fwd_index);
+    g_free(b->slots);
+    g_free(b->arrival);
+    g_free(b->fromlen);
+    g_free(b->from);
+    g_free(b->lens);
+    g_free(b->pkts);
+}
+
+/* Counters held back by the publish interval are flushed here, so readers
+ * see a source's last packets even once it goes quiet, and held frames
+ * that waited out the latency are released. Called at the top of every
+ * receive loop iteration. */
+static void relay_batch_sweep(RelayController *rc, UvRelayBatch *b) {
+    relay_hold_tick(rc);
+    if (!b->pub_pending) return;
+    gint64 t = relay_now_us(rc);
+    if (t - b->last_sweep_us >= UV_STATS_PUBLISH_INTERVAL_US) {
+        b->pub_pending = relay_publish_sweep(rc, &b->source_lock, rc->viewer->config.clock_rate, t);
+        b->last_sweep_us = t;
+    }
+}
+
+/* Receive wait in ms: short while counters wait to be published, and no
+ * later than the oldest held datagram's deadline. */
+static int relay_wait_ms(RelayController *rc, const UvRelayBatch *b) {
+    int ms = b->pub_pending ? UV_STATS_PUBLISH_INTERVAL_US / 1000 : 200;
+    if (!rc->marker_release) return ms;
+    g_mutex_lock(&rc->hold.lock);
+    if (rc->hold.held > 0) {
+        gint64 left = rc->hold.oldest_us + relay_hold_latency_us(rc) - relay_now_us(rc);
+        ms = (int)CLAMP((left + 999) / 1000, 1, (gint64)ms);
+    }
+    g_mutex_unlock(&rc->hold.lock);
+    return ms;
+}
+
+/* Kernel receive stamps are CLOCK_REALTIME; one realtime/monotonic pair per
+ * batch (rt_to_mono_ns, taken at mono_ns) moves them onto the monotonic
+ * clock the rest of the relay uses. A stamp that lands in the future or
+ * over a second back (clock stepped in between) is ignored and the packet
+ * is stamped when it is processed, as without kernel timestamps. */
+static void relay_batch_stamp(UvRelayBatch *b, guint i, int64_t rx_rt_ns,
+                              int64_t mono_ns, int64_t rt_to_mono_ns) {
+    b->arrival[i] = 0;
+    if (rx_rt_ns == 0 || !b->delay) return;
+    int64_t wait_ns = mono_ns - (rx_rt_ns - rt_to_mono_ns);
+    if (wait_ns < 0 || wait_ns > 1000000000ll) return;
+    b->arrival[i] = (gint64)((rx_rt_ns - rt_to_mono_ns) / 1000);
+    b->delay[b->delay_count++] = wait_ns;
+    if (b->delay_count == UV_RELAY_DELAY_WINDOW) {
+        qsort(b->delay, b->delay_count, sizeof(*b->delay), relay_cmp_i64);
+        b->delay_median_ns = b->delay[b->delay_count / 2];
+        b->delay_max_ns = b->delay[b->delay_count - 1];
+        b->delay_ready = TRUE;
+        b->delay_count = 0;
+    }
+}
+
+/* Close out one batch's timing; start_ns is when the wakeup returned. */
+static void relay_batch_timed(UvRelayBatch *b, uint64_t start_ns) {
+    uint64_t ns = relay_clock_ns() - start_ns;
+    b->batch_ns_total += ns;
+    if (ns > b->batch_ns_max) b->batch_ns_max = ns;
+}
+
+static int64_t relay_rt_to_mono_ns(int64_t *mono_ns) {
+    struct timespec rt;
+    clock_gettime(CLOCK_REALTIME, &rt);
+    *mono_ns = (int64_t)relay_clock_ns();
+    return (int64_t)rt.tv_sec * 1000000000ll + rt.tv_nsec - *mono_ns;
+}
+
+/* Route, account and push the n datagrams a backend just received.
+ * kernel_drops is the backend's cumulative drop count, or UINT64_MAX when
+ * it has nothing new to report. */
+static void relay_batch_process(UvRelayWorker *w, UvRelayBatch *b, guint n, gint64 now_us,
+                                uint64_t kernel_drops) {
+    RelayController *rc = w->rc;
+    UvViewer *viewer = rc->viewer;
+    guint n_discovered = 0;
+    int emit_selected = -1;
+    gboolean any_push = FALSE;
+    gboolean any_restream = FALSE;
+
+    /* Registry pass under rc->lock: source lookup, restream and the push
+     * routing decision for every datagram, plus a copy of the analysis
+     * config. No per-source state is touched here, so a snapshot or a
+     * grid reclassify holding a source lock can't stall it. */
+    relay_lock_timed(&rc->lock, &rc->ingest.registry_lock);
+    gboolean restream = rc->restream.enabled && rc->restream.fanout.count > 0;
+    CaptureRecorder *rec = rc->recorder.thread ? &rc->recorder : NULL;
+    for (guint i = 0; i < n; i++) {
+        const unsigned char *pkt = b->pkts[i];
+        size_t len = b->lens[i];
+        b->fwd_index[i] = -1;
+        b->dest[i] = NULL;
+        b->srcs[i] = NULL;
+
+        int idx = -1;
+        gboolean evicted = FALSE;
+        bool is_new = relay_add_or_find(rc, &b->from[i], b->fromlen[i],
+                                        pkt, len, now_us, &idx, &evicted);
+        /* An all-sources capture takes every datagram, even one the
+         * source table turned away. */
+        if (rec && rec->all_sources) {
+            capture_recorder_push(rec, pkt, len, &b->from[i], b->arrival[i] ? b->arrival[i] : now_us);
+        }
+        if (idx < 0 || (guint)idx >= rc->sources_count) continue;
+        b->srcs[i] = &rc->sources[idx];
+        if (rc->gop.cap > 0 && len >= 12 && (pkt[0] >> 6) == 2 &&
+            (pkt[1] & 0x7F) == rc->viewer->config.payload_type) {
+            relay_gop_append(rc, b->srcs[i], pkt, len);
+        }
+
+        if (is_new) {
+            char addr[64];
+            addr_to_str(&b->srcs[i]->addr, addr, sizeof(addr));
+            if (evicted) {
+                uv_log_info("Relay: source table full, recycled stale slot [%d] for %s:%u",
+                            idx, addr, (unsigned)ntohs(b->srcs[i]->addr.sin_port));
+            } else {
+                uv_log_info("Relay: discovered source [%d] %s", idx, addr);
+            }
+            b->recycled[n_discovered] = evicted;
+            b->discovered[n_discovered++] = idx;
+            if (rc->selected_index < 0) {
+                g_atomic_int_set(&rc->selected_index, idx);
+                emit_selected = idx;
+            } else if (rc->selected_index == idx) {
+                emit_selected = idx;   /* followed its endpoint to a new SSRC */
+            }
+        }
+
+        b->selected[i] = (idx == rc->selected_index);
+        if (!b->selected[i]) continue;
+        if (rec && !rec->all_sources) {
+            capture_recorder_push(rec, pkt, len, &b->from[i], b->arrival[i] ? b->arrival[i] : now_us);
+        }
+
+        /* Verbatim restream: queue every raw datagram from the selected
+         * source, untouched, for each destination (independent of the
+         * pipeline push gate so it keeps flowing while the local view is
+         * paused). The fan-out thread sends; a full queue just drops. */
+        if (restream) {
+            restream_fanout_push(&rc->restream.fanout, pkt, len);
+            any_restream = TRUE;
+        }
+
+        if (rc->push_enabled && (rc->backend != UV_RELAY_BACKEND_REPLAY || rc->replay.decode)) {
+            b->dest[i] = relay_pick_dest_locked(rc, pkt, len);
+            if (b->dest[i]) {
+                gst_object_ref(b->dest[i]);
+                b->fwd_index[i] = idx;
+                any_push = TRUE;
+            }
+        }
+    }
+    relay_analysis_load(rc, &b->analysis, b->calib, b->cap);
+    if (any_restream && restream_fanout_kick(&rc->restream.fanout)) b->syscalls++;
+    if (rec && capture_recorder_kick(rec)) b->syscalls++;
+    rc->ingest.batches++;
+    rc->ingest.datagrams += (uint64_t)n;
+    rc->ingest.batch_last = n;
+    if (n > rc->ingest.batch_peak) rc->ingest.batch_peak = n;
+    rc->ingest.pool_allocated += b->pool_allocated;
+    rc->ingest.pool_recycled += b->pool_recycled;
+    rc->ingest.pool_copies += b->pool_copies;
+    w->batches++;
+    w->datagrams += (uint64_t)n;
+    if (kernel_drops != UINT64_MAX) w->kernel_drops = kernel_drops;
+    if (b->delay_ready) {
+        w->rx_delay_median_ns = b->delay_median_ns;
+        w->rx_delay_max_ns = b->delay_max_ns;
+        b->delay_ready = FALSE;
+    }
+    w->syscalls += b->syscalls;
+    w->batch_ns_total += b->batch_ns_total;
+    w->batch_ns_max = MAX(w->batch_ns_max, b->batch_ns_max);
+    w->buffer_stalls += b->buffer_stalls;
+    w->analytics_overruns += b->analytics_overruns;
+    b->syscalls = b->batch_ns_total = b->batch_ns_max = b->buffer_stalls = 0;
+    b->analytics_overruns = 0;
+    relay_lock_stats_merge(&rc->ingest.source_lock, &b->source_lock);
+    b->pool_allocated = b->pool_recycled = b->pool_copies = 0;
+    if (now_us - rc->pub.published_us >= UV_STATS_PUBLISH_INTERVAL_US) {
+        relay_publish_locked(rc, now_us);
+    } else {
+        b->pub_pending = TRUE;
+    }
+    g_mutex_unlock(&rc->lock);
+
+    /* One metadata record per RTP datagram for the analytics thread,
+     * written before the push: a pooled datagram belongs to appsrc once
+     * pushed. Without the thread the worker folds its own ring here. */
+    UvAnalyticsRing *ring = &w->analytics;
+    guint queued = 0;
+    for (guint i = 0; i < n; i++) {
+        UvPacketMeta meta;
+        if (!b->srcs[i] || !relay_packet_meta(&meta, b->srcs[i], b->pkts[i], b->lens[i], b->arrival[i],
+                                              viewer->config.payload_type, b->selected[i])) {
+            continue;
+        }
+        UvPacketMeta *slot = analytics_ring_slot(ring);
+        if (!slot) {
+            b->analytics_overruns++;
+            continue;
+        }
+        *slot = meta;
+        analytics_ring_commit(ring);
+        queued++;
+    }
+    if (queued > 0 && rc->analytics.thread) {
+        if (relay_analytics_kick(rc)) b->syscalls++;
+    } else if (queued > 0) {
+        relay_analytics_drain(rc, ring, &b->analysis, &b->source_lock, queued, &b->pub_pending);
+        if (b->analysis.calib_count > 0) {
+            g_mutex_lock(&rc->lock);
+            relay_analysis_fold(rc, &b->analysis);
+            relay_publish_locked(rc, now_us);
+            g_mutex_unlock(&rc->lock);
+        }
+    }
+
+    /* Latency tracing tags each video frame, by RTP timestamp, on its first
+     * datagram. Replay arrivals are capture time, so those use the clock. */
+    gboolean trace = viewer->config.latency_trace;
+    gint64 hold_now_us = rc->marker_release && any_push ? relay_now_us(rc) : 0;
+    for (guint i = 0; i < n && any_push; i++) {
+        if (!b->dest[i]) continue;
+        size_t len = b->lens[i];
+        const unsigned char *p = b->pkts[i];
+        gboolean video = (p[1] & 0x7F) == viewer->config.payload_type;
+        if (trace && video) {
+            gint64 at = rc->backend == UV_RELAY_BACKEND_REPLAY || !b->arrival[i]
+                      ? g_get_monotonic_time() : b->arrival[i];
+            uv_internal_latency_ingest(&viewer->latency,
+                                       (uint32_t)((p[4] << 24) | (p[5] << 16) | (p[6] << 8) | p[7]), at);
+        }
+        GstFlowReturn push_ret = GST_FLOW_OK;
+        if (rc->marker_release && video) {
+            gint64 at = rc->backend == UV_RELAY_BACKEND_REPLAY || !b->arrival[i] ? hold_now_us : b->arrival[i];
+            g_mutex_lock(&rc->hold.lock);
+            relay_hold_feed(rc, &rc->hold, b->dest[i], p, len, at, hold_now_us, trace);
+            g_mutex_unlock(&rc->hold.lock);
+        } else if (rc->direct_au && video) {
+            /* Unpacked into the access unit in progress; the datagram,
+             * pooled or not, stays with the batch. */
+            g_mutex_lock(&rc->direct.lock);
+            relay_direct_feed(&rc->direct, b->dest[i], p, len, trace);
+            g_mutex_unlock(&rc->direct.lock);
+        } else {
+            push_ret = (b->slots && b->pkts[i] == b->slots[i].map.data && b->slots[i].buffer)
+                ? relay_push_pooled(b->dest[i], &b->slots[i], len)
+                : relay_push_buffer(b->dest[i], b->pkts[i], len);
+        }
+        gst_object_unref(b->dest[i]);
+        b->dest[i] = NULL;
+        if (push_ret != GST_FLOW_OK) {
+            uv_log_warn("Relay: appsrc push returned %s", gst_flow_get_name(push_ret));
+            b->fwd_index[i] = -1;
+        }
+    }
+
+    /* Receive and forward counters under each source's own lock, taken
+     * once per run of datagrams from the same source. */
+    UvRelaySource *held = NULL;
+    for (guint i = 0; i < n; i++) {
+        UvRelaySource *src = b->srcs[i];
+        if (!src) continue;
+        if (src != held) {
+            if (held) {
+                relay_source_touch(held, viewer->config.clock_rate, now_us);
+                b->pub_pending |= held->pub_dirty;
+                g_mutex_unlock(&held->lock);
+            }
+            relay_lock_timed(&src->lock, &b->source_lock);
+            held = src;
+        }
+        size_t len = b->lens[i];
+        src->rx_packets++;
+        src->rx_bytes += (uint64_t)len;
+        src->last_seen_us = now_us;
+        if (b->fwd_index[i] >= 0) {
+            src->forwarded_packets++;
+            src->forwarded_bytes += (uint64_t)len;
+        }
+    }
+    if (held) {
+        relay_source_touch(held, viewer->config.clock_rate, now_us);
+        b->pub_pending |= held->pub_dirty;
+        g_mutex_unlock(&held->lock);
+    }
+
+    /* New sources are rare; take the event snapshot per discovery rather
+     * than carrying a source copy per batch slot. */
+    for (guint k = 0; k < n_discovered; k++) {
+        int idx = b->discovered[k];
+        UvRelaySource *src = &rc->sources[idx];
+        if (b->recycled[k]) {
+            uv_internal_emit_event(viewer, UV_VIEWER_EVENT_SOURCE_REMOVED, idx, NULL, NULL);
+        }
+        g_mutex_lock(&src->lock);
+        uv_internal_populate_source_stats(src, viewer->config.clock_rate, now_us, &b->snapshot);
+        g_mutex_unlock(&src->lock);
+        uv_internal_emit_event(viewer, UV_VIEWER_EVENT_SOURCE_ADDED, idx, &b->snapshot, NULL);
+        if (idx == emit_selected) {
+            uv_internal_emit_event(viewer, UV_VIEWER_EVENT_SOURCE_SELECTED, idx, &b->snapshot, NULL);
+        }
+    }
+}
+
+/* Open, configure and bind one worker's UDP socket on listen_port, the
+ * same for the socket and io-uring backends. Records whether the socket
+ * delivers kernel receive timestamps. Returns the fd or -1 (logged). */
+static int relay_open_socket(UvRelayWorker *w, gboolean *kernel_ts_out) {
+    RelayController *rc = w->rc;
+    UvViewer *viewer = rc->viewer;
 
-        if (push_index >= 0) {
-            GstFlowReturn push_ret = relay_push_buffer(rc, buf, (size_t)r);
-            if (push_ret != GST_FLOW_OK) {
-                uv_log_warn("Relay: appsrc push returned %s", gst_flow_get_name(push_ret));
+    int in_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (in_fd < 0) {
+        uv_log_error("Relay: socket() failed: %s", g_strerror(errno));
+        return -1;
+    }
+
+    int flags = fcntl(in_fd, F_GETFL, 0);
+    if (flags >= 0) fcntl(in_fd, F_SETFL, flags | O_NONBLOCK);
+
+    int reuse = 1;
+    setsockopt(in_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    /* Only a multi-worker relay joins a reuseport group; a lone socket
+     * keeps the port exclusive to this process. */
+    if (rc->workers_count > 1 &&
+        setsockopt(in_fd, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse)) < 0) {
+        uv_log_error("Relay: worker %u SO_REUSEPORT failed: %s", w->id, g_strerror(errno));
+        close(in_fd);
+        return -1;
+    }
+    setsockopt(in_fd, SOL_SOCKET, SO_RXQ_OVFL, &reuse, sizeof(reuse));
+    gboolean kernel_ts = viewer->config.relay_kernel_timestamps && relay_enable_timestamps(in_fd);
+    if (viewer->config.relay_kernel_timestamps && !kernel_ts) {
+        uv_log_warn("Relay: worker %u has no kernel receive timestamps (%s); stamping on receive",
+                    w->id, g_strerror(errno));
+    }
+    g_mutex_lock(&rc->lock);
+    w->kernel_ts = kernel_ts;
+    g_mutex_unlock(&rc->lock);
+    *kernel_ts_out = kernel_ts;
+
+    int rcvbuf = 4 * 1024 * 1024; // allow bursty sources before poll loop catches up
+    setsockopt(in_fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    struct sockaddr_in bind_addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons((uint16_t)rc->listen_port),
+        .sin_addr.s_addr = htonl(INADDR_ANY)
+    };
+    if (bind(in_fd, (struct sockaddr *)&bind_addr, sizeof(bind_addr)) < 0) {
+        uv_log_error("Relay: bind() failed on port %d: %s", rc->listen_port, g_strerror(errno));
+        close(in_fd);
+        return -1;
+    }
+
+    if (rc->workers_count > 1) {
+        uv_log_info("Relay: worker %u listening on UDP port %d (cpu %d)",
+                    w->id, rc->listen_port, w->cpu);
+    } else {
+        uv_log_info("Relay: listening on UDP port %d", rc->listen_port);
+    }
+    return in_fd;
+}
+
+/* How long relay_controller_start() waits for the workers to open their
+ * sockets before returning with some still starting. */
+#define UV_RELAY_START_WAIT_US (2 * G_USEC_PER_SEC)
+
+/* A worker reports once whether its receive path came up, which
+ * relay_controller_start() waits for. A worker that loses its socket
+ * later (a fallback that cannot reopen one) is marked and logged. */
+static void relay_worker_started(UvRelayWorker *w, gboolean ok) {
+    RelayController *rc = w->rc;
+    g_mutex_lock(&rc->lock);
+    gboolean late = w->started != 0;
+    if (!late || !ok) w->started = ok ? 1 : -1;
+    g_cond_broadcast(&rc->workers_cond);
+    g_mutex_unlock(&rc->lock);
+    if (late && !ok) {
+        uv_log_error("Relay: worker %u has no socket and stopped receiving", w->id);
+    }
+}
+
+static gpointer relay_thread_run(gpointer data) {
+    UvRelayWorker *w = (UvRelayWorker *)data;
+    RelayController *rc = w->rc;
+
+    relay_worker_pin(w);
+
+    gboolean kernel_ts = FALSE;
+    int in_fd = relay_open_socket(w, &kernel_ts);
+    relay_worker_started(w, in_fd >= 0);
+    if (in_fd < 0) return NULL;
+    g_mutex_lock(&rc->lock);
+    w->backend = UV_RELAY_BACKEND_SOCKET;
+    g_mutex_unlock(&rc->lock);
+
+    /* One recvmmsg() vector per wakeup. Every slot owns a full-size scratch
+     * buffer; with the pool on, the first UV_RELAY_POOL_BUF_SIZE bytes are
+     * scattered into pool memory instead and only an oversized datagram
+     * spills into (and is reassembled in) scratch. */
+    guint batch = rc->ingest.batch_size;
+    GstBufferPool *pool = rc->ingest.pool_buffers > 0 ? relay_pool_new(rc->ingest.pool_buffers) : NULL;
+    UvRelayBatch b;
+    relay_batch_init(&b, batch, pool != NULL, kernel_ts);
+    unsigned char *buf = g_malloc0((gsize)batch * UV_RELAY_BUF_SIZE);
+    struct mmsghdr *msgs = g_new0(struct mmsghdr, batch);
+    struct iovec *iov = g_new0(struct iovec, (gsize)batch * 2u);
+    unsigned char *ctrl = g_malloc0((gsize)batch * UV_RELAY_CTRL_SIZE);
+    for (guint i = 0; i < batch; i++) {
+        msgs[i].msg_hdr.msg_iov = &iov[2u * i];
+        msgs[i].msg_hdr.msg_name = &b.from[i];
+        msgs[i].msg_hdr.msg_control = ctrl + (gsize)i * UV_RELAY_CTRL_SIZE;
+    }
+
+    struct pollfd fds[1];
+    fds[0].fd = in_fd;
+    fds[0].events = POLLIN;
+
+    gboolean backlog = FALSE;
+    while (rc->running) {
+        relay_batch_sweep(rc, &b);
+
+        /* A full vector on the previous call means datagrams are very likely
+         * still queued: go straight back to recvmmsg() and skip the poll(). */
+        if (!backlog) {
+            int pr = poll(fds, 1, relay_wait_ms(rc, &b));
+            b.syscalls++;
+            if (pr < 0) {
+                if (errno == EINTR) continue;
+                uv_log_warn("Relay: poll() error: %s", g_strerror(errno));
+                break;
+            }
+            if (!(pr > 0 && (fds[0].revents & POLLIN))) continue;
+        }
+
+        uint64_t start_ns = relay_clock_ns();
+        for (guint i = 0; i < batch; i++) {
+            unsigned char *scratch = buf + (gsize)i * UV_RELAY_BUF_SIZE;
+            struct iovec *v = &iov[2u * i];
+            if (pool && relay_pool_slot_arm(pool, rc->ingest.pool_seen_quark, &b.slots[i], &b.pool_allocated, &b.pool_recycled)) {
+                v[0].iov_base = b.slots[i].map.data;
+                v[0].iov_len = UV_RELAY_POOL_BUF_SIZE;
+                v[1].iov_base = scratch + UV_RELAY_POOL_BUF_SIZE;
+                v[1].iov_len = UV_RELAY_BUF_SIZE - UV_RELAY_POOL_BUF_SIZE;
+                msgs[i].msg_hdr.msg_iovlen = 2;
             } else {
-                g_mutex_lock(&rc->lock);
-                if (push_index >= 0 && (guint)push_index < rc->sources_count) {
-                    UvRelaySource *forward_src = &rc->sources[push_index];
-                    if (forward_src->in_use) {
-                        forward_src->forwarded_packets++;
-                        forward_src->forwarded_bytes += (uint64_t)r;
-                    }
+                v[0].iov_base = scratch;
+                v[0].iov_len = UV_RELAY_BUF_SIZE;
+                msgs[i].msg_hdr.msg_iovlen = 1;
+            }
+            msgs[i].msg_hdr.msg_namelen = sizeof(b.from[i]);
+            msgs[i].msg_hdr.msg_controllen = UV_RELAY_CTRL_SIZE;
+            msgs[i].msg_hdr.msg_flags = 0;
+            msgs[i].msg_len = 0;
+        }
+        int n = recvmmsg(in_fd, msgs, batch, MSG_DONTWAIT, NULL);
+        b.syscalls++;
+        if (n <= 0) {
+            backlog = FALSE;
+            if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                uv_log_warn("Relay: recvmmsg() error: %s", g_strerror(errno));
+            }
+            continue;
+        }
+        backlog = ((guint)n == batch);
+        gint64 now_us = g_get_monotonic_time();
+
+        uint32_t rxq_drops = 0;
+        gboolean have_drops = FALSE;
+        int64_t mono_ns = 0, rt_to_mono_ns = 0;
+        if (kernel_ts) rt_to_mono_ns = relay_rt_to_mono_ns(&mono_ns);
+        for (int i = 0; i < n; i++) {
+            int64_t rx_rt_ns = 0;
+            relay_rx_cmsg(&msgs[i].msg_hdr, &rxq_drops, &have_drops, &rx_rt_ns);
+            relay_batch_stamp(&b, (guint)i, rx_rt_ns, mono_ns, rt_to_mono_ns);
+        }
+
+        /* Resolve each datagram to one contiguous view. A pooled datagram
+         * that overflowed into scratch gets its head copied in front of the
+         * tail and takes the copy path on push. */
+        for (int i = 0; i < n; i++) {
+            unsigned char *scratch = buf + (gsize)i * UV_RELAY_BUF_SIZE;
+            b.lens[i] = msgs[i].msg_len;
+            b.fromlen[i] = msgs[i].msg_hdr.msg_namelen;
+            if (msgs[i].msg_hdr.msg_iovlen == 2) {
+                if (msgs[i].msg_len <= UV_RELAY_POOL_BUF_SIZE) {
+                    b.pkts[i] = b.slots[i].map.data;
+                    continue;
                 }
-                g_mutex_unlock(&rc->lock);
+                memcpy(scratch, b.slots[i].map.data, UV_RELAY_POOL_BUF_SIZE);
+                b.pool_copies++;
             }
+            b.pkts[i] = scratch;
         }
+
+        relay_batch_process(w, &b, (guint)n, now_us, have_drops ? rxq_drops : UINT64_MAX);
+        relay_batch_timed(&b, start_ns);
     }
 
     close(in_fd);
+    relay_batch_clear(&b);
+    if (pool) {
+        gst_buffer_pool_set_active(pool, FALSE);
+        gst_object_unref(pool);
+    }
+    g_free(ctrl);
+    g_free(iov);
+    g_free(msgs);
     g_free(buf);
-    rc->running = 0;
+    return NULL;
+}
+
+/* Packet-ring backend (relay_backend = packet-ring): one thread reading a
+ * TPACKET_V3 ring instead of a UDP socket. Datagrams are processed in
+ * place in the ring, up to recv_batch at a time, and each block goes back
+ * to the kernel once the batches drawn from it have been pushed; appsrc
+ * gets a copy, so the pool is not used. A poll() is only needed when the
+ * ring is empty. Arrival stamps are the ring's own (always kernel
+ * CLOCK_REALTIME) and kernel_drops counts frames lost to a full ring. */
+static gpointer relay_ring_thread_run(gpointer data) {
+    UvRelayWorker *w = (UvRelayWorker *)data;
+    RelayController *rc = w->rc;
+    UvViewer *viewer = rc->viewer;
+
+    relay_worker_pin(w);
+
+    PacketRing ring;
+    if (!packet_ring_open(&ring, viewer->config.relay_ring_ifname, rc->listen_port)) {
+        relay_worker_started(w, FALSE);
+        return NULL;
+    }
+    relay_worker_started(w, TRUE);
+    gboolean kernel_ts = viewer->config.relay_kernel_timestamps;
+    g_mutex_lock(&rc->lock);
+    w->kernel_ts = kernel_ts;
+    g_mutex_unlock(&rc->lock);
+    uv_log_info("Relay: packet ring on %s listening on UDP port %d",
+                viewer->config.relay_ring_ifname[0] ? viewer->config.relay_ring_ifname : "any",
+                rc->listen_port);
+
+    guint batch = rc->ingest.batch_size;
+    UvRelayBatch b;
+    relay_batch_init(&b, batch, FALSE, kernel_ts);
+    PacketRingPacket *ring_pkts = g_new0(PacketRingPacket, batch);
+
+    struct pollfd fds[1];
+    fds[0].fd = ring.fd;
+    fds[0].events = POLLIN;
+
+    uint64_t stats_block = 0;
+    while (rc->running) {
+        relay_batch_sweep(rc, &b);
+
+        if (!packet_ring_ready(&ring)) {
+            int pr = poll(fds, 1, relay_wait_ms(rc, &b));
+            b.syscalls++;
+            if (pr < 0) {
+                if (errno == EINTR) continue;
+                uv_log_warn("Relay: poll() error: %s", g_strerror(errno));
+                break;
+            }
+            if (!packet_ring_ready(&ring)) continue;
+        }
+
+        uint64_t start_ns = relay_clock_ns();
+        guint n = packet_ring_next(&ring, ring_pkts, batch);
+        if (n == 0) {
+            packet_ring_release(&ring);
+            continue;
+        }
+        gint64 now_us = g_get_monotonic_time();
+        int64_t mono_ns = 0, rt_to_mono_ns = 0;
+        if (kernel_ts) rt_to_mono_ns = relay_rt_to_mono_ns(&mono_ns);
+        for (guint i = 0; i < n; i++) {
+            b.pkts[i] = ring_pkts[i].data;
+            b.lens[i] = ring_pkts[i].len;
+            b.from[i] = ring_pkts[i].from;
+            b.fromlen[i] = sizeof(b.from[i]);
+            relay_batch_stamp(&b, i, kernel_ts ? ring_pkts[i].rx_realtime_ns : 0, mono_ns, rt_to_mono_ns);
+        }
+
+        /* Ring statistics cost a syscall; read them once per block. */
+        uint64_t drops = UINT64_MAX;
+        if (ring.blocks != stats_block) {
+            stats_block = ring.blocks;
+            drops = packet_ring_drops(&ring);
+            b.syscalls++;
+        }
+        relay_batch_process(w, &b, n, now_us, drops);
+        packet_ring_release(&ring);
+        relay_batch_timed(&b, start_ns);
+    }
+
+    packet_ring_close(&ring);
+    relay_batch_clear(&b);
+    g_free(ring_pkts);
+    return NULL;
+}
+
+/* Replay backend (replay_path set). The one worker reads the capture and
+ * hands its datagrams to relay_batch_process() as if received, batching
+ * them by capture time instead of by wakeup: a batch closes at recv_batch
+ * datagrams or at a gap over UV_RELAY_REPLAY_GAP_US to the next one, so
+ * both pacing modes cut the same batches. The virtual clock follows the
+ * capture timestamps (held, never stepped back, where they go backwards)
+ * and stamps every arrival. At the original timing the worker sleeps until
+ * each batch is due, measured from the first; fast mode never sleeps. At
+ * the end the clock moves one publish interval on so that everything held
+ * back by rate limiting goes out, and the stats then stay put. */
+#define UV_RELAY_REPLAY_GAP_US 100
+
+static gpointer relay_replay_thread_run(gpointer data) {
+    UvRelayWorker *w = (UvRelayWorker *)data;
+    RelayController *rc = w->rc;
+
+    CaptureReader cr;
+    if (!capture_reader_open(&cr, rc->replay.path, (guint16)rc->listen_port)) {
+        g_atomic_int_set(&rc->replay.finished, 1);
+        relay_worker_started(w, FALSE);
+        return NULL;
+    }
+    relay_worker_started(w, TRUE);
+    uv_log_info("Relay: replaying %s (%s, %s)", rc->replay.path,
+                cr.format == UV_RECORD_FORMAT_RTPDUMP ? "rtpdump" : "pcap",
+                rc->replay.fast ? "as fast as possible" : "original timing");
+
+    guint batch = rc->ingest.batch_size;
+    UvRelayBatch b;
+    relay_batch_init(&b, batch, FALSE, FALSE);
+    /* One spare slot holds the datagram that opens the next batch. */
+    unsigned char **bufs = g_new(unsigned char *, batch + 1);
+    for (guint i = 0; i <= batch; i++) bufs[i] = g_malloc(UV_RELAY_BUF_SIZE);
+    CaptureDatagram *dg = g_new0(CaptureDatagram, batch + 1);
+    gint64 *when = g_new0(gint64, batch + 1);
+
+    gint64 wall0 = g_get_monotonic_time();
+    gint64 first_us = 0;
+    gint64 clock_us = 0;
+    guint held = 0;
+    gboolean eof = FALSE;
+
+    while (rc->running && !eof) {
+        relay_batch_sweep(rc, &b);
+
+        /* Fill the batch, copying each datagram out of the reader's
+         * buffer and stamping it on the virtual clock. */
+        guint n = held;
+        while (n < batch) {
+            if (!capture_reader_next(&cr, &dg[n])) {
+                eof = TRUE;
+                break;
+            }
+            if (dg[n].len > UV_RELAY_BUF_SIZE) {
+                cr.skipped++;
+                continue;
+            }
+            memcpy(bufs[n], dg[n].data, dg[n].len);
+            if (first_us == 0) first_us = clock_us = dg[n].ts_us;
+            when[n] = MAX(dg[n].ts_us, n > 0 ? when[n - 1] : clock_us);
+            if (n > 0 && when[n] - when[n - 1] > UV_RELAY_REPLAY_GAP_US) break;
+            n++;
+        }
+        /* Slot n, when filled above without being taken, opens the next
+         * batch. */
+        held = (!eof && n < batch) ? 1 : 0;
+        if (n == 0) break;
+
+        if (!rc->replay.fast) {
+            gint64 due = wall0 + (when[n - 1] - first_us);
+            for (gint64 now = g_get_monotonic_time(); now < due && rc->running;
+                 now = g_get_monotonic_time()) {
+                g_usleep((gulong)MIN(due - now, (gint64)100000));
+            }
+        }
+
+        uint64_t start_ns = relay_clock_ns();
+        for (guint i = 0; i < n; i++) {
+            b.pkts[i] = bufs[i];
+            b.lens[i] = dg[i].len;
+            b.from[i] = dg[i].from;
+            b.fromlen[i] = sizeof(b.from[i]);
+            b.arrival[i] = when[i];
+        }
+        clock_us = when[n - 1];
+        __atomic_store_n(&rc->replay.clock_us, clock_us, __ATOMIC_RELAXED);
+        relay_batch_process(w, &b, n, clock_us, UINT64_MAX);
+        relay_batch_timed(&b, start_ns);
+        __atomic_store_n(&rc->replay.datagrams, rc->replay.datagrams + n, __ATOMIC_RELAXED);
+        __atomic_store_n(&rc->replay.skipped, cr.skipped, __ATOMIC_RELAXED);
+        __atomic_store_n(&rc->replay.capture_us, clock_us - first_us, __ATOMIC_RELAXED);
+        __atomic_store_n(&rc->replay.wall_us, g_get_monotonic_time() - wall0, __ATOMIC_RELAXED);
+
+        if (held) {
+            unsigned char *t = bufs[0];
+            bufs[0] = bufs[n];
+            bufs[n] = t;
+            dg[0] = dg[n];
+            when[0] = when[n];
+        }
+    }
+
+    clock_us += UV_STATS_PUBLISH_INTERVAL_US;
+    __atomic_store_n(&rc->replay.clock_us, clock_us, __ATOMIC_RELAXED);
+    relay_publish_sweep(rc, &b.source_lock, rc->viewer->config.clock_rate, clock_us);
+    g_atomic_int_set(&rc->replay.finished, eof);
+    g_mutex_lock(&rc->lock);
+    relay_publish_locked(rc, clock_us);
+    g_mutex_unlock(&rc->lock);
+    if (eof) {
+        double wall_s = (double)(g_get_monotonic_time() - wall0) / 1e6;
+        double capture_s = (double)(clock_us - UV_STATS_PUBLISH_INTERVAL_US - first_us) / 1e6;
+        uv_log_info("Relay: replay finished, %" G_GUINT64_FORMAT " datagrams (%" G_GUINT64_FORMAT
+                    " skipped) covering %.1fs in %.1fs",
+                    rc->replay.datagrams, cr.skipped, capture_s, wall_s);
+    }
+
+    capture_reader_close(&cr);
+    relay_batch_clear(&b);
+    for (guint i = 0; i <= batch; i++) g_free(bufs[i]);
+    g_free(bufs);
+    g_free(dg);
+    g_free(when);
+    return NULL;
+}
+
+/* io-uring backend (relay_backend = io-uring). Each worker owns a ring, a
+ * socket set up exactly like the socket backend's, and a provided-buffer
+ * ring the kernel fills on its own: one multishot recvmsg stays armed and
+ * posts a completion per datagram (header, source address, control data
+ * and payload in one buffer), so the loop's only syscall is the
+ * io_uring_enter() that submits pending work and waits for completions.
+ * Completions are reaped up to recv_batch at a time and handed to
+ * relay_batch_process() straight out of the buffers, which go back to the
+ * kernel as soon as their batch is done. Kernels without io_uring,
+ * provided buffer rings or multishot recvmsg (Linux 6.0) fall back to the
+ * socket backend. */
+#define UV_RELAY_URING_TAG_RECV 0ull
+#define UV_RELAY_URING_TAG_CANCEL 1ull
+#define UV_RELAY_URING_BUF_SIZE \
+    (sizeof(struct io_uring_recvmsg_out) + sizeof(struct sockaddr_in) + UV_RELAY_CTRL_SIZE + UV_RELAY_BUF_SIZE)
+
+typedef struct {
+    UringIo io;
+    int fd;
+    struct msghdr recv_mh;      /* multishot template: name and control sizes */
+    gboolean armed;
+    gboolean recv_failed;       /* multishot recvmsg rejected: fall back */
+    guint *bids;                /* provided buffer behind each batch slot */
+    guint recycled;             /* buffers queued since the last publish */
+} UvRelayUring;
+
+static gboolean relay_uring_arm(UvRelayUring *ru) {
+    struct io_uring_sqe *sqe = uring_io_get_sqe(&ru->io);
+    if (!sqe) return FALSE;
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = ru->fd;
+    sqe->addr = (uint64_t)(uintptr_t)&ru->recv_mh;
+    sqe->len = 1;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = 0;
+    sqe->user_data = UV_RELAY_URING_TAG_RECV;
+    ru->armed = TRUE;
+    return TRUE;
+}
+
+static void relay_uring_recycle(UvRelayUring *ru, guint bid) {
+    uring_io_buffer_recycle(&ru->io, bid);
+    ru->recycled++;
+}
+
+/* Hand a processed batch's buffers back to the kernel. */
+static void relay_uring_finish_batch(UvRelayUring *ru, guint n) {
+    for (guint i = 0; i < n; i++) relay_uring_recycle(ru, ru->bids[i]);
+}
+
+/* Reap every ready completion. Receives are gathered into batches of up
+ * to b->cap and processed as they fill. */
+static void relay_uring_reap(UvRelayWorker *w, UvRelayUring *ru, UvRelayBatch *b,
+                             gboolean kernel_ts, uint64_t start_ns) {
+    unsigned head;
+    unsigned ready = uring_io_cq_ready(&ru->io, &head);
+    if (ready == 0) return;
+    gint64 now_us = g_get_monotonic_time();
+    int64_t mono_ns = 0, rt_to_mono_ns = 0;
+    if (kernel_ts) rt_to_mono_ns = relay_rt_to_mono_ns(&mono_ns);
+    uint32_t rxq_drops = 0;
+    gboolean have_drops = FALSE;
+    guint n = 0;
+
+    for (unsigned k = 0; k < ready; k++) {
+        const struct io_uring_cqe *cqe = uring_io_cqe_at(&ru->io, head + k);
+        if (cqe->user_data != UV_RELAY_URING_TAG_RECV) continue;
+
+        if (!(cqe->flags & IORING_CQE_F_MORE)) ru->armed = FALSE;
+        if (cqe->res < 0) {
+            if (cqe->res == -ENOBUFS) {
+                b->buffer_stalls++;
+            } else if (cqe->res == -EINVAL || cqe->res == -EOPNOTSUPP) {
+                ru->recv_failed = TRUE;
+            } else if (cqe->res != -ECANCELED) {
+                uv_log_warn("Relay: io_uring recvmsg error: %s", g_strerror(-cqe->res));
+            }
+            continue;
+        }
+        if (!(cqe->flags & IORING_CQE_F_BUFFER)) continue;
+        guint bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+        unsigned char *buf = uring_io_buffer(&ru->io, bid);
+        const struct io_uring_recvmsg_out *out = (const struct io_uring_recvmsg_out *)buf;
+        unsigned char *name = buf + sizeof(*out);
+        unsigned char *control = name + ru->recv_mh.msg_namelen;
+        unsigned char *payload = control + ru->recv_mh.msg_controllen;
+        if ((size_t)cqe->res < (size_t)(payload - buf) || out->namelen < sizeof(struct sockaddr_in)) {
+            relay_uring_recycle(ru, bid);
+            continue;
+        }
+        size_t avail = (size_t)cqe->res - (size_t)(payload - buf);
+
+        struct msghdr cm = {
+            .msg_control = control,
+            .msg_controllen = MIN(out->controllen, (uint32_t)ru->recv_mh.msg_controllen),
+        };
+        int64_t rx_rt_ns = 0;
+        relay_rx_cmsg(&cm, &rxq_drops, &have_drops, &rx_rt_ns);
+        ru->bids[n] = bid;
+        memcpy(&b->from[n], name, sizeof(b->from[n]));
+        b->fromlen[n] = sizeof(b->from[n]);
+        b->pkts[n] = payload;
+        b->lens[n] = MIN((size_t)out->payloadlen, avail);
+        relay_batch_stamp(b, n, rx_rt_ns, mono_ns, rt_to_mono_ns);
+        if (++n == b->cap) {
+            relay_batch_process(w, b, n, now_us, have_drops ? rxq_drops : UINT64_MAX);
+            relay_uring_finish_batch(ru, n);
+            relay_batch_timed(b, start_ns);
+            start_ns = relay_clock_ns();
+            have_drops = FALSE;
+            n = 0;
+        }
+    }
+    uring_io_cq_advance(&ru->io, ready);
+    if (n > 0) {
+        relay_batch_process(w, b, n, now_us, have_drops ? rxq_drops : UINT64_MAX);
+        relay_uring_finish_batch(ru, n);
+        relay_batch_timed(b, start_ns);
+    }
+    if (ru->recycled > 0) {
+        uring_io_buffers_publish(&ru->io);
+        ru->recycled = 0;
+    }
+}
+
+static gpointer relay_uring_thread_run(gpointer data) {
+    UvRelayWorker *w = (UvRelayWorker *)data;
+    RelayController *rc = w->rc;
+
+    relay_worker_pin(w);
+
+    /* Four buffers per batch slot (a power of two, as the buffer ring
+     * requires) so the kernel keeps receiving while a reap pass works
+     * through several batches. */
+    guint batch = rc->ingest.batch_size;
+    guint nbufs = 16;
+    while (nbufs < 4u * batch) nbufs <<= 1;
+    UvRelayUring ru;
+    memset(&ru, 0, sizeof(ru));
+    if (!uring_io_init(&ru.io, 2u * nbufs) ||
+        !uring_io_buffers_init(&ru.io, nbufs, UV_RELAY_URING_BUF_SIZE, 0)) {
+        uv_log_warn("Relay: worker %u io_uring unavailable (%s); using recvmmsg()",
+                    w->id, g_strerror(errno));
+        uring_io_close(&ru.io);
+        return relay_thread_run(data);
+    }
+
+    gboolean kernel_ts = FALSE;
+    ru.fd = relay_open_socket(w, &kernel_ts);
+    relay_worker_started(w, ru.fd >= 0);
+    if (ru.fd < 0) {
+        uring_io_close(&ru.io);
+        return NULL;
+    }
+    ru.recv_mh.msg_namelen = sizeof(struct sockaddr_in);
+    ru.recv_mh.msg_controllen = UV_RELAY_CTRL_SIZE;
+    ru.bids = g_new0(guint, batch);
+
+    UvRelayBatch b;
+    relay_batch_init(&b, batch, FALSE, kernel_ts);
+
+    while (rc->running && !ru.recv_failed) {
+        relay_batch_sweep(rc, &b);
+        if (!ru.armed && !relay_uring_arm(&ru)) {
+            uring_io_submit(&ru.io, FALSE, 0);
+            b.syscalls++;
+            continue;
+        }
+        int ret = uring_io_submit(&ru.io, TRUE, relay_wait_ms(rc, &b));
+        b.syscalls++;
+        if (ret < 0 && ret != -ETIME && ret != -EINTR && ret != -EBUSY && ret != -EAGAIN) {
+            uv_log_warn("Relay: io_uring_enter() error: %s", g_strerror(-ret));
+            break;
+        }
+        relay_uring_reap(w, &ru, &b, kernel_ts, relay_clock_ns());
+    }
+
+    /* Cancel the receive and wait for it to retire before the buffers it
+     * writes into go away. */
+    struct io_uring_sqe *sqe = uring_io_get_sqe(&ru.io);
+    if (sqe) {
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = UV_RELAY_URING_TAG_RECV;
+        sqe->user_data = UV_RELAY_URING_TAG_CANCEL;
+    }
+    for (int tries = 0; tries < 20 && ru.armed; tries++) {
+        uring_io_submit(&ru.io, TRUE, 50);
+        relay_uring_reap(w, &ru, &b, kernel_ts, relay_clock_ns());
+    }
+
+    gboolean fallback = ru.recv_failed;
+    close(ru.fd);
+    uring_io_close(&ru.io);
+    relay_batch_clear(&b);
+    g_free(ru.bids);
+    if (fallback && rc->running) {
+        uv_log_warn("Relay: worker %u kernel lacks multishot recvmsg; using recvmmsg()", w->id);
+        return relay_thread_run(data);
+    }
+    return NULL;
+}
+
+/* Analytics thread: drains every worker's metadata ring in passes of up
+ * to UV_RELAY_ANALYTICS_BATCH records per ring. Each pass reloads the
+ * analysis config under rc->lock, as a worker batch used to, and hands
+ * calibration samples back there. With nothing queued it sleeps on
+ * wake_fd, waking on its own only to flush sources left dirty by the
+ * publish rate limit. One last pass after running drops catches what the
+ * workers queued before they were joined. */
+static gpointer relay_analytics_run(gpointer data) {
+    RelayController *rc = (RelayController *)data;
+    UvRelayAnalysis an;
+    guint capacity = UV_RELAY_ANALYTICS_BATCH * rc->workers_count;
+    double *calib = g_new0(double, capacity);
+    UvLockStats source_lock;
+    memset(&source_lock, 0, sizeof(source_lock));
+    gboolean pub_pending = FALSE;
+    gint64 last_sweep_us = 0;
+    struct pollfd pfd = { .fd = rc->analytics.wake_fd, .events = POLLIN };
+
+    for (;;) {
+        gboolean running = g_atomic_int_get(&rc->analytics.running);
+        relay_lock_timed(&rc->lock, &rc->ingest.registry_lock);
+        relay_analysis_load(rc, &an, calib, capacity);
+        relay_lock_stats_merge(&rc->ingest.source_lock, &source_lock);
+        g_mutex_unlock(&rc->lock);
+
+        guint folded = 0;
+        for (guint i = 0; i < rc->workers_count; i++) {
+            folded += relay_analytics_drain(rc, &rc->workers[i].analytics, &an, &source_lock,
+                                            UV_RELAY_ANALYTICS_BATCH, &pub_pending);
+        }
+        gint64 now_us = relay_now_us(rc);
+        if (an.calib_count > 0) {
+            g_mutex_lock(&rc->lock);
+            relay_analysis_fold(rc, &an);
+            relay_publish_locked(rc, now_us);
+            g_mutex_unlock(&rc->lock);
+        }
+        if (!running) break;
+        if (pub_pending && now_us - last_sweep_us >= UV_STATS_PUBLISH_INTERVAL_US) {
+            pub_pending = relay_publish_sweep(rc, &source_lock, rc->viewer->config.clock_rate, now_us);
+            last_sweep_us = now_us;
+        }
+        if (folded > 0) continue;
+
+        /* Announce the sleep, then look once more: a record queued before
+         * the announcement was seen has to be caught here. */
+        g_atomic_int_set(&rc->analytics.sleeping, 1);
+        gboolean pending = FALSE;
+        for (guint i = 0; i < rc->workers_count && !pending; i++) {
+            const UvAnalyticsRing *r = &rc->workers[i].analytics;
+            pending = __atomic_load_n(&r->head, __ATOMIC_SEQ_CST) !=
+                      __atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+        }
+        if (!pending && g_atomic_int_get(&rc->analytics.running)) {
+            poll(&pfd, 1, pub_pending ? UV_STATS_PUBLISH_INTERVAL_US / 1000 : 200);
+            if (pfd.revents & POLLIN) {
+                uint64_t v;
+                ssize_t r = read(rc->analytics.wake_fd, &v, sizeof(v));
+                (void)r;
+            }
+        }
+        g_atomic_int_set(&rc->analytics.sleeping, 0);
+    }
+
+    g_mutex_lock(&rc->lock);
+    relay_lock_stats_merge(&rc->ingest.source_lock, &source_lock);
+    g_mutex_unlock(&rc->lock);
+    g_free(calib);
     return NULL;
 }
 
@@ -1432,6 +3731,31 @@ gboolean relay_controller_init(RelayController *rc, struct _UvViewer *viewer) {
 
     memset(rc, 0, sizeof(*rc));
     g_mutex_init(&rc->lock);
+    g_cond_init(&rc->workers_cond);
+    guint max_sources = viewer->config.relay_max_sources;
+    if (max_sources == 0) max_sources = UV_RELAY_SOURCES_DEFAULT;
+    rc->sources_max = MIN(max_sources, UV_RELAY_SOURCES_MAX);
+    /* Slots are cache-line aligned so one source's hot block never shares a
+     * line with another's (see UvRelaySource). */
+    void *slots = NULL;
+    if (posix_memalign(&slots, UV_CACHE_LINE, sizeof(UvRelaySource) * rc->sources_max) != 0) {
+        g_cond_clear(&rc->workers_cond);
+        g_mutex_clear(&rc->lock);
+        return FALSE;
+    }
+    memset(slots, 0, sizeof(UvRelaySource) * rc->sources_max);
+    rc->sources = slots;
+    for (guint i = 0; i < rc->sources_max; i++) {
+        g_mutex_init(&rc->sources[i].lock);
+    }
+    /* Two keys per source at most; keep the table no more than half full. */
+    guint buckets = 16;
+    while (buckets < 4u * rc->sources_max) buckets <<= 1;
+    rc->index.entries = g_new(UvRelayIndexEntry, buckets);
+    for (guint i = 0; i < buckets; i++) rc->index.entries[i].slot = -1;
+    rc->index.mask = buckets - 1;
+    rc->index.lru_head = -1;
+    rc->index.lru_tail = -1;
     rc->listen_port = viewer->config.listen_port;
     rc->selected_index = -1;
     rc->viewer = viewer;
@@ -1461,18 +3785,67 @@ gboolean relay_controller_init(RelayController *rc, struct _UvViewer *viewer) {
     rc->frame_block.thresholds_fpc[0] = 1.0;
     rc->frame_block.thresholds_fpc[1] = 2.0;
     rc->frame_block.thresholds_fpc[2] = 3.0;
-    rc->frame_block.reset_requested = TRUE;
-    rc->frame_block.thresholds_dirty_ms = TRUE;
-    rc->frame_block.thresholds_dirty_kb = TRUE;
 
     rc->frame_release.enabled = FALSE;
     rc->frame_release.paused = FALSE;
     rc->frame_release.gap_us = UV_RELEASE_DEFAULT_GAP_US;
-    rc->frame_release.reset_requested = TRUE;
 
     rc->restream.enabled = FALSE;
-    rc->restream.fd = -1;
-    rc->restream.dest_valid = FALSE;
+    restream_fanout_init(&rc->restream.fanout, viewer->config.restream_queue_depth,
+                         viewer->config.restream_pace_spread, viewer->config.payload_type);
+    capture_recorder_init(&rc->recorder, &viewer->config);
+    rc->gop.cap = (size_t)MIN(viewer->config.gop_cache_kb, UV_GOP_CACHE_MAX_KB) * 1024u;
+    g_mutex_init(&rc->direct.lock);
+    rc->direct_au = viewer->config.direct_au;
+    rc->direct.loss = viewer->config.direct_au_loss;
+    relay_direct_reset(&rc->direct);
+    g_mutex_init(&rc->hold.lock);
+    rc->marker_release = viewer->config.marker_release;
+    if (rc->marker_release) rc->hold.slots = g_new0(RelayHoldSlot, UV_RELAY_HOLD_SLOTS);
+
+    guint batch = viewer->config.relay_batch_size;
+    if (batch == 0) batch = UV_RELAY_BATCH_DEFAULT;
+    rc->ingest.batch_size = MIN(batch, UV_RELAY_BATCH_MAX);
+    rc->ingest.pool_buffers = viewer->config.relay_pool_buffers;
+    rc->ingest.pool_seen_quark = g_quark_from_static_string("uv-relay-pool-seen");
+
+    /* The packet ring already sees every datagram on the interface from
+     * one socket; it runs a single thread. */
+    guint workers = viewer->config.relay_workers;
+    rc->backend = viewer->config.relay_backend;
+    if (viewer->config.replay_path[0]) {
+        rc->backend = UV_RELAY_BACKEND_REPLAY;
+        g_strlcpy(rc->replay.path, viewer->config.replay_path, sizeof(rc->replay.path));
+        rc->replay.fast = viewer->config.replay_fast;
+        rc->replay.decode = viewer->config.replay_decode;
+    }
+    if (rc->backend == UV_RELAY_BACKEND_PACKET_RING || rc->backend == UV_RELAY_BACKEND_REPLAY) workers = 1;
+    rc->workers_count = CLAMP(workers, 1u, UV_RELAY_WORKERS_MAX);
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    gboolean pin = rc->workers_count > 1 && viewer->config.relay_pin_workers && online > 0;
+    for (guint i = 0; i < rc->workers_count; i++) {
+        rc->workers[i].rc = rc;
+        rc->workers[i].id = i;
+        rc->workers[i].cpu = pin ? (int)(i % (guint)online) : -1;
+        rc->workers[i].rx_delay_median_ns = -1;
+        rc->workers[i].rx_delay_max_ns = -1;
+        rc->workers[i].backend = rc->backend;
+    }
+
+    guint records = viewer->config.relay_analytics_ring;
+    if (records == 0) records = UV_RELAY_ANALYTICS_RING_DEFAULT;
+    records = MIN(records, UV_RELAY_ANALYTICS_RING_MAX);
+    rc->analytics.ring_size = 64;
+    while (rc->analytics.ring_size < records) rc->analytics.ring_size <<= 1;
+    for (guint i = 0; i < rc->workers_count; i++) {
+        rc->workers[i].analytics.recs = g_new(UvPacketMeta, rc->analytics.ring_size);
+        rc->workers[i].analytics.mask = rc->analytics.ring_size - 1;
+    }
+    rc->analytics.wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (rc->analytics.wake_fd < 0) {
+        uv_log_warn("Relay: analytics eventfd() failed: %s", g_strerror(errno));
+    }
+    relay_publish_locked(rc, relay_now_us(rc));
     return TRUE;
 }
 
@@ -1483,63 +3856,150 @@ void relay_controller_deinit(RelayController *rc) {
     rc->appsrc = NULL;
     rc->audio_appsrc = NULL;
     for (guint i = 0; i < rc->sources_count; i++) {
-        frame_block_state_free(rc->sources[i].frame_block);
-        rc->sources[i].frame_block = NULL;
-        release_rings_free(&rc->sources[i]);
+        relay_gop_free(rc, &rc->sources[i]);
+        relay_source_free_storage(&rc->sources[i]);
     }
     rc->sources_count = 0;
     rc->selected_index = -1;
     g_free(rc->frame_release.calib_samples);
     rc->frame_release.calib_samples = NULL;
-    if (rc->restream.fd >= 0) {
-        close(rc->restream.fd);
-        rc->restream.fd = -1;
-    }
     rc->restream.enabled = FALSE;
-    rc->restream.dest_valid = FALSE;
     g_mutex_unlock(&rc->lock);
+    restream_fanout_deinit(&rc->restream.fanout);
+    capture_recorder_deinit(&rc->recorder);
+    for (guint i = 0; i < rc->workers_count; i++) {
+        g_free(rc->workers[i].analytics.recs);
+        rc->workers[i].analytics.recs = NULL;
+    }
+    if (rc->analytics.wake_fd >= 0) close(rc->analytics.wake_fd);
+    rc->analytics.wake_fd = -1;
+    for (guint i = 0; i < rc->sources_max; i++) {
+        g_mutex_clear(&rc->sources[i].lock);
+    }
+    free(rc->sources);
+    rc->sources = NULL;
+    rc->sources_max = 0;
+    g_free(rc->index.entries);
+    rc->index.entries = NULL;
+    g_free(rc->direct.au);
+    rc->direct.au = NULL;
+    g_mutex_clear(&rc->direct.lock);
+    relay_hold_reset(&rc->hold);
+    g_free(rc->hold.slots);
+    rc->hold.slots = NULL;
+    g_mutex_clear(&rc->hold.lock);
+    g_cond_clear(&rc->workers_cond);
     g_mutex_clear(&rc->lock);
 }
 
 gboolean relay_controller_start(RelayController *rc) {
     g_return_val_if_fail(rc != NULL, FALSE);
-    if (rc->thread) return TRUE;
+    if (rc->workers[0].thread) return TRUE;
+    if (!restream_fanout_start(&rc->restream.fanout)) {
+        uv_log_warn("Restream: sender thread unavailable; restream will only queue");
+    }
+    capture_recorder_start(&rc->recorder);
+    /* A replay folds its analytics inline, in capture order, so that the
+     * result does not depend on thread scheduling. */
+    if (rc->analytics.wake_fd >= 0 && rc->backend != UV_RELAY_BACKEND_REPLAY) {
+        g_atomic_int_set(&rc->analytics.running, 1);
+        rc->analytics.thread = g_thread_new("uv-analytics", relay_analytics_run, rc);
+    }
+    if (!rc->analytics.thread && rc->backend != UV_RELAY_BACKEND_REPLAY) {
+        uv_log_warn("Relay: analytics thread unavailable; workers fold their own stats");
+    }
     rc->running = 1;
-    rc->thread = g_thread_new("uv-relay", relay_thread_run, rc);
-    if (!rc->thread) {
-        rc->running = 0;
+    for (guint i = 0; i < rc->workers_count; i++) {
+        UvRelayWorker *w = &rc->workers[i];
+        char name[16];
+        g_snprintf(name, sizeof(name), i == 0 ? "uv-relay" : "uv-relay-%u", i);
+        GThreadFunc run = relay_thread_run;
+        if (rc->backend == UV_RELAY_BACKEND_PACKET_RING) run = relay_ring_thread_run;
+        if (rc->backend == UV_RELAY_BACKEND_IO_URING) run = relay_uring_thread_run;
+        if (rc->backend == UV_RELAY_BACKEND_REPLAY) run = relay_replay_thread_run;
+        g_mutex_lock(&rc->lock);
+        w->started = 0;
+        g_mutex_unlock(&rc->lock);
+        w->thread = g_thread_new(name, run, w);
+        if (!w->thread) {
+            relay_controller_stop(rc);
+            return FALSE;
+        }
+    }
+
+    /* Wait for every worker to report its socket. None up is a failed
+     * start; some down leaves their share of a reuseport group unheard. */
+    guint up = 0, failed = 0, pending = 0;
+    gint64 deadline = g_get_monotonic_time() + UV_RELAY_START_WAIT_US;
+    g_mutex_lock(&rc->lock);
+    for (;;) {
+        up = failed = pending = 0;
+        for (guint i = 0; i < rc->workers_count; i++) {
+            if (rc->workers[i].started > 0) up++;
+            else if (rc->workers[i].started < 0) failed++;
+            else pending++;
+        }
+        if (pending == 0 || !g_cond_wait_until(&rc->workers_cond, &rc->lock, deadline)) break;
+    }
+    g_mutex_unlock(&rc->lock);
+    if (up == 0 && pending == 0) {
+        uv_log_error("Relay: no receive worker could start");
+        relay_controller_stop(rc);
         return FALSE;
     }
+    if (failed > 0) {
+        uv_log_warn("Relay: %u of %u workers failed to start; %u receiving",
+                    failed, rc->workers_count, up);
+    }
+    if (pending > 0) {
+        uv_log_warn("Relay: %u of %u workers not receiving yet", pending, rc->workers_count);
+    }
     return TRUE;
 }
 
 void relay_controller_stop(RelayController *rc) {
     if (!rc) return;
     rc->running = 0;
-    if (rc->thread) {
-        g_thread_join(rc->thread);
-        rc->thread = NULL;
+    for (guint i = 0; i < rc->workers_count; i++) {
+        if (rc->workers[i].thread) {
+            g_thread_join(rc->workers[i].thread);
+            rc->workers[i].thread = NULL;
+        }
     }
+    if (rc->analytics.thread) {
+        g_atomic_int_set(&rc->analytics.running, 0);
+        uint64_t one = 1;
+        ssize_t r = write(rc->analytics.wake_fd, &one, sizeof(one));
+        (void)r;
+        g_thread_join(rc->analytics.thread);
+        rc->analytics.thread = NULL;
+    }
+    restream_fanout_stop(&rc->restream.fanout);
 }
 
 gboolean relay_controller_select(RelayController *rc, int index, GError **error) {
     g_return_val_if_fail(rc != NULL, FALSE);
     gboolean valid = FALSE;
-    UvRelaySource snapshot = {0};
+    UvSourceStats snapshot = {0};
     g_mutex_lock(&rc->lock);
     if (index >= 0 && (guint)index < rc->sources_count && rc->sources[index].in_use) {
-        rc->selected_index = index;
+        gboolean changed = rc->selected_index != index;
+        g_atomic_int_set(&rc->selected_index, index);
         UvRelaySource *selected_src = &rc->sources[index];
-        snapshot = *selected_src;
+        g_mutex_lock(&selected_src->lock);
+        uv_internal_populate_source_stats(selected_src, rc->viewer->config.clock_rate,
+                                          relay_now_us(rc), &snapshot);
         if (rc->frame_block.enabled) {
-            if (!selected_src->frame_block) {
-                selected_src->frame_block = frame_block_state_new(rc->frame_block.width, rc->frame_block.height);
-                frame_block_state_apply_lateness_thresholds(selected_src->frame_block, rc->frame_block.thresholds_ms);
-                frame_block_state_apply_size_thresholds(selected_src->frame_block, rc->frame_block.thresholds_kb);
-            }
-            frame_block_state_reset(selected_src->frame_block);
+            UvRelayAnalysis an;
+            relay_analysis_load(rc, &an, NULL, 0);
+            frame_block_state_reset(frame_block_sync(selected_src, &an));
+        }
+        if (selected_src->cold) selected_src->cold->frame_block_accum_bytes = 0;
+        g_mutex_unlock(&selected_src->lock);
+        if (changed) {
+            relay_stream_restart(rc);
+            relay_gop_flush_locked(rc, selected_src);
         }
-        selected_src->frame_block_accum_bytes = 0;
         valid = TRUE;
     }
     g_mutex_unlock(&rc->lock);
@@ -1555,26 +4015,32 @@ gboolean relay_controller_select_next(RelayController *rc, GError **error) {
     g_return_val_if_fail(rc != NULL, FALSE);
     gboolean success = FALSE;
     int next_index = -1;
-    UvRelaySource snapshot = {0};
+    UvSourceStats snapshot = {0};
     g_mutex_lock(&rc->lock);
     if (rc->sources_count > 0) {
+        int prev_index = rc->selected_index;
         if (rc->selected_index < 0) {
-            rc->selected_index = 0;
+            g_atomic_int_set(&rc->selected_index, 0);
         } else {
-            rc->selected_index = (rc->selected_index + 1) % (int)rc->sources_count;
+            g_atomic_int_set(&rc->selected_index, (rc->selected_index + 1) % (int)rc->sources_count);
         }
         next_index = rc->selected_index;
+        gboolean changed = next_index != prev_index;
         UvRelaySource *selected_src = &rc->sources[next_index];
-        snapshot = *selected_src;
+        g_mutex_lock(&selected_src->lock);
+        uv_internal_populate_source_stats(selected_src, rc->viewer->config.clock_rate,
+                                          relay_now_us(rc), &snapshot);
         if (rc->frame_block.enabled) {
-            if (!selected_src->frame_block) {
-                selected_src->frame_block = frame_block_state_new(rc->frame_block.width, rc->frame_block.height);
-                frame_block_state_apply_lateness_thresholds(selected_src->frame_block, rc->frame_block.thresholds_ms);
-                frame_block_state_apply_size_thresholds(selected_src->frame_block, rc->frame_block.thresholds_kb);
-            }
-            frame_block_state_reset(selected_src->frame_block);
+            UvRelayAnalysis an;
+            relay_analysis_load(rc, &an, NULL, 0);
+            frame_block_state_reset(frame_block_sync(selected_src, &an));
+        }
+        if (selected_src->cold) selected_src->cold->frame_block_accum_bytes = 0;
+        g_mutex_unlock(&selected_src->lock);
+        if (changed) {
+            relay_stream_restart(rc);
+            relay_gop_flush_locked(rc, selected_src);
         }
-        selected_src->frame_block_accum_bytes = 0;
         success = TRUE;
     }
     g_mutex_unlock(&rc->lock);
@@ -1591,10 +4057,15 @@ int relay_controller_selected(const RelayController *rc) {
     return rc->selected_index;
 }
 
+/* Reader side of the published stats. Never blocks the relay or SHM thread
+ * on counters; callers are serialised by UvViewer.stats_lock because the
+ * bitrate baseline in each source is reader-owned. */
 void relay_controller_snapshot(RelayController *rc, UvViewerStats *stats, int clock_rate) {
     if (!rc || !stats) return;
     (void)clock_rate;
-    gint64 now_us = g_get_monotonic_time();
+    gint64 now_us = relay_now_us(rc);
+    UvRelayPub rc_pub;
+    UvSourcePub src_pub;
 
     GArray *fb_lateness = stats->frame_block.lateness_ms;
     GArray *fb_sizes = stats->frame_block.frame_size_kb;
@@ -1623,215 +4094,231 @@ void relay_controller_snapshot(RelayController *rc, UvViewerStats *stats, int cl
     if (fr_frames) g_array_set_size(fr_frames, 0);
     stats->frame_release_valid = FALSE;
 
-    g_mutex_lock(&rc->lock);
-    for (guint i = 0; i < rc->sources_count; i++) {
+    /* Controller-level counters and the analysis config, lock-free. */
+    guint retries = uv_seqlock_read(&rc->pub_seq, &rc_pub, &rc->pub, sizeof(rc_pub));
+    stats->ingest = rc_pub.ingest;
+    for (guint i = 0; i < rc_pub.ingest.workers; i++) {
+        UvRelayWorkerStats *ws = &stats->ingest.worker[i];
+        if (rc->worker_rate[i].published_us > 0 &&
+            rc_pub.published_us > rc->worker_rate[i].published_us &&
+            ws->datagrams >= rc->worker_rate[i].datagrams) {
+            double dt = (double)(rc_pub.published_us - rc->worker_rate[i].published_us) / 1e6;
+            ws->pps = (double)(ws->datagrams - rc->worker_rate[i].datagrams) / dt;
+        }
+        rc->worker_rate[i].datagrams = ws->datagrams;
+        rc->worker_rate[i].published_us = rc_pub.published_us;
+    }
+    UvFrameBlockStats *fb = &stats->frame_block;
+    fb->active = rc_pub.frame_block.active;
+    fb->paused = rc_pub.frame_block.paused;
+    fb->snapshot_mode = rc_pub.frame_block.snapshot_mode;
+    memcpy(fb->thresholds_lateness_ms, rc_pub.frame_block.thresholds_lateness_ms, sizeof(fb->thresholds_lateness_ms));
+    memcpy(fb->thresholds_size_kb, rc_pub.frame_block.thresholds_size_kb, sizeof(fb->thresholds_size_kb));
+    memcpy(fb->thresholds_span_ms, rc_pub.frame_block.thresholds_span_ms, sizeof(fb->thresholds_span_ms));
+    memcpy(fb->thresholds_chunks, rc_pub.frame_block.thresholds_chunks, sizeof(fb->thresholds_chunks));
+    memcpy(fb->thresholds_fpc, rc_pub.frame_block.thresholds_fpc, sizeof(fb->thresholds_fpc));
+    guint cfg_width = rc_pub.frame_block.width;
+    guint cfg_height = rc_pub.frame_block.height;
+    UvReleaseStats *fr = &stats->frame_release;
+    fr->active = rc_pub.frame_release.active;
+    fr->paused = rc_pub.frame_release.paused;
+    fr->gap_us = rc_pub.frame_release.gap_us;
+    fr->calib_active = rc_pub.frame_release.calib_active;
+    fr->calib_seq = rc_pub.frame_release.calib_seq;
+    fr->calib_gap_us = rc_pub.frame_release.calib_gap_us;
+    fr->calib_confident = rc_pub.frame_release.calib_confident;
+    gboolean analysis_on = fb->active || fr->active;
+
+    int selected_index = g_atomic_int_get(&rc->selected_index);
+    guint sources_count = g_atomic_int_get(&rc->sources_count);
+
+    /* Per-source pass: counters come from each source's published block.
+     * Only the selected source's grid/ring copy, and only while one of the
+     * analysis views is on, still takes that source's lock. */
+    for (guint i = 0; i < sources_count; i++) {
         UvRelaySource *src = &rc->sources[i];
-        if (!src->in_use) continue;
-        UvSourceStats s = {0};
-        uv_internal_populate_source_stats(src, clock_rate, now_us, &s);
-        s.selected = (rc->selected_index == (int)i);
-
-        if (src->prev_timestamp_us != 0 && now_us > src->prev_timestamp_us && src->rx_bytes >= src->prev_bytes) {
-            uint64_t dbytes = src->rx_bytes - src->prev_bytes;
-            double dt = (now_us - src->prev_timestamp_us) / 1e6;
-            if (dt > 0.0) s.inbound_bitrate_bps = (double)dbytes * 8.0 / dt;
+        retries += uv_seqlock_read(&src->pub_seq, &src_pub, &src->pub, sizeof(src_pub));
+        if (src_pub.published_us == 0) continue;
+        UvSourceStats s = src_pub.stats;
+        s.selected = (selected_index == (int)i);
+
+        /* Age-derived fields are relative to the reader's clock. The FPS
+         * window is a trailing second, so a source silent for longer than
+         * that no longer has a rate. */
+        if (src_pub.last_seen_us > 0) {
+            s.seconds_since_last_seen = (double)(now_us - src_pub.last_seen_us) / 1e6;
+            if (now_us - src_pub.last_seen_us > G_USEC_PER_SEC) s.rtp_marker_fps = 0.0;
         }
-        src->prev_bytes = src->rx_bytes;
-        src->prev_timestamp_us = now_us;
-
-        s.hevc_idr_count       = src->hevc_idr_count;
-        s.hevc_cra_count       = src->hevc_cra_count;
-        s.hevc_trail_count     = src->hevc_trail_count;
-        s.hevc_vps_count       = src->hevc_vps_count;
-        s.hevc_sps_count       = src->hevc_sps_count;
-        s.hevc_pps_count       = src->hevc_pps_count;
-        s.hevc_aud_count       = src->hevc_aud_count;
-        s.hevc_sei_count       = src->hevc_sei_count;
-        s.hevc_other_nal_count = src->hevc_other_nal_count;
-        if (src->kind != UV_SOURCE_SHM) {
-            s.rtp_ap_packets = src->rtp_ap_packets;
-            s.rtp_fu_packets = src->rtp_fu_packets;
-        }
-        if (src->last_keyframe_us > 0) {
-            s.seconds_since_keyframe = (double)(now_us - src->last_keyframe_us) / 1e6;
-        } else {
-            s.seconds_since_keyframe = -1.0;
+        if (src_pub.last_keyframe_us > 0) {
+            s.seconds_since_keyframe = (double)(now_us - src_pub.last_keyframe_us) / 1e6;
         }
-        if (src->last_keyframe_us > 0 && src->prev_keyframe_us > 0
-            && src->last_keyframe_us > src->prev_keyframe_us) {
-            s.last_keyframe_interval_seconds =
-                (double)(src->last_keyframe_us - src->prev_keyframe_us) / 1e6;
-        } else {
-            s.last_keyframe_interval_seconds = -1.0;
+
+        if (src->prev_timestamp_us != 0 && src_pub.published_us > src->prev_timestamp_us &&
+            s.rx_bytes >= src->prev_bytes) {
+            uint64_t dbytes = s.rx_bytes - src->prev_bytes;
+            double dt = (src_pub.published_us - src->prev_timestamp_us) / 1e6;
+            if (dt > 0.0) s.inbound_bitrate_bps = (double)dbytes * 8.0 / dt;
         }
+        src->prev_bytes = s.rx_bytes;
+        src->prev_timestamp_us = src_pub.published_us;
+        s.gop_cache_bytes = __atomic_load_n(&src->gop_bytes, __ATOMIC_RELAXED);
 
         g_array_append_val(stats->sources, s);
 
-        if (s.selected) {
-            stats->frame_block_valid = TRUE;
-            UvFrameBlockStats *fb = &stats->frame_block;
-            UvFrameBlockState *state = src->frame_block;
+        if (!s.selected) continue;
 
-            fb->active = rc->frame_block.enabled;
-            fb->paused = rc->frame_block.paused;
-            fb->snapshot_mode = rc->frame_block.snapshot_mode;
-            fb->snapshot_complete = state ? state->snapshot_complete : FALSE;
+        /* With both views off there is nothing to copy but the empty grid
+         * at the configured geometry; leave the source alone. */
+        if (analysis_on) g_mutex_lock(&src->lock);
+        const UvRelaySourceCold *an = analysis_on ? src->cold : NULL;
+        stats->frame_block_valid = TRUE;
+        UvFrameBlockState *state = an ? an->frame_block : NULL;
 
-            fb->width = state ? state->width : rc->frame_block.width;
-            fb->height = state ? state->height : rc->frame_block.height;
-            if (fb->width == 0) fb->width = UV_FRAME_BLOCK_DEFAULT_WIDTH;
-            if (fb->height == 0) fb->height = UV_FRAME_BLOCK_DEFAULT_HEIGHT;
-            guint capacity = fb->width * fb->height;
+        fb->snapshot_complete = state ? state->snapshot_complete : FALSE;
 
-            if (!fb->lateness_ms) {
-                fb->lateness_ms = g_array_new(FALSE, TRUE, sizeof(double));
-            }
-            if (!fb->frame_size_kb) {
-                fb->frame_size_kb = g_array_new(FALSE, TRUE, sizeof(double));
-            }
-            g_array_set_size(fb->lateness_ms, capacity);
-            g_array_set_size(fb->frame_size_kb, capacity);
+        fb->width = state ? state->width : cfg_width;
+        fb->height = state ? state->height : cfg_height;
+        if (fb->width == 0) fb->width = UV_FRAME_BLOCK_DEFAULT_WIDTH;
+        if (fb->height == 0) fb->height = UV_FRAME_BLOCK_DEFAULT_HEIGHT;
+        guint capacity = fb->width * fb->height;
 
-            if (state && state->lateness_ms && state->size_kb) {
-                for (guint k = 0; k < capacity && k < state->capacity; k++) {
-                    g_array_index(fb->lateness_ms, double, k) = state->lateness_ms[k];
-                    g_array_index(fb->frame_size_kb, double, k) = state->size_kb[k];
-                }
-                for (guint k = state->capacity; k < capacity; k++) {
-                    g_array_index(fb->lateness_ms, double, k) = NAN;
-                    g_array_index(fb->frame_size_kb, double, k) = NAN;
-                }
-            } else {
-                for (guint k = 0; k < capacity; k++) {
-                    g_array_index(fb->lateness_ms, double, k) = NAN;
-                    g_array_index(fb->frame_size_kb, double, k) = NAN;
-                }
-            }
+        if (!fb->lateness_ms) {
+            fb->lateness_ms = g_array_new(FALSE, TRUE, sizeof(double));
+        }
+        if (!fb->frame_size_kb) {
+            fb->frame_size_kb = g_array_new(FALSE, TRUE, sizeof(double));
+        }
+        g_array_set_size(fb->lateness_ms, capacity);
+        g_array_set_size(fb->frame_size_kb, capacity);
 
-            memcpy(fb->thresholds_lateness_ms, rc->frame_block.thresholds_ms, sizeof(fb->thresholds_lateness_ms));
-            memcpy(fb->thresholds_size_kb, rc->frame_block.thresholds_kb, sizeof(fb->thresholds_size_kb));
-
-            fb->real_frames = state ? state->real_samples : 0;
-            fb->missing_frames = state ? state->missing_frames : 0;
-
-            if (state) {
-                fb->filled = state->filled;
-                fb->next_index = MIN(state->cursor, state->capacity);
-                if (state->real_samples > 0) {
-                    fb->min_lateness_ms = state->min_lateness_ms;
-                    fb->max_lateness_ms = state->max_lateness_ms;
-                    fb->avg_lateness_ms = state->sum_lateness_ms / (double)state->real_samples;
-                    fb->min_size_kb = state->min_size_kb;
-                    fb->max_size_kb = state->max_size_kb;
-                    fb->avg_size_kb = state->sum_size_kb / (double)state->real_samples;
-                }
-            } else {
-                fb->filled = 0;
-                fb->next_index = 0;
+        if (state && state->lateness_ms && state->size_kb) {
+            for (guint k = 0; k < capacity && k < state->capacity; k++) {
+                g_array_index(fb->lateness_ms, double, k) = state->lateness_ms[k];
+                g_array_index(fb->frame_size_kb, double, k) = state->size_kb[k];
             }
-
-            if (state && state->real_samples > 0) {
-                for (guint c = 0; c < UV_FRAME_BLOCK_COLOR_BUCKETS; c++) {
-                    fb->color_counts_lateness[c] = state->color_counts_lateness[c];
-                    fb->color_counts_size[c] = state->color_counts_size[c];
-                }
-            } else {
-                fb->min_lateness_ms = 0.0;
-                fb->max_lateness_ms = 0.0;
-                fb->avg_lateness_ms = 0.0;
-                fb->min_size_kb = 0.0;
-                fb->max_size_kb = 0.0;
-                fb->avg_size_kb = 0.0;
-                memset(fb->color_counts_lateness, 0, sizeof(fb->color_counts_lateness));
-                memset(fb->color_counts_size, 0, sizeof(fb->color_counts_size));
+            for (guint k = state->capacity; k < capacity; k++) {
+                g_array_index(fb->lateness_ms, double, k) = NAN;
+                g_array_index(fb->frame_size_kb, double, k) = NAN;
             }
-
-            /* Part A: per-frame span (first-pkt -> marker) + chunks-per-frame.
-             * Same grid layout as lateness/size; summary computed here. */
-            if (!fb->span_ms) fb->span_ms = g_array_new(FALSE, TRUE, sizeof(double));
-            if (!fb->chunks_per_frame) fb->chunks_per_frame = g_array_new(FALSE, TRUE, sizeof(double));
-            if (!fb->frames_per_chunk) fb->frames_per_chunk = g_array_new(FALSE, TRUE, sizeof(double));
-            g_array_set_size(fb->span_ms, capacity);
-            g_array_set_size(fb->chunks_per_frame, capacity);
-            g_array_set_size(fb->frames_per_chunk, capacity);
+        } else {
             for (guint k = 0; k < capacity; k++) {
-                double sv = NAN, cv = NAN, fv = NAN;
-                if (state && state->span_ms && state->chunks_pf && state->fpc && k < state->capacity) {
-                    sv = state->span_ms[k];
-                    cv = state->chunks_pf[k];
-                    fv = state->fpc[k];
-                }
-                g_array_index(fb->span_ms, double, k) = sv;
-                g_array_index(fb->chunks_per_frame, double, k) = cv;
-                g_array_index(fb->frames_per_chunk, double, k) = fv;
+                g_array_index(fb->lateness_ms, double, k) = NAN;
+                g_array_index(fb->frame_size_kb, double, k) = NAN;
             }
-            memcpy(fb->thresholds_span_ms, rc->frame_block.thresholds_span, sizeof(fb->thresholds_span_ms));
-            memcpy(fb->thresholds_chunks, rc->frame_block.thresholds_chunks, sizeof(fb->thresholds_chunks));
-            memcpy(fb->thresholds_fpc, rc->frame_block.thresholds_fpc, sizeof(fb->thresholds_fpc));
-            frame_block_summarize_metric(fb->span_ms, capacity, fb->thresholds_span_ms,
-                                         &fb->min_span_ms, &fb->max_span_ms, &fb->avg_span_ms,
-                                         fb->color_counts_span);
-            frame_block_summarize_metric(fb->chunks_per_frame, capacity, fb->thresholds_chunks,
-                                         &fb->min_chunks, &fb->max_chunks, &fb->avg_chunks,
-                                         fb->color_counts_chunks);
-            frame_block_summarize_metric(fb->frames_per_chunk, capacity, fb->thresholds_fpc,
-                                         &fb->min_fpc, &fb->max_fpc, &fb->avg_fpc,
-                                         fb->color_counts_fpc);
-
-            /* Part B: frame-release (FEC chunk) ring snapshot. */
-            stats->frame_release_valid = TRUE;
-            UvReleaseStats *fr = &stats->frame_release;
-            fr->active = rc->frame_release.enabled;
-            fr->paused = rc->frame_release.paused;
-            fr->gap_us = rc->frame_release.gap_us > 0.0 ? rc->frame_release.gap_us
-                                                        : UV_RELEASE_DEFAULT_GAP_US;
-            fr->frame_period_ms = src->frame_period_ms;
-            fr->total_chunks = src->release_total;
-            fr->overlap_chunks = src->release_overlap;
-            fr->overlap_rate = src->release_total > 0
-                ? (double)src->release_overlap / (double)src->release_total : 0.0;
-            fr->calib_active = rc->frame_release.calib_active;
-            fr->calib_seq = rc->frame_release.calib_seq;
-            fr->calib_gap_us = rc->frame_release.calib_gap_us;
-            fr->calib_confident = rc->frame_release.calib_confident;
-            if (!fr->chunks) fr->chunks = g_array_new(FALSE, TRUE, sizeof(UvReleaseChunk));
-            g_array_set_size(fr->chunks, 0);
-            guint rc_count = src->release_ring ? src->release_count : 0;
-            guint rc_start = (src->release_head + UV_RELEASE_CHUNK_RING - rc_count) % UV_RELEASE_CHUNK_RING;
-            guint64 sum_pkts = 0, sum_frames = 0;
-            for (guint i = 0; i < rc_count; i++) {
-                UvReleaseChunk c = src->release_ring[(rc_start + i) % UV_RELEASE_CHUNK_RING];
-                g_array_append_val(fr->chunks, c);
-                sum_pkts += c.pkts;
-                sum_frames += c.frames;
-                guint bucket = (c.frames >= UV_RELEASE_FRAMES_BUCKETS)
-                    ? (UV_RELEASE_FRAMES_BUCKETS - 1u)
-                    : (c.frames > 0u ? c.frames - 1u : 0u);
-                fr->hist_frames[bucket]++;
+        }
+
+        fb->real_frames = state ? state->real_samples : 0;
+        fb->missing_frames = state ? state->missing_frames : 0;
+
+        if (state) {
+            fb->filled = state->filled;
+            fb->next_index = MIN(state->cursor, state->capacity);
+            if (state->real_samples > 0) {
+                fb->min_lateness_ms = state->min_lateness_ms;
+                fb->max_lateness_ms = state->max_lateness_ms;
+                fb->avg_lateness_ms = state->sum_lateness_ms / (double)state->real_samples;
+                fb->min_size_kb = state->min_size_kb;
+                fb->max_size_kb = state->max_size_kb;
+                fb->avg_size_kb = state->sum_size_kb / (double)state->real_samples;
             }
-            if (rc_count > 0) {
-                fr->avg_pkts_per_chunk = (double)sum_pkts / (double)rc_count;
-                fr->avg_frames_per_chunk = (double)sum_frames / (double)rc_count;
+        } else {
+            fb->filled = 0;
+            fb->next_index = 0;
+        }
+
+        if (state && state->real_samples > 0) {
+            for (guint c = 0; c < UV_FRAME_BLOCK_COLOR_BUCKETS; c++) {
+                fb->color_counts_lateness[c] = state->color_counts_lateness[c];
+                fb->color_counts_size[c] = state->color_counts_size[c];
             }
+        } else {
+            fb->min_lateness_ms = 0.0;
+            fb->max_lateness_ms = 0.0;
+            fb->avg_lateness_ms = 0.0;
+            fb->min_size_kb = 0.0;
+            fb->max_size_kb = 0.0;
+            fb->avg_size_kb = 0.0;
+            memset(fb->color_counts_lateness, 0, sizeof(fb->color_counts_lateness));
+            memset(fb->color_counts_size, 0, sizeof(fb->color_counts_size));
+        }
 
-            /* Per-frame ring → cadence timeline. */
-            if (!fr->frames) fr->frames = g_array_new(FALSE, TRUE, sizeof(UvReleaseFrame));
-            g_array_set_size(fr->frames, 0);
-            guint fr_count = src->frame_ring ? src->frame_ring_count : 0;
-            guint fr_start = (src->frame_ring_head + UV_RELEASE_FRAME_RING - fr_count) % UV_RELEASE_FRAME_RING;
-            for (guint i = 0; i < fr_count; i++) {
-                UvReleaseFrame f = src->frame_ring[(fr_start + i) % UV_RELEASE_FRAME_RING];
-                g_array_append_val(fr->frames, f);
+        /* Part A: per-frame span (first-pkt -> marker) + chunks-per-frame.
+         * Same grid layout as lateness/size; summary computed here. */
+        if (!fb->span_ms) fb->span_ms = g_array_new(FALSE, TRUE, sizeof(double));
+        if (!fb->chunks_per_frame) fb->chunks_per_frame = g_array_new(FALSE, TRUE, sizeof(double));
+        if (!fb->frames_per_chunk) fb->frames_per_chunk = g_array_new(FALSE, TRUE, sizeof(double));
+        g_array_set_size(fb->span_ms, capacity);
+        g_array_set_size(fb->chunks_per_frame, capacity);
+        g_array_set_size(fb->frames_per_chunk, capacity);
+        for (guint k = 0; k < capacity; k++) {
+            double sv = NAN, cv = NAN, fv = NAN;
+            if (state && state->span_ms && state->chunks_pf && state->fpc && k < state->capacity) {
+                sv = state->span_ms[k];
+                cv = state->chunks_pf[k];
+                fv = state->fpc[k];
             }
+            g_array_index(fb->span_ms, double, k) = sv;
+            g_array_index(fb->chunks_per_frame, double, k) = cv;
+            g_array_index(fb->frames_per_chunk, double, k) = fv;
+        }
+        frame_block_summarize_metric(fb->span_ms, capacity, fb->thresholds_span_ms,
+                                     &fb->min_span_ms, &fb->max_span_ms, &fb->avg_span_ms,
+                                     fb->color_counts_span);
+        frame_block_summarize_metric(fb->chunks_per_frame, capacity, fb->thresholds_chunks,
+                                     &fb->min_chunks, &fb->max_chunks, &fb->avg_chunks,
+                                     fb->color_counts_chunks);
+        frame_block_summarize_metric(fb->frames_per_chunk, capacity, fb->thresholds_fpc,
+                                     &fb->min_fpc, &fb->max_fpc, &fb->avg_fpc,
+                                     fb->color_counts_fpc);
+
+        /* Part B: frame-release (FEC chunk) ring snapshot. */
+        stats->frame_release_valid = TRUE;
+        if (an) {
+            fr->frame_period_ms = an->frame_period_ms;
+            fr->total_chunks = an->release_total;
+            fr->overlap_chunks = an->release_overlap;
+            fr->overlap_rate = an->release_total > 0
+                ? (double)an->release_overlap / (double)an->release_total : 0.0;
         }
+        if (!fr->chunks) fr->chunks = g_array_new(FALSE, TRUE, sizeof(UvReleaseChunk));
+        g_array_set_size(fr->chunks, 0);
+        guint rc_count = (an && an->release_ring) ? an->release_count : 0;
+        guint rc_start = an ? (an->release_head + UV_RELEASE_CHUNK_RING - rc_count) % UV_RELEASE_CHUNK_RING : 0;
+        guint64 sum_pkts = 0, sum_frames = 0;
+        for (guint i = 0; i < rc_count; i++) {
+            UvReleaseChunk c = an->release_ring[(rc_start + i) % UV_RELEASE_CHUNK_RING];
+            g_array_append_val(fr->chunks, c);
+            sum_pkts += c.pkts;
+            sum_frames += c.frames;
+            guint bucket = (c.frames >= UV_RELEASE_FRAMES_BUCKETS)
+                ? (UV_RELEASE_FRAMES_BUCKETS - 1u)
+                : (c.frames > 0u ? c.frames - 1u : 0u);
+            fr->hist_frames[bucket]++;
+        }
+        if (rc_count > 0) {
+            fr->avg_pkts_per_chunk = (double)sum_pkts / (double)rc_count;
+            fr->avg_frames_per_chunk = (double)sum_frames / (double)rc_count;
+        }
+
+        /* Per-frame ring → cadence timeline. */
+        if (!fr->frames) fr->frames = g_array_new(FALSE, TRUE, sizeof(UvReleaseFrame));
+        g_array_set_size(fr->frames, 0);
+        guint fr_count = (an && an->frame_ring) ? an->frame_ring_count : 0;
+        guint fr_start = an ? (an->frame_ring_head + UV_RELEASE_FRAME_RING - fr_count) % UV_RELEASE_FRAME_RING : 0;
+        for (guint i = 0; i < fr_count; i++) {
+            UvReleaseFrame f = an->frame_ring[(fr_start + i) % UV_RELEASE_FRAME_RING];
+            g_array_append_val(fr->frames, f);
+        }
+        if (analysis_on) g_mutex_unlock(&src->lock);
     }
-    g_mutex_unlock(&rc->lock);
+    stats->snapshot.last_retries += retries;
 }
 
 void relay_controller_set_appsrc(RelayController *rc, GstAppSrc *appsrc) {
     if (!rc) return;
     g_mutex_lock(&rc->lock);
     rc->appsrc = appsrc;
+    relay_stream_restart(rc);
     g_mutex_unlock(&rc->lock);
 }
 
@@ -1850,54 +4337,47 @@ void relay_controller_set_push_enabled(RelayController *rc, gboolean enabled) {
 }
 
 void relay_controller_set_restream(RelayController *rc, gboolean enabled,
-                                   const char *address, guint16 port) {
+                                   const UvRestreamTarget *targets, guint count) {
     if (!rc) return;
 
-    /* Resolve the destination outside the lock so a bad address never wedges
-     * the relay thread. */
-    gboolean want = enabled && address && address[0] && port > 0;
-    struct in_addr resolved = {0};
-    if (want && inet_pton(AF_INET, address, &resolved) != 1) {
-        uv_log_warn("Restream: invalid destination address '%s'", address);
-        want = FALSE;
+    /* Resolve the destinations outside the lock so a bad address never
+     * wedges the relay thread. */
+    UvRestreamTarget valid[UV_RESTREAM_TARGETS_MAX];
+    struct sockaddr_in dests[UV_RESTREAM_TARGETS_MAX];
+    guint n = 0;
+    for (guint i = 0; enabled && targets && i < count && n < UV_RESTREAM_TARGETS_MAX; i++) {
+        struct in_addr resolved = {0};
+        if (!targets[i].address[0] || targets[i].port == 0) continue;
+        if (inet_pton(AF_INET, targets[i].address, &resolved) != 1) {
+            uv_log_warn("Restream: invalid destination address '%s'", targets[i].address);
+            continue;
+        }
+        valid[n] = targets[i];
+        memset(&dests[n], 0, sizeof(dests[n]));
+        dests[n].sin_family = AF_INET;
+        dests[n].sin_port = htons(targets[i].port);
+        dests[n].sin_addr = resolved;
+        n++;
     }
+    gboolean want = enabled && n > 0;
 
     g_mutex_lock(&rc->lock);
 
-    /* Any change to enable/target closes the current socket; a fresh one is
-     * opened below so tx counters restart cleanly per session. */
-    if (rc->restream.fd >= 0) {
-        close(rc->restream.fd);
-        rc->restream.fd = -1;
-    }
-    rc->restream.dest_valid = FALSE;
-    rc->restream.enabled = want;
-    rc->restream.tx_packets = 0;
-    rc->restream.tx_bytes = 0;
-    rc->restream.tx_errors = 0;
-
-    if (want) {
-        int fd = socket(AF_INET, SOCK_DGRAM, 0);
-        if (fd < 0) {
-            uv_log_warn("Restream: socket() failed: %s", g_strerror(errno));
-            rc->restream.enabled = FALSE;
-        } else {
-            int flags = fcntl(fd, F_GETFL, 0);
-            if (flags >= 0) fcntl(fd, F_SETFL, flags | O_NONBLOCK);
-            memset(&rc->restream.dest, 0, sizeof(rc->restream.dest));
-            rc->restream.dest.sin_family = AF_INET;
-            rc->restream.dest.sin_port = htons(port);
-            rc->restream.dest.sin_addr = resolved;
-            g_strlcpy(rc->restream.dest_addr, address, sizeof(rc->restream.dest_addr));
-            rc->restream.dest_port = port;
-            rc->restream.fd = fd;
-            rc->restream.dest_valid = TRUE;
-            uv_log_info("Restream: forwarding selected source to %s:%u", address, port);
+    /* Any change to enable/targets replaces every destination, so queues
+     * and tx counters restart cleanly per session. */
+    guint opened = restream_fanout_set_targets(&rc->restream.fanout, valid, dests, want ? n : 0);
+    rc->restream.enabled = want && opened > 0;
+    if (rc->restream.enabled) {
+        for (guint i = 0; i < rc->restream.fanout.count; i++) {
+            uv_log_info("Restream: forwarding selected source to %s:%u",
+                        rc->restream.fanout.targets[i].address,
+                        rc->restream.fanout.targets[i].port);
         }
     } else {
         uv_log_info("Restream: disabled");
     }
 
+    relay_publish_locked(rc, relay_now_us(rc));
     g_mutex_unlock(&rc->lock);
 }
 
@@ -1905,15 +4385,47 @@ void relay_controller_restream_snapshot(RelayController *rc, UvRestreamStats *ou
     if (!out) return;
     memset(out, 0, sizeof(*out));
     if (!rc) return;
+    UvRelayPub pub;
+    uv_seqlock_read(&rc->pub_seq, &pub, &rc->pub, sizeof(pub));
+    out->enabled = pub.restream.enabled;
+    restream_fanout_snapshot(&rc->restream.fanout, out);
+    if (out->target_count > 0) {
+        out->active = out->enabled && out->targets[0].active;
+        g_strlcpy(out->address, out->targets[0].address, sizeof(out->address));
+        out->port = out->targets[0].port;
+    }
+}
+
+/* Per-source grid maintenance for the setters below. The config change is
+ * made under rc->lock first; the grids are then visited one source lock at a
+ * time with the controller lock dropped, so a full-grid reset or reclassify
+ * only ever holds up ingest for the source it is working on. */
+typedef enum {
+    FRAME_BLOCK_OP_RESET,
+    FRAME_BLOCK_OP_SYNC,
+} FrameBlockOp;
+
+static void frame_block_for_each_source(RelayController *rc, FrameBlockOp op) {
+    UvRelayAnalysis an;
     g_mutex_lock(&rc->lock);
-    out->enabled = rc->restream.enabled;
-    out->active = rc->restream.enabled && rc->restream.dest_valid && rc->restream.fd >= 0;
-    g_strlcpy(out->address, rc->restream.dest_addr, sizeof(out->address));
-    out->port = rc->restream.dest_port;
-    out->tx_packets = rc->restream.tx_packets;
-    out->tx_bytes = rc->restream.tx_bytes;
-    out->tx_errors = rc->restream.tx_errors;
+    relay_analysis_load(rc, &an, NULL, 0);
+    guint count = rc->sources_count;
     g_mutex_unlock(&rc->lock);
+
+    for (guint i = 0; i < count; i++) {
+        UvRelaySource *src = &rc->sources[i];
+        g_mutex_lock(&src->lock);
+        UvRelaySourceCold *cold = src->cold;
+        if (!cold) {
+            /* Nothing analysed yet; the grid is created on first use. */
+        } else if (op == FRAME_BLOCK_OP_RESET) {
+            if (cold->frame_block) frame_block_state_reset(cold->frame_block);
+            cold->frame_block_accum_bytes = 0;
+        } else if (cold->frame_block) {
+            frame_block_sync(src, &an);
+        }
+        g_mutex_unlock(&src->lock);
+    }
 }
 
 void relay_controller_frame_block_configure(RelayController *rc, gboolean enabled, gboolean snapshot_mode) {
@@ -1924,16 +4436,9 @@ void relay_controller_frame_block_configure(RelayController *rc, gboolean enable
     if (!enabled) {
         rc->frame_block.paused = FALSE;
     }
-    rc->frame_block.reset_requested = TRUE;
-    for (guint i = 0; i < rc->sources_count; i++) {
-        UvRelaySource *src = &rc->sources[i];
-        if (src->frame_block) {
-            frame_block_state_reset(src->frame_block);
-        }
-        src->frame_block_accum_bytes = 0;
-    }
-    rc->frame_block.reset_requested = FALSE;
+    relay_publish_locked(rc, relay_now_us(rc));
     g_mutex_unlock(&rc->lock);
+    frame_block_for_each_source(rc, FRAME_BLOCK_OP_RESET);
 }
 
 void relay_controller_frame_block_set_width(RelayController *rc, guint width) {
@@ -1947,41 +4452,23 @@ void relay_controller_frame_block_set_width(RelayController *rc, guint width) {
     }
 
     rc->frame_block.width = clamped;
-    guint height = rc->frame_block.height ? rc->frame_block.height : UV_FRAME_BLOCK_DEFAULT_HEIGHT;
-
-    for (guint i = 0; i < rc->sources_count; i++) {
-        UvRelaySource *src = &rc->sources[i];
-        if (!src->frame_block) continue;
-        UvFrameBlockState *old_state = src->frame_block;
-        src->frame_block = frame_block_state_new(rc->frame_block.width, height);
-        frame_block_state_apply_lateness_thresholds(src->frame_block, rc->frame_block.thresholds_ms);
-        frame_block_state_apply_size_thresholds(src->frame_block, rc->frame_block.thresholds_kb);
-        frame_block_state_free(old_state);
-    }
-
+    rc->frame_block.generation++;
+    relay_publish_locked(rc, relay_now_us(rc));
     g_mutex_unlock(&rc->lock);
+    frame_block_for_each_source(rc, FRAME_BLOCK_OP_SYNC);
 }
 
 void relay_controller_frame_block_pause(RelayController *rc, gboolean paused) {
     if (!rc) return;
     g_mutex_lock(&rc->lock);
     rc->frame_block.paused = paused;
+    relay_publish_locked(rc, relay_now_us(rc));
     g_mutex_unlock(&rc->lock);
 }
 
 void relay_controller_frame_block_reset(RelayController *rc) {
     if (!rc) return;
-    g_mutex_lock(&rc->lock);
-    rc->frame_block.reset_requested = TRUE;
-    for (guint i = 0; i < rc->sources_count; i++) {
-        UvRelaySource *src = &rc->sources[i];
-        if (src->frame_block) {
-            frame_block_state_reset(src->frame_block);
-        }
-        src->frame_block_accum_bytes = 0;
-    }
-    rc->frame_block.reset_requested = FALSE;
-    g_mutex_unlock(&rc->lock);
+    frame_block_for_each_source(rc, FRAME_BLOCK_OP_RESET);
 }
 
 void relay_controller_frame_block_set_thresholds(RelayController *rc,
@@ -2013,15 +4500,10 @@ void relay_controller_frame_block_set_thresholds(RelayController *rc,
     rc->frame_block.thresholds_ms[0] = green_ms;
     rc->frame_block.thresholds_ms[1] = yellow_ms;
     rc->frame_block.thresholds_ms[2] = orange_ms;
-    rc->frame_block.thresholds_dirty_ms = TRUE;
-    for (guint i = 0; i < rc->sources_count; i++) {
-        UvRelaySource *src = &rc->sources[i];
-        if (src->frame_block) {
-            frame_block_state_apply_lateness_thresholds(src->frame_block, rc->frame_block.thresholds_ms);
-        }
-    }
-    rc->frame_block.thresholds_dirty_ms = FALSE;
+    rc->frame_block.generation++;
+    relay_publish_locked(rc, relay_now_us(rc));
     g_mutex_unlock(&rc->lock);
+    frame_block_for_each_source(rc, FRAME_BLOCK_OP_SYNC);
 }
 
 void relay_controller_frame_block_set_size_thresholds(RelayController *rc,
@@ -2053,15 +4535,10 @@ void relay_controller_frame_block_set_size_thresholds(RelayController *rc,
     rc->frame_block.thresholds_kb[0] = green_kb;
     rc->frame_block.thresholds_kb[1] = yellow_kb;
     rc->frame_block.thresholds_kb[2] = orange_kb;
-    rc->frame_block.thresholds_dirty_kb = TRUE;
-    for (guint i = 0; i < rc->sources_count; i++) {
-        UvRelaySource *src = &rc->sources[i];
-        if (src->frame_block) {
-            frame_block_state_apply_size_thresholds(src->frame_block, rc->frame_block.thresholds_kb);
-        }
-    }
-    rc->frame_block.thresholds_dirty_kb = FALSE;
+    rc->frame_block.generation++;
+    relay_publish_locked(rc, relay_now_us(rc));
     g_mutex_unlock(&rc->lock);
+    frame_block_for_each_source(rc, FRAME_BLOCK_OP_SYNC);
 }
 
 /* Sort three threshold values ascending in place. */
@@ -2084,6 +4561,7 @@ void relay_controller_frame_block_set_span_thresholds(RelayController *rc,
     rc->frame_block.thresholds_span[0] = green_ms;
     rc->frame_block.thresholds_span[1] = yellow_ms;
     rc->frame_block.thresholds_span[2] = orange_ms;
+    relay_publish_locked(rc, relay_now_us(rc));
     g_mutex_unlock(&rc->lock);
 }
 
@@ -2100,6 +4578,7 @@ void relay_controller_frame_block_set_chunk_thresholds(RelayController *rc,
     rc->frame_block.thresholds_chunks[0] = green;
     rc->frame_block.thresholds_chunks[1] = yellow;
     rc->frame_block.thresholds_chunks[2] = orange;
+    relay_publish_locked(rc, relay_now_us(rc));
     g_mutex_unlock(&rc->lock);
 }
 
@@ -2116,29 +4595,43 @@ void relay_controller_frame_block_set_overlap_thresholds(RelayController *rc,
     rc->frame_block.thresholds_fpc[0] = green;
     rc->frame_block.thresholds_fpc[1] = yellow;
     rc->frame_block.thresholds_fpc[2] = orange;
+    relay_publish_locked(rc, relay_now_us(rc));
     g_mutex_unlock(&rc->lock);
 }
 
+/* Clear every source's burst/cadence state, one source lock at a time. */
+static void frame_release_clear_sources(RelayController *rc) {
+    g_mutex_lock(&rc->lock);
+    guint count = rc->sources_count;
+    g_mutex_unlock(&rc->lock);
+    for (guint i = 0; i < count; i++) {
+        UvRelaySource *src = &rc->sources[i];
+        g_mutex_lock(&src->lock);
+        if (src->cold) release_state_clear(src->cold);
+        g_mutex_unlock(&src->lock);
+    }
+}
+
 void relay_controller_frame_release_configure(RelayController *rc, gboolean enabled) {
     if (!rc) return;
     g_mutex_lock(&rc->lock);
     rc->frame_release.enabled = enabled;
-    rc->frame_release.reset_requested = TRUE;
+    relay_publish_locked(rc, relay_now_us(rc));
     g_mutex_unlock(&rc->lock);
+    frame_release_clear_sources(rc);
 }
 
 void relay_controller_frame_release_pause(RelayController *rc, gboolean paused) {
     if (!rc) return;
     g_mutex_lock(&rc->lock);
     rc->frame_release.paused = paused;
+    relay_publish_locked(rc, relay_now_us(rc));
     g_mutex_unlock(&rc->lock);
 }
 
 void relay_controller_frame_release_reset(RelayController *rc) {
     if (!rc) return;
-    g_mutex_lock(&rc->lock);
-    rc->frame_release.reset_requested = TRUE;
-    g_mutex_unlock(&rc->lock);
+    frame_release_clear_sources(rc);
 }
 
 void relay_controller_frame_release_set_gap_us(RelayController *rc, double gap_us) {
@@ -2146,6 +4639,7 @@ void relay_controller_frame_release_set_gap_us(RelayController *rc, double gap_u
     if (gap_us < 1.0) gap_us = 1.0;
     g_mutex_lock(&rc->lock);
     rc->frame_release.gap_us = gap_us;
+    relay_publish_locked(rc, relay_now_us(rc));
     g_mutex_unlock(&rc->lock);
 }
 
@@ -2154,5 +4648,6 @@ void relay_controller_frame_release_calibrate(RelayController *rc) {
     g_mutex_lock(&rc->lock);
     rc->frame_release.calib_active = TRUE;
     rc->frame_release.calib_count = 0;
+    relay_publish_locked(rc, relay_now_us(rc));
     g_mutex_unlock(&rc->lock);
 }
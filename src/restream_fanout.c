@@ -0,0 +1,350 @@
+#define _GNU_SOURCE
+#include "uv_internal.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Restream fan-out: ingest copies each restreamed datagram into every
+ * destination's bounded queue (restream_fanout_push) and a dedicated
+ * thread drains the queues with sendmmsg(). Sends are non-blocking; a
+ * destination whose socket buffer is full keeps its backlog, is polled for
+ * POLLOUT and drops new datagrams once its queue fills, while the other
+ * destinations and ingest carry on. Optionally each destination is paced
+ * (see RestreamFanout). */
+
+/* Idle wakeup so a missed kick or a blocked socket never stalls a queue. */
+#define UV_RESTREAM_IDLE_MS 100
+
+/* Single-writer counters, read concurrently by restream_fanout_snapshot(). */
+static inline void fanout_count(uint64_t *c, uint64_t v) {
+    __atomic_store_n(c, *c + v, __ATOMIC_RELAXED);
+}
+
+static inline uint64_t fanout_read(const uint64_t *c) {
+    return __atomic_load_n(c, __ATOMIC_RELAXED);
+}
+
+static inline uint64_t fanout_clock_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void restream_target_close(RestreamTarget *t) {
+    if (t->fd >= 0) close(t->fd);
+    g_free(t->slots);
+    g_free(t->lens);
+    g_free(t->queued_us);
+    memset(t, 0, sizeof(*t));
+    t->fd = -1;
+}
+
+void restream_fanout_init(RestreamFanout *f, guint depth, double pace_spread, int video_pt) {
+    memset(f, 0, sizeof(*f));
+    g_mutex_init(&f->lock);
+    for (guint i = 0; i < UV_RESTREAM_TARGETS_MAX; i++) f->targets[i].fd = -1;
+    if (depth == 0) depth = UV_RESTREAM_QUEUE_DEFAULT;
+    depth = MIN(depth, UV_RESTREAM_QUEUE_MAX);
+    f->depth = 16;
+    while (f->depth < depth) f->depth <<= 1;
+    f->pace_spread = pace_spread > 0.0 ? MIN(pace_spread, 1.0) : 0.0;
+    f->video_pt = video_pt;
+    f->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (f->wake_fd < 0) uv_log_warn("Restream: eventfd() failed: %s", g_strerror(errno));
+}
+
+void restream_fanout_deinit(RestreamFanout *f) {
+    restream_fanout_stop(f);
+    for (guint i = 0; i < f->count; i++) restream_target_close(&f->targets[i]);
+    f->count = 0;
+    if (f->wake_fd >= 0) close(f->wake_fd);
+    f->wake_fd = -1;
+    g_mutex_clear(&f->lock);
+}
+
+/* Replace the destination list; the caller holds RelayController.lock so
+ * no datagram is being queued. dests are the resolved targets. Queues and
+ * counters start empty. Returns how many destinations were opened. */
+guint restream_fanout_set_targets(RestreamFanout *f, const UvRestreamTarget *targets,
+                                  const struct sockaddr_in *dests, guint count) {
+    g_mutex_lock(&f->lock);
+    for (guint i = 0; i < f->count; i++) restream_target_close(&f->targets[i]);
+    f->count = 0;
+    for (guint i = 0; i < count && f->count < UV_RESTREAM_TARGETS_MAX; i++) {
+        int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            uv_log_warn("Restream: socket() failed: %s", g_strerror(errno));
+            continue;
+        }
+        RestreamTarget *t = &f->targets[f->count++];
+        t->fd = fd;
+        t->dest = dests[i];
+        g_strlcpy(t->address, targets[i].address, sizeof(t->address));
+        t->port = targets[i].port;
+        t->slots = g_malloc((gsize)f->depth * UV_RESTREAM_SLOT_SIZE);
+        t->lens = g_new0(guint16, f->depth);
+        t->queued_us = g_new0(gint64, f->depth);
+    }
+    g_mutex_unlock(&f->lock);
+    return f->count;
+}
+
+/* Queue one datagram for every destination. Called by ingest under
+ * RelayController.lock; never blocks. The enqueue is stamped on the
+ * fan-out thread's clock (monotonic, also under replay) so the queue
+ * delay compares like with like. */
+void restream_fanout_push(RestreamFanout *f, const unsigned char *pkt, size_t len) {
+    if (f->pace_spread > 0.0 && len >= 12 && (pkt[0] >> 6) == 2 &&
+        (pkt[1] & 0x7F) == f->video_pt) {
+        /* Frame size for the pacer: video bytes up to and including an
+         * RTP packet with the marker bit, averaged over frames (1/8).
+         * Audio on the same port has its own marker semantics and is
+         * left out. */
+        f->frame_bytes_acc += len;
+        if (pkt[1] & 0x80) {
+            uint64_t avg = f->frame_bytes_avg;
+            avg = avg ? avg - avg / 8 + f->frame_bytes_acc / 8 : f->frame_bytes_acc;
+            __atomic_store_n(&f->frame_bytes_avg, avg, __ATOMIC_RELAXED);
+            f->frame_bytes_acc = 0;
+        }
+    }
+    gint64 now_us = (gint64)(fanout_clock_ns() / 1000);
+    for (guint i = 0; i < f->count; i++) {
+        RestreamTarget *t = &f->targets[i];
+        guint used = t->head - __atomic_load_n(&t->tail, __ATOMIC_ACQUIRE);
+        if (len > UV_RESTREAM_SLOT_SIZE || used >= f->depth) {
+            fanout_count(&t->dropped, 1);
+            continue;
+        }
+        guint slot = t->head & (f->depth - 1);
+        memcpy(t->slots + (gsize)slot * UV_RESTREAM_SLOT_SIZE, pkt, len);
+        t->lens[slot] = (guint16)len;
+        t->queued_us[slot] = now_us;
+        fanout_count(&t->bytes_in, len);
+        __atomic_store_n(&t->head, t->head + 1, __ATOMIC_RELEASE);
+        if (used + 1 > t->queue_peak) __atomic_store_n(&t->queue_peak, used + 1, __ATOMIC_RELAXED);
+    }
+}
+
+/* Selected source's measured frame period, from the relay stats pass. */
+void restream_fanout_set_frame_period(RestreamFanout *f, double period_ms) {
+    uint64_t ns = period_ms > 0.0 ? (uint64_t)(period_ms * 1e6) : 0;
+    __atomic_store_n(&f->frame_period_ns, ns, __ATOMIC_RELAXED);
+}
+
+/* Wake the sender after a batch was queued. Returns TRUE when that took a
+ * syscall (the sender had gone to sleep). */
+gboolean restream_fanout_kick(RestreamFanout *f) {
+    if (f->wake_fd < 0 || !g_atomic_int_compare_and_exchange(&f->sleeping, 1, 0)) return FALSE;
+    uint64_t one = 1;
+    ssize_t r = write(f->wake_fd, &one, sizeof(one));
+    (void)r;
+    return TRUE;
+}
+
+/* Token bucket for a paced destination: how many of the next n queued
+ * datagrams may go now. The rate spreads max(average frame, current
+ * backlog) over pace_spread of the frame period, and once raised by a
+ * burst it holds until the queue drains, so every burst is out within
+ * that window of landing. Returns n untouched while the period or frame
+ * size is still unknown; sets t->pace_wait_ns when tokens run short. */
+static guint restream_target_pace(RestreamFanout *f, RestreamTarget *t, guint n) {
+    uint64_t period_ns = __atomic_load_n(&f->frame_period_ns, __ATOMIC_RELAXED);
+    uint64_t frame_bytes = __atomic_load_n(&f->frame_bytes_avg, __ATOMIC_RELAXED);
+    if (period_ns == 0 || frame_bytes == 0) return n;
+
+    uint64_t now = fanout_clock_ns();
+    uint64_t backlog = fanout_read(&t->bytes_in) - t->bytes_out;
+    double window_ns = f->pace_spread * (double)period_ns;
+    double rate = (double)MAX(frame_bytes, backlog) / window_ns;
+    if (rate > t->pace_rate) t->pace_rate = rate;
+    if (t->pace_refill_ns != 0) {
+        t->pace_tokens += t->pace_rate * (double)(now - t->pace_refill_ns);
+    } else {
+        t->pace_tokens = UV_RESTREAM_PACE_BURST_BYTES;
+    }
+    t->pace_tokens = MIN(t->pace_tokens, (double)UV_RESTREAM_PACE_BURST_BYTES);
+    t->pace_refill_ns = now;
+
+    guint k = 0;
+    while (k < n) {
+        guint len = t->lens[(t->tail + k) & (f->depth - 1)];
+        if (t->pace_tokens < (double)len) {
+            uint64_t wait = (uint64_t)(((double)len - t->pace_tokens) / t->pace_rate);
+            t->pace_wait_ns = MAX(wait, UV_RESTREAM_PACE_MIN_SLEEP_NS);
+            break;
+        }
+        t->pace_tokens -= (double)len;
+        k++;
+    }
+    return k;
+}
+
+/* Retire n sent (or refused) datagrams from the front of the queue. */
+static void restream_target_dequeue(RestreamFanout *f, RestreamTarget *t, guint n, gint64 now_us) {
+    uint64_t bytes = 0, delay_total = 0, delay_max = t->delay_us_max;
+    for (guint i = 0; i < n; i++) {
+        guint slot = (t->tail + i) & (f->depth - 1);
+        bytes += t->lens[slot];
+        uint64_t d = now_us > t->queued_us[slot] ? (uint64_t)(now_us - t->queued_us[slot]) : 0;
+        delay_total += d;
+        if (d > delay_max) delay_max = d;
+    }
+    t->bytes_out += bytes;
+    fanout_count(&t->delay_us_total, delay_total);
+    fanout_count(&t->delay_count, n);
+    __atomic_store_n(&t->delay_us_max, delay_max, __ATOMIC_RELAXED);
+    __atomic_store_n(&t->tail, t->tail + n, __ATOMIC_RELEASE);
+    if (t->tail == __atomic_load_n(&t->head, __ATOMIC_ACQUIRE)) t->pace_rate = 0.0;
+}
+
+/* Send what the destination held when called, UV_RESTREAM_SEND_BATCH
+ * datagrams per sendmmsg() (fewer when paced). A full socket buffer leaves
+ * the rest queued and marks the destination blocked; any other error drops
+ * the datagram the kernel refused. */
+static void restream_target_flush(RestreamFanout *f, RestreamTarget *t,
+                                  struct mmsghdr *msgs, struct iovec *iov) {
+    guint head = __atomic_load_n(&t->head, __ATOMIC_ACQUIRE);
+    t->blocked = FALSE;
+    t->pace_wait_ns = 0;
+    while (t->tail != head) {
+        guint n = MIN(head - t->tail, UV_RESTREAM_SEND_BATCH);
+        if (f->pace_spread > 0.0) {
+            n = restream_target_pace(f, t, n);
+            if (n == 0) return;
+        }
+        for (guint i = 0; i < n; i++) {
+            guint slot = (t->tail + i) & (f->depth - 1);
+            iov[i].iov_base = t->slots + (gsize)slot * UV_RESTREAM_SLOT_SIZE;
+            iov[i].iov_len = t->lens[slot];
+            memset(&msgs[i], 0, sizeof(msgs[i]));
+            msgs[i].msg_hdr.msg_name = &t->dest;
+            msgs[i].msg_hdr.msg_namelen = sizeof(t->dest);
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        int sent = sendmmsg(t->fd, msgs, n, MSG_DONTWAIT);
+        fanout_count(&t->send_calls, 1);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                t->blocked = TRUE;
+                return;
+            }
+            fanout_count(&t->tx_errors, 1);
+            sent = 1;
+        } else {
+            uint64_t bytes = 0;
+            for (int i = 0; i < sent; i++) bytes += msgs[i].msg_len;
+            fanout_count(&t->tx_packets, (uint64_t)sent);
+            fanout_count(&t->tx_bytes, bytes);
+        }
+        /* Tokens for datagrams a partial send left behind go back. */
+        for (guint i = (guint)sent; i < n && f->pace_spread > 0.0; i++) t->pace_tokens += (double)iov[i].iov_len;
+        restream_target_dequeue(f, t, (guint)sent, (gint64)(fanout_clock_ns() / 1000));
+    }
+}
+
+static gpointer restream_fanout_run(gpointer data) {
+    RestreamFanout *f = (RestreamFanout *)data;
+    struct mmsghdr msgs[UV_RESTREAM_SEND_BATCH];
+    struct iovec iov[UV_RESTREAM_SEND_BATCH];
+    struct pollfd pfd[1 + UV_RESTREAM_TARGETS_MAX];
+
+    while (g_atomic_int_get(&f->running)) {
+        nfds_t nfds = 1;
+        pfd[0].fd = f->wake_fd;
+        pfd[0].events = POLLIN;
+        uint64_t sleep_ns = (uint64_t)UV_RESTREAM_IDLE_MS * 1000000ull;
+        g_mutex_lock(&f->lock);
+        for (guint i = 0; i < f->count; i++) {
+            restream_target_flush(f, &f->targets[i], msgs, iov);
+            if (f->targets[i].blocked) {
+                pfd[nfds].fd = f->targets[i].fd;
+                pfd[nfds].events = POLLOUT;
+                nfds++;
+            }
+            if (f->targets[i].pace_wait_ns) sleep_ns = MIN(sleep_ns, f->targets[i].pace_wait_ns);
+        }
+
+        /* Announce the sleep, then look once more: a datagram queued
+         * before the announcement was seen has to be caught here. */
+        g_atomic_int_set(&f->sleeping, 1);
+        gboolean pending = FALSE;
+        for (guint i = 0; i < f->count && !pending; i++) {
+            const RestreamTarget *t = &f->targets[i];
+            pending = !t->blocked && !t->pace_wait_ns &&
+                      __atomic_load_n(&t->head, __ATOMIC_ACQUIRE) != t->tail;
+        }
+        g_mutex_unlock(&f->lock);
+        if (!pending) {
+            struct timespec timeout = {
+                .tv_sec = (time_t)(sleep_ns / 1000000000ull),
+                .tv_nsec = (long)(sleep_ns % 1000000000ull),
+            };
+            ppoll(pfd, nfds, &timeout, NULL);
+            if (pfd[0].revents & POLLIN) {
+                uint64_t v;
+                ssize_t r = read(f->wake_fd, &v, sizeof(v));
+                (void)r;
+            }
+        }
+        g_atomic_int_set(&f->sleeping, 0);
+    }
+    return NULL;
+}
+
+gboolean restream_fanout_start(RestreamFanout *f) {
+    if (f->thread) return TRUE;
+    if (f->wake_fd < 0) return FALSE;
+    g_atomic_int_set(&f->running, 1);
+    f->thread = g_thread_new("uv-restream", restream_fanout_run, f);
+    return f->thread != NULL;
+}
+
+void restream_fanout_stop(RestreamFanout *f) {
+    if (!f->thread) return;
+    g_atomic_int_set(&f->running, 0);
+    uint64_t one = 1;
+    ssize_t r = write(f->wake_fd, &one, sizeof(one));
+    (void)r;
+    g_thread_join(f->thread);
+    f->thread = NULL;
+}
+
+/* Fill the per-destination part of out and the totals. */
+void restream_fanout_snapshot(RestreamFanout *f, UvRestreamStats *out) {
+    g_mutex_lock(&f->lock);
+    out->target_count = f->count;
+    out->pace_spread = f->pace_spread;
+    out->frame_period_ms = (double)__atomic_load_n(&f->frame_period_ns, __ATOMIC_RELAXED) / 1e6;
+    out->tx_packets = out->tx_bytes = out->tx_errors = out->dropped = 0;
+    for (guint i = 0; i < f->count; i++) {
+        const RestreamTarget *t = &f->targets[i];
+        UvRestreamTargetStats *ts = &out->targets[i];
+        g_strlcpy(ts->address, t->address, sizeof(ts->address));
+        ts->port = t->port;
+        ts->active = t->fd >= 0;
+        ts->queued = __atomic_load_n(&t->head, __ATOMIC_ACQUIRE) - t->tail;
+        ts->queue_peak = __atomic_load_n(&t->queue_peak, __ATOMIC_RELAXED);
+        ts->queue_depth = f->depth;
+        ts->dropped = fanout_read(&t->dropped);
+        ts->tx_packets = fanout_read(&t->tx_packets);
+        ts->tx_bytes = fanout_read(&t->tx_bytes);
+        ts->tx_errors = fanout_read(&t->tx_errors);
+        ts->send_calls = fanout_read(&t->send_calls);
+        uint64_t delay_count = fanout_read(&t->delay_count);
+        ts->delay_us_avg = delay_count ? (double)fanout_read(&t->delay_us_total) / (double)delay_count : 0.0;
+        ts->delay_us_max = (double)fanout_read(&t->delay_us_max);
+        out->tx_packets += ts->tx_packets;
+        out->tx_bytes += ts->tx_bytes;
+        out->tx_errors += ts->tx_errors;
+        out->dropped += ts->dropped;
+    }
+    g_mutex_unlock(&f->lock);
+}
@@ -0,0 +1,59 @@
+#ifndef RTP_SEQ_H
+#define RTP_SEQ_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* RTP sequence-number arithmetic (RFC 3550 A.1) shared by the relay's
+ * per-source accounting. Plain libc so the decisions can be checked on
+ * their own (tests/rtp_seq_test.c). */
+
+/* RFC 3550 sequence-validity constants. A forward gap below MAX_DROPOUT is a
+ * normal loss burst; a backward step within MAX_MISORDER is genuine reordering.
+ * Anything else means the sender's sequence space jumped — typically a Wi-Fi
+ * link recovering after the encoder restarted with a fresh (often reset) seq. */
+#define UV_RTP_MAX_DROPOUT   3000u
+#define UV_RTP_MAX_MISORDER  100u
+
+/* Extend seq16 to 32 bits against max_ext, the highest extended sequence
+ * number accounted so far, adding a cycle to *cycles on an in-order wrap.
+ * *jumped is set when seq16 is neither a loss burst ahead nor reordering
+ * behind. Until the first packet has been accounted (initialized false)
+ * there is nothing to compare with: seq16 is taken as it is. */
+static inline uint32_t rtp_seq_extend(bool initialized, uint32_t *cycles, uint32_t max_ext,
+                                      uint16_t seq16, bool *jumped) {
+    *jumped = false;
+    if (!initialized) return seq16;
+    uint16_t max_seq16 = (uint16_t)(max_ext & 0xffffu);
+    uint16_t udelta = (uint16_t)(seq16 - max_seq16);
+    if (udelta < UV_RTP_MAX_DROPOUT) {
+        if (seq16 < max_seq16) *cycles += 1u << 16; /* in-order wrap */
+    } else if (udelta <= (uint16_t)(0x10000u - UV_RTP_MAX_MISORDER)) {
+        *jumped = true; /* large gap or reset: sequence space is discontinuous */
+    } else if (seq16 > max_seq16) {
+        /* Small step back across a wrap: the packet is from the previous
+         * cycle. Before the first wrap there is none, so treat it as a stray. */
+        if (*cycles == 0) *jumped = true;
+        return *cycles - (1u << 16) + seq16;
+    }
+    /* else: small step backwards — a genuine duplicate or reordered packet. */
+    return *cycles + seq16;
+}
+
+/* Where seq falls in a window of slots sequence numbers opening at base:
+ * its offset from base, or one of the two below. Anything up to
+ * UV_RTP_MAX_DROPOUT behind base is late (a duplicate, or a straggler for
+ * a slot already released or given up on) and must leave the window
+ * alone; only a forward jump past the window or a step further back than
+ * that means the sequence started over. slots must be below 0x8000. */
+#define UV_RTP_SEQ_LATE   (-1)
+#define UV_RTP_SEQ_REBASE (-2)
+
+static inline int rtp_seq_window_offset(uint16_t base, uint16_t seq, unsigned slots) {
+    uint16_t d = (uint16_t)(seq - base);
+    if (d >= 0x8000u && (uint16_t)(base - seq) <= UV_RTP_MAX_DROPOUT) return UV_RTP_SEQ_LATE;
+    if (d >= slots) return UV_RTP_SEQ_REBASE;
+    return (int)d;
+}
+
+#endif // RTP_SEQ_H
@@ -27,8 +27,123 @@ static inline void store_u64(void *base, size_t off, uint64_t value) {
     __atomic_store_n((uint64_t *)((uint8_t *)base + off), value, __ATOMIC_RELEASE);
 }
 
+/* Without a release in this long, a zero-copy consumer stops waiting for
+ * downstream and copies the next access unit instead (see
+ * shm_zc_wait_capacity). */
+#define UV_SHM_ZC_STALL_US 100000
+
+/* Zero-copy ring mapping. In zero-copy mode access units are pushed as
+ * GstMemory wrapping the ring slot itself, so the mapping and the READ_IDX
+ * bookkeeping have to outlive both a detach and the ShmIngress: every
+ * in-flight buffer holds a ref and the munmap happens when the last one
+ * drops. READ_IDX only advances in ring order, over slots downstream has
+ * released, so the producer sees held slots as occupied. */
+struct ShmZcMap {
+    gint refs;
+    void *base;
+    size_t map_size;
+    uint32_t slot_count;
+    GMutex lock;
+    GCond released_cond;
+    uint64_t consume_idx;   /* next slot the ingest thread hands out */
+    uint64_t release_idx;   /* mirrors VFRM_OFF_READ_IDX */
+    guint8 *released;       /* per slot: downstream done, awaiting in-order advance */
+    gboolean stalled;       /* a capacity wait timed out; cleared by the next release */
+    guint inflight_peak;
+};
+
+typedef struct {
+    struct ShmZcMap *map;
+    uint64_t idx;
+} ShmZcToken;
+
+static struct ShmZcMap *shm_zc_map_new(void *base, size_t map_size, uint32_t slot_count) {
+    struct ShmZcMap *m = g_new0(struct ShmZcMap, 1);
+    m->refs = 1;
+    m->base = base;
+    m->map_size = map_size;
+    m->slot_count = slot_count;
+    g_mutex_init(&m->lock);
+    g_cond_init(&m->released_cond);
+    m->consume_idx = m->release_idx = load_u64(base, VFRM_OFF_READ_IDX);
+    m->released = g_new0(guint8, slot_count);
+    return m;
+}
+
+static struct ShmZcMap *shm_zc_map_ref(struct ShmZcMap *m) {
+    g_atomic_int_inc(&m->refs);
+    return m;
+}
+
+static void shm_zc_map_unref(struct ShmZcMap *m) {
+    if (!g_atomic_int_dec_and_test(&m->refs)) return;
+    munmap(m->base, m->map_size);
+    g_free(m->released);
+    g_cond_clear(&m->released_cond);
+    g_mutex_clear(&m->lock);
+    g_free(m);
+}
+
+/* Mark a handed-out slot done and advance READ_IDX over the released prefix. */
+static void shm_zc_release(struct ShmZcMap *m, uint64_t idx) {
+    uint32_t mask = m->slot_count - 1u;
+    g_mutex_lock(&m->lock);
+    m->released[idx & mask] = 1;
+    uint64_t before = m->release_idx;
+    while (m->release_idx < m->consume_idx && m->released[m->release_idx & mask]) {
+        m->released[m->release_idx & mask] = 0;
+        m->release_idx++;
+    }
+    if (m->release_idx != before) {
+        store_u64(m->base, VFRM_OFF_READ_IDX, m->release_idx);
+        m->stalled = FALSE;
+        g_cond_signal(&m->released_cond);
+    }
+    g_mutex_unlock(&m->lock);
+}
+
+/* GstMemory destroy notify: runs on whichever streaming thread drops the
+ * last ref, possibly after the ingress itself is gone. */
+static void shm_zc_token_release(gpointer data) {
+    ShmZcToken *tok = data;
+    shm_zc_release(tok->map, tok->idx);
+    shm_zc_map_unref(tok->map);
+    g_free(tok);
+}
+
+/* Block until fewer than max_inflight slots are held downstream. Returns
+ * FALSE when nothing was released for UV_SHM_ZC_STALL_US; the caller then
+ * copies the next access unit so an element that needs more input before it
+ * lets go of the held ones cannot deadlock the ring. Once stalled, later
+ * calls return FALSE straight away until downstream releases a slot, so a
+ * stall costs one timeout rather than one per access unit. */
+static gboolean shm_zc_wait_capacity(struct ShmZcMap *m, guint max_inflight,
+                                     volatile gboolean *stop) {
+    gboolean ok = TRUE;
+    g_mutex_lock(&m->lock);
+    if (m->stalled && m->consume_idx - m->release_idx >= max_inflight) {
+        g_mutex_unlock(&m->lock);
+        return FALSE;
+    }
+    gint64 deadline = g_get_monotonic_time() + UV_SHM_ZC_STALL_US;
+    while (!*stop && m->consume_idx - m->release_idx >= max_inflight) {
+        if (!g_cond_wait_until(&m->released_cond, &m->lock, deadline)) {
+            ok = m->consume_idx - m->release_idx < max_inflight;
+            m->stalled = !ok;
+            break;
+        }
+    }
+    g_mutex_unlock(&m->lock);
+    return ok;
+}
+
 static void shm_detach_locked(ShmIngress *si) {
-    if (si->base) munmap(si->base, si->map_size);
+    if (si->zc_map) {
+        shm_zc_map_unref(si->zc_map);
+        si->zc_map = NULL;
+    } else if (si->base) {
+        munmap(si->base, si->map_size);
+    }
     si->base = NULL;
     si->map_size = 0;
     si->attached = FALSE;
@@ -72,6 +187,10 @@ static gboolean shm_try_attach(ShmIngress *si) {
     si->st_dev = st.st_dev;
     si->st_ino = st.st_ino;
     si->attached = TRUE;
+    if (si->zero_copy) {
+        si->zc_map = shm_zc_map_new(base, (size_t)st.st_size, slots);
+        si->zc_max_inflight = CLAMP(si->zc_max_inflight_cfg, 1u, slots - 1u);
+    }
     if (replacing_producer) {
         /* A recreated ring is a brand-new encoded stream. Gate ingress on the
          * next IDR and flush stale parser/decoder state when it arrives. */
@@ -106,15 +225,19 @@ static gboolean backing_object_current(ShmIngress *si) {
     return current;
 }
 
-static void push_frame(ShmIngress *si, const uint8_t *data, size_t len,
-                       const VencFrameMeta *meta) {
+/* Returns TRUE when the access unit was handed downstream as a wrapped ring
+ * slot (zc != NULL); its release then happens from the buffer's destroy
+ * notify. On FALSE the caller still owns slot_idx. */
+static gboolean push_frame(ShmIngress *si, const uint8_t *data, size_t len,
+                           const VencFrameMeta *meta, struct ShmZcMap *zc,
+                           uint64_t slot_idx) {
     /* No reserved-field check: bytes 6-7 now carry gdr_pos/gdr_len (venc #179),
      * which are non-zero on every non-IDR frame when intra-refresh is on. */
     if (len <= sizeof(*meta) || meta->codec != UV_FRAME_CODEC_H265) {
         g_mutex_lock(&si->lock);
         si->bad_slots++;
         g_mutex_unlock(&si->lock);
-        return;
+        return FALSE;
     }
     const uint8_t *au = data + sizeof(*meta);
     size_t au_len = len - sizeof(*meta);
@@ -139,7 +262,7 @@ static void push_frame(ShmIngress *si, const uint8_t *data, size_t len,
         si->push_enabled = TRUE;
     }
     g_mutex_unlock(&si->lock);
-    if (!appsrc) return;
+    if (!appsrc) return FALSE;
 
     if (reset_stream) {
         /* A recreated ring starts a new encoded stream. Flush stale parser and
@@ -150,16 +273,153 @@ static void push_frame(ShmIngress *si, const uint8_t *data, size_t len,
         gst_element_send_event(GST_ELEMENT(appsrc), gst_event_new_flush_stop(TRUE));
         uv_log_info("SHM ingress %s reset decoder stream after producer restart", si->name);
     }
-    GstBuffer *buffer = gst_buffer_new_allocate(NULL, au_len, NULL);
+    GstBuffer *buffer = NULL;
+    gboolean held = FALSE;
+    if (zc) {
+        ShmZcToken *tok = g_new(ShmZcToken, 1);
+        tok->map = shm_zc_map_ref(zc);
+        tok->idx = slot_idx;
+        buffer = gst_buffer_new_wrapped_full(GST_MEMORY_FLAG_READONLY, (gpointer)au,
+                                             au_len, 0, au_len, tok, shm_zc_token_release);
+        if (buffer) {
+            held = TRUE;
+            g_mutex_lock(&si->lock);
+            si->zc_frames++;
+            g_mutex_unlock(&si->lock);
+        } else {
+            shm_zc_map_unref(tok->map);
+            g_free(tok);
+        }
+    } else {
+        buffer = gst_buffer_new_allocate(NULL, au_len, NULL);
+        if (buffer) gst_buffer_fill(buffer, 0, au, au_len);
+    }
     if (buffer) {
-        gst_buffer_fill(buffer, 0, au, au_len);
         if (start_stream) GST_BUFFER_FLAG_SET(buffer, GST_BUFFER_FLAG_DISCONT);
+        if (si->latency) {
+            /* The offset carries the pts to the tracer's appsrc probe. */
+            GST_BUFFER_OFFSET(buffer) = meta->pts;
+            uv_internal_latency_ingest(si->latency, meta->pts, g_get_monotonic_time());
+        }
         GstFlowReturn flow = gst_app_src_push_buffer(appsrc, buffer);
         if (flow != GST_FLOW_OK && flow != GST_FLOW_FLUSHING) {
             uv_log_warn("SHM appsrc push returned %s", gst_flow_get_name(flow));
         }
     }
     gst_object_unref(appsrc);
+    return held;
+}
+
+static gboolean shm_slot_read(ShmIngress *si, uint64_t idx, uint8_t **payload,
+                              uint32_t *length, VencFrameMeta *meta) {
+    uint8_t *slot = (uint8_t *)si->base + VFRM_HEADER_SIZE +
+                    (idx & (si->slot_count - 1u)) * si->stride;
+    memcpy(length, slot, sizeof(*length));
+    if (*length > si->slot_data_size || *length < sizeof(VencFrameMeta)) {
+        g_mutex_lock(&si->lock);
+        si->bad_slots++;
+        g_mutex_unlock(&si->lock);
+        return FALSE;
+    }
+    memcpy(meta, slot + sizeof(*length), sizeof(*meta));
+    *payload = slot + sizeof(*length);
+    return TRUE;
+}
+
+/* Copy mode: every access unit is copied out and READ_IDX follows the
+ * ingest thread directly. */
+static gboolean shm_drain_copy(ShmIngress *si) {
+    uint64_t read_idx = load_u64(si->base, VFRM_OFF_READ_IDX);
+    uint64_t write_idx = load_u64(si->base, VFRM_OFF_WRITE_IDX);
+    gboolean drained = FALSE;
+    while (!si->stop && read_idx != write_idx) {
+        uint8_t *payload;
+        uint32_t length;
+        VencFrameMeta meta;
+        if (shm_slot_read(si, read_idx, &payload, &length, &meta)) {
+            push_frame(si, payload, length, &meta, NULL, 0);
+        }
+        read_idx++;
+        store_u64(si->base, VFRM_OFF_READ_IDX, read_idx);
+        write_idx = load_u64(si->base, VFRM_OFF_WRITE_IDX);
+        drained = TRUE;
+    }
+    return drained;
+}
+
+/* Zero-copy mode: slots are handed downstream in place and READ_IDX trails
+ * behind until the buffers come back, bounded by zc_max_inflight. */
+static gboolean shm_drain_zero_copy(ShmIngress *si) {
+    struct ShmZcMap *m = si->zc_map;
+    uint64_t write_idx = load_u64(si->base, VFRM_OFF_WRITE_IDX);
+    gboolean drained = FALSE;
+    while (!si->stop) {
+        g_mutex_lock(&m->lock);
+        uint64_t idx = m->consume_idx;
+        g_mutex_unlock(&m->lock);
+        if (idx == write_idx) break;
+
+        gboolean wrap = shm_zc_wait_capacity(m, si->zc_max_inflight, &si->stop);
+        if (si->stop) break;
+
+        g_mutex_lock(&m->lock);
+        m->consume_idx = idx + 1u;
+        guint inflight = (guint)(m->consume_idx - m->release_idx);
+        if (inflight > m->inflight_peak) m->inflight_peak = inflight;
+        g_mutex_unlock(&m->lock);
+
+        gboolean held = FALSE;
+        uint8_t *payload;
+        uint32_t length;
+        VencFrameMeta meta;
+        if (shm_slot_read(si, idx, &payload, &length, &meta)) {
+            if (!wrap) {
+                g_mutex_lock(&si->lock);
+                si->zc_copy_fallbacks++;
+                g_mutex_unlock(&si->lock);
+            }
+            held = push_frame(si, payload, length, &meta, wrap ? m : NULL, idx);
+        }
+        if (!held) shm_zc_release(m, idx);
+        write_idx = load_u64(si->base, VFRM_OFF_WRITE_IDX);
+        drained = TRUE;
+    }
+    return drained;
+}
+
+/* Publish the ingress counters for shm_ingress_snapshot(). Only the SHM
+ * thread writes them (init aside), so they are read here without si->lock.
+ * Unless forced, publishes are spaced UV_STATS_PUBLISH_INTERVAL_US apart;
+ * the idle path forces one per futex timeout so a quiet ring still reports
+ * a current fill level. */
+static void shm_publish_stats(ShmIngress *si, gboolean force) {
+    gint64 now_us = g_get_monotonic_time();
+    if (!force && now_us - si->pub_us < UV_STATS_PUBLISH_INTERVAL_US) return;
+    UvSourceStats p;
+    memset(&p, 0, sizeof(p));
+    p.shm_attached = si->attached;
+    p.shm_oversize_drops = si->oversize_drops;
+    p.shm_bad_slots = si->bad_slots;
+    p.shm_reattaches = si->reattaches;
+    p.shm_zero_copy = si->zero_copy;
+    p.shm_zero_copy_frames = si->zc_frames;
+    p.shm_copy_fallbacks = si->zc_copy_fallbacks;
+    if (si->zc_map) {
+        struct ShmZcMap *m = si->zc_map;
+        g_mutex_lock(&m->lock);
+        p.shm_inflight = (guint)(m->consume_idx - m->release_idx);
+        p.shm_inflight_peak = m->inflight_peak;
+        g_mutex_unlock(&m->lock);
+        p.shm_inflight_max = si->zc_max_inflight;
+    }
+    if (si->attached) {
+        uint64_t used = load_u64(si->base, VFRM_OFF_WRITE_IDX) -
+                        load_u64(si->base, VFRM_OFF_READ_IDX);
+        if (used > si->slot_count) used = si->slot_count;
+        p.shm_fill_pct = 100.0 * (double)used / (double)si->slot_count;
+    }
+    uv_seqlock_publish(&si->pub_seq, &si->pub, &p, sizeof(p));
+    si->pub_us = now_us;
 }
 
 static gpointer shm_thread_run(gpointer data) {
@@ -168,32 +428,13 @@ static gpointer shm_thread_run(gpointer data) {
     while (!si->stop) {
         if (!si->attached) {
             if (!shm_try_attach(si)) g_usleep(500000);
+            else shm_publish_stats(si, TRUE);
             last_frame_us = g_get_monotonic_time();
             continue;
         }
-        uint64_t read_idx = load_u64(si->base, VFRM_OFF_READ_IDX);
-        uint64_t write_idx = load_u64(si->base, VFRM_OFF_WRITE_IDX);
-        gboolean drained = FALSE;
-        while (!si->stop && read_idx != write_idx) {
-            uint8_t *slot = (uint8_t *)si->base + VFRM_HEADER_SIZE +
-                            (read_idx & (si->slot_count - 1u)) * si->stride;
-            uint32_t length;
-            memcpy(&length, slot, sizeof(length));
-            if (length > si->slot_data_size || length < sizeof(VencFrameMeta)) {
-                g_mutex_lock(&si->lock);
-                si->bad_slots++;
-                g_mutex_unlock(&si->lock);
-            } else {
-                VencFrameMeta meta;
-                memcpy(&meta, slot + sizeof(length), sizeof(meta));
-                push_frame(si, slot + sizeof(length), length, &meta);
-            }
-            read_idx++;
-            store_u64(si->base, VFRM_OFF_READ_IDX, read_idx);
-            write_idx = load_u64(si->base, VFRM_OFF_WRITE_IDX);
-            drained = TRUE;
-        }
+        gboolean drained = si->zc_map ? shm_drain_zero_copy(si) : shm_drain_copy(si);
         if (drained) {
+            shm_publish_stats(si, FALSE);
             last_frame_us = g_get_monotonic_time();
             continue;
         }
@@ -210,6 +451,7 @@ static gpointer shm_thread_run(gpointer data) {
             g_mutex_unlock(&si->lock);
             uv_log_warn("SHM ingress %s detached; waiting for producer", si->name);
         }
+        shm_publish_stats(si, TRUE);
     }
     return NULL;
 }
@@ -223,6 +465,10 @@ gboolean shm_ingress_init(ShmIngress *si, struct _UvViewer *viewer,
     g_snprintf(si->name, sizeof(si->name), "%s%s", name[0] == '/' ? "" : "/", name);
     si->registry = registry;
     si->source_index = -1;
+    si->zero_copy = viewer->config.shm_zero_copy;
+    si->zc_max_inflight_cfg = viewer->config.shm_max_inflight;
+    si->latency = viewer->config.latency_trace ? &viewer->latency : NULL;
+    shm_publish_stats(si, TRUE);
     return TRUE;
 }
 
@@ -272,17 +518,19 @@ void shm_ingress_set_push_enabled(ShmIngress *si, gboolean enabled) {
     g_mutex_unlock(&si->lock);
 }
 
-void shm_ingress_snapshot(ShmIngress *si, UvSourceStats *stats) {
-    g_mutex_lock(&si->lock);
-    stats->shm_attached = si->attached;
-    stats->shm_oversize_drops = si->oversize_drops;
-    stats->shm_bad_slots = si->bad_slots;
-    stats->shm_reattaches = si->reattaches;
-    if (si->attached) {
-        uint64_t used = load_u64(si->base, VFRM_OFF_WRITE_IDX) -
-                        load_u64(si->base, VFRM_OFF_READ_IDX);
-        if (used > si->slot_count) used = si->slot_count;
-        stats->shm_fill_pct = 100.0 * (double)used / (double)si->slot_count;
-    }
-    g_mutex_unlock(&si->lock);
+guint shm_ingress_snapshot(ShmIngress *si, UvSourceStats *stats) {
+    UvSourceStats pub;
+    guint retries = uv_seqlock_read(&si->pub_seq, &pub, &si->pub, sizeof(pub));
+    stats->shm_attached = pub.shm_attached;
+    stats->shm_fill_pct = pub.shm_fill_pct;
+    stats->shm_oversize_drops = pub.shm_oversize_drops;
+    stats->shm_bad_slots = pub.shm_bad_slots;
+    stats->shm_reattaches = pub.shm_reattaches;
+    stats->shm_zero_copy = pub.shm_zero_copy;
+    stats->shm_zero_copy_frames = pub.shm_zero_copy_frames;
+    stats->shm_copy_fallbacks = pub.shm_copy_fallbacks;
+    stats->shm_inflight = pub.shm_inflight;
+    stats->shm_inflight_peak = pub.shm_inflight_peak;
+    stats->shm_inflight_max = pub.shm_inflight_max;
+    return retries;
 }
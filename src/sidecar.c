@@ -1,8 +1,8 @@
 /* RTP sidecar probe — subscribes to the encoder's per-frame telemetry
  * channel defined by waybeam_venc's rtp_sidecar.h.  Owns its own UDP
  * socket and worker thread; per-frame metadata is folded into
- * SidecarController under sc->lock and surfaced to the GUI through
- * sidecar_controller_snapshot(). */
+ * SidecarController under sc->lock and republished through a seqlock
+ * that sidecar_controller_snapshot() reads without taking the lock. */
 
 #include "uv_internal.h"
 
@@ -47,12 +47,65 @@ static uint16_t read_be16(const uint8_t *p) {
     return (uint16_t)((p[0] << 8) | p[1]);
 }
 
+/* Publish the reader view. Caller holds sc->lock, which also serialises
+ * the writers (the sidecar thread and the target/start/stop calls). The
+ * frame age is left to the reader, computed from last_frame_us. */
+static void sidecar_publish_locked(SidecarController *sc) {
+    UvSidecarPub p;
+    memset(&p, 0, sizeof(p));
+    UvSidecarStats *out = &p.stats;
+    out->enabled = sc->enabled;
+    out->socket_bound = (sc->fd >= 0);
+    out->target_port = sc->encoder_port;
+    out->local_port = sc->local_port;
+    g_strlcpy(out->target_address, sc->target_addr, sizeof(out->target_address));
+
+    out->frames_received = sc->frames_received;
+    out->idr_inserted_count = sc->idr_inserted_count;
+    out->scene_change_count = sc->scene_change_count;
+    out->keyframes_count = sc->keyframes_count;
+
+    out->last_ssrc = sc->last_ssrc;
+    out->last_frame_id = sc->last_frame_id;
+    out->last_rtp_timestamp = sc->last_rtp_timestamp;
+    out->last_seq_count = sc->last_seq_count;
+    out->last_frame_size_bytes = sc->last_frame_size_bytes;
+    out->last_frame_type = sc->last_frame_type;
+    out->last_qp = sc->last_qp;
+    out->last_complexity = sc->last_complexity;
+    out->last_scene_change = sc->last_scene_change;
+    out->last_gop_state = sc->last_gop_state;
+    out->last_idr_inserted = sc->last_idr_inserted;
+    out->last_frames_since_idr = sc->last_frames_since_idr;
+
+    if (sc->window_count > 0) {
+        uint32_t sum_qp = 0, sum_cx = 0;
+        for (guint i = 0; i < sc->window_count; i++) {
+            sum_qp += sc->qp_window[i];
+            sum_cx += sc->cx_window[i];
+        }
+        out->avg_qp = (double)sum_qp / (double)sc->window_count;
+        out->avg_complexity = (double)sum_cx / (double)sc->window_count;
+    }
+
+    out->transport_info_seen = sc->transport_info_seen;
+    out->encoder_fill_pct = sc->encoder_fill_pct;
+    out->encoder_in_pressure = sc->encoder_in_pressure;
+    out->encoder_transport_drops = sc->encoder_transport_drops;
+    out->encoder_pressure_drops = sc->encoder_pressure_drops;
+    out->encoder_packets_sent = sc->encoder_packets_sent;
+
+    p.last_frame_us = sc->last_frame_us;
+    uv_seqlock_publish(&sc->pub_seq, &sc->pub, &p, sizeof(p));
+}
+
 gboolean sidecar_controller_init(SidecarController *sc, struct _UvViewer *viewer) {
     if (!sc) return FALSE;
     memset(sc, 0, sizeof(*sc));
     sc->fd = -1;
     sc->viewer = viewer;
     g_mutex_init(&sc->lock);
+    sidecar_publish_locked(sc);
     return TRUE;
 }
 
@@ -79,6 +132,7 @@ void sidecar_controller_set_target(SidecarController *sc, const char *address) {
             sc->window_head = 0;
             sc->transport_info_seen = FALSE;
         }
+        sidecar_publish_locked(sc);
         g_mutex_unlock(&sc->lock);
         return;
     }
@@ -98,6 +152,7 @@ void sidecar_controller_set_target(SidecarController *sc, const char *address) {
         sc->window_head = 0;
         sc->transport_info_seen = FALSE;
     }
+    sidecar_publish_locked(sc);
     g_mutex_unlock(&sc->lock);
 }
 
@@ -216,6 +271,7 @@ static void sidecar_consume_frame(SidecarController *sc, const uint8_t *buf, siz
         sc->encoder_pressure_drops = pressure_drops;
         sc->encoder_packets_sent = packets_sent;
     }
+    sidecar_publish_locked(sc);
     g_mutex_unlock(&sc->lock);
 }
 
@@ -303,6 +359,7 @@ gboolean sidecar_controller_start(SidecarController *sc) {
     sc->encoder_port = (uint16_t)sc->viewer->config.sidecar_port;
     if (sc->encoder_port == 0) sc->encoder_port = 5602;
     sc->running = 1;
+    sidecar_publish_locked(sc);
     g_mutex_unlock(&sc->lock);
 
     sc->thread = g_thread_new("uv-sidecar", sidecar_thread_run, sc);
@@ -311,6 +368,7 @@ gboolean sidecar_controller_start(SidecarController *sc) {
         sc->running = 0;
         sc->enabled = FALSE;
         sc->fd = -1;
+        sidecar_publish_locked(sc);
         g_mutex_unlock(&sc->lock);
         close(fd);
         return FALSE;
@@ -365,64 +423,23 @@ void sidecar_controller_stop(SidecarController *sc) {
     sc->encoder_transport_drops = 0;
     sc->encoder_pressure_drops = 0;
     sc->encoder_packets_sent = 0;
+    sidecar_publish_locked(sc);
     g_mutex_unlock(&sc->lock);
 }
 
 void sidecar_controller_snapshot(SidecarController *sc, UvViewerStats *stats) {
     if (!sc || !stats) return;
     UvSidecarStats *out = &stats->sidecar;
-    memset(out, 0, sizeof(*out));
-
-    g_mutex_lock(&sc->lock);
-    out->enabled = sc->enabled;
-    out->socket_bound = (sc->fd >= 0);
-    out->target_port = sc->encoder_port;
-    out->local_port = sc->local_port;
-    g_strlcpy(out->target_address, sc->target_addr, sizeof(out->target_address));
+    UvSidecarPub pub;
+    stats->snapshot.last_retries += uv_seqlock_read(&sc->pub_seq, &pub, &sc->pub, sizeof(pub));
+    *out = pub.stats;
 
     gint64 now = g_get_monotonic_time();
-    if (sc->last_frame_us > 0) {
-        out->seconds_since_last_frame = (double)(now - sc->last_frame_us) / 1e6;
-        out->subscribed = (now - sc->last_frame_us) < SIDECAR_STALE_AFTER_US;
+    if (pub.last_frame_us > 0) {
+        out->seconds_since_last_frame = (double)(now - pub.last_frame_us) / 1e6;
+        out->subscribed = (now - pub.last_frame_us) < SIDECAR_STALE_AFTER_US;
     } else {
         out->seconds_since_last_frame = -1.0;
         out->subscribed = FALSE;
     }
-
-    out->frames_received = sc->frames_received;
-    out->idr_inserted_count = sc->idr_inserted_count;
-    out->scene_change_count = sc->scene_change_count;
-    out->keyframes_count = sc->keyframes_count;
-
-    out->last_ssrc = sc->last_ssrc;
-    out->last_frame_id = sc->last_frame_id;
-    out->last_rtp_timestamp = sc->last_rtp_timestamp;
-    out->last_seq_count = sc->last_seq_count;
-    out->last_frame_size_bytes = sc->last_frame_size_bytes;
-    out->last_frame_type = sc->last_frame_type;
-    out->last_qp = sc->last_qp;
-    out->last_complexity = sc->last_complexity;
-    out->last_scene_change = sc->last_scene_change;
-    out->last_gop_state = sc->last_gop_state;
-    out->last_idr_inserted = sc->last_idr_inserted;
-    out->last_frames_since_idr = sc->last_frames_since_idr;
-
-    if (sc->window_count > 0) {
-        uint32_t sum_qp = 0, sum_cx = 0;
-        for (guint i = 0; i < sc->window_count; i++) {
-            sum_qp += sc->qp_window[i];
-            sum_cx += sc->cx_window[i];
-        }
-        out->avg_qp = (double)sum_qp / (double)sc->window_count;
-        out->avg_complexity = (double)sum_cx / (double)sc->window_count;
-    }
-
-    out->transport_info_seen = sc->transport_info_seen;
-    out->encoder_fill_pct = sc->encoder_fill_pct;
-    out->encoder_in_pressure = sc->encoder_in_pressure;
-    out->encoder_transport_drops = sc->encoder_transport_drops;
-    out->encoder_pressure_drops = sc->encoder_pressure_drops;
-    out->encoder_packets_sent = sc->encoder_packets_sent;
-
-    g_mutex_unlock(&sc->lock);
 }
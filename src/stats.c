@@ -36,6 +36,163 @@ void uv_internal_decoder_stats_push_frame(DecoderStats *stats, gint64 now_us) {
     g_mutex_unlock(&stats->lock);
 }
 
+void uv_internal_latency_init(LatencyTracer *t) {
+    memset(t, 0, sizeof(*t));
+    g_mutex_init(&t->lock);
+    t->last_stage = UV_LATENCY_STAGE_SINK;
+}
+
+/* Called as each pipeline is built: forget frames and histograms of the
+ * previous one, whose stages were other element instances. */
+void uv_internal_latency_reset(LatencyTracer *t, gboolean enabled, gboolean shm, UvLatencyStage last_stage) {
+    g_mutex_lock(&t->lock);
+    t->enabled = enabled;
+    t->shm = shm;
+    t->last_stage = last_stage;
+    memset(t->frames, 0, sizeof(t->frames));
+    t->head = 0;
+    __atomic_store_n(&t->ingest_tag, 0, __ATOMIC_RELAXED);
+    t->link_tag = 0;
+    t->traced = 0;
+    t->lost = 0;
+    memset(t->count, 0, sizeof(t->count));
+    memset(t->sum_us, 0, sizeof(t->sum_us));
+    memset(t->max_us, 0, sizeof(t->max_us));
+    memset(t->hist, 0, sizeof(t->hist));
+    g_mutex_unlock(&t->lock);
+}
+
+static LatencyFrame *latency_find_key(LatencyTracer *t, guint32 key) {
+    /* Newest first: the frame asked about is nearly always recent. */
+    for (guint i = 1; i <= UV_LATENCY_TRACK_FRAMES; i++) {
+        LatencyFrame *f = &t->frames[(t->head + UV_LATENCY_TRACK_FRAMES - i) % UV_LATENCY_TRACK_FRAMES];
+        if (f->used && f->key == key) return f;
+    }
+    return NULL;
+}
+
+static LatencyFrame *latency_find_pts(LatencyTracer *t, GstClockTime pts) {
+    if (!GST_CLOCK_TIME_IS_VALID(pts)) return NULL;
+    for (guint i = 1; i <= UV_LATENCY_TRACK_FRAMES; i++) {
+        LatencyFrame *f = &t->frames[(t->head + UV_LATENCY_TRACK_FRAMES - i) % UV_LATENCY_TRACK_FRAMES];
+        if (f->used && f->pts == pts) return f;
+    }
+    return NULL;
+}
+
+static void latency_fold(LatencyTracer *t, UvLatencyStage stage, gint64 delta_us) {
+    if (delta_us < 0) delta_us = 0;
+    guint bucket = 0;
+    while (bucket + 1 < UV_LATENCY_BUCKETS && delta_us >= (gint64)1000 << bucket) bucket++;
+    t->hist[stage][bucket]++;
+    t->count[stage]++;
+    t->sum_us[stage] += delta_us;
+    if (delta_us > t->max_us[stage]) t->max_us[stage] = delta_us;
+}
+
+/* The frame reached the last traced stage: fold the time between each
+ * pair of consecutive stamps. A stage whose stamp or predecessor's stamp
+ * is missing is left out rather than charged with the gap. */
+static void latency_finish(LatencyTracer *t, LatencyFrame *f) {
+    gint64 prev = f->stamp_us[0];
+    for (guint s = UV_LATENCY_STAGE_APPSRC; s <= (guint)t->last_stage; s++) {
+        if (s == UV_LATENCY_STAGE_DEPAY && t->shm) continue;
+        gint64 at = f->stamp_us[s + 1];
+        if (at && prev) latency_fold(t, (UvLatencyStage)s, at - prev);
+        prev = at;
+    }
+    gint64 end = f->stamp_us[t->last_stage + 1];
+    if (f->stamp_us[0] && end) latency_fold(t, UV_LATENCY_STAGE_TOTAL, end - f->stamp_us[0]);
+    t->traced++;
+    f->used = FALSE;
+}
+
+/* A frame entered the relay or SHM ingest. Only the first datagram of a
+ * frame tags it; the check for that needs no lock. */
+void uv_internal_latency_ingest(LatencyTracer *t, guint32 key, gint64 now_us) {
+    guint64 tag = (guint64)key | ((guint64)1 << 32);
+    if (__atomic_load_n(&t->ingest_tag, __ATOMIC_RELAXED) == tag) return;
+    g_mutex_lock(&t->lock);
+    if (t->enabled && t->ingest_tag != tag) {
+        __atomic_store_n(&t->ingest_tag, tag, __ATOMIC_RELAXED);
+        LatencyFrame *f = &t->frames[t->head];
+        if (f->used) t->lost++;
+        memset(f, 0, sizeof(*f));
+        f->used = TRUE;
+        f->key = key;
+        f->pts = GST_CLOCK_TIME_NONE;
+        f->stamp_us[0] = now_us;
+        t->head = (t->head + 1u) % UV_LATENCY_TRACK_FRAMES;
+    }
+    g_mutex_unlock(&t->lock);
+}
+
+void uv_internal_latency_stamp_key(LatencyTracer *t, guint32 key, UvLatencyStage stage, gint64 now_us) {
+    g_mutex_lock(&t->lock);
+    LatencyFrame *f = latency_find_key(t, key);
+    if (f) f->stamp_us[stage + 1] = now_us;
+    g_mutex_unlock(&t->lock);
+}
+
+/* The pipeline gave the frame with this ingest key a buffer PTS. Called
+ * for every packet of the frame; only the first takes the lock. */
+void uv_internal_latency_link(LatencyTracer *t, guint32 key, GstClockTime pts) {
+    guint64 tag = (guint64)key | ((guint64)1 << 32);
+    if (t->link_tag == tag || !GST_CLOCK_TIME_IS_VALID(pts)) return;
+    t->link_tag = tag;
+    g_mutex_lock(&t->lock);
+    LatencyFrame *f = latency_find_key(t, key);
+    if (f) f->pts = pts;
+    g_mutex_unlock(&t->lock);
+}
+
+void uv_internal_latency_stamp_pts(LatencyTracer *t, GstClockTime pts, UvLatencyStage stage, gint64 now_us) {
+    g_mutex_lock(&t->lock);
+    LatencyFrame *f = latency_find_pts(t, pts);
+    if (f && !f->stamp_us[stage + 1]) {
+        f->stamp_us[stage + 1] = now_us;
+        if (stage == t->last_stage) latency_finish(t, f);
+    }
+    g_mutex_unlock(&t->lock);
+}
+
+/* Percentile q of a stage, interpolated linearly within its bucket; the
+ * open-ended last bucket reaches up to the maximum seen. */
+static double latency_percentile(const guint64 *hist, guint64 n, double max_ms, double q) {
+    if (n == 0) return 0.0;
+    double want = q * (double)n;
+    guint64 below = 0;
+    for (guint i = 0; i < UV_LATENCY_BUCKETS; i++) {
+        if (hist[i] == 0 || (double)(below + hist[i]) < want) {
+            below += hist[i];
+            continue;
+        }
+        double lo = i == 0 ? 0.0 : (double)(1u << (i - 1));
+        double hi = i + 1 == UV_LATENCY_BUCKETS ? max_ms : (double)(1u << i);
+        double v = lo + (hi - lo) * (want - (double)below) / (double)hist[i];
+        return v < max_ms ? v : max_ms;
+    }
+    return max_ms;
+}
+
+void uv_internal_latency_snapshot(LatencyTracer *t, UvLatencyStats *out) {
+    memset(out, 0, sizeof(*out));
+    g_mutex_lock(&t->lock);
+    out->enabled = t->enabled;
+    out->frames_traced = t->traced;
+    out->frames_lost = t->lost;
+    for (guint s = 0; s < UV_LATENCY_STAGE_COUNT; s++) {
+        UvLatencyStageStats *st = &out->stage[s];
+        st->frames = t->count[s];
+        memcpy(st->hist, t->hist[s], sizeof(st->hist));
+        st->max_ms = (double)t->max_us[s] / 1000.0;
+        if (st->frames > 0) st->avg_ms = (double)t->sum_us[s] / 1000.0 / (double)st->frames;
+        st->p50_ms = latency_percentile(st->hist, st->frames, st->max_ms, 0.50);
+        st->p95_ms = latency_percentile(st->hist, st->frames, st->max_ms, 0.95);
+    }
+    g_mutex_unlock(&t->lock);
+}
+
 void uv_internal_qos_db_init(QoSDatabase *db) {
     if (!db) return;
     g_mutex_init(&db->lock);
@@ -128,7 +285,7 @@ void uv_internal_qos_db_snapshot(QoSDatabase *db, UvViewerStats *stats) {
     g_mutex_unlock(&db->lock);
 }
 
-void uv_internal_emit_event(struct _UvViewer *viewer, UvViewerEventKind kind, int source_index, const UvRelaySource *source, GError *error) {
+void uv_internal_emit_event(struct _UvViewer *viewer, UvViewerEventKind kind, int source_index, const UvSourceStats *source, GError *error) {
     if (!viewer || !viewer->event_cb) return;
     UvViewerEvent event = {
         .kind = kind,
@@ -136,8 +293,7 @@ void uv_internal_emit_event(struct _UvViewer *viewer, UvViewerEventKind kind, in
         .error = error
     };
     if (source) {
-        uv_internal_populate_source_stats(source, viewer->config.clock_rate,
-                                          g_get_monotonic_time(), &event.source_snapshot);
+        event.source_snapshot = *source;
         int current = relay_controller_selected(&viewer->relay);
         event.source_snapshot.selected = (source_index >= 0 && current == source_index);
     }
@@ -0,0 +1,198 @@
+#define _GNU_SOURCE
+#include "uv_internal.h"
+
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/* Minimal io_uring plumbing for the relay (no liburing dependency): ring
+ * setup and mapping, SQE/CQE access, and one provided-buffer ring. Only the
+ * thread that called uring_io_init() may use the ring. */
+
+static int uring_setup(unsigned entries, struct io_uring_params *p) {
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags,
+                       const void *arg, size_t argsz) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, argsz);
+}
+
+static int uring_register(int fd, unsigned opcode, const void *arg, unsigned nr_args) {
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+gboolean uring_io_init(UringIo *u, unsigned entries) {
+    memset(u, 0, sizeof(*u));
+    u->fd = -1;
+
+    /* Cooperative task-run first: completion work waits for our next
+     * trip into the kernel rather than interrupting the relay mid-batch.
+     * DEFER_TASKRUN would go further and post completions only inside a
+     * GETEVENTS wait. The relay's one multishot receive reaps only after
+     * such a wait, so it would fit, but it has not been measured against
+     * COOP_TASKRUN and is left off for now. Older kernels reject the flags
+     * and get the default. */
+    static const unsigned setup_flags[] = {
+        IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_COOP_TASKRUN,
+        IORING_SETUP_COOP_TASKRUN,
+        0,
+    };
+    struct io_uring_params p;
+    for (gsize i = 0; i < G_N_ELEMENTS(setup_flags); i++) {
+        memset(&p, 0, sizeof(p));
+        p.flags = setup_flags[i] | IORING_SETUP_CQSIZE;
+        p.cq_entries = entries * 4u;
+        u->fd = uring_setup(entries, &p);
+        if (u->fd >= 0 || errno != EINVAL) break;
+    }
+    if (u->fd < 0) return FALSE;
+    if (!(p.features & IORING_FEAT_SINGLE_MMAP) || !(p.features & IORING_FEAT_EXT_ARG)) {
+        close(u->fd);
+        u->fd = -1;
+        errno = EOPNOTSUPP;
+        return FALSE;
+    }
+    u->flags = p.flags;
+
+    size_t sq_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    size_t cq_len = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    u->ring_len = MAX(sq_len, cq_len);
+    u->ring = mmap(NULL, u->ring_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                   u->fd, IORING_OFF_SQ_RING);
+    if (u->ring == MAP_FAILED) {
+        u->ring = NULL;
+        uring_io_close(u);
+        return FALSE;
+    }
+    u->sqes_len = p.sq_entries * sizeof(struct io_uring_sqe);
+    u->sqes = mmap(NULL, u->sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                   u->fd, IORING_OFF_SQES);
+    if (u->sqes == MAP_FAILED) {
+        u->sqes = NULL;
+        uring_io_close(u);
+        return FALSE;
+    }
+
+    unsigned char *r = u->ring;
+    u->sq_head = (unsigned *)(r + p.sq_off.head);
+    u->sq_tail = (unsigned *)(r + p.sq_off.tail);
+    u->sq_mask = *(unsigned *)(r + p.sq_off.ring_mask);
+    u->sq_entries = p.sq_entries;
+    u->cq_head = (unsigned *)(r + p.cq_off.head);
+    u->cq_tail = (unsigned *)(r + p.cq_off.tail);
+    u->cq_mask = *(unsigned *)(r + p.cq_off.ring_mask);
+    u->cqes = (struct io_uring_cqe *)(r + p.cq_off.cqes);
+    /* SQ index array is the identity map; SQEs are filled in ring order. */
+    unsigned *array = (unsigned *)(r + p.sq_off.array);
+    for (unsigned i = 0; i < p.sq_entries; i++) array[i] = i;
+    u->sq_local_tail = *u->sq_tail;
+    return TRUE;
+}
+
+void uring_io_close(UringIo *u) {
+    if (u->buf_ring) {
+        struct io_uring_buf_reg reg = { .bgid = u->bgid };
+        if (u->fd >= 0) uring_register(u->fd, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+        munmap(u->buf_ring, u->buf_ring_len);
+    }
+    g_free(u->bufs);
+    if (u->sqes) munmap(u->sqes, u->sqes_len);
+    if (u->ring) munmap(u->ring, u->ring_len);
+    if (u->fd >= 0) close(u->fd);
+    memset(u, 0, sizeof(*u));
+    u->fd = -1;
+}
+
+/* Next free SQE, zeroed, or NULL when the submission queue is full (submit
+ * and retry). */
+struct io_uring_sqe *uring_io_get_sqe(UringIo *u) {
+    unsigned head = __atomic_load_n(u->sq_head, __ATOMIC_ACQUIRE);
+    if (u->sq_local_tail - head >= u->sq_entries) return NULL;
+    struct io_uring_sqe *sqe = &u->sqes[u->sq_local_tail & u->sq_mask];
+    u->sq_local_tail++;
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+/* Submit every queued SQE and, with wait, block until at least one
+ * completion is ready or timeout_ms passes. Returns the number submitted
+ * or -errno; -ETIME and -EINTR just mean nothing completed in time. */
+int uring_io_submit(UringIo *u, gboolean wait, int timeout_ms) {
+    unsigned pending = u->sq_local_tail - *u->sq_tail;
+    if (!wait && pending == 0) return 0;
+    __atomic_store_n(u->sq_tail, u->sq_local_tail, __ATOMIC_RELEASE);
+    struct __kernel_timespec ts = {
+        .tv_sec = timeout_ms / 1000,
+        .tv_nsec = (long long)(timeout_ms % 1000) * 1000000ll,
+    };
+    struct io_uring_getevents_arg arg = { .ts = (uint64_t)(uintptr_t)&ts };
+    unsigned flags = IORING_ENTER_EXT_ARG;
+    if (wait) flags |= IORING_ENTER_GETEVENTS;
+    int ret = uring_enter(u->fd, pending, wait ? 1u : 0u, flags, &arg, sizeof(arg));
+    u->enters++;
+    return ret < 0 ? -errno : ret;
+}
+
+/* Completions ready to read, starting at *head. */
+unsigned uring_io_cq_ready(UringIo *u, unsigned *head) {
+    *head = *u->cq_head;
+    return __atomic_load_n(u->cq_tail, __ATOMIC_ACQUIRE) - *head;
+}
+
+struct io_uring_cqe *uring_io_cqe_at(UringIo *u, unsigned index) {
+    return &u->cqes[index & u->cq_mask];
+}
+
+void uring_io_cq_advance(UringIo *u, unsigned n) {
+    __atomic_store_n(u->cq_head, *u->cq_head + n, __ATOMIC_RELEASE);
+}
+
+/* Register a ring of count (a power of two) buffers of size bytes each
+ * under group bgid; every buffer starts out owned by the kernel. */
+gboolean uring_io_buffers_init(UringIo *u, guint count, gsize size, uint16_t bgid) {
+    u->buf_ring_len = (gsize)count * sizeof(struct io_uring_buf);
+    void *ring = mmap(NULL, u->buf_ring_len, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (ring == MAP_FAILED) return FALSE;
+    struct io_uring_buf_reg reg = {
+        .ring_addr = (uint64_t)(uintptr_t)ring,
+        .ring_entries = count,
+        .bgid = bgid,
+    };
+    if (uring_register(u->fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        int saved = errno;
+        munmap(ring, u->buf_ring_len);
+        errno = saved;
+        return FALSE;
+    }
+    u->buf_ring = ring;
+    u->buf_count = count;
+    u->buf_size = size;
+    u->bgid = bgid;
+    u->bufs = g_malloc((gsize)count * size);
+    for (guint i = 0; i < count; i++) uring_io_buffer_recycle(u, i);
+    uring_io_buffers_publish(u);
+    return TRUE;
+}
+
+unsigned char *uring_io_buffer(UringIo *u, guint bid) {
+    return u->bufs + (gsize)bid * u->buf_size;
+}
+
+/* Queue a buffer to go back to the kernel; uring_io_buffers_publish()
+ * makes everything queued since the last publish visible at once. */
+void uring_io_buffer_recycle(UringIo *u, guint bid) {
+    struct io_uring_buf *b = &u->buf_ring->bufs[u->buf_tail & (u->buf_count - 1u)];
+    b->addr = (uint64_t)(uintptr_t)uring_io_buffer(u, bid);
+    b->len = (uint32_t)u->buf_size;
+    b->bid = (uint16_t)bid;
+    u->buf_tail++;
+}
+
+void uring_io_buffers_publish(UringIo *u) {
+    __atomic_store_n(&u->buf_ring->tail, u->buf_tail, __ATOMIC_RELEASE);
+}
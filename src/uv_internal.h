@@ -3,64 +3,112 @@
 
 #include "uv_viewer.h"
 #include "frame_shm_format.h"
+#include "annexb_scan.h"
+#include "rtp_seq.h"
 
 #include <gst/app/gstappsrc.h>
 #include <arpa/inet.h>
 #include <poll.h>
 #include <signal.h>
+#include <stdio.h>
+#include <stdatomic.h>
+#include <string.h>
 
 G_BEGIN_DECLS
 
-#define UV_RELAY_MAX_SOURCES 256
+/* A full source table recycles its least recently heard source, but only
+ * one that has been silent at least this long. */
+#define UV_RELAY_EVICT_IDLE_US (5 * G_USEC_PER_SEC)
+/* A new video SSRC on an endpoint whose bound SSRC has been silent this
+ * long is the same sender restarted: the slot is rebound, not duplicated. */
+#define UV_RELAY_SSRC_REBIND_US (500 * 1000)
 #define UV_RELAY_BUF_SIZE 65536
+/* Pooled receive buffer size. Covers a full-MTU RTP datagram; anything
+ * larger spills into the slot's scratch buffer and is pushed as a copy. */
+#define UV_RELAY_POOL_BUF_SIZE 2048u
+/* Restream queue slot; a larger datagram is dropped rather than queued. */
+#define UV_RESTREAM_SLOT_SIZE 2048u
+/* Datagrams per sendmmsg() call of the restream sender. */
+#define UV_RESTREAM_SEND_BATCH 64u
+/* Paced restream: token bucket depth, so a datagram or two may go back to
+ * back after an idle spell, and the shortest sleep between paced sends. */
+#define UV_RESTREAM_PACE_BURST_BYTES (2u * UV_RESTREAM_SLOT_SIZE)
+#define UV_RESTREAM_PACE_MIN_SLEEP_NS 50000ull
+/* Duplicate/reorder window: one bit per extended sequence number ending at
+ * rtp_max_ext_seq, so UV_RTP_WIN_SIZE must be a multiple of 64. */
 #define UV_RTP_WIN_SIZE 4096
-#define UV_RTP_SLOT_EMPTY 0xffffffffu
+#define UV_RTP_WIN_WORDS (UV_RTP_WIN_SIZE / 64)
+#define UV_CACHE_LINE 64
 #define UV_SOURCE_FRAME_FPS_WINDOW_SAMPLES 512u
 #define UV_DECODER_FPS_WINDOW_SAMPLES 512u
+/* Frames the latency tracer follows at once; the oldest is given up on
+ * (and counted lost) when a new one arrives with all slots in use. */
+#define UV_LATENCY_TRACK_FRAMES 128u
 #define UV_RELEASE_CHUNK_RING 512u
 #define UV_RELEASE_FRAME_RING 1024u
 #define UV_RELEASE_DEFAULT_GAP_US 500.0
 /* Inter-arrival deltas collected before auto-calibration runs its 2-means.
  * At ~30 pkts/frame * 60 fps (~1800 pps) this fills in under a second. */
 #define UV_RELEASE_CALIB_SAMPLES 1500u
+/* Minimum spacing between stats publishes from a hot thread. Readers poll at
+ * the 200 ms GUI tick, so this bounds staleness well inside one tick. */
+#define UV_STATS_PUBLISH_INTERVAL_US 20000
 
 struct UvFrameBlockState;
+struct ShmZcMap;
 
+/* Single-writer sequence lock for stats published by a hot thread. The
+ * writer never waits: it bumps the sequence to odd, copies the block in and
+ * bumps it back to even. A reader copies the block out and retries when the
+ * sequence was odd or moved under it. Concurrent writers must already be
+ * serialised by the caller (the lock that guards the source data). */
 typedef struct {
-    UvSourceKind kind;
-    char label[UV_VIEWER_ADDR_MAX];
-    struct sockaddr_in addr;
-    socklen_t addrlen;
-    bool in_use;
+    atomic_uint seq;
+} UvSeqlock;
 
-    uint64_t rx_packets;
-    uint64_t rx_bytes;
-    uint64_t forwarded_packets;
-    uint64_t forwarded_bytes;
-    gint64   last_seen_us;
+static inline void uv_seqlock_publish(UvSeqlock *sl, void *dst, const void *src, size_t len) {
+    unsigned s = atomic_load_explicit(&sl->seq, memory_order_relaxed);
+    atomic_store_explicit(&sl->seq, s + 1u, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(dst, src, len);
+    atomic_store_explicit(&sl->seq, s + 2u, memory_order_release);
+}
 
-    uint64_t prev_bytes;
-    gint64   prev_timestamp_us;
+/* Returns the number of retries the copy took. */
+static inline guint uv_seqlock_read(UvSeqlock *sl, void *dst, const void *src, size_t len) {
+    guint retries = 0;
+    for (;;) {
+        unsigned s = atomic_load_explicit(&sl->seq, memory_order_acquire);
+        if (!(s & 1u)) {
+            memcpy(dst, src, len);
+            atomic_thread_fence(memory_order_acquire);
+            if (atomic_load_explicit(&sl->seq, memory_order_relaxed) == s) return retries;
+        }
+        retries++;
+        if ((retries & 63u) == 0) g_thread_yield();
+    }
+}
 
-    bool     rtp_initialized;
-    uint32_t rtp_cycles;
-    uint32_t rtp_first_ext_seq;
-    uint32_t rtp_max_ext_seq;
-    uint32_t rtp_bad_seq;
-    uint64_t rtp_unique_packets;
-    uint64_t rtp_duplicate_packets;
-    uint64_t rtp_reordered_packets;
-    uint32_t rtp_seq_slot[UV_RTP_WIN_SIZE];
-    uint64_t rtp_marker_frames;
+/* Per-source counters as last published by the ingest thread. Age-derived
+ * fields in stats are recomputed by the reader from the raw timestamps. */
+typedef struct {
+    UvSourceStats stats;
+    gint64 published_us;     /* 0 = never published, source not visible yet */
+    gint64 last_seen_us;
+    gint64 last_keyframe_us;
+} UvSourcePub;
+
+/* Analytics state kept out of line from the per-packet counters: the
+ * marker-FPS window (touched once per frame), plus the frame-block grid and
+ * release/cadence bookkeeping that only the selected source runs while
+ * those views are on. Allocated on first use; guarded by the source lock. */
+typedef struct {
     gint64   frame_times_us[UV_SOURCE_FRAME_FPS_WINDOW_SAMPLES];
     guint    frame_times_head;
     guint    frame_times_count;
 
-    bool     jitter_initialized;
-    uint32_t jitter_prev_transit;
-    double   jitter_value;
-
     struct UvFrameBlockState *frame_block;
+    guint    frame_block_gen;      /* frame_block.generation the grid reflects */
     uint64_t frame_block_accum_bytes;
 
     /* Per-frame release timing (Part A: span + chunks-per-frame). A frame is
@@ -99,7 +147,129 @@ typedef struct {
     guint         release_count;       /* filled entries (<= ring size) */
     guint64       release_total;       /* lifetime chunks since reset */
     guint64       release_overlap;     /* lifetime chunks with frames >= 2 */
+} UvRelaySourceCold;
+
+/* GOP cache of one source (relay_controller.c), guarded by
+ * RelayController.lock: its video datagrams from the start of the latest
+ * IRAP access unit on, each stored as a 2-byte big-endian length and the
+ * datagram. Without an IRAP yet (or after outgrowing the cap) only the
+ * access unit in progress is kept, in case it turns out to be one. */
+typedef struct {
+    unsigned char *buf;      /* RelayController.gop.cap bytes */
+    size_t   used;
+    size_t   au_start;       /* offset of the current access unit's first record */
+    uint32_t au_ts;          /* its RTP timestamp */
+    gboolean have_au;
+    gboolean valid;          /* buf starts with an IRAP access unit */
+    guint    frames;         /* access units held */
+    guint    packets;
+    guint    au_packets;     /* of which in the current access unit */
+    gboolean au_truncated;   /* the cap cut the current access unit short */
+} UvGopCache;
 
+/* In-relay RFC 7798 depacketizer for direct AU mode (relay_controller.c).
+ * Fed the selected source's video datagrams by whichever worker receives
+ * them, and reset by select; lock serialises both and keeps access units
+ * in order at the appsrc. Taken after RelayController.lock when both are
+ * held. The access unit is assembled in au with 4-byte start codes and
+ * copied into one GstBuffer when complete. */
+typedef struct {
+    GMutex lock;
+    UvDirectAuLoss loss;
+    unsigned char *au;
+    size_t   au_len;
+    size_t   au_cap;
+    uint32_t ts;
+    gboolean have_au;
+    gboolean damaged;      /* a datagram of this access unit is missing */
+    gboolean irap;         /* it holds an IDR/CRA/BLA slice */
+    gboolean fu_open;      /* a fragmented NAL unit is in progress ... */
+    size_t   fu_start;     /* ... from this offset */
+    gboolean have_seq;
+    uint16_t next_seq;
+    gboolean wait_irap;    /* dropping up to the next IRAP (wait-irap policy) */
+    gboolean discont;      /* flag the next pushed access unit DISCONT */
+    uint64_t aus;
+    uint64_t bytes;
+    uint64_t partial;
+    uint64_t dropped;
+    uint64_t nals_dropped;
+    uint64_t lost_packets;
+    uint64_t late_packets;
+} RelayDirectAu;
+
+/* Marker release (relay_controller.c): the selected source's video
+ * datagrams, held by sequence number from base, the one after the last
+ * released. A frame goes out when its marker datagram is in and every
+ * slot before it is filled; the rest wait until the oldest held datagram
+ * is jitter_latency_ms old. Guarded by lock, taken after
+ * RelayController.lock and before RelayDirectAu.lock. */
+#define UV_RELAY_HOLD_SLOTS 4096u   /* power of two */
+
+typedef struct {
+    GstBuffer *buf;        /* NULL = empty */
+    gint64   arrival_us;
+    gboolean marker;
+} RelayHoldSlot;
+
+typedef struct {
+    GMutex lock;
+    RelayHoldSlot *slots;  /* UV_RELAY_HOLD_SLOTS, indexed by seq */
+    GstAppSrc *dest;       /* ref, while anything is held */
+    gboolean have_base;
+    uint16_t base;
+    guint    run;          /* filled slots from base, none a marker */
+    guint    span;         /* base up to the highest held seq */
+    guint    held;
+    gint64   oldest_us;    /* earliest arrival held, 0 = none */
+    uint64_t frames;
+    uint64_t timeouts;
+    uint64_t lost_packets;
+    uint64_t late_packets;
+    uint64_t overflows;
+    uint64_t hold_us_total;
+    uint64_t hold_us_max;
+    uint64_t saved_us_total;
+} RelayHold;
+
+/* Per-source state, laid out in cache-line-aligned blocks by who touches
+ * them: the hot block (lock plus everything rtp_update_stats updates for
+ * every packet), the sequence window, the source-table identity, and the
+ * reader side.
+ *
+ * The identity fields (kind, label, addr, ssrc, in_use and the LRU links)
+ * belong to the source table and are guarded by RelayController.lock;
+ * everything else is guarded by the source's own lock so ingest for one
+ * source never waits on a snapshot or reclassify of another. When both are
+ * needed the controller lock is taken first. Slots are never moved or freed
+ * while the controller runs, so a source pointer stays valid after the
+ * controller lock is dropped; a slot is only recycled for a new source once
+ * it has been silent for UV_RELAY_EVICT_IDLE_US. */
+typedef struct {
+    /* Hot block. The first two lines cover a duplicate or out-of-sequence
+     * packet; NAL and keyframe counters follow for unique ones. */
+    _Alignas(UV_CACHE_LINE) GMutex lock;
+    uint64_t rx_packets;
+    uint64_t rx_bytes;
+    gint64   last_seen_us;
+    uint32_t rtp_cycles;
+    uint32_t rtp_first_ext_seq;
+    uint32_t rtp_max_ext_seq;
+    uint32_t rtp_bad_seq;
+    uint32_t jitter_prev_transit;
+    bool     rtp_initialized;
+    bool     jitter_initialized;
+    gboolean pub_dirty;            /* counters moved since pub was written */
+    uint64_t jitter_q4;            /* RFC 3550 interarrival jitter, RTP ticks x 16 */
+    uint64_t rtp_unique_packets;
+    uint64_t rtp_duplicate_packets;
+    uint64_t rtp_reordered_packets;
+    uint64_t rtp_window_lost;      /* sequence numbers that left the window unseen */
+    uint64_t forwarded_packets;
+    uint64_t forwarded_bytes;
+    uint64_t rtp_marker_frames;
+    uint64_t rtp_ap_packets;
+    uint64_t rtp_fu_packets;
     /* HEVC stream composition counters (computed from RTP payload). */
     uint64_t hevc_idr_count;
     uint64_t hevc_cra_count;
@@ -110,22 +280,297 @@ typedef struct {
     uint64_t hevc_aud_count;
     uint64_t hevc_sei_count;
     uint64_t hevc_other_nal_count;
-    uint64_t rtp_ap_packets;
-    uint64_t rtp_fu_packets;
-    gint64   last_keyframe_us;   /* g_get_monotonic_time of most recent IDR/CRA */
-    gint64   prev_keyframe_us;   /* one before that, for interval calculation */
+    gint64   last_keyframe_us;     /* g_get_monotonic_time of most recent IDR/CRA */
+    gint64   prev_keyframe_us;     /* one before that, for interval calculation */
+    UvRelaySourceCold *cold;       /* NULL until first needed */
+
+    /* Sequence window: bit (ext % UV_RTP_WIN_SIZE) is set once ext has
+     * arrived, for ext in (rtp_max_ext_seq - UV_RTP_WIN_SIZE, rtp_max_ext_seq].
+     * Positions before rtp_first_ext_seq read as arrived. A packet touches the
+     * one word holding its bit. */
+    _Alignas(UV_CACHE_LINE) uint64_t rtp_seq_bits[UV_RTP_WIN_WORDS];
+
+    /* Source-table identity (RelayController.lock), read by the registry
+     * pass once per datagram. */
+    _Alignas(UV_CACHE_LINE) UvSourceKind kind;
+    uint32_t ssrc;
+    struct sockaddr_in addr;
+    socklen_t addrlen;
+    bool ssrc_bound;     /* FALSE until a video-PT packet names the SSRC */
+    gint64 ssrc_seen_us; /* last video datagram with that SSRC */
+    bool in_use;
+    int lru_prev;        /* toward more recently heard, -1 at the head */
+    int lru_next;        /* toward less recently heard, -1 at the tail */
+    gint64 lru_touch_us; /* last datagram, as seen by the registry pass */
+    char label[UV_VIEWER_ADDR_MAX];
+    UvGopCache *gop;     /* NULL until the first video datagram (cache on) */
+
+    /* Reader side: kept off the hot lines so lock-free stats readers never
+     * pull them away from the ingest thread. Everything from here down
+     * survives relay_source_wipe(). The bitrate baseline is owned by the
+     * stats reader (serialised by UvViewer.stats_lock), not by the source
+     * lock. The published view (see UvSeqlock) is written by the thread
+     * holding the source lock at most every UV_STATS_PUBLISH_INTERVAL_US and
+     * flushed by the relay thread. */
+    _Alignas(UV_CACHE_LINE) uint64_t prev_bytes;
+    gint64      prev_timestamp_us;
+    uint64_t    gop_bytes;  /* gop->used, relaxed stores under RelayController.lock */
+    UvSeqlock   pub_seq;
+    UvSourcePub pub;
 } UvRelaySource;
 
+/* One relay index entry. slot < 0 marks an empty bucket. */
 typedef struct {
-    int listen_port;
+    uint32_t addr;      /* network order */
+    uint16_t port;      /* network order */
+    uint16_t endpoint;  /* 1 = (address, port) key, ssrc unused */
+    uint32_t ssrc;
+    int32_t  slot;
+} UvRelayIndexEntry;
+
+/* Controller-level reader view (RelayController.pub). */
+typedef struct {
+    UvIngestStats     ingest;
+    UvRestreamStats   restream;
+    UvFrameBlockStats frame_block;   /* config fields only, no grid arrays */
+    UvReleaseStats    frame_release; /* config and calibration fields only */
+    gint64            published_us;
+} UvRelayPub;
+
+/* One restream destination (restream_fanout.c): a send socket and a
+ * single-producer/single-consumer queue of copied datagrams. Ingest fills
+ * it under RelayController.lock (so relay workers take turns as the one
+ * producer); the sender thread drains it under RestreamFanout.lock. head
+ * and tail are free-running and published with release stores; each
+ * counter has one writer and is read with relaxed atomics by the stats
+ * snapshot. */
+typedef struct {
+    int                fd;
+    struct sockaddr_in dest;
+    char               address[UV_VIEWER_ADDR_MAX];
+    guint16            port;
+    unsigned char     *slots;       /* depth x UV_RESTREAM_SLOT_SIZE */
+    guint16           *lens;
+    gint64            *queued_us;   /* monotonic enqueue time per slot */
+    guint              head;        /* producer: next slot to fill */
+    guint              tail;        /* sender: next slot to send */
+    gboolean           blocked;     /* sender: last send hit a full socket buffer */
+    /* producer side */
+    guint              queue_peak;
+    uint64_t           dropped;
+    uint64_t           bytes_in;
+    /* sender side */
+    uint64_t           bytes_out;   /* bytes_in - bytes_out = bytes queued */
+    uint64_t           tx_packets;
+    uint64_t           tx_bytes;
+    uint64_t           tx_errors;
+    uint64_t           send_calls;
+    uint64_t           delay_us_total; /* enqueue to send, summed over dequeued */
+    uint64_t           delay_count;
+    uint64_t           delay_us_max;
+    /* sender: token bucket (paced restream only) */
+    double             pace_rate;    /* bytes/ns, held until the queue empties */
+    double             pace_tokens;  /* bytes */
+    uint64_t           pace_refill_ns;
+    uint64_t           pace_wait_ns; /* tokens short: next send due in this long */
+} RestreamTarget;
+
+/* Restream fan-out: every destination's queue and the thread that sends
+ * them. The destination list changes only with both RelayController.lock
+ * and lock held, so neither ingest nor the sender ever sees it move. The
+ * sender sleeps in ppoll() on wake_fd (and on blocked destinations'
+ * sockets); ingest writes wake_fd once per batch, and only when the sender
+ * has announced it is going to sleep.
+ *
+ * With pace_spread set, each destination's sends are paced by a token
+ * bucket so a frame's burst leaves spread over pace_spread of the frame
+ * period rather than back to back. The period is the selected source's
+ * measured frame_period_ms, fed in by the stats pass; the frame size is
+ * an average of the video bytes queued between RTP marker packets. */
+typedef struct {
+    GMutex         lock;
+    RestreamTarget targets[UV_RESTREAM_TARGETS_MAX];
+    guint          count;
+    guint          depth;            /* queue slots per destination, power of two */
+    int            wake_fd;          /* eventfd */
+    gint           sleeping;
+    gint           running;
+    GThread       *thread;
+    double         pace_spread;      /* fraction of the frame period, 0 = unpaced */
+    uint64_t       frame_period_ns;  /* measured, 0 = not yet known */
+    uint64_t       frame_bytes_avg;  /* producer: EWMA of bytes per frame */
+    uint64_t       frame_bytes_acc;  /* producer: video bytes since the last marker */
+    int            video_pt;         /* RTP payload type the frame size is taken from */
+} RestreamFanout;
+
+/* Capture recorder (capture_recorder.c): raw datagrams to a pcap or rtpdump
+ * file. Ingest formats each record straight into a preallocated byte ring
+ * under RelayController.lock (relay workers take turns as the one
+ * producer) and never waits: a record that does not fit is dropped and
+ * counted. The writer thread drains the ring with large sequential
+ * write()s once UV_RECORD_WRITE_CHUNK bytes are waiting, or whatever is
+ * there UV_RECORD_FLUSH_MS after its last write; ingest writes wake_fd
+ * only when a chunk is ready and the writer has announced it is going to
+ * sleep. With O_DIRECT the ring is page aligned and only whole pages go
+ * out until the file is closed. The file stays open from the first relay
+ * start to deinit, across pipeline restarts. head and tail are
+ * free-running byte offsets; counters have one writer each and are read
+ * with relaxed atomics by the stats snapshot. */
+#define UV_RECORD_WRITE_CHUNK (1u << 20)
+#define UV_RECORD_WRITE_MAX   (8u << 20)
+#define UV_RECORD_FLUSH_MS    500
+#define UV_RECORD_ALIGN       4096u
+
+typedef struct {
+    char           path[UV_RECORD_PATH_MAX];
+    UvRecordFormat format;
+    gboolean       all_sources;
+    guint16        listen_port;
+    int            fd;
+    gint           direct;          /* O_DIRECT in effect; the writer may drop it */
+    gint           failed;
+    gint           running;
+    gint           sleeping;
+    int            wake_fd;         /* eventfd */
+    GThread       *thread;
+    unsigned char *ring;
+    uint64_t       size;            /* bytes, power of two */
+    gint64         start_us;        /* monotonic at open: rtpdump offsets */
+    gint64         rt_offset_us;    /* realtime - monotonic at open: pcap stamps */
+    /* producer side */
+    uint64_t       head;
+    uint64_t       records;
+    uint64_t       bytes;
+    uint64_t       dropped;
+    uint64_t       dropped_bytes;
+    uint64_t       backlog_peak;
+    /* writer side */
+    uint64_t       tail;
+    uint64_t       bytes_written;
+    uint64_t       write_calls;
+    uint64_t       write_errors;
+    uint64_t       write_ns_total;
+    uint64_t       write_ns_max;
+} CaptureRecorder;
+
+/* Capture reader (capture_reader.c), the replay backend's source. */
+typedef struct {
+    FILE              *fp;
+    UvRecordFormat     format;
+    gboolean           swapped;     /* pcap written in the other byte order */
+    gboolean           nanos;       /* pcap nanosecond stamps */
+    guint32            linktype;
+    guint16            port;        /* pcap: UDP destination port kept, 0 = any */
+    struct sockaddr_in from;        /* rtpdump: the file's one source */
+    gint64             start_us;    /* rtpdump: capture start, realtime */
+    unsigned char     *buf;
+    uint64_t           skipped;     /* records that were not a datagram we replay */
+} CaptureReader;
+
+typedef struct {
+    const unsigned char *data;
+    size_t               len;
+    struct sockaddr_in   from;
+    gint64               ts_us;     /* capture timestamp, realtime */
+} CaptureDatagram;
+
+/* One RTP datagram as the analytics thread needs it: everything the RTP,
+ * HEVC, frame-block and release-burst analytics read, so the payload never
+ * has to outlive the receive batch. nals lists the NAL unit types the
+ * payload starts (a single NAL, a starting FU fragment, or the first
+ * UV_PACKET_META_NALS units of an aggregation packet); hdr_type is the
+ * RFC 7798 payload header type (48 = AP, 49 = FU, 50 = PACI). */
+#define UV_PACKET_META_NALS 5
+#define UV_PACKET_META_MARKER   0x01u
+#define UV_PACKET_META_SELECTED 0x02u
+#define UV_PACKET_META_PAYLOAD  0x04u  /* payload header present and parsed */
+
+typedef struct {
+    UvRelaySource *src;
+    gint64   arrival_us;
+    uint32_t ts;
+    uint16_t seq;
+    uint16_t len;
+    uint8_t  flags;
+    uint8_t  hdr_type;
+    uint8_t  nal_count;
+    uint8_t  nals[UV_PACKET_META_NALS];
+} UvPacketMeta;
+
+/* Lock-free single-producer/single-consumer ring of UvPacketMeta from one
+ * relay worker (producer) to the analytics thread (consumer). head and
+ * tail are free-running (tail doubles as the count of records folded),
+ * on their own cache lines, and published with release stores. A record
+ * that finds the ring full is dropped and counted as an overrun. */
+typedef struct {
+    UvPacketMeta *recs;
+    guint mask;
+    _Alignas(UV_CACHE_LINE) uint64_t head;
+    uint64_t tail_cache;     /* producer's last look at tail */
+    _Alignas(UV_CACHE_LINE) uint64_t tail;
+} UvAnalyticsRing;
+
+struct _RelayController;
+
+/* One relay receive thread and its socket. With more than one worker every
+ * socket joins an SO_REUSEPORT group on listen_port; the kernel hashes each
+ * sender's 4-tuple to one socket, so all datagrams of a source land on the
+ * same worker (and, pinned, the same CPU) and its source lock is never
+ * contended by another worker. Counters are guarded by
+ * RelayController.lock. */
+typedef struct {
+    struct _RelayController *rc;
+    guint    id;
     GThread *thread;
+    int      cpu;            /* pinned CPU, -1 = not pinned */
+    uint64_t batches;
+    uint64_t datagrams;
+    uint64_t kernel_drops;   /* last SO_RXQ_OVFL count (cumulative per socket) */
+    gboolean kernel_ts;      /* socket delivers kernel receive timestamps */
+    gint64   rx_delay_median_ns; /* last completed delay window, -1 = none yet */
+    gint64   rx_delay_max_ns;
+    UvRelayBackend backend;  /* receive path actually running (after any fallback) */
+    int      started;        /* 0 = starting, 1 = receiving, -1 = no socket (exited) */
+    uint64_t syscalls;       /* made by the receive loop, see UvRelayWorkerStats */
+    uint64_t batch_ns_total; /* wakeup to batch handled, summed over batches */
+    uint64_t batch_ns_max;
+    uint64_t buffer_stalls;  /* io-uring: multishot receive ran out of buffers */
+    uint64_t analytics_overruns; /* metadata records dropped on a full ring */
+    UvAnalyticsRing analytics;   /* to the analytics thread (not under lock) */
+} UvRelayWorker;
+
+typedef struct _RelayController {
+    int listen_port;
+    UvRelayBackend backend;
+    UvRelayWorker workers[UV_RELAY_WORKERS_MAX];
+    guint workers_count;
+    GCond workers_cond;     /* a worker settled its started state (under lock) */
     volatile sig_atomic_t running;
     volatile sig_atomic_t push_enabled;
 
-    UvRelaySource sources[UV_RELAY_MAX_SOURCES];
+    /* Source table, sources_max slots allocated at init. Slots fill in
+     * order and are recycled in place, so sources_count only grows. */
+    UvRelaySource *sources;
+    guint sources_max;
     guint sources_count;
     int selected_index;
 
+    /* Open-addressed (linear probing) index over the UDP sources, guarded by
+     * lock. Each source owns up to two entries: its full (address, port,
+     * SSRC) key, and an endpoint key (address, port) that routes packets
+     * carrying no video SSRC, such as audio sharing the port, to the video
+     * source on the same endpoint. Sized to stay at most half full. */
+    struct {
+        UvRelayIndexEntry *entries;
+        guint    mask;
+        int      lru_head;       /* most recently heard UDP source */
+        int      lru_tail;       /* least recently heard: first to evict */
+        uint64_t lookups;
+        uint64_t probes;
+        uint64_t evictions;
+        uint64_t rejects;
+    } index;
+
     GstAppSrc *appsrc;
     GstAppSrc *audio_appsrc; /* optional, used for shared-port audio demux */
 
@@ -140,16 +585,17 @@ typedef struct {
         double thresholds_span[3];   /* span_ms metric (computed at snapshot) */
         double thresholds_chunks[3]; /* chunks-per-frame metric */
         double thresholds_fpc[3];    /* frames-per-chunk metric */
-        gboolean reset_requested;
-        gboolean thresholds_dirty_ms;
-        gboolean thresholds_dirty_kb;
+        /* Bumped whenever the geometry or lateness/size thresholds change.
+         * Setters re-apply them to each grid eagerly; the relay thread
+         * re-applies on a mismatch in case it raced the setter with an
+         * older copy of the config. */
+        guint generation;
     } frame_block;
 
     struct {
         gboolean enabled;
         gboolean paused;
         double gap_us;            /* burst separator: gap above this = new chunk */
-        gboolean reset_requested;
         /* Auto-calibration of gap_us. While active, every selected-source
          * inter-arrival delta is logged; once UV_RELEASE_CALIB_SAMPLES land we
          * 2-means the log10(delta) distribution and place gap_us in the valley
@@ -163,22 +609,105 @@ typedef struct {
         double  *calib_samples;   /* log10(delta_us), lazily allocated */
     } frame_release;
 
-    /* Restream: verbatim UDP forward of the selected source's raw datagrams.
-     * All fields are guarded by RelayController.lock. The send socket is opened
-     * when restream is enabled with a resolvable destination and closed on
-     * disable / teardown. */
+    /* Restream: verbatim UDP forward of the selected source's raw datagrams
+     * to every destination in the fan-out. enabled is guarded by
+     * RelayController.lock; ingest queues datagrams under it and the
+     * fan-out's own thread sends them. Destinations are opened when restream
+     * is enabled and closed on disable / teardown. */
     struct {
-        gboolean           enabled;
-        int                fd;          /* UDP send socket, -1 when closed */
-        gboolean           dest_valid;  /* dest resolved and socket ready */
-        struct sockaddr_in dest;
-        char               dest_addr[UV_VIEWER_ADDR_MAX];
-        guint16            dest_port;
-        uint64_t           tx_packets;
-        uint64_t           tx_bytes;
-        uint64_t           tx_errors;
+        gboolean       enabled;
+        RestreamFanout fanout;
     } restream;
 
+    /* Capture recorder, configured from the viewer config at init. Fed in
+     * the registry pass under lock, like restream. */
+    CaptureRecorder recorder;
+
+    /* GOP caches: fed in the registry pass and flushed into appsrc by
+     * select, both under lock, so a flush always precedes the first live
+     * datagram routed from the new source. cap = 0 is off. */
+    struct {
+        size_t   cap;            /* bytes per source */
+        uint64_t bytes;          /* held, all sources */
+        guint    sources;        /* holding a valid GOP */
+        uint64_t overflows;
+        uint64_t flushes;
+        guint    flush_frames;   /* last flush */
+        guint    flush_packets;
+        uint64_t flush_bytes;
+    } gop;
+
+    /* Direct AU mode: set from the viewer config at init. */
+    gboolean direct_au;
+    RelayDirectAu direct;
+
+    /* Marker release: set from the viewer config at init. */
+    gboolean marker_release;
+    RelayHold hold;
+
+    /* Capture replay (backend UV_RELAY_BACKEND_REPLAY): one worker reads
+     * replay_path instead of a socket and hands the datagrams to the usual
+     * batch path, batched by their capture timestamps rather than by
+     * wakeups. clock_us is the relay's virtual clock while replaying (see
+     * relay_now_us()): the latest capture timestamp handed on, so every
+     * arrival, publish interval and snapshot is timed by the capture, and
+     * the analytics are folded inline on the worker, in order. The
+     * counters are the worker's, read with relaxed atomics. */
+    struct {
+        char     path[UV_RECORD_PATH_MAX];
+        gboolean fast;           /* no pacing: as fast as the relay goes */
+        gboolean decode;         /* also push to the pipeline */
+        gint64   clock_us;
+        gint     finished;
+        uint64_t datagrams;
+        uint64_t skipped;
+        gint64   capture_us;     /* capture time replayed so far */
+        gint64   wall_us;        /* wall time it took */
+    } replay;
+
+    /* Analytics thread: folds every worker's packet-metadata ring into the
+     * per-source RTP and analysis state under the source locks. It sleeps
+     * in poll() on wake_fd; a worker writes wake_fd after a batch only when
+     * sleeping is set. NULL thread = workers fold their own rings. */
+    struct {
+        GThread *thread;
+        int      wake_fd;        /* eventfd */
+        gint     sleeping;
+        gint     running;
+        guint    ring_size;      /* records per worker ring (power of two) */
+    } analytics;
+
+    /* Receive-loop batching and buffer pool (guarded by lock). batch_size,
+     * pool_buffers and pool_seen_quark are fixed at init; the rest is
+     * accumulated per recvmmsg(). */
+    struct {
+        guint    batch_size;
+        uint64_t batches;
+        uint64_t datagrams;
+        guint    batch_last;
+        guint    batch_peak;
+        guint    pool_buffers;
+        GQuark   pool_seen_quark; /* tags pool buffers the relay has seen */
+        uint64_t pool_allocated;
+        uint64_t pool_recycled;
+        uint64_t pool_copies;
+        UvLockStats registry_lock;
+        UvLockStats source_lock;
+    } ingest;
+
+    /* Lock-free reader view of everything above that lives under lock:
+     * ingest and restream counters plus the analysis config. Republished
+     * under lock by the relay thread (rate limited) and by every setter. */
+    UvSeqlock pub_seq;
+    UvRelayPub pub;
+
+    /* Per-worker rate baselines, owned by the stats reader (serialised by
+     * UvViewer.stats_lock). */
+    struct {
+        uint64_t datagrams;
+        gint64   published_us;
+    } worker_rate[UV_RELAY_WORKERS_MAX];
+
     GMutex lock;
     struct _UvViewer *viewer;
 } RelayController;
@@ -202,6 +731,7 @@ typedef struct {
     GMutex lock;
     GstAppSrc *appsrc;
     RelayController *registry;
+    struct _LatencyTracer *latency; /* viewer's tracer; NULL when not tracing */
     int source_index;
     uint64_t frames;
     uint64_t bytes;
@@ -209,8 +739,87 @@ typedef struct {
     uint64_t oversize_drops;
     uint64_t bad_slots;
     uint64_t reattaches;
+
+    /* Zero-copy mode (config.shm_zero_copy): ring slots are pushed as wrapped
+     * GstMemory and READ_IDX advances on release. zc_map is the refcounted
+     * mapping in-flight buffers keep alive; NULL in copy mode. */
+    gboolean zero_copy;
+    guint zc_max_inflight_cfg;
+    guint zc_max_inflight;       /* effective cap, clamped to slot_count - 1 */
+    struct ShmZcMap *zc_map;
+    uint64_t zc_frames;          /* access units pushed without a copy */
+    uint64_t zc_copy_fallbacks;  /* copied because downstream stopped releasing */
+
+    /* shm_* fields of UvSourceStats as last published by the ingest thread
+     * (the only writer of the counters above). */
+    UvSeqlock pub_seq;
+    UvSourceStats pub;
+    gint64 pub_us;
 } ShmIngress;
 
+/* TPACKET_V3 receive ring on an AF_PACKET socket (packet_ring.c), the
+ * relay's alternative to recvmmsg(). The kernel fills fixed-size blocks of
+ * the mmap'd ring with every frame a BPF filter passes (UDP to port) and
+ * flips each block to user ownership when full or after a 1 ms timeout;
+ * the relay walks the block in place and hands it back, so reading costs
+ * no syscall per datagram, only a poll() when the ring runs dry. */
+typedef struct {
+    const unsigned char *data;   /* UDP payload, inside the ring */
+    size_t len;
+    struct sockaddr_in from;
+    int64_t rx_realtime_ns;      /* kernel receive stamp, CLOCK_REALTIME */
+} PacketRingPacket;
+
+typedef struct {
+    int fd;                      /* AF_PACKET socket owning the ring */
+    int port_fd;                 /* UDP socket holding port (drops everything) */
+    int port;
+    unsigned char *map;
+    gsize map_len;
+    guint block_size;
+    guint block_nr;
+    guint block_cur;             /* next block to read, in ring order */
+    unsigned char *cursor;       /* next frame in the open block, NULL = none open */
+    guint pkts_left;             /* frames left in the open block */
+    uint64_t blocks;             /* blocks opened since packet_ring_open() */
+    uint64_t drops;              /* frames lost to a full ring, cumulative */
+} PacketRing;
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+
+/* One io_uring instance (uring_io.c), raw syscalls rather than liburing,
+ * with at most one provided-buffer ring. The relay's io-uring backend keeps
+ * a multishot recvmsg armed on its socket, so the kernel picks a buffer
+ * from the ring for every datagram and posts a completion without a
+ * syscall per packet; completions are reaped in batches. */
+typedef struct {
+    int fd;
+    unsigned flags;              /* IORING_SETUP_* the kernel accepted */
+    void *ring;                  /* SQ and CQ rings (single mmap) */
+    gsize ring_len;
+    struct io_uring_sqe *sqes;
+    gsize sqes_len;
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned sq_mask;
+    unsigned sq_entries;
+    unsigned sq_local_tail;      /* SQEs filled, published on submit */
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe *cqes;
+    uint64_t enters;             /* io_uring_enter() calls */
+    struct io_uring_buf_ring *buf_ring;
+    gsize buf_ring_len;
+    guint buf_count;
+    gsize buf_size;
+    uint16_t buf_tail;
+    uint16_t bgid;
+    unsigned char *bufs;
+} UringIo;
+
 typedef enum {
     UV_INGRESS_UDP = 0,
     UV_INGRESS_SHM
@@ -218,6 +827,11 @@ typedef enum {
 
 #define UV_SIDECAR_AVG_WINDOW 64u
 
+typedef struct {
+    UvSidecarStats stats;
+    gint64 last_frame_us;
+} UvSidecarPub;
+
 typedef struct {
     int fd;                          /* UDP socket (-1 = closed) */
     guint16 local_port;              /* bound port (0 = unknown) */
@@ -269,6 +883,11 @@ typedef struct {
     uint32_t encoder_pressure_drops;
     uint32_t encoder_packets_sent;
 
+    /* Reader view, republished under lock by every writer. Age fields are
+     * derived by the reader from last_frame_us. */
+    UvSeqlock pub_seq;
+    UvSidecarPub pub;
+
     struct _UvViewer *viewer;
 } SidecarController;
 
@@ -283,6 +902,43 @@ typedef struct {
     GMutex lock;
 } DecoderStats;
 
+/* A frame in flight through the pipeline. It is found by its ingest key
+ * (RTP timestamp, or the SHM pts) until the pipeline gives it a buffer
+ * PTS, and by that PTS from then on. stamp_us[0] is ingest, stamp_us[s + 1]
+ * stage s leaving; 0 = not seen. */
+typedef struct {
+    gboolean used;
+    guint32 key;
+    GstClockTime pts;
+    gint64 stamp_us[UV_LATENCY_STAGE_SINK + 2];
+} LatencyFrame;
+
+/* Per-frame latency tracer. Fed by the relay / SHM ingest threads and by
+ * pad probes on the streaming threads, all under lock; the hot paths only
+ * take it once per frame. */
+typedef struct _LatencyTracer {
+    GMutex lock;
+    gboolean enabled;
+    gboolean shm;                   /* SHM ingest: no depay stage */
+    UvLatencyStage last_stage;      /* SINK, or QUEUE_POSTDEC with videorate */
+    LatencyFrame frames[UV_LATENCY_TRACK_FRAMES];
+    guint head;                     /* slot the next ingested frame takes */
+    guint64 ingest_tag;             /* key | 1 << 32 of the last ingested frame */
+    guint64 link_tag;               /* same, last key given a PTS */
+    guint64 traced;
+    guint64 lost;
+    guint64 count[UV_LATENCY_STAGE_COUNT];
+    gint64 sum_us[UV_LATENCY_STAGE_COUNT];
+    gint64 max_us[UV_LATENCY_STAGE_COUNT];
+    guint64 hist[UV_LATENCY_STAGE_COUNT][UV_LATENCY_BUCKETS];
+} LatencyTracer;
+
+/* user_data of a latency pad probe. */
+typedef struct {
+    LatencyTracer *tracer;
+    UvLatencyStage stage;
+} LatencyProbe;
+
 typedef struct {
     guint64 processed;
     guint64 dropped;
@@ -303,6 +959,7 @@ typedef struct {
 
 typedef struct {
     int ingress_mode; /* UvIngressMode; int for __atomic ops */
+    gboolean direct_au; /* UDP ingress arrives as access units (relay depacketizes) */
     int payload_type;
     int clock_rate;
     gboolean sync_to_clock;
@@ -367,6 +1024,27 @@ typedef struct {
     gint64 audio_last_buffer_us;
     GMutex audio_lock;
     gboolean audio_active_cached;
+    LatencyProbe latency_probes[UV_LATENCY_STAGE_COUNT];
+    gulong latency_sink_probe_id;
+
+    /* Live updates (pipeline_controller_update). convert_frames counts
+     * buffers into video_convert; while settling is set, the first one
+     * closes the update's loss window. lock guards the rest; done is
+     * signalled when a pending relink finishes. */
+    guint64 convert_frames;
+    gint settling;
+    struct {
+        GMutex lock;
+        GCond done;
+        GstPad *probe_pad;           /* ref, while the relink probe is armed */
+        gulong probe_id;
+        gint64 start_us;
+        guint64 dec_start;
+        guint64 conv_start;
+        guint64 queued_start;        /* post-decode queues' level */
+        gboolean enable_videorate;   /* what the pending relink does */
+        UvReconfigStats stats;
+    } reconfig;
 } PipelineController;
 
 struct _UvViewer {
@@ -375,6 +1053,7 @@ struct _UvViewer {
     RelayController relay;
     PipelineController pipeline;
     DecoderStats decoder;
+    LatencyTracer latency;
     QoSDatabase qos;
     SidecarController sidecar;
     ShmIngress shm_ingress;
@@ -383,6 +1062,14 @@ struct _UvViewer {
     gboolean started;
     gboolean shutting_down;
 
+    /* Serialises stats readers (GUI tick, CLI) with each other; ingest
+     * threads never take it. Also accumulates the reader-side cost. */
+    GMutex stats_lock;
+    uint64_t stats_snapshots;
+    uint64_t stats_retries;
+    gint64 stats_total_us;
+    gint64 stats_max_us;
+
     UvViewerEventCallback event_cb;
     gpointer event_cb_data;
 };
@@ -390,12 +1077,20 @@ struct _UvViewer {
 void uv_internal_decoder_stats_reset(DecoderStats *stats);
 void uv_internal_decoder_stats_push_frame(DecoderStats *stats, gint64 now_us);
 
+void uv_internal_latency_init(LatencyTracer *t);
+void uv_internal_latency_reset(LatencyTracer *t, gboolean enabled, gboolean shm, UvLatencyStage last_stage);
+void uv_internal_latency_ingest(LatencyTracer *t, guint32 key, gint64 now_us);
+void uv_internal_latency_stamp_key(LatencyTracer *t, guint32 key, UvLatencyStage stage, gint64 now_us);
+void uv_internal_latency_link(LatencyTracer *t, guint32 key, GstClockTime pts);
+void uv_internal_latency_stamp_pts(LatencyTracer *t, GstClockTime pts, UvLatencyStage stage, gint64 now_us);
+void uv_internal_latency_snapshot(LatencyTracer *t, UvLatencyStats *out);
+
 void uv_internal_qos_db_init(QoSDatabase *db);
 void uv_internal_qos_db_clear(QoSDatabase *db);
 void uv_internal_qos_db_update(QoSDatabase *db, GstMessage *msg);
 void uv_internal_qos_db_snapshot(QoSDatabase *db, UvViewerStats *stats);
 
-void uv_internal_emit_event(struct _UvViewer *viewer, UvViewerEventKind kind, int source_index, const UvRelaySource *source, GError *error);
+void uv_internal_emit_event(struct _UvViewer *viewer, UvViewerEventKind kind, int source_index, const UvSourceStats *source, GError *error);
 void uv_internal_populate_source_stats(const UvRelaySource *src, int clock_rate, gint64 now_us, UvSourceStats *out);
 
 gboolean relay_controller_init(RelayController *rc, struct _UvViewer *viewer);
@@ -444,7 +1139,7 @@ void     relay_controller_frame_release_reset(RelayController *rc);
 void     relay_controller_frame_release_set_gap_us(RelayController *rc, double gap_us);
 void     relay_controller_frame_release_calibrate(RelayController *rc);
 void     relay_controller_set_restream(RelayController *rc, gboolean enabled,
-                                       const char *address, guint16 port);
+                                       const UvRestreamTarget *targets, guint count);
 void     relay_controller_restream_snapshot(RelayController *rc, UvRestreamStats *out);
 
 gboolean sidecar_controller_init(SidecarController *sc, struct _UvViewer *viewer);
@@ -475,7 +1170,49 @@ gboolean shm_ingress_start(ShmIngress *si);
 void shm_ingress_stop(ShmIngress *si);
 void shm_ingress_set_appsrc(ShmIngress *si, GstAppSrc *appsrc);
 void shm_ingress_set_push_enabled(ShmIngress *si, gboolean enabled);
-void shm_ingress_snapshot(ShmIngress *si, UvSourceStats *stats);
+guint shm_ingress_snapshot(ShmIngress *si, UvSourceStats *stats);
+
+gboolean packet_ring_open(PacketRing *pr, const char *ifname, int port);
+void     packet_ring_close(PacketRing *pr);
+gboolean packet_ring_ready(const PacketRing *pr);
+guint    packet_ring_next(PacketRing *pr, PacketRingPacket *out, guint max);
+void     packet_ring_release(PacketRing *pr);
+uint64_t packet_ring_drops(PacketRing *pr);
+
+gboolean uring_io_init(UringIo *u, unsigned entries);
+void     uring_io_close(UringIo *u);
+struct io_uring_sqe *uring_io_get_sqe(UringIo *u);
+int      uring_io_submit(UringIo *u, gboolean wait, int timeout_ms);
+unsigned uring_io_cq_ready(UringIo *u, unsigned *head);
+struct io_uring_cqe *uring_io_cqe_at(UringIo *u, unsigned index);
+void     uring_io_cq_advance(UringIo *u, unsigned n);
+gboolean uring_io_buffers_init(UringIo *u, guint count, gsize size, uint16_t bgid);
+unsigned char *uring_io_buffer(UringIo *u, guint bid);
+void     uring_io_buffer_recycle(UringIo *u, guint bid);
+void     uring_io_buffers_publish(UringIo *u);
+
+void     restream_fanout_init(RestreamFanout *f, guint depth, double pace_spread, int video_pt);
+void     restream_fanout_deinit(RestreamFanout *f);
+gboolean restream_fanout_start(RestreamFanout *f);
+void     restream_fanout_stop(RestreamFanout *f);
+guint    restream_fanout_set_targets(RestreamFanout *f, const UvRestreamTarget *targets,
+                                     const struct sockaddr_in *dests, guint count);
+void     restream_fanout_push(RestreamFanout *f, const unsigned char *pkt, size_t len);
+void     restream_fanout_set_frame_period(RestreamFanout *f, double period_ms);
+gboolean restream_fanout_kick(RestreamFanout *f);
+void     restream_fanout_snapshot(RestreamFanout *f, UvRestreamStats *out);
+
+void     capture_recorder_init(CaptureRecorder *r, const UvViewerConfig *cfg);
+void     capture_recorder_deinit(CaptureRecorder *r);
+gboolean capture_recorder_start(CaptureRecorder *r);
+void     capture_recorder_push(CaptureRecorder *r, const unsigned char *pkt, size_t len,
+                               const struct sockaddr_in *from, gint64 arrival_us);
+gboolean capture_recorder_kick(CaptureRecorder *r);
+void     capture_recorder_snapshot(CaptureRecorder *r, UvRecordStats *out);
+
+gboolean capture_reader_open(CaptureReader *cr, const char *path, guint16 port);
+void     capture_reader_close(CaptureReader *cr);
+gboolean capture_reader_next(CaptureReader *cr, CaptureDatagram *out);
 
 GstElement *uv_internal_viewer_get_sink(struct _UvViewer *viewer);
 
@@ -4,15 +4,31 @@
 static void uv_viewer_init_struct(UvViewer *viewer, const UvViewerConfig *cfg) {
     viewer->config = *cfg;
     g_mutex_init(&viewer->state_lock);
+    g_mutex_init(&viewer->stats_lock);
     viewer->started = FALSE;
     viewer->shutting_down = FALSE;
     viewer->event_cb = NULL;
     viewer->event_cb_data = NULL;
     g_mutex_init(&viewer->decoder.lock);
     uv_internal_decoder_stats_reset(&viewer->decoder);
+    uv_internal_latency_init(&viewer->latency);
     uv_internal_qos_db_init(&viewer->qos);
 }
 
+/* Push the configured restream destinations (restream_address:port first,
+ * then restream_extra) to the relay. */
+static void viewer_apply_restream(UvViewer *viewer) {
+    const UvViewerConfig *cfg = &viewer->config;
+    UvRestreamTarget targets[UV_RESTREAM_TARGETS_MAX];
+    guint count = 0;
+    g_strlcpy(targets[count].address, cfg->restream_address, sizeof(targets[count].address));
+    targets[count++].port = cfg->restream_port;
+    for (guint i = 0; i < cfg->restream_extra_count && i < G_N_ELEMENTS(cfg->restream_extra); i++) {
+        targets[count++] = cfg->restream_extra[i];
+    }
+    relay_controller_set_restream(&viewer->relay, cfg->restream_enabled, targets, count);
+}
+
 void uv_viewer_config_init(UvViewerConfig *cfg) {
     if (!cfg) return;
     cfg->listen_port = 5600;
@@ -42,8 +58,35 @@ void uv_viewer_config_init(UvViewerConfig *cfg) {
     cfg->restream_enabled = FALSE;
     cfg->restream_address[0] = '\0';
     cfg->restream_port = 5600;
+    cfg->restream_extra_count = 0;
+    cfg->restream_queue_depth = UV_RESTREAM_QUEUE_DEFAULT;
+    cfg->restream_pace_spread = 0.0;
     cfg->shm_enabled = FALSE;
     g_strlcpy(cfg->shm_name, "venc_frame_out", sizeof(cfg->shm_name));
+    cfg->shm_zero_copy = FALSE;
+    cfg->shm_max_inflight = 8;
+    cfg->relay_batch_size = UV_RELAY_BATCH_DEFAULT;
+    cfg->relay_pool_buffers = 512;
+    cfg->relay_max_sources = UV_RELAY_SOURCES_DEFAULT;
+    cfg->relay_workers = 1;
+    cfg->relay_pin_workers = TRUE;
+    cfg->relay_kernel_timestamps = TRUE;
+    cfg->relay_backend = UV_RELAY_BACKEND_SOCKET;
+    g_strlcpy(cfg->relay_ring_ifname, "any", sizeof(cfg->relay_ring_ifname));
+    cfg->relay_analytics_ring = UV_RELAY_ANALYTICS_RING_DEFAULT;
+    cfg->record_path[0] = '\0';
+    cfg->record_format = UV_RECORD_FORMAT_PCAP;
+    cfg->record_all_sources = FALSE;
+    cfg->record_buffer_mb = UV_RECORD_BUFFER_DEFAULT_MB;
+    cfg->record_direct = FALSE;
+    cfg->replay_path[0] = '\0';
+    cfg->replay_fast = FALSE;
+    cfg->replay_decode = FALSE;
+    cfg->latency_trace = FALSE;
+    cfg->gop_cache_kb = 0;
+    cfg->direct_au = FALSE;
+    cfg->direct_au_loss = UV_DIRECT_AU_LOSS_PASS;
+    cfg->marker_release = FALSE;
 }
 
 UvViewer *uv_viewer_new(const UvViewerConfig *cfg) {
@@ -82,7 +125,9 @@ void uv_viewer_free(UvViewer *viewer) {
     }
     g_mutex_clear(&viewer->qos.lock);
     g_mutex_clear(&viewer->state_lock);
+    g_mutex_clear(&viewer->stats_lock);
     g_mutex_clear(&viewer->decoder.lock);
+    g_mutex_clear(&viewer->latency.lock);
     g_free(viewer);
 }
 
@@ -121,9 +166,7 @@ bool uv_viewer_start(UvViewer *viewer, GError **error) {
     /* Honour a restream destination carried in the config (e.g. after an
      * Apply-Settings restart that rebuilt the viewer). */
     if (viewer->config.restream_enabled && viewer->config.restream_address[0]) {
-        relay_controller_set_restream(&viewer->relay, TRUE,
-                                      viewer->config.restream_address,
-                                      viewer->config.restream_port);
+        viewer_apply_restream(viewer);
     }
 
     g_mutex_lock(&viewer->state_lock);
@@ -307,9 +350,7 @@ void uv_viewer_set_restream(UvViewer *viewer, bool enabled, const char *address,
     }
     if (port > 0) viewer->config.restream_port = port;
 
-    relay_controller_set_restream(&viewer->relay, want,
-                                  viewer->config.restream_address,
-                                  viewer->config.restream_port);
+    viewer_apply_restream(viewer);
 }
 
 void uv_viewer_frame_block_configure(UvViewer *viewer, gboolean enabled, gboolean snapshot_mode) {
@@ -422,6 +463,11 @@ void uv_viewer_stats_init(UvViewerStats *stats) {
     memset(&stats->sidecar, 0, sizeof(stats->sidecar));
     stats->sidecar.seconds_since_last_frame = -1.0;
     memset(&stats->restream, 0, sizeof(stats->restream));
+    memset(&stats->record, 0, sizeof(stats->record));
+    memset(&stats->latency, 0, sizeof(stats->latency));
+    memset(&stats->reconfig, 0, sizeof(stats->reconfig));
+    memset(&stats->ingest, 0, sizeof(stats->ingest));
+    memset(&stats->snapshot, 0, sizeof(stats->snapshot));
 }
 
 void uv_viewer_stats_clear(UvViewerStats *stats) {
@@ -476,25 +522,50 @@ void uv_viewer_stats_clear(UvViewerStats *stats) {
 bool uv_viewer_get_stats(UvViewer *viewer, UvViewerStats *stats) {
     if (!viewer || !stats) return FALSE;
     if (!stats->sources) uv_viewer_stats_init(stats);
+
+    /* Relay, SHM and sidecar counters come from their seqlock-published
+     * views, so this never waits on an ingest thread. stats_lock only
+     * serialises readers (GUI tick vs CLI), which share the bitrate
+     * baselines and the accounting below. */
+    g_mutex_lock(&viewer->stats_lock);
+    gint64 start_us = g_get_monotonic_time();
     g_array_set_size(stats->sources, 0);
     g_array_set_size(stats->qos_entries, 0);
+    stats->snapshot.last_retries = 0;
     relay_controller_snapshot(&viewer->relay, stats, viewer->config.clock_rate);
+    const char *selected_udp = NULL;
     for (guint i = 0; i < stats->sources->len; i++) {
         UvSourceStats *source = &g_array_index(stats->sources, UvSourceStats, i);
-        if (source->kind == UV_SOURCE_SHM) shm_ingress_snapshot(&viewer->shm_ingress, source);
+        if (source->kind == UV_SOURCE_SHM) {
+            stats->snapshot.last_retries += shm_ingress_snapshot(&viewer->shm_ingress, source);
+        } else if (source->selected) {
+            selected_udp = source->address;
+        }
     }
     pipeline_controller_snapshot(&viewer->pipeline, stats);
+    uv_internal_latency_snapshot(&viewer->latency, &stats->latency);
     uv_internal_qos_db_snapshot(&viewer->qos, stats);
 
     /* Keep the sidecar pointed at whichever source the user is currently
      * locked on. Cheaper than wiring an event into every selection path. */
     if (viewer->config.sidecar_enabled) {
-        char sel[UV_VIEWER_ADDR_MAX] = {0};
-        gboolean have = relay_controller_get_selected_address(&viewer->relay, sel, sizeof(sel));
-        sidecar_controller_set_target(&viewer->sidecar, have ? sel : NULL);
+        sidecar_controller_set_target(&viewer->sidecar, selected_udp);
     }
     sidecar_controller_snapshot(&viewer->sidecar, stats);
     relay_controller_restream_snapshot(&viewer->relay, &stats->restream);
+    capture_recorder_snapshot(&viewer->relay.recorder, &stats->record);
+
+    gint64 elapsed_us = g_get_monotonic_time() - start_us;
+    viewer->stats_snapshots++;
+    viewer->stats_retries += stats->snapshot.last_retries;
+    viewer->stats_total_us += elapsed_us;
+    if (elapsed_us > viewer->stats_max_us) viewer->stats_max_us = elapsed_us;
+    stats->snapshot.snapshots = viewer->stats_snapshots;
+    stats->snapshot.last_us = (double)elapsed_us;
+    stats->snapshot.avg_us = (double)viewer->stats_total_us / (double)viewer->stats_snapshots;
+    stats->snapshot.max_us = (double)viewer->stats_max_us;
+    stats->snapshot.reader_retries = viewer->stats_retries;
+    g_mutex_unlock(&viewer->stats_lock);
     return TRUE;
 }
 
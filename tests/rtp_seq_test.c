@@ -0,0 +1,143 @@
+/* Regression checks for the relay's RTP sequence arithmetic (src/rtp_seq.h).
+ *
+ * The extension cases feed sequence numbers through the same steps
+ * rtp_update_stats() takes: the first packet starts the count, and the
+ * highest extended number seen so far is what the next one is extended
+ * against. The window cases place datagrams the way relay_hold_feed()
+ * does. A failed check prints the case and exits non-zero.
+ *
+ * Built standalone (no GLib/GStreamer) by `make check`. */
+#include "rtp_seq.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+typedef struct {
+    bool initialized;
+    uint32_t cycles;
+    uint32_t first_ext;
+    uint32_t max_ext;
+    unsigned jumps;
+    unsigned behind;    /* extended at or below max: would count as duplicate or reordered */
+} SeqModel;
+
+static uint32_t model_feed(SeqModel *m, uint16_t seq) {
+    bool jumped = false;
+    uint32_t ext = rtp_seq_extend(m->initialized, &m->cycles, m->max_ext, seq, &jumped);
+    if (!m->initialized) {
+        m->initialized = true;
+        m->first_ext = ext;
+        m->max_ext = ext;
+        return ext;
+    }
+    if (jumped) {
+        m->jumps++;
+        return ext;
+    }
+    if (ext > m->max_ext) m->max_ext = ext;
+    else m->behind++;
+    return ext;
+}
+
+static int failures;
+
+#define CHECK(cond, ...)                                                           \
+    do {                                                                           \
+        if (!(cond)) {                                                             \
+            fprintf(stderr, "FAIL %s:%d: ", __func__, __LINE__);                   \
+            fprintf(stderr, __VA_ARGS__);                                          \
+            fprintf(stderr, "\n");                                                 \
+            failures++;                                                            \
+            return;                                                                \
+        }                                                                          \
+    } while (0)
+
+/* A stream whose first packet sits just below the wrap: the first packet
+ * is taken as it is, and the wrap that follows is one cycle. */
+static void start_below_wrap(void) {
+    for (uint32_t start = 65437; start <= 65535; start++) {
+        SeqModel m = {0};
+        for (uint32_t i = 0; i < 3000; i++) {
+            uint32_t ext = model_feed(&m, (uint16_t)(start + i));
+            CHECK(ext == start + i, "start %u packet %u: ext %u, want %u", start, i, ext, start + i);
+        }
+        CHECK(m.first_ext == start, "start %u: first_ext %u", start, m.first_ext);
+        CHECK(m.jumps == 0 && m.behind == 0, "start %u: %u jumps, %u behind", start, m.jumps, m.behind);
+        CHECK(m.cycles == 1u << 16, "start %u: cycles %u after one wrap", start, m.cycles);
+    }
+}
+
+/* Reordering within UV_RTP_MAX_MISORDER, on either side of a wrap, lands
+ * on the packet's own extended number. */
+static void reorder_across_wrap(void) {
+    SeqModel m = {0};
+    for (uint32_t seq = 65000; seq < 65536 + 50; seq++) model_feed(&m, (uint16_t)seq);
+    uint32_t ext = model_feed(&m, 65530);
+    CHECK(ext == 65530, "late packet from the previous cycle: ext %u", ext);
+    ext = model_feed(&m, 20);
+    CHECK(ext == 65536 + 20, "late packet from this cycle: ext %u", ext);
+    CHECK(m.jumps == 0, "%u jumps", m.jumps);
+}
+
+/* Before any wrap a small step back across zero has no earlier cycle to
+ * belong to, and a step past the dropout window is a jump either way. */
+static void strays_and_jumps(void) {
+    SeqModel m = {0};
+    for (uint32_t seq = 10; seq <= 50; seq++) model_feed(&m, (uint16_t)seq);
+    model_feed(&m, 65530);
+    CHECK(m.jumps == 1, "stray before the first wrap: %u jumps", m.jumps);
+    model_feed(&m, (uint16_t)(50 + UV_RTP_MAX_DROPOUT));
+    CHECK(m.jumps == 2, "forward jump: %u jumps", m.jumps);
+    model_feed(&m, (uint16_t)(50 - UV_RTP_MAX_MISORDER - 1));
+    CHECK(m.jumps == 3, "backward jump: %u jumps", m.jumps);
+    CHECK(m.max_ext == 50, "max_ext %u moved on a jump", m.max_ext);
+}
+
+#define HOLD_SLOTS 4096u   /* UV_RELAY_HOLD_SLOTS */
+
+/* One old datagram in the middle of a stream is late and leaves the
+ * window where it was: the next live datagram still lands at base. Every
+ * live datagram here completes a frame, so base moves past it at once. */
+static void hold_old_datagram_mid_stream(void) {
+    uint16_t base = 64000;
+    for (uint32_t i = 0; i < 3000; i++) {
+        int off = rtp_seq_window_offset(base, (uint16_t)(64000 + i), HOLD_SLOTS);
+        CHECK(off == 0, "live datagram %u: offset %d", i, off);
+        base++;
+    }
+    const unsigned behind[] = { 1, UV_RTP_MAX_MISORDER + 1, 2000, UV_RTP_MAX_DROPOUT };
+    for (size_t k = 0; k < sizeof(behind) / sizeof(behind[0]); k++) {
+        uint16_t old = (uint16_t)(base - behind[k]);
+        int off = rtp_seq_window_offset(base, old, HOLD_SLOTS);
+        CHECK(off == UV_RTP_SEQ_LATE, "seq %u behind base %u: offset %d", behind[k], base, off);
+        off = rtp_seq_window_offset(base, base, HOLD_SLOTS);
+        CHECK(off == 0, "live datagram after one %u behind: offset %d", behind[k], off);
+        base++;
+    }
+}
+
+/* The window starts over only on a forward jump past it or a step back
+ * beyond the dropout window. */
+static void hold_rebase(void) {
+    uint16_t base = 100;
+    int off = rtp_seq_window_offset(base, (uint16_t)(base + HOLD_SLOTS - 1), HOLD_SLOTS);
+    CHECK(off == (int)HOLD_SLOTS - 1, "last slot: offset %d", off);
+    off = rtp_seq_window_offset(base, (uint16_t)(base + HOLD_SLOTS), HOLD_SLOTS);
+    CHECK(off == UV_RTP_SEQ_REBASE, "past the window: offset %d", off);
+    off = rtp_seq_window_offset(base, (uint16_t)(base - UV_RTP_MAX_DROPOUT - 1), HOLD_SLOTS);
+    CHECK(off == UV_RTP_SEQ_REBASE, "beyond the dropout window: offset %d", off);
+}
+
+int main(void) {
+    start_below_wrap();
+    reorder_across_wrap();
+    strays_and_jumps();
+    hold_old_datagram_mid_stream();
+    hold_rebase();
+    if (failures) {
+        fprintf(stderr, "rtp_seq_test: %d failed\n", failures);
+        return 1;
+    }
+    printf("rtp_seq_test: ok\n");
+    return 0;
+}